@@ -98,8 +98,11 @@
 #include "asio/handler_alloc_hook.hpp"
 #include "asio/handler_continuation_hook.hpp"
 #include "asio/handler_invoke_hook.hpp"
+#include "asio/handler_memory.hpp"
+#include "asio/handler_tracking.hpp"
 #include "asio/high_resolution_timer.hpp"
 #include "asio/io_context.hpp"
+#include "asio/io_context_pool.hpp"
 #include "asio/io_context_strand.hpp"
 #include "asio/io_service.hpp"
 #include "asio/io_service_strand.hpp"
@@ -168,6 +171,7 @@
 #include "asio/thread.hpp"
 #include "asio/thread_pool.hpp"
 #include "asio/time_traits.hpp"
+#include "asio/timing_wheel_traits.hpp"
 #include "asio/use_awaitable.hpp"
 #include "asio/use_future.hpp"
 #include "asio/uses_executor.hpp"
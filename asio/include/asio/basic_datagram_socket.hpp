@@ -740,6 +740,394 @@ public:
         initiate_async_send_to(this), handler, buffers, destination, flags);
   }
 
+#if !defined(ASIO_HAS_IOCP) || defined(GENERATING_DOCUMENTATION)
+  /// Send a batch of datagrams, each to its own endpoint.
+  /**
+   * This function is used to send several datagrams using as few system calls
+   * as possible. On Linux, up to 64 datagrams are passed to each call to
+   * @c sendmmsg. The function call will block until all of the datagrams have
+   * been sent successfully or an error occurs.
+   *
+   * @param buffers An array of @c count buffers, each holding one datagram.
+   *
+   * @param destinations An array of @c count endpoints, where each datagram is
+   * sent to the corresponding endpoint.
+   *
+   * @param count The number of datagrams to send.
+   *
+   * @returns The number of datagrams sent.
+   *
+   * @throws asio::system_error Thrown on failure.
+   *
+   * @note This function is not available on Windows when I/O completion ports
+   * are in use.
+   */
+  std::size_t send_batch(const const_buffer* buffers,
+      const endpoint_type* destinations, std::size_t count)
+  {
+    asio::error_code ec;
+    std::size_t s = this->impl_.get_service().send_batch(
+        this->impl_.get_implementation(), buffers, destinations, count, 0, ec);
+    asio::detail::throw_error(ec, "send_batch");
+    return s;
+  }
+
+  /// Send a batch of datagrams, each to its own endpoint.
+  /**
+   * This function is used to send several datagrams using as few system calls
+   * as possible. On Linux, up to 64 datagrams are passed to each call to
+   * @c sendmmsg. The function call will block until all of the datagrams have
+   * been sent successfully or an error occurs.
+   *
+   * @param buffers An array of @c count buffers, each holding one datagram.
+   *
+   * @param destinations An array of @c count endpoints, where each datagram is
+   * sent to the corresponding endpoint.
+   *
+   * @param count The number of datagrams to send.
+   *
+   * @param flags Flags specifying how the send call is to be made.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @returns The number of datagrams sent. If an error occurs, this is the
+   * number of datagrams that were sent before the error.
+   *
+   * @note This function is not available on Windows when I/O completion ports
+   * are in use.
+   */
+  std::size_t send_batch(const const_buffer* buffers,
+      const endpoint_type* destinations, std::size_t count,
+      socket_base::message_flags flags, asio::error_code& ec)
+  {
+    return this->impl_.get_service().send_batch(
+        this->impl_.get_implementation(), buffers,
+        destinations, count, flags, ec);
+  }
+
+  /// Start an asynchronous send of a batch of datagrams.
+  /**
+   * This function is used to asynchronously send several datagrams, each to
+   * its own endpoint, using as few system calls as possible. On Linux, up to
+   * 64 datagrams are passed to each call to @c sendmmsg. The function call
+   * always returns immediately. The operation completes when all of the
+   * datagrams have been sent or an error occurs.
+   *
+   * @param buffers An array of @c count buffers, each holding one datagram.
+   * Ownership of the array and of the underlying memory blocks is retained by
+   * the caller, which must guarantee that they remain valid until the handler
+   * is called.
+   *
+   * @param destinations An array of @c count endpoints, where each datagram is
+   * sent to the corresponding endpoint. The array must remain valid until the
+   * handler is called.
+   *
+   * @param count The number of datagrams to send.
+   *
+   * @param handler The handler to be called when the send operation completes.
+   * Copies will be made of the handler as required. The function signature of
+   * the handler must be:
+   * @code void handler(
+   *   const asio::error_code& error, // Result of operation.
+   *   std::size_t datagrams_transferred       // Number of datagrams sent.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. On
+   * immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using asio::post().
+   *
+   * @par Per-Operation Cancellation
+   * On POSIX operating systems, this asynchronous operation supports
+   * cancellation for the following asio::cancellation_type values:
+   *
+   * @li @c cancellation_type::terminal
+   *
+   * @li @c cancellation_type::partial
+   *
+   * @li @c cancellation_type::total
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+        std::size_t)) WriteHandler
+          ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE(WriteHandler,
+      void (asio::error_code, std::size_t))
+  async_send_batch(const const_buffer* buffers,
+      const endpoint_type* destinations, std::size_t count,
+      ASIO_MOVE_ARG(WriteHandler) handler
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return async_initiate<WriteHandler,
+      void (asio::error_code, std::size_t)>(
+        initiate_async_send_batch(this), handler, buffers,
+        destinations, count, socket_base::message_flags(0));
+  }
+
+  /// Start an asynchronous send of a batch of datagrams.
+  /**
+   * This function is used to asynchronously send several datagrams, each to
+   * its own endpoint, using as few system calls as possible. On Linux, up to
+   * 64 datagrams are passed to each call to @c sendmmsg. The function call
+   * always returns immediately. The operation completes when all of the
+   * datagrams have been sent or an error occurs.
+   *
+   * @param buffers An array of @c count buffers, each holding one datagram.
+   * Ownership of the array and of the underlying memory blocks is retained by
+   * the caller, which must guarantee that they remain valid until the handler
+   * is called.
+   *
+   * @param destinations An array of @c count endpoints, where each datagram is
+   * sent to the corresponding endpoint. The array must remain valid until the
+   * handler is called.
+   *
+   * @param count The number of datagrams to send.
+   *
+   * @param flags Flags specifying how the send call is to be made.
+   *
+   * @param handler The handler to be called when the send operation completes.
+   * Copies will be made of the handler as required. The function signature of
+   * the handler must be:
+   * @code void handler(
+   *   const asio::error_code& error, // Result of operation.
+   *   std::size_t datagrams_transferred       // Number of datagrams sent.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. On
+   * immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using asio::post().
+   *
+   * @par Per-Operation Cancellation
+   * On POSIX operating systems, this asynchronous operation supports
+   * cancellation for the following asio::cancellation_type values:
+   *
+   * @li @c cancellation_type::terminal
+   *
+   * @li @c cancellation_type::partial
+   *
+   * @li @c cancellation_type::total
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+        std::size_t)) WriteHandler
+          ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE(WriteHandler,
+      void (asio::error_code, std::size_t))
+  async_send_batch(const const_buffer* buffers,
+      const endpoint_type* destinations, std::size_t count,
+      socket_base::message_flags flags,
+      ASIO_MOVE_ARG(WriteHandler) handler
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return async_initiate<WriteHandler,
+      void (asio::error_code, std::size_t)>(
+        initiate_async_send_batch(this), handler, buffers,
+        destinations, count, flags);
+  }
+#endif // !defined(ASIO_HAS_IOCP) || defined(GENERATING_DOCUMENTATION)
+
+#if defined(ASIO_HAS_UDP_GSO) || defined(GENERATING_DOCUMENTATION)
+  /// Send data to the specified endpoint as a sequence of datagrams.
+  /**
+   * This function is used to send data to the specified remote endpoint as a
+   * sequence of datagrams, each of @c segment_size bytes except for the last,
+   * which may be shorter. The kernel, or the network interface, splits the
+   * data into datagrams using UDP generic segmentation offload, so that many
+   * datagrams are sent for the cost of one.
+   * The function call will block until the data has been sent successfully or
+   * an error occurs.
+   *
+   * @param buffers One or more data buffers to be sent to the remote endpoint.
+   * The total size must not exceed 64 segments, nor the maximum size of a
+   * single UDP datagram.
+   *
+   * @param destination The remote endpoint to which the data will be sent.
+   *
+   * @param segment_size The size of each datagram. Must be greater than zero
+   * and no more than 65535 bytes.
+   *
+   * @returns The number of bytes sent.
+   *
+   * @throws asio::system_error Thrown on failure.
+   *
+   * @note This function is available on Linux only, for UDP sockets.
+   */
+  template <typename ConstBufferSequence>
+  std::size_t send_segments(const ConstBufferSequence& buffers,
+      const endpoint_type& destination, std::size_t segment_size)
+  {
+    asio::error_code ec;
+    std::size_t s = this->impl_.get_service().send_segments(
+        this->impl_.get_implementation(), buffers,
+        destination, segment_size, 0, ec);
+    asio::detail::throw_error(ec, "send_segments");
+    return s;
+  }
+
+  /// Send data to the specified endpoint as a sequence of datagrams.
+  /**
+   * This function is used to send data to the specified remote endpoint as a
+   * sequence of datagrams, each of @c segment_size bytes except for the last,
+   * which may be shorter. The kernel, or the network interface, splits the
+   * data into datagrams using UDP generic segmentation offload, so that many
+   * datagrams are sent for the cost of one.
+   * The function call will block until the data has been sent successfully or
+   * an error occurs.
+   *
+   * @param buffers One or more data buffers to be sent to the remote endpoint.
+   * The total size must not exceed 64 segments, nor the maximum size of a
+   * single UDP datagram.
+   *
+   * @param destination The remote endpoint to which the data will be sent.
+   *
+   * @param segment_size The size of each datagram. Must be greater than zero
+   * and no more than 65535 bytes.
+   *
+   * @param flags Flags specifying how the send call is to be made.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @returns The number of bytes sent.
+   *
+   * @note This function is available on Linux only, for UDP sockets.
+   */
+  template <typename ConstBufferSequence>
+  std::size_t send_segments(const ConstBufferSequence& buffers,
+      const endpoint_type& destination, std::size_t segment_size,
+      socket_base::message_flags flags, asio::error_code& ec)
+  {
+    return this->impl_.get_service().send_segments(
+        this->impl_.get_implementation(), buffers,
+        destination, segment_size, flags, ec);
+  }
+
+  /// Start an asynchronous send of data as a sequence of datagrams.
+  /**
+   * This function is used to send data to the specified remote endpoint as a
+   * sequence of datagrams, each of @c segment_size bytes except for the last,
+   * which may be shorter. The kernel, or the network interface, splits the
+   * data into datagrams using UDP generic segmentation offload, so that many
+   * datagrams are sent for the cost of one.
+   * The function call always returns immediately.
+   *
+   * @param buffers One or more data buffers to be sent to the remote endpoint.
+   * The total size must not exceed 64 segments, nor the maximum size of a
+   * single UDP datagram.
+   * Although the buffers object may be copied as necessary, ownership of the
+   * underlying memory blocks is retained by the caller, which must guarantee
+   * that they remain valid until the handler is called.
+   *
+   * @param destination The remote endpoint to which the data will be sent.
+   *
+   * @param segment_size The size of each datagram. Must be greater than zero
+   * and no more than 65535 bytes.
+   *
+   * @param handler The handler to be called when the send operation completes.
+   * Copies will be made of the handler as required. The function signature of
+   * the handler must be:
+   * @code void handler(
+   *   const asio::error_code& error, // Result of operation.
+   *   std::size_t bytes_transferred           // Number of bytes sent.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. On
+   * immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using asio::post().
+   *
+   * @note This function is available on Linux only, for UDP sockets.
+   *
+   * @par Per-Operation Cancellation
+   * On POSIX operating systems, this asynchronous operation supports
+   * cancellation for the following asio::cancellation_type values:
+   *
+   * @li @c cancellation_type::terminal
+   *
+   * @li @c cancellation_type::partial
+   *
+   * @li @c cancellation_type::total
+   */
+  template <typename ConstBufferSequence,
+      ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+        std::size_t)) WriteHandler
+          ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE(WriteHandler,
+      void (asio::error_code, std::size_t))
+  async_send_segments(const ConstBufferSequence& buffers,
+      const endpoint_type& destination, std::size_t segment_size,
+      ASIO_MOVE_ARG(WriteHandler) handler
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return async_initiate<WriteHandler,
+      void (asio::error_code, std::size_t)>(
+        initiate_async_send_segments(this), handler, buffers,
+        destination, segment_size, socket_base::message_flags(0));
+  }
+
+  /// Start an asynchronous send of data as a sequence of datagrams.
+  /**
+   * This function is used to send data to the specified remote endpoint as a
+   * sequence of datagrams, each of @c segment_size bytes except for the last,
+   * which may be shorter. The kernel, or the network interface, splits the
+   * data into datagrams using UDP generic segmentation offload, so that many
+   * datagrams are sent for the cost of one.
+   * The function call always returns immediately.
+   *
+   * @param buffers One or more data buffers to be sent to the remote endpoint.
+   * The total size must not exceed 64 segments, nor the maximum size of a
+   * single UDP datagram.
+   * Although the buffers object may be copied as necessary, ownership of the
+   * underlying memory blocks is retained by the caller, which must guarantee
+   * that they remain valid until the handler is called.
+   *
+   * @param destination The remote endpoint to which the data will be sent.
+   *
+   * @param segment_size The size of each datagram. Must be greater than zero
+   * and no more than 65535 bytes.
+   *
+   * @param flags Flags specifying how the send call is to be made.
+   *
+   * @param handler The handler to be called when the send operation completes.
+   * Copies will be made of the handler as required. The function signature of
+   * the handler must be:
+   * @code void handler(
+   *   const asio::error_code& error, // Result of operation.
+   *   std::size_t bytes_transferred           // Number of bytes sent.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. On
+   * immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using asio::post().
+   *
+   * @note This function is available on Linux only, for UDP sockets.
+   *
+   * @par Per-Operation Cancellation
+   * On POSIX operating systems, this asynchronous operation supports
+   * cancellation for the following asio::cancellation_type values:
+   *
+   * @li @c cancellation_type::terminal
+   *
+   * @li @c cancellation_type::partial
+   *
+   * @li @c cancellation_type::total
+   */
+  template <typename ConstBufferSequence,
+      ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+        std::size_t)) WriteHandler
+          ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE(WriteHandler,
+      void (asio::error_code, std::size_t))
+  async_send_segments(const ConstBufferSequence& buffers,
+      const endpoint_type& destination, std::size_t segment_size,
+      socket_base::message_flags flags,
+      ASIO_MOVE_ARG(WriteHandler) handler
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return async_initiate<WriteHandler,
+      void (asio::error_code, std::size_t)>(
+        initiate_async_send_segments(this), handler, buffers,
+        destination, segment_size, flags);
+  }
+#endif // defined(ASIO_HAS_UDP_GSO) || defined(GENERATING_DOCUMENTATION)
+
   /// Receive some data on a connected socket.
   /**
    * This function is used to receive data on the datagram socket. The function
@@ -1153,22 +1541,446 @@ public:
         buffers, &sender_endpoint, flags);
   }
 
-private:
-  // Disallow copying and assignment.
-  basic_datagram_socket(const basic_datagram_socket&) ASIO_DELETED;
-  basic_datagram_socket& operator=(
-      const basic_datagram_socket&) ASIO_DELETED;
-
-  class initiate_async_send
-  { 
-  public:
-    typedef Executor executor_type;
-
-    explicit initiate_async_send(basic_datagram_socket* self)
-      : self_(self)
-    {
-    }
-
+#if !defined(ASIO_HAS_IOCP) || defined(GENERATING_DOCUMENTATION)
+  /// Receive a batch of datagrams with the endpoint of each sender.
+  /**
+   * This function is used to receive several datagrams using a single system
+   * call, where one is available. On Linux, up to 64 datagrams are received
+   * by each call to @c recvmmsg. The function call will block until at least
+   * one datagram has been received successfully or an error occurs. Other
+   * platforms receive one datagram per call.
+   *
+   * @param buffers An array of @c count buffers, each of which receives one
+   * datagram.
+   *
+   * @param senders An array of @c count endpoint objects, each of which
+   * receives the endpoint of the remote sender of the corresponding
+   * datagram.
+   *
+   * @param sizes An array of @c count elements, each of which receives the
+   * size of the corresponding datagram.
+   *
+   * @param count The maximum number of datagrams to receive.
+   *
+   * @returns The number of datagrams received.
+   *
+   * @throws asio::system_error Thrown on failure.
+   *
+   * @note This function is not available on Windows when I/O completion ports
+   * are in use.
+   */
+  std::size_t receive_batch(const mutable_buffer* buffers,
+      endpoint_type* senders, std::size_t* sizes, std::size_t count)
+  {
+    asio::error_code ec;
+    std::size_t s = this->impl_.get_service().receive_batch(
+        this->impl_.get_implementation(), buffers,
+        senders, sizes, count, 0, ec);
+    asio::detail::throw_error(ec, "receive_batch");
+    return s;
+  }
+
+  /// Receive a batch of datagrams with the endpoint of each sender.
+  /**
+   * This function is used to receive several datagrams using a single system
+   * call, where one is available. On Linux, up to 64 datagrams are received
+   * by each call to @c recvmmsg. The function call will block until at least
+   * one datagram has been received successfully or an error occurs. Other
+   * platforms receive one datagram per call.
+   *
+   * @param buffers An array of @c count buffers, each of which receives one
+   * datagram.
+   *
+   * @param senders An array of @c count endpoint objects, each of which
+   * receives the endpoint of the remote sender of the corresponding
+   * datagram.
+   *
+   * @param sizes An array of @c count elements, each of which receives the
+   * size of the corresponding datagram.
+   *
+   * @param count The maximum number of datagrams to receive.
+   *
+   * @param flags Flags specifying how the receive call is to be made.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @returns The number of datagrams received.
+   *
+   * @note This function is not available on Windows when I/O completion ports
+   * are in use.
+   */
+  std::size_t receive_batch(const mutable_buffer* buffers,
+      endpoint_type* senders, std::size_t* sizes, std::size_t count,
+      socket_base::message_flags flags, asio::error_code& ec)
+  {
+    return this->impl_.get_service().receive_batch(
+        this->impl_.get_implementation(), buffers,
+        senders, sizes, count, flags, ec);
+  }
+
+  /// Start an asynchronous receive of a batch of datagrams.
+  /**
+   * This function is used to asynchronously receive several datagrams using a
+   * single system call, where one is available. On Linux, up to 64 datagrams
+   * are received by each call to @c recvmmsg. The function call always
+   * returns immediately. The operation completes when at least one datagram
+   * has been received or an error occurs.
+   *
+   * @param buffers An array of @c count buffers, each of which receives one
+   * datagram.
+   * Ownership of the array and of the underlying memory blocks is retained by
+   * the caller, which must guarantee that they remain valid until the handler
+   * is called.
+   *
+   * @param senders An array of @c count endpoint objects, each of which
+   * receives the endpoint of the remote sender of the corresponding
+   * datagram. The array must remain valid until the
+   * handler is called.
+   *
+   * @param sizes An array of @c count elements, each of which receives the
+   * size of the corresponding datagram. The array must remain valid until the
+   * handler is called.
+   *
+   * @param count The maximum number of datagrams to receive.
+   *
+   * @param handler The handler to be called when the receive operation
+   * completes. Copies will be made of the handler as required. The function
+   * signature of the handler must be:
+   * @code void handler(
+   *   const asio::error_code& error, // Result of operation.
+   *   std::size_t datagrams_transferred       // Number of datagrams received.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. On
+   * immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using asio::post().
+   *
+   * @par Per-Operation Cancellation
+   * On POSIX operating systems, this asynchronous operation supports
+   * cancellation for the following asio::cancellation_type values:
+   *
+   * @li @c cancellation_type::terminal
+   *
+   * @li @c cancellation_type::partial
+   *
+   * @li @c cancellation_type::total
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+        std::size_t)) ReadHandler
+          ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE(ReadHandler,
+      void (asio::error_code, std::size_t))
+  async_receive_batch(const mutable_buffer* buffers,
+      endpoint_type* senders, std::size_t* sizes, std::size_t count,
+      ASIO_MOVE_ARG(ReadHandler) handler
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return async_initiate<ReadHandler,
+      void (asio::error_code, std::size_t)>(
+        initiate_async_receive_batch(this), handler, buffers,
+        senders, sizes, count, socket_base::message_flags(0));
+  }
+
+  /// Start an asynchronous receive of a batch of datagrams.
+  /**
+   * This function is used to asynchronously receive several datagrams using a
+   * single system call, where one is available. On Linux, up to 64 datagrams
+   * are received by each call to @c recvmmsg. The function call always
+   * returns immediately. The operation completes when at least one datagram
+   * has been received or an error occurs.
+   *
+   * @param buffers An array of @c count buffers, each of which receives one
+   * datagram.
+   * Ownership of the array and of the underlying memory blocks is retained by
+   * the caller, which must guarantee that they remain valid until the handler
+   * is called.
+   *
+   * @param senders An array of @c count endpoint objects, each of which
+   * receives the endpoint of the remote sender of the corresponding
+   * datagram. The array must remain valid until the
+   * handler is called.
+   *
+   * @param sizes An array of @c count elements, each of which receives the
+   * size of the corresponding datagram. The array must remain valid until the
+   * handler is called.
+   *
+   * @param count The maximum number of datagrams to receive.
+   *
+   * @param flags Flags specifying how the receive call is to be made.
+   *
+   * @param handler The handler to be called when the receive operation
+   * completes. Copies will be made of the handler as required. The function
+   * signature of the handler must be:
+   * @code void handler(
+   *   const asio::error_code& error, // Result of operation.
+   *   std::size_t datagrams_transferred       // Number of datagrams received.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. On
+   * immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using asio::post().
+   *
+   * @par Per-Operation Cancellation
+   * On POSIX operating systems, this asynchronous operation supports
+   * cancellation for the following asio::cancellation_type values:
+   *
+   * @li @c cancellation_type::terminal
+   *
+   * @li @c cancellation_type::partial
+   *
+   * @li @c cancellation_type::total
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+        std::size_t)) ReadHandler
+          ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE(ReadHandler,
+      void (asio::error_code, std::size_t))
+  async_receive_batch(const mutable_buffer* buffers,
+      endpoint_type* senders, std::size_t* sizes, std::size_t count,
+      socket_base::message_flags flags,
+      ASIO_MOVE_ARG(ReadHandler) handler
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return async_initiate<ReadHandler,
+      void (asio::error_code, std::size_t)>(
+        initiate_async_receive_batch(this), handler, buffers,
+        senders, sizes, count, flags);
+  }
+#endif // !defined(ASIO_HAS_IOCP) || defined(GENERATING_DOCUMENTATION)
+
+#if defined(ASIO_HAS_UDP_GSO) || defined(GENERATING_DOCUMENTATION)
+  /// Receive datagrams that may have been coalesced by the kernel.
+  /**
+   * This function is used to receive datagrams from a UDP socket on which the
+   * ip::udp::receive_offload option has been enabled. The kernel may coalesce
+   * several consecutive datagrams of the same size from the same sender, and
+   * these are received together. Each datagram is @c segment_size bytes,
+   * except for the last, which may be shorter.
+   * The function call will block until data has been received successfully or
+   * an error occurs.
+   *
+   * @param buffers One or more buffers into which the data will be received.
+   * To receive coalesced datagrams, the buffers should be able to hold up to
+   * 64 KB.
+   *
+   * @param sender_endpoint An endpoint object that receives the endpoint of
+   * the remote sender of the datagrams.
+   *
+   * @param segment_size Receives the size of each of the datagrams. If no
+   * datagrams were coalesced, this is the number of bytes received.
+   *
+   * @returns The number of bytes received.
+   *
+   * @throws asio::system_error Thrown on failure.
+   *
+   * @note This function is available on Linux only, for UDP sockets.
+   */
+  template <typename MutableBufferSequence>
+  std::size_t receive_segments(const MutableBufferSequence& buffers,
+      endpoint_type& sender_endpoint, std::size_t& segment_size)
+  {
+    asio::error_code ec;
+    std::size_t s = this->impl_.get_service().receive_segments(
+        this->impl_.get_implementation(), buffers,
+        sender_endpoint, segment_size, 0, ec);
+    asio::detail::throw_error(ec, "receive_segments");
+    return s;
+  }
+
+  /// Receive datagrams that may have been coalesced by the kernel.
+  /**
+   * This function is used to receive datagrams from a UDP socket on which the
+   * ip::udp::receive_offload option has been enabled. The kernel may coalesce
+   * several consecutive datagrams of the same size from the same sender, and
+   * these are received together. Each datagram is @c segment_size bytes,
+   * except for the last, which may be shorter.
+   * The function call will block until data has been received successfully or
+   * an error occurs.
+   *
+   * @param buffers One or more buffers into which the data will be received.
+   * To receive coalesced datagrams, the buffers should be able to hold up to
+   * 64 KB.
+   *
+   * @param sender_endpoint An endpoint object that receives the endpoint of
+   * the remote sender of the datagrams.
+   *
+   * @param segment_size Receives the size of each of the datagrams. If no
+   * datagrams were coalesced, this is the number of bytes received.
+   *
+   * @param flags Flags specifying how the receive call is to be made.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @returns The number of bytes received.
+   *
+   * @note This function is available on Linux only, for UDP sockets.
+   */
+  template <typename MutableBufferSequence>
+  std::size_t receive_segments(const MutableBufferSequence& buffers,
+      endpoint_type& sender_endpoint, std::size_t& segment_size,
+      socket_base::message_flags flags, asio::error_code& ec)
+  {
+    return this->impl_.get_service().receive_segments(
+        this->impl_.get_implementation(), buffers,
+        sender_endpoint, segment_size, flags, ec);
+  }
+
+  /// Start an asynchronous receive of datagrams that may have been coalesced.
+  /**
+   * This function is used to receive datagrams from a UDP socket on which the
+   * ip::udp::receive_offload option has been enabled. The kernel may coalesce
+   * several consecutive datagrams of the same size from the same sender, and
+   * these are received together. Each datagram is @c segment_size bytes,
+   * except for the last, which may be shorter.
+   * The function call always returns immediately.
+   *
+   * @param buffers One or more buffers into which the data will be received.
+   * To receive coalesced datagrams, the buffers should be able to hold up to
+   * 64 KB.
+   * Although the buffers object may be copied as necessary, ownership of the
+   * underlying memory blocks is retained by the caller, which must guarantee
+   * that they remain valid until the handler is called.
+   *
+   * @param sender_endpoint An endpoint object that receives the endpoint of
+   * the remote sender of the datagrams. Ownership of the object is retained
+   * by the caller, which must guarantee that it is valid until the handler is
+   * called.
+   *
+   * @param segment_size Receives the size of each of the datagrams. If no
+   * datagrams were coalesced, this is the number of bytes received. Ownership
+   * of the object is retained by the caller, which must guarantee that it is
+   * valid until the handler is called.
+   *
+   * @param handler The handler to be called when the receive operation
+   * completes. Copies will be made of the handler as required. The function
+   * signature of the handler must be:
+   * @code void handler(
+   *   const asio::error_code& error, // Result of operation.
+   *   std::size_t bytes_transferred           // Number of bytes received.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. On
+   * immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using asio::post().
+   *
+   * @note This function is available on Linux only, for UDP sockets.
+   *
+   * @par Per-Operation Cancellation
+   * On POSIX operating systems, this asynchronous operation supports
+   * cancellation for the following asio::cancellation_type values:
+   *
+   * @li @c cancellation_type::terminal
+   *
+   * @li @c cancellation_type::partial
+   *
+   * @li @c cancellation_type::total
+   */
+  template <typename MutableBufferSequence,
+      ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+        std::size_t)) ReadHandler
+          ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE(ReadHandler,
+      void (asio::error_code, std::size_t))
+  async_receive_segments(const MutableBufferSequence& buffers,
+      endpoint_type& sender_endpoint, std::size_t& segment_size,
+      ASIO_MOVE_ARG(ReadHandler) handler
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return async_initiate<ReadHandler,
+      void (asio::error_code, std::size_t)>(
+        initiate_async_receive_segments(this), handler, buffers,
+        &sender_endpoint, &segment_size, socket_base::message_flags(0));
+  }
+
+  /// Start an asynchronous receive of datagrams that may have been coalesced.
+  /**
+   * This function is used to receive datagrams from a UDP socket on which the
+   * ip::udp::receive_offload option has been enabled. The kernel may coalesce
+   * several consecutive datagrams of the same size from the same sender, and
+   * these are received together. Each datagram is @c segment_size bytes,
+   * except for the last, which may be shorter.
+   * The function call always returns immediately.
+   *
+   * @param buffers One or more buffers into which the data will be received.
+   * To receive coalesced datagrams, the buffers should be able to hold up to
+   * 64 KB.
+   * Although the buffers object may be copied as necessary, ownership of the
+   * underlying memory blocks is retained by the caller, which must guarantee
+   * that they remain valid until the handler is called.
+   *
+   * @param sender_endpoint An endpoint object that receives the endpoint of
+   * the remote sender of the datagrams. Ownership of the object is retained
+   * by the caller, which must guarantee that it is valid until the handler is
+   * called.
+   *
+   * @param segment_size Receives the size of each of the datagrams. If no
+   * datagrams were coalesced, this is the number of bytes received. Ownership
+   * of the object is retained by the caller, which must guarantee that it is
+   * valid until the handler is called.
+   *
+   * @param flags Flags specifying how the receive call is to be made.
+   *
+   * @param handler The handler to be called when the receive operation
+   * completes. Copies will be made of the handler as required. The function
+   * signature of the handler must be:
+   * @code void handler(
+   *   const asio::error_code& error, // Result of operation.
+   *   std::size_t bytes_transferred           // Number of bytes received.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the handler will not be invoked from within this function. On
+   * immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using asio::post().
+   *
+   * @note This function is available on Linux only, for UDP sockets.
+   *
+   * @par Per-Operation Cancellation
+   * On POSIX operating systems, this asynchronous operation supports
+   * cancellation for the following asio::cancellation_type values:
+   *
+   * @li @c cancellation_type::terminal
+   *
+   * @li @c cancellation_type::partial
+   *
+   * @li @c cancellation_type::total
+   */
+  template <typename MutableBufferSequence,
+      ASIO_COMPLETION_TOKEN_FOR(void (asio::error_code,
+        std::size_t)) ReadHandler
+          ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE(ReadHandler,
+      void (asio::error_code, std::size_t))
+  async_receive_segments(const MutableBufferSequence& buffers,
+      endpoint_type& sender_endpoint, std::size_t& segment_size,
+      socket_base::message_flags flags,
+      ASIO_MOVE_ARG(ReadHandler) handler
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+  {
+    return async_initiate<ReadHandler,
+      void (asio::error_code, std::size_t)>(
+        initiate_async_receive_segments(this), handler, buffers,
+        &sender_endpoint, &segment_size, flags);
+  }
+#endif // defined(ASIO_HAS_UDP_GSO) || defined(GENERATING_DOCUMENTATION)
+
+private:
+  // Disallow copying and assignment.
+  basic_datagram_socket(const basic_datagram_socket&) ASIO_DELETED;
+  basic_datagram_socket& operator=(
+      const basic_datagram_socket&) ASIO_DELETED;
+
+  class initiate_async_send
+  { 
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_send(basic_datagram_socket* self)
+      : self_(self)
+    {
+    }
+
     executor_type get_executor() const ASIO_NOEXCEPT
     {
       return self_->get_executor();
@@ -1294,6 +2106,147 @@ private:
   private:
     basic_datagram_socket* self_;
   };
+
+#if !defined(ASIO_HAS_IOCP)
+  class initiate_async_send_batch
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_send_batch(basic_datagram_socket* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename WriteHandler>
+    void operator()(ASIO_MOVE_ARG(WriteHandler) handler,
+        const const_buffer* buffers, const endpoint_type* destinations,
+        std::size_t count, socket_base::message_flags flags) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WriteHandler.
+      ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
+
+      detail::non_const_lvalue<WriteHandler> handler2(handler);
+      self_->impl_.get_service().async_send_batch(
+          self_->impl_.get_implementation(), buffers, destinations,
+          count, flags, handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_datagram_socket* self_;
+  };
+
+  class initiate_async_receive_batch
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_receive_batch(basic_datagram_socket* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename ReadHandler>
+    void operator()(ASIO_MOVE_ARG(ReadHandler) handler,
+        const mutable_buffer* buffers, endpoint_type* senders,
+        std::size_t* sizes, std::size_t count,
+        socket_base::message_flags flags) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a ReadHandler.
+      ASIO_READ_HANDLER_CHECK(ReadHandler, handler) type_check;
+
+      detail::non_const_lvalue<ReadHandler> handler2(handler);
+      self_->impl_.get_service().async_receive_batch(
+          self_->impl_.get_implementation(), buffers, senders, sizes,
+          count, flags, handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_datagram_socket* self_;
+  };
+#endif // !defined(ASIO_HAS_IOCP)
+
+#if defined(ASIO_HAS_UDP_GSO)
+  class initiate_async_send_segments
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_send_segments(basic_datagram_socket* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename WriteHandler, typename ConstBufferSequence>
+    void operator()(ASIO_MOVE_ARG(WriteHandler) handler,
+        const ConstBufferSequence& buffers, const endpoint_type& destination,
+        std::size_t segment_size, socket_base::message_flags flags) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WriteHandler.
+      ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
+
+      detail::non_const_lvalue<WriteHandler> handler2(handler);
+      self_->impl_.get_service().async_send_segments(
+          self_->impl_.get_implementation(), buffers, destination,
+          segment_size, flags, handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_datagram_socket* self_;
+  };
+
+  class initiate_async_receive_segments
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_receive_segments(basic_datagram_socket* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename ReadHandler, typename MutableBufferSequence>
+    void operator()(ASIO_MOVE_ARG(ReadHandler) handler,
+        const MutableBufferSequence& buffers, endpoint_type* sender_endpoint,
+        std::size_t* segment_size, socket_base::message_flags flags) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a ReadHandler.
+      ASIO_READ_HANDLER_CHECK(ReadHandler, handler) type_check;
+
+      detail::non_const_lvalue<ReadHandler> handler2(handler);
+      self_->impl_.get_service().async_receive_segments(
+          self_->impl_.get_implementation(), buffers, *sender_endpoint,
+          *segment_size, flags, handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_datagram_socket* self_;
+  };
+#endif // defined(ASIO_HAS_UDP_GSO)
 };
 
 } // namespace asio
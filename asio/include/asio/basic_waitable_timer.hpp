@@ -697,6 +697,33 @@ public:
   }
 #endif // !defined(ASIO_NO_DEPRECATED)
 
+  /// Get the timer's slack.
+  /**
+   * This function may be used to obtain the amount by which the completion of
+   * an asynchronous wait operation may be delayed beyond the timer's expiry
+   * time. A timer has no slack by default.
+   */
+  duration slack() const
+  {
+    return impl_.get_service().slack(impl_.get_implementation());
+  }
+
+  /// Set the timer's slack.
+  /**
+   * This function sets the amount by which the completion of subsequently
+   * started asynchronous wait operations may be delayed beyond the timer's
+   * expiry time. Each wait is scheduled at a time within this window that is
+   * shared with other timers where possible, so that timers whose windows
+   * overlap expire together and the reactor wakes and rearms its timer less
+   * often. Asynchronous wait operations never complete before the expiry time.
+   *
+   * @param s The slack to be used for the timer.
+   */
+  void slack(const duration& s)
+  {
+    impl_.get_service().slack(impl_.get_implementation(), s);
+  }
+
   /// Perform a blocking wait on the timer.
   /**
    * This function is used to wait for the timer to expire. This function
@@ -0,0 +1,280 @@
+//
+// detail/binary_handler_tracking.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_BINARY_HANDLER_TRACKING_HPP
+#define ASIO_DETAIL_BINARY_HANDLER_TRACKING_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+
+#include <cstddef>
+#include "asio/error_code.hpp"
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/stall_record.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+
+class execution_context;
+
+namespace detail {
+
+// Records handler tracking events as fixed-size binary records in per-thread
+// ring buffers. Each thread writes only to its own buffer, so recording an
+// event needs no locking. When a buffer is full the oldest events are
+// overwritten. The buffers are written to a file on request, and the file is
+// decoded offline by the handlerdecode.pl tool.
+class binary_handler_tracking
+{
+public:
+  class completion;
+
+  // The kinds of event that are recorded.
+  enum event_kind
+  {
+    creation_event = 1,
+    location_event = 2,
+    abandoned_event = 3,
+    destroyed_event = 4,
+    invocation_begin_event = 5,
+    invocation_end_event = 6,
+    operation_event = 7,
+    reactor_operation_event = 8
+  };
+
+  // Flags that describe which fields of an event are valid.
+  enum event_flags
+  {
+    has_error_code = 1,
+    has_bytes_transferred = 2,
+    has_signal_number = 4,
+    has_argument = 8,
+    innermost_location = 16
+  };
+
+  // A recorded event. Strings are recorded as addresses, and must be string
+  // literals or otherwise outlive the program's last call to dump().
+  struct event
+  {
+    uint64_t timestamp;
+    uint64_t id;
+    uint64_t parent_id;
+    uint64_t value;
+    uint64_t string1;
+    uint64_t string2;
+    int32_t error_value;
+    uint8_t kind;
+    uint8_t flags;
+    uint16_t reserved;
+  };
+
+  // Base class for objects containing tracked handlers.
+  class tracked_handler
+  {
+  private:
+    // Only the binary_handler_tracking class will have access to the id.
+    friend class binary_handler_tracking;
+    friend class completion;
+    uint64_t id_;
+
+  protected:
+    // Constructor initialises with no id.
+    tracked_handler() : id_(0) {}
+
+    // Prevent deletion through this type.
+    ~tracked_handler() {}
+  };
+
+  // Initialise the tracking system.
+  ASIO_DECL static void init();
+
+  // Start or stop recording events.
+  ASIO_DECL static void enable(bool on);
+
+  // Determine whether events are being recorded.
+  ASIO_DECL static bool enabled();
+
+  // Write the recorded events of all threads to the named file.
+  ASIO_DECL static void dump(const char* filename, asio::error_code& ec);
+
+  class location
+  {
+  public:
+    // Constructor adds a location to the stack.
+    ASIO_DECL explicit location(const char* file,
+        int line, const char* func);
+
+    // Destructor removes a location from the stack.
+    ASIO_DECL ~location();
+
+  private:
+    // Disallow copying and assignment.
+    location(const location&) ASIO_DELETED;
+    location& operator=(const location&) ASIO_DELETED;
+
+    friend class binary_handler_tracking;
+    const char* file_;
+    int line_;
+    const char* func_;
+    location* next_;
+  };
+
+  // Record the creation of a tracked handler.
+  ASIO_DECL static void creation(
+      execution_context& context, tracked_handler& h,
+      const char* object_type, void* object,
+      uintmax_t native_handle, const char* op_name);
+
+  class completion
+  {
+  public:
+    // Constructor records that handler is to be invoked with no arguments.
+    ASIO_DECL explicit completion(const tracked_handler& h);
+
+    // Destructor records only when an exception is thrown from the handler, or
+    // if the memory is being freed without the handler having been invoked.
+    ASIO_DECL ~completion();
+
+    // Records that handler is to be invoked with no arguments.
+    ASIO_DECL void invocation_begin();
+
+    // Records that handler is to be invoked with one arguments.
+    ASIO_DECL void invocation_begin(const asio::error_code& ec);
+
+    // Constructor records that handler is to be invoked with two arguments.
+    ASIO_DECL void invocation_begin(
+        const asio::error_code& ec, std::size_t bytes_transferred);
+
+    // Constructor records that handler is to be invoked with two arguments.
+    ASIO_DECL void invocation_begin(
+        const asio::error_code& ec, int signal_number);
+
+    // Constructor records that handler is to be invoked with two arguments.
+    // The argument is not recorded, as it need not outlive the call.
+    ASIO_DECL void invocation_begin(
+        const asio::error_code& ec, const char* arg);
+
+    // Record that handler invocation has ended.
+    ASIO_DECL void invocation_end();
+
+  private:
+    friend class binary_handler_tracking;
+    uint64_t id_;
+    bool invoked_;
+    completion* next_;
+  };
+
+  // Record an operation that is not directly associated with a handler.
+  ASIO_DECL static void operation(execution_context& context,
+      const char* object_type, void* object,
+      uintmax_t native_handle, const char* op_name);
+
+  // Record that a descriptor has been registered with the reactor.
+  ASIO_DECL static void reactor_registration(execution_context& context,
+      uintmax_t native_handle, uintmax_t registration);
+
+  // Record that a descriptor has been deregistered from the reactor.
+  ASIO_DECL static void reactor_deregistration(execution_context& context,
+      uintmax_t native_handle, uintmax_t registration);
+
+  // Record a reactor-based operation that is associated with a handler.
+  ASIO_DECL static void reactor_events(execution_context& context,
+      uintmax_t registration, unsigned events);
+
+  // Record a reactor-based operation that is associated with a handler.
+  ASIO_DECL static void reactor_operation(
+      const tracked_handler& h, const char* op_name,
+      const asio::error_code& ec);
+
+  // Record a reactor-based operation that is associated with a handler.
+  ASIO_DECL static void reactor_operation(
+      const tracked_handler& h, const char* op_name,
+      const asio::error_code& ec, std::size_t bytes_transferred);
+
+private:
+  struct thread_state;
+  struct thread_dump;
+  struct tracking_state;
+  ASIO_DECL static tracking_state* get_state();
+  ASIO_DECL static thread_state* get_thread_state();
+
+  // Add an event to the calling thread's buffer.
+  ASIO_DECL static void record(thread_state* t, event_kind kind,
+      unsigned flags, uint64_t id, uint64_t parent_id, uint64_t value,
+      const char* string1, const char* string2, int error_value);
+};
+
+# define ASIO_INHERIT_TRACKED_HANDLER \
+  : public asio::detail::binary_handler_tracking::tracked_handler
+
+# define ASIO_ALSO_INHERIT_TRACKED_HANDLER \
+  , public asio::detail::binary_handler_tracking::tracked_handler
+
+# define ASIO_HANDLER_TRACKING_INIT \
+  asio::detail::binary_handler_tracking::init()
+
+# if defined(ASIO_HAS_STALL_DETECTION)
+#  define ASIO_HANDLER_LOCATION(args) \
+  asio::detail::binary_handler_tracking::location tracked_location args; \
+  asio::detail::stall_location tracked_stall_location args
+# else // defined(ASIO_HAS_STALL_DETECTION)
+#  define ASIO_HANDLER_LOCATION(args) \
+  asio::detail::binary_handler_tracking::location tracked_location args
+# endif // defined(ASIO_HAS_STALL_DETECTION)
+
+# define ASIO_HANDLER_CREATION(args) \
+  asio::detail::binary_handler_tracking::creation args
+
+# define ASIO_HANDLER_COMPLETION(args) \
+  asio::detail::binary_handler_tracking::completion tracked_completion args
+
+# define ASIO_HANDLER_INVOCATION_BEGIN(args) \
+  tracked_completion.invocation_begin args
+
+# define ASIO_HANDLER_INVOCATION_END \
+  tracked_completion.invocation_end()
+
+# define ASIO_HANDLER_OPERATION(args) \
+  asio::detail::binary_handler_tracking::operation args
+
+# define ASIO_HANDLER_REACTOR_REGISTRATION(args) \
+  asio::detail::binary_handler_tracking::reactor_registration args
+
+# define ASIO_HANDLER_REACTOR_DEREGISTRATION(args) \
+  asio::detail::binary_handler_tracking::reactor_deregistration args
+
+# define ASIO_HANDLER_REACTOR_READ_EVENT 1
+# define ASIO_HANDLER_REACTOR_WRITE_EVENT 2
+# define ASIO_HANDLER_REACTOR_ERROR_EVENT 4
+
+# define ASIO_HANDLER_REACTOR_EVENTS(args) \
+  asio::detail::binary_handler_tracking::reactor_events args
+
+# define ASIO_HANDLER_REACTOR_OPERATION(args) \
+  asio::detail::binary_handler_tracking::reactor_operation args
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/binary_handler_tracking.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+
+#endif // ASIO_DETAIL_BINARY_HANDLER_TRACKING_HPP
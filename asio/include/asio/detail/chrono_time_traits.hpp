@@ -119,6 +119,29 @@ struct chrono_time_traits
     return t1 < t2;
   }
 
+  // Round a time up to a boundary that lies within the given slack. The
+  // boundaries are power-of-two multiples of the clock's tick, so that times
+  // whose windows overlap are rounded to the same value where possible.
+  static time_type coalesce(const time_type& t, const duration_type& slack)
+  {
+    int64_t s = static_cast<int64_t>(slack.count());
+    if (s <= 1)
+      return t;
+
+    int64_t grid = 1;
+    while (grid <= s / 2)
+      grid *= 2;
+
+    int64_t rem = static_cast<int64_t>(t.time_since_epoch().count()) % grid;
+    if (rem < 0)
+      rem += grid;
+    if (rem == 0)
+      return t;
+
+    return add(t, duration_type(
+          static_cast<typename duration_type::rep>(grid - rem)));
+  }
+
   // Implement just enough of the posix_time::time_duration interface to supply
   // what the timer_queue requires.
   class posix_time_duration
@@ -0,0 +1,410 @@
+//
+// detail/composed_op_memory.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_COMPOSED_OP_MEMORY_HPP
+#define ASIO_DETAIL_COMPOSED_OP_MEMORY_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <new>
+#include "asio/associated_allocator.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/type_traits.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+// The header stored in front of each block of memory obtained through a
+// composed_op_allocator.
+struct composed_op_block
+{
+  // The number of bytes available after the header.
+  std::size_t size;
+
+  // The number of composed_op_memory objects, and blocks, that refer to the
+  // block. A block with no references is freed when it is deallocated.
+  std::size_t references;
+
+  // Whether the block is allocated to an intermediate operation.
+  bool in_use;
+
+  // The larger block that replaced this one, if any.
+  composed_op_block* next;
+
+  // Return the block to the allocator that it was obtained from.
+  void (*destroy)(composed_op_block* b);
+
+  // Remove a reference to a block, freeing it and any blocks that replaced it
+  // if they are no longer needed.
+  static void release(composed_op_block* b)
+  {
+    while (b && --b->references == 0 && !b->in_use)
+    {
+      composed_op_block* next = b->next;
+      b->destroy(b);
+      b = next;
+    }
+  }
+};
+
+template <typename Allocator>
+struct get_composed_op_allocator;
+
+// Refers to the block of memory that a composed operation reuses for each of
+// its intermediate operations. The block is reserved when the operation is
+// constructed, so that copies and moves of the operation refer to the same
+// block. This matters because the allocator may be obtained from an operation
+// that is then moved before it is used. A moved-from object keeps a pointer to
+// the block but not a reference, so that the block may be released before the
+// final handler is invoked. Operations are not run concurrently with their
+// copies, so the references need not be counted atomically.
+class composed_op_memory
+{
+public:
+  // The space reserved for an intermediate operation, in addition to the
+  // space needed for the composed operation it holds.
+  enum { intermediate_op_overhead = 256 };
+
+  template <typename Handler>
+  composed_op_memory(const Handler& handler, std::size_t op_size)
+    : block_(0),
+      owner_(false)
+  {
+    typedef typename associated_allocator<Handler>::type allocator_type;
+    get_composed_op_allocator<allocator_type>::reserve(
+        (get_associated_allocator)(handler), *this,
+        op_size + intermediate_op_overhead);
+  }
+
+  composed_op_memory(const composed_op_memory& other)
+    : block_(other.block_),
+      owner_(other.owner_)
+  {
+    if (owner_)
+      ++block_->references;
+  }
+
+#if defined(ASIO_HAS_MOVE)
+  composed_op_memory(composed_op_memory&& other)
+    : block_(other.block_),
+      owner_(other.owner_)
+  {
+    other.owner_ = false;
+  }
+#endif // defined(ASIO_HAS_MOVE)
+
+  ~composed_op_memory()
+  {
+    if (owner_)
+      composed_op_block::release(block_);
+  }
+
+  // Give up the reference to the block. Composed operations call this before
+  // invoking their final handler, so that the memory may be reused by the
+  // handler.
+  void release()
+  {
+    if (owner_)
+      composed_op_block::release(block_);
+    block_ = 0;
+    owner_ = false;
+  }
+
+private:
+  template <typename, typename> friend class composed_op_allocator;
+
+  // Disallow assignment.
+  composed_op_memory& operator=(const composed_op_memory&);
+
+  // Get the current block, following any replacements.
+  composed_op_block* block() const
+  {
+    composed_op_block* b = block_;
+    while (b && b->next)
+      b = b->next;
+    return b;
+  }
+
+  // Associators obtain the allocator from a const reference to the operation.
+  mutable composed_op_block* block_;
+  mutable bool owner_;
+};
+
+// Adapts the allocator associated with a composed operation's handler so that
+// the intermediate operations reuse a single block of memory. Blocks are
+// obtained from the handler's allocator, with a header in front of each that
+// records how the block is to be freed. Like hook_allocator, an object of this
+// type must only be used to allocate while the operation it was obtained from
+// exists. Deallocation relies only on the header.
+template <typename T, typename Allocator>
+class composed_op_allocator
+{
+public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind
+  {
+    typedef composed_op_allocator<U, Allocator> other;
+  };
+
+  composed_op_allocator(const Allocator& a, const composed_op_memory& m)
+    : allocator_(a),
+      memory_(&m)
+  {
+  }
+
+  template <typename U>
+  composed_op_allocator(const composed_op_allocator<U, Allocator>& other)
+    : allocator_(other.allocator_),
+      memory_(other.memory_)
+  {
+  }
+
+  bool operator==(const composed_op_allocator& other) const
+  {
+    return allocator_ == other.allocator_;
+  }
+
+  bool operator!=(const composed_op_allocator& other) const
+  {
+    return allocator_ != other.allocator_;
+  }
+
+  T* allocate(std::size_t n)
+  {
+    if (ASIO_ALIGNOF(T) > ASIO_DEFAULT_ALIGN)
+    {
+      ASIO_REBIND_ALLOC(Allocator, T) a(allocator_);
+      return a.allocate(n);
+    }
+
+    std::size_t size = sizeof(T) * n;
+    composed_op_block* b = memory_->block();
+    if (b && !b->in_use && b->size < size)
+    {
+      // Replace the block with a larger one. The old block is freed once it
+      // is no longer referred to.
+      composed_op_block* larger = create(allocator_, size);
+      larger->references = 1;
+      b->next = larger;
+      if (memory_->owner_)
+      {
+        ++larger->references;
+        composed_op_block::release(memory_->block_);
+        memory_->block_ = larger;
+      }
+      b = larger;
+    }
+    else if (!b || b->in_use)
+    {
+      // Another intermediate operation holds the block, or no block was
+      // reserved.
+      b = create(allocator_, size);
+    }
+
+    b->in_use = true;
+    return static_cast<T*>(data(b));
+  }
+
+  void deallocate(T* p, std::size_t n)
+  {
+    if (ASIO_ALIGNOF(T) > ASIO_DEFAULT_ALIGN)
+    {
+      ASIO_REBIND_ALLOC(Allocator, T) a(allocator_);
+      a.deallocate(p, n);
+      return;
+    }
+
+    composed_op_block* b = block(p);
+    b->in_use = false;
+    if (b->references == 0)
+    {
+      b->references = 1;
+      composed_op_block::release(b);
+    }
+  }
+
+  // Reserve a block for the intermediate operations.
+  static void reserve(const Allocator& a,
+      const composed_op_memory& m, std::size_t size)
+  {
+    composed_op_block* b = create(a, size);
+    b->references = 1;
+    m.block_ = b;
+    m.owner_ = true;
+  }
+
+private:
+  template <typename, typename> friend class composed_op_allocator;
+  template <typename> friend struct get_composed_op_allocator;
+
+  // Blocks are allocated as arrays of maximally aligned units.
+  typedef typename aligned_storage<ASIO_DEFAULT_ALIGN,
+    ASIO_DEFAULT_ALIGN>::type unit_type;
+
+  // The header also records the allocator used to free the block.
+  struct header_type : composed_op_block
+  {
+    explicit header_type(const Allocator& a)
+      : allocator(a)
+    {
+    }
+
+    Allocator allocator;
+  };
+
+  enum
+  {
+    header_units =
+      (sizeof(header_type) + sizeof(unit_type) - 1) / sizeof(unit_type)
+  };
+
+  static composed_op_block* create(const Allocator& allocator,
+      std::size_t size)
+  {
+    std::size_t units = header_units
+      + (size + sizeof(unit_type) - 1) / sizeof(unit_type);
+    ASIO_REBIND_ALLOC(Allocator, unit_type) a(allocator);
+    header_type* h = new (a.allocate(units)) header_type(allocator);
+    h->size = (units - header_units) * sizeof(unit_type);
+    h->references = 0;
+    h->in_use = false;
+    h->next = 0;
+    h->destroy = &composed_op_allocator::destroy;
+    return h;
+  }
+
+  static void destroy(composed_op_block* b)
+  {
+    header_type* h = static_cast<header_type*>(b);
+    std::size_t units = header_units + h->size / sizeof(unit_type);
+    ASIO_REBIND_ALLOC(Allocator, unit_type) a(h->allocator);
+    h->~header_type();
+    a.deallocate(reinterpret_cast<unit_type*>(h), units);
+  }
+
+  static void* data(composed_op_block* b)
+  {
+    return reinterpret_cast<unit_type*>(
+        static_cast<header_type*>(b)) + header_units;
+  }
+
+  static composed_op_block* block(void* p)
+  {
+    return reinterpret_cast<header_type*>(
+        static_cast<unit_type*>(p) - header_units);
+  }
+
+  Allocator allocator_;
+  const composed_op_memory* memory_;
+};
+
+// Obtain the allocator to be used by a composed operation's intermediate
+// operations. Handlers using the default allocator continue to obtain memory
+// through the handler allocation hooks and the per-thread recycling cache,
+// which already reuse blocks between steps of a composed operation.
+template <typename Allocator>
+struct get_composed_op_allocator
+{
+  typedef composed_op_allocator<
+    typename Allocator::value_type, Allocator> type;
+
+  static type get(const Allocator& a, const composed_op_memory& m)
+  {
+    return type(a, m);
+  }
+
+  static void reserve(const Allocator& a,
+      const composed_op_memory& m, std::size_t size)
+  {
+    type::reserve(a, m, size);
+  }
+};
+
+template <typename T>
+struct get_composed_op_allocator<std::allocator<T> >
+{
+  typedef std::allocator<T> type;
+
+  static type get(const std::allocator<T>& a, const composed_op_memory&)
+  {
+    return a;
+  }
+
+  static void reserve(const std::allocator<T>&,
+      const composed_op_memory&, std::size_t)
+  {
+  }
+};
+
+// A composed operation started by another one's intermediate operation uses
+// its own block, obtained from the original allocator.
+template <typename T, typename Allocator>
+struct get_composed_op_allocator<composed_op_allocator<T, Allocator> >
+{
+  typedef composed_op_allocator<T, Allocator> type;
+
+  static type get(const type& a, const composed_op_memory& m)
+  {
+    return type(a.allocator_, m);
+  }
+
+  static void reserve(const type& a,
+      const composed_op_memory& m, std::size_t size)
+  {
+    type::reserve(a.allocator_, m, size);
+  }
+};
+
+// Used by composed operations to forward associated characteristics to their
+// handlers, substituting the composed_op_allocator for the allocator.
+template <template <typename, typename> class Associator,
+    typename Handler, typename DefaultCandidate>
+struct composed_op_associator
+  : Associator<Handler, DefaultCandidate>
+{
+  static typename Associator<Handler, DefaultCandidate>::type get(
+      const Handler& h, const composed_op_memory&,
+      const DefaultCandidate& c) ASIO_NOEXCEPT
+  {
+    return Associator<Handler, DefaultCandidate>::get(h, c);
+  }
+};
+
+template <typename Handler, typename DefaultCandidate>
+struct composed_op_associator<associated_allocator, Handler, DefaultCandidate>
+{
+  typedef typename associated_allocator<
+    Handler, DefaultCandidate>::type handler_allocator_type;
+
+  typedef typename get_composed_op_allocator<
+    handler_allocator_type>::type type;
+
+  static type get(const Handler& h, const composed_op_memory& m,
+      const DefaultCandidate& c) ASIO_NOEXCEPT
+  {
+    return get_composed_op_allocator<handler_allocator_type>::get(
+        associated_allocator<Handler, DefaultCandidate>::get(h, c), m);
+  }
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_COMPOSED_OP_MEMORY_HPP
@@ -1478,6 +1478,49 @@
 #   endif // (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 8)
 #  endif // defined(ASIO_HAS_EPOLL)
 # endif // !defined(ASIO_HAS_TIMERFD)
+# if !defined(ASIO_HAS_IO_URING)
+#  if defined(ASIO_ENABLE_IO_URING)
+#   if LINUX_VERSION_CODE >= KERNEL_VERSION(5,11,0)
+#    define ASIO_HAS_IO_URING 1
+#   endif // LINUX_VERSION_CODE >= KERNEL_VERSION(5,11,0)
+#  endif // defined(ASIO_ENABLE_IO_URING)
+# endif // !defined(ASIO_HAS_IO_URING)
+# if !defined(ASIO_HAS_MSG_ZEROCOPY)
+#  if !defined(ASIO_DISABLE_MSG_ZEROCOPY)
+#   if defined(ASIO_HAS_EPOLL) && !defined(ASIO_HAS_IO_URING)
+#    if LINUX_VERSION_CODE >= KERNEL_VERSION(4,14,0)
+#     if (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27)
+#      define ASIO_HAS_MSG_ZEROCOPY 1
+#     endif // (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27)
+#    endif // LINUX_VERSION_CODE >= KERNEL_VERSION(4,14,0)
+#   endif // defined(ASIO_HAS_EPOLL) && !defined(ASIO_HAS_IO_URING)
+#  endif // !defined(ASIO_DISABLE_MSG_ZEROCOPY)
+# endif // !defined(ASIO_HAS_MSG_ZEROCOPY)
+# if !defined(ASIO_HAS_MMSG)
+#  if !defined(ASIO_DISABLE_MMSG)
+#   if LINUX_VERSION_CODE >= KERNEL_VERSION(3,0,0)
+#    if (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14)
+#     define ASIO_HAS_MMSG 1
+#    endif // (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14)
+#   endif // LINUX_VERSION_CODE >= KERNEL_VERSION(3,0,0)
+#  endif // !defined(ASIO_DISABLE_MMSG)
+# endif // !defined(ASIO_HAS_MMSG)
+# if !defined(ASIO_HAS_UDP_GSO)
+#  if !defined(ASIO_DISABLE_UDP_GSO)
+#   if LINUX_VERSION_CODE >= KERNEL_VERSION(5,0,0)
+#    if (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29)
+#     define ASIO_HAS_UDP_GSO 1
+#    endif // (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29)
+#   endif // LINUX_VERSION_CODE >= KERNEL_VERSION(5,0,0)
+#  endif // !defined(ASIO_DISABLE_UDP_GSO)
+# endif // !defined(ASIO_HAS_UDP_GSO)
+# if !defined(ASIO_HAS_KERNEL_TLS)
+#  if !defined(ASIO_DISABLE_KERNEL_TLS)
+#   if LINUX_VERSION_CODE >= KERNEL_VERSION(4,17,0)
+#    define ASIO_HAS_KERNEL_TLS 1
+#   endif // LINUX_VERSION_CODE >= KERNEL_VERSION(4,17,0)
+#  endif // !defined(ASIO_DISABLE_KERNEL_TLS)
+# endif // !defined(ASIO_HAS_KERNEL_TLS)
 #endif // defined(__linux__)
 
 // Mac OS X, FreeBSD, NetBSD, OpenBSD: kqueue.
@@ -1684,6 +1727,37 @@
 # endif // defined(ASIO_HAS_THREADS)
 #endif // !defined(ASIO_HAS_PTHREADS)
 
+// Lock-free strand implementation, as an alternative to a pool of mutexes.
+#if !defined(ASIO_HAS_LOCK_FREE_STRANDS)
+# if defined(ASIO_ENABLE_LOCK_FREE_STRANDS)
+#  if defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+#   define ASIO_HAS_LOCK_FREE_STRANDS 1
+#  endif // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+# endif // defined(ASIO_ENABLE_LOCK_FREE_STRANDS)
+#endif // !defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
+// Support for collecting io_context metrics.
+#if !defined(ASIO_HAS_IO_CONTEXT_METRICS)
+# if !defined(ASIO_DISABLE_IO_CONTEXT_METRICS)
+#  if defined(ASIO_HAS_STD_ATOMIC) && defined(ASIO_HAS_CHRONO)
+#   if !defined(ASIO_HAS_IOCP)
+#    define ASIO_HAS_IO_CONTEXT_METRICS 1
+#   endif // !defined(ASIO_HAS_IOCP)
+#  endif // defined(ASIO_HAS_STD_ATOMIC) && defined(ASIO_HAS_CHRONO)
+# endif // !defined(ASIO_DISABLE_IO_CONTEXT_METRICS)
+#endif // !defined(ASIO_HAS_IO_CONTEXT_METRICS)
+
+// Support for detecting handlers that stall an io_context.
+#if !defined(ASIO_HAS_STALL_DETECTION)
+# if defined(ASIO_ENABLE_STALL_DETECTION)
+#  if defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+#   if defined(ASIO_HAS_CHRONO) && !defined(ASIO_HAS_IOCP)
+#    define ASIO_HAS_STALL_DETECTION 1
+#   endif // defined(ASIO_HAS_CHRONO) && !defined(ASIO_HAS_IOCP)
+#  endif // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+# endif // defined(ASIO_ENABLE_STALL_DETECTION)
+#endif // !defined(ASIO_HAS_STALL_DETECTION)
+
 // Helper to prevent macro expansion.
 #define ASIO_PREVENT_MACRO_SUBSTITUTION
 
@@ -22,6 +22,7 @@
 #include "asio/error.hpp"
 #include "asio/execution_context.hpp"
 #include "asio/detail/bind_handler.hpp"
+#include "asio/detail/chrono_time_traits.hpp"
 #include "asio/detail/fenced_block.hpp"
 #include "asio/detail/memory.hpp"
 #include "asio/detail/noncopyable.hpp"
@@ -29,6 +30,7 @@
 #include "asio/detail/socket_types.hpp"
 #include "asio/detail/timer_queue.hpp"
 #include "asio/detail/timer_queue_ptime.hpp"
+#include "asio/detail/timer_queue_wheel.hpp"
 #include "asio/detail/timer_scheduler.hpp"
 #include "asio/detail/wait_handler.hpp"
 #include "asio/detail/wait_op.hpp"
@@ -60,6 +62,7 @@ public:
     : private asio::detail::noncopyable
   {
     time_type expiry;
+    duration_type slack;
     bool might_have_pending_waits;
     typename timer_queue<Time_Traits>::per_timer_data timer_data;
   };
@@ -89,6 +92,7 @@ public:
   void construct(implementation_type& impl)
   {
     impl.expiry = time_type();
+    impl.slack = duration_type();
     impl.might_have_pending_waits = false;
   }
 
@@ -108,6 +112,8 @@ public:
     impl.expiry = other_impl.expiry;
     other_impl.expiry = time_type();
 
+    impl.slack = other_impl.slack;
+
     impl.might_have_pending_waits = other_impl.might_have_pending_waits;
     other_impl.might_have_pending_waits = false;
   }
@@ -127,6 +133,8 @@ public:
     impl.expiry = other_impl.expiry;
     other_impl.expiry = time_type();
 
+    impl.slack = other_impl.slack;
+
     impl.might_have_pending_waits = other_impl.might_have_pending_waits;
     other_impl.might_have_pending_waits = false;
   }
@@ -229,6 +237,18 @@ public:
         Time_Traits::add(Time_Traits::now(), expiry_time), ec);
   }
 
+  // Get the slack for the timer.
+  duration_type slack(const implementation_type& impl) const
+  {
+    return impl.slack;
+  }
+
+  // Set the slack for the timer. Applies to subsequently started waits.
+  void slack(implementation_type& impl, const duration_type& slack_duration)
+  {
+    impl.slack = slack_duration;
+  }
+
   // Perform a blocking wait on the timer.
   void wait(implementation_type& impl, asio::error_code& ec)
   {
@@ -268,11 +288,29 @@ public:
     ASIO_HANDLER_CREATION((scheduler_.context(),
           *p.p, "deadline_timer", &impl, 0, "async_wait"));
 
-    scheduler_.schedule_timer(timer_queue_, impl.expiry, impl.timer_data, p.p);
+    scheduler_.schedule_timer(timer_queue_,
+        coalesce(static_cast<Time_Traits*>(0), impl.expiry, impl.slack),
+        impl.timer_data, p.p);
     p.v = p.p = 0;
   }
 
 private:
+  // Apply a timer's slack to its expiry time. Slack is supported only for
+  // timers based on std::chrono clocks.
+  template <typename Clock, typename WaitTraits>
+  static time_type coalesce(chrono_time_traits<Clock, WaitTraits>*,
+      const time_type& expiry, const duration_type& slack)
+  {
+    return chrono_time_traits<Clock, WaitTraits>::coalesce(expiry, slack);
+  }
+
+  // Apply a timer's slack to its expiry time.
+  template <typename T>
+  static time_type coalesce(T*, const time_type& expiry, const duration_type&)
+  {
+    return expiry;
+  }
+
   // Helper function to wait given a duration type. The duration type should
   // either be of type boost::posix_time::time_duration, or implement the
   // required subset of its interface.
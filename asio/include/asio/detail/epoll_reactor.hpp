@@ -26,12 +26,16 @@
 #include "asio/detail/op_queue.hpp"
 #include "asio/detail/reactor_op.hpp"
 #include "asio/detail/select_interrupter.hpp"
+#include "asio/detail/socket_ops.hpp"
 #include "asio/detail/socket_types.hpp"
 #include "asio/detail/timer_queue_base.hpp"
 #include "asio/detail/timer_queue_set.hpp"
 #include "asio/detail/wait_op.hpp"
 #include "asio/execution_context.hpp"
 
+#include <vector>
+#include <sys/epoll.h>
+
 #if defined(ASIO_HAS_TIMERFD)
 # include <sys/timerfd.h>
 #endif // defined(ASIO_HAS_TIMERFD)
@@ -68,6 +72,9 @@ public:
     op_queue<reactor_op> op_queue_[max_ops];
     bool try_speculative_[max_ops];
     bool shutdown_;
+#if defined(ASIO_HAS_MSG_ZEROCOPY)
+    socket_ops::zero_copy_state zero_copy_;
+#endif // defined(ASIO_HAS_MSG_ZEROCOPY)
 
     ASIO_DECL descriptor_state(bool locking);
     void set_ready_events(uint32_t events) { task_result_ = events; }
@@ -81,6 +88,16 @@ public:
   // Per-descriptor data.
   typedef descriptor_state* per_descriptor_data;
 
+#if defined(ASIO_HAS_MSG_ZEROCOPY)
+  // Get the counters used to track zero-copy sends on a descriptor. Must only
+  // be used by operations performed by the reactor on that descriptor.
+  static socket_ops::zero_copy_state& get_zero_copy_state(
+      per_descriptor_data& descriptor_data)
+  {
+    return descriptor_data->zero_copy_;
+  }
+#endif // defined(ASIO_HAS_MSG_ZEROCOPY)
+
   // Constructor.
   ASIO_DECL epoll_reactor(asio::execution_context& ctx);
 
@@ -218,6 +235,10 @@ private:
   // Called to recalculate and update the timeout.
   ASIO_DECL void update_timeout();
 
+  // Poll the epoll descriptor without blocking until events arrive or the
+  // busy poll duration elapses. The timeout is reduced by the time spent.
+  ASIO_DECL int busy_poll(int& msec);
+
   // Get the timeout value for the epoll_wait call. The timeout value is
   // returned as a number of milliseconds. A return value of -1 indicates
   // that epoll_wait should block indefinitely.
@@ -244,6 +265,16 @@ private:
   // The timer file descriptor.
   int timer_fd_;
 
+  // The buffer used to receive events from epoll_wait.
+  std::vector<epoll_event> events_;
+
+  // The maximum duration of a busy poll, in microseconds.
+  const long busy_poll_usec_;
+
+  // The duration of the next busy poll. This shrinks while busy polling fails
+  // to find events, and is restored when it succeeds.
+  long busy_poll_budget_usec_;
+
   // The timer queues.
   timer_queue_set timer_queues_;
 
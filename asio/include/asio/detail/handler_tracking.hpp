@@ -25,11 +25,16 @@ class execution_context;
 
 #if defined(ASIO_CUSTOM_HANDLER_TRACKING)
 # include ASIO_CUSTOM_HANDLER_TRACKING
+#elif defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+# include "asio/detail/binary_handler_tracking.hpp"
 #elif defined(ASIO_ENABLE_HANDLER_TRACKING)
 # include "asio/error_code.hpp"
 # include "asio/detail/cstdint.hpp"
+# include "asio/detail/stall_record.hpp"
 # include "asio/detail/static_mutex.hpp"
 # include "asio/detail/tss_ptr.hpp"
+#else // defined(ASIO_ENABLE_HANDLER_TRACKING)
+# include "asio/detail/stall_record.hpp"
 #endif // defined(ASIO_ENABLE_HANDLER_TRACKING)
 
 #include "asio/detail/push_options.hpp"
@@ -60,6 +65,14 @@ namespace detail {
 #  define ASIO_ENABLE_HANDLER_TRACKING 1
 # endif /// !defined(ASIO_ENABLE_HANDLER_TRACKING)
 
+#elif defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+
+// The macros are defined by the binary tracking header.
+
+# if !defined(ASIO_ENABLE_HANDLER_TRACKING)
+#  define ASIO_ENABLE_HANDLER_TRACKING 1
+# endif /// !defined(ASIO_ENABLE_HANDLER_TRACKING)
+
 #elif defined(ASIO_ENABLE_HANDLER_TRACKING)
 
 class handler_tracking
@@ -197,8 +210,14 @@ private:
 # define ASIO_HANDLER_TRACKING_INIT \
   asio::detail::handler_tracking::init()
 
-# define ASIO_HANDLER_LOCATION(args) \
+# if defined(ASIO_HAS_STALL_DETECTION)
+#  define ASIO_HANDLER_LOCATION(args) \
+  asio::detail::handler_tracking::location tracked_location args; \
+  asio::detail::stall_location tracked_stall_location args
+# else // defined(ASIO_HAS_STALL_DETECTION)
+#  define ASIO_HANDLER_LOCATION(args) \
   asio::detail::handler_tracking::location tracked_location args
+# endif // defined(ASIO_HAS_STALL_DETECTION)
 
 # define ASIO_HANDLER_CREATION(args) \
   asio::detail::handler_tracking::creation args
@@ -236,7 +255,12 @@ private:
 # define ASIO_INHERIT_TRACKED_HANDLER
 # define ASIO_ALSO_INHERIT_TRACKED_HANDLER
 # define ASIO_HANDLER_TRACKING_INIT (void)0
-# define ASIO_HANDLER_LOCATION(loc) (void)0
+# if defined(ASIO_HAS_STALL_DETECTION)
+#  define ASIO_HANDLER_LOCATION(args) \
+  asio::detail::stall_location tracked_stall_location args
+# else // defined(ASIO_HAS_STALL_DETECTION)
+#  define ASIO_HANDLER_LOCATION(loc) (void)0
+# endif // defined(ASIO_HAS_STALL_DETECTION)
 # define ASIO_HANDLER_CREATION(args) (void)0
 # define ASIO_HANDLER_COMPLETION(args) (void)0
 # define ASIO_HANDLER_INVOCATION_BEGIN(args) (void)0
@@ -0,0 +1,493 @@
+//
+// detail/impl/binary_handler_tracking.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_BINARY_HANDLER_TRACKING_IPP
+#define ASIO_DETAIL_IMPL_BINARY_HANDLER_TRACKING_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "asio/detail/binary_handler_tracking.hpp"
+#include "asio/detail/chrono.hpp"
+#include "asio/detail/static_mutex.hpp"
+#include "asio/detail/tss_ptr.hpp"
+#include "asio/error.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+// The number of events held by each thread's buffer. Must be a power of two.
+#if defined(ASIO_BINARY_HANDLER_TRACKING_EVENTS)
+enum { binary_handler_tracking_events = ASIO_BINARY_HANDLER_TRACKING_EVENTS };
+#else // defined(ASIO_BINARY_HANDLER_TRACKING_EVENTS)
+enum { binary_handler_tracking_events = 16384 };
+#endif // defined(ASIO_BINARY_HANDLER_TRACKING_EVENTS)
+
+// The first bytes of a dump file, followed by the format version.
+static const char binary_handler_tracking_magic[8] =
+  { 'A', 'S', 'I', 'O', 'H', 'T', 'R', 'K' };
+enum { binary_handler_tracking_version = 1 };
+
+struct binary_handler_tracking::thread_state
+{
+  // The number of events written by the thread. The event with sequence
+  // number n is held in events_[n % binary_handler_tracking_events].
+  std::atomic<uint64_t> head_;
+
+  // The thread's number, in order of first use.
+  uint64_t index_;
+
+  // The thread's buffer.
+  event* events_;
+
+  // The handler tracking state of the thread.
+  completion* current_completion_;
+  location* current_location_;
+
+  // The next thread in the list of all threads.
+  thread_state* next_;
+};
+
+struct binary_handler_tracking::tracking_state
+{
+  static_mutex mutex_;
+  std::atomic<bool> enabled_;
+  std::atomic<uint64_t> next_id_;
+  tss_ptr<thread_state>* current_thread_;
+
+  // The list of all threads that have recorded events, protected by the
+  // mutex. Threads are never removed, so that their events can be dumped
+  // after they have exited.
+  thread_state* threads_;
+  uint64_t next_thread_index_;
+};
+
+binary_handler_tracking::tracking_state* binary_handler_tracking::get_state()
+{
+  static tracking_state state =
+    { ASIO_STATIC_MUTEX_INIT, { true }, { 1 }, 0, 0, 0 };
+  return &state;
+}
+
+binary_handler_tracking::thread_state*
+binary_handler_tracking::get_thread_state()
+{
+  static tracking_state* state = get_state();
+
+  thread_state* t = *state->current_thread_;
+  if (t == 0)
+  {
+    t = new thread_state;
+    t->head_.store(0, std::memory_order_relaxed);
+    t->events_ = new event[binary_handler_tracking_events];
+    t->current_completion_ = 0;
+    t->current_location_ = 0;
+
+    static_mutex::scoped_lock lock(state->mutex_);
+    t->index_ = state->next_thread_index_++;
+    t->next_ = state->threads_;
+    state->threads_ = t;
+    lock.unlock();
+
+    *state->current_thread_ = t;
+  }
+
+  return t;
+}
+
+void binary_handler_tracking::init()
+{
+  static tracking_state* state = get_state();
+
+  state->mutex_.init();
+
+  static_mutex::scoped_lock lock(state->mutex_);
+  if (state->current_thread_ == 0)
+    state->current_thread_ = new tss_ptr<thread_state>;
+}
+
+void binary_handler_tracking::enable(bool on)
+{
+  get_state()->enabled_.store(on, std::memory_order_relaxed);
+}
+
+bool binary_handler_tracking::enabled()
+{
+  return get_state()->enabled_.load(std::memory_order_relaxed);
+}
+
+void binary_handler_tracking::record(thread_state* t, event_kind kind,
+    unsigned flags, uint64_t id, uint64_t parent_id, uint64_t value,
+    const char* string1, const char* string2, int error_value)
+{
+  // Only this thread writes to the buffer, so the sequence number may be read
+  // without synchronisation. The release store publishes the event to dump().
+  uint64_t n = t->head_.load(std::memory_order_relaxed);
+  event& e = t->events_[n & (binary_handler_tracking_events - 1)];
+
+  e.timestamp = static_cast<uint64_t>(
+      chrono::duration_cast<chrono::microseconds>(
+        chrono::system_clock::now().time_since_epoch()).count());
+  e.id = id;
+  e.parent_id = parent_id;
+  e.value = value;
+  e.string1 = reinterpret_cast<std::uintptr_t>(string1);
+  e.string2 = reinterpret_cast<std::uintptr_t>(string2);
+  e.error_value = error_value;
+  e.kind = static_cast<uint8_t>(kind);
+  e.flags = static_cast<uint8_t>(flags);
+  e.reserved = 0;
+
+  t->head_.store(n + 1, std::memory_order_release);
+}
+
+binary_handler_tracking::location::location(
+    const char* file, int line, const char* func)
+  : file_(file),
+    line_(line),
+    func_(func),
+    next_(0)
+{
+  if (file_)
+  {
+    thread_state* t = get_thread_state();
+    next_ = t->current_location_;
+    t->current_location_ = this;
+  }
+}
+
+binary_handler_tracking::location::~location()
+{
+  if (file_)
+    get_thread_state()->current_location_ = next_;
+}
+
+void binary_handler_tracking::creation(execution_context&,
+    binary_handler_tracking::tracked_handler& h,
+    const char* object_type, void* object,
+    uintmax_t /*native_handle*/, const char* op_name)
+{
+  static tracking_state* state = get_state();
+
+  if (!state->enabled_.load(std::memory_order_relaxed))
+    return;
+
+  h.id_ = state->next_id_.fetch_add(1, std::memory_order_relaxed);
+
+  thread_state* t = get_thread_state();
+
+  uint64_t current_id = 0;
+  if (completion* current_completion = t->current_completion_)
+    current_id = current_completion->id_;
+
+  for (location* current_location = t->current_location_;
+      current_location; current_location = current_location->next_)
+  {
+    record(t, location_event,
+        current_location == t->current_location_ ? innermost_location : 0,
+        h.id_, current_id, static_cast<uint64_t>(current_location->line_),
+        current_location->file_, current_location->func_, 0);
+  }
+
+  record(t, creation_event, 0, h.id_, current_id,
+      reinterpret_cast<std::uintptr_t>(object), object_type, op_name, 0);
+}
+
+binary_handler_tracking::completion::completion(
+    const binary_handler_tracking::tracked_handler& h)
+  : id_(h.id_),
+    invoked_(false),
+    next_(0)
+{
+  thread_state* t = get_thread_state();
+  next_ = t->current_completion_;
+  t->current_completion_ = this;
+}
+
+binary_handler_tracking::completion::~completion()
+{
+  thread_state* t = get_thread_state();
+
+  if (id_ && enabled())
+  {
+    record(t, invoked_ ? destroyed_event : abandoned_event,
+        0, id_, 0, 0, 0, 0, 0);
+  }
+
+  t->current_completion_ = next_;
+}
+
+void binary_handler_tracking::completion::invocation_begin()
+{
+  if (id_ && enabled())
+  {
+    record(get_thread_state(), invocation_begin_event,
+        0, id_, 0, 0, 0, 0, 0);
+  }
+
+  invoked_ = true;
+}
+
+void binary_handler_tracking::completion::invocation_begin(
+    const asio::error_code& ec)
+{
+  if (id_ && enabled())
+  {
+    record(get_thread_state(), invocation_begin_event,
+        has_error_code, id_, 0, 0, ec.category().name(), 0, ec.value());
+  }
+
+  invoked_ = true;
+}
+
+void binary_handler_tracking::completion::invocation_begin(
+    const asio::error_code& ec, std::size_t bytes_transferred)
+{
+  if (id_ && enabled())
+  {
+    record(get_thread_state(), invocation_begin_event,
+        has_error_code | has_bytes_transferred, id_, 0,
+        static_cast<uint64_t>(bytes_transferred),
+        ec.category().name(), 0, ec.value());
+  }
+
+  invoked_ = true;
+}
+
+void binary_handler_tracking::completion::invocation_begin(
+    const asio::error_code& ec, int signal_number)
+{
+  if (id_ && enabled())
+  {
+    record(get_thread_state(), invocation_begin_event,
+        has_error_code | has_signal_number, id_, 0,
+        static_cast<uint64_t>(signal_number),
+        ec.category().name(), 0, ec.value());
+  }
+
+  invoked_ = true;
+}
+
+void binary_handler_tracking::completion::invocation_begin(
+    const asio::error_code& ec, const char* /*arg*/)
+{
+  if (id_ && enabled())
+  {
+    record(get_thread_state(), invocation_begin_event,
+        has_error_code | has_argument, id_, 0, 0,
+        ec.category().name(), 0, ec.value());
+  }
+
+  invoked_ = true;
+}
+
+void binary_handler_tracking::completion::invocation_end()
+{
+  if (id_)
+  {
+    if (enabled())
+    {
+      record(get_thread_state(), invocation_end_event,
+          0, id_, 0, 0, 0, 0, 0);
+    }
+
+    id_ = 0;
+  }
+}
+
+void binary_handler_tracking::operation(execution_context&,
+    const char* object_type, void* object,
+    uintmax_t /*native_handle*/, const char* op_name)
+{
+  if (!enabled())
+    return;
+
+  thread_state* t = get_thread_state();
+
+  uint64_t current_id = 0;
+  if (completion* current_completion = t->current_completion_)
+    current_id = current_completion->id_;
+
+  record(t, operation_event, 0, 0, current_id,
+      reinterpret_cast<std::uintptr_t>(object), object_type, op_name, 0);
+}
+
+void binary_handler_tracking::reactor_registration(
+    execution_context& /*context*/, uintmax_t /*native_handle*/,
+    uintmax_t /*registration*/)
+{
+}
+
+void binary_handler_tracking::reactor_deregistration(
+    execution_context& /*context*/, uintmax_t /*native_handle*/,
+    uintmax_t /*registration*/)
+{
+}
+
+void binary_handler_tracking::reactor_events(execution_context& /*context*/,
+    uintmax_t /*native_handle*/, unsigned /*events*/)
+{
+}
+
+void binary_handler_tracking::reactor_operation(
+    const tracked_handler& h, const char* op_name,
+    const asio::error_code& ec)
+{
+  if (h.id_ && enabled())
+  {
+    record(get_thread_state(), reactor_operation_event, has_error_code,
+        h.id_, 0, 0, ec.category().name(), op_name, ec.value());
+  }
+}
+
+void binary_handler_tracking::reactor_operation(
+    const tracked_handler& h, const char* op_name,
+    const asio::error_code& ec, std::size_t bytes_transferred)
+{
+  if (h.id_ && enabled())
+  {
+    record(get_thread_state(), reactor_operation_event,
+        has_error_code | has_bytes_transferred, h.id_, 0,
+        static_cast<uint64_t>(bytes_transferred),
+        ec.category().name(), op_name, ec.value());
+  }
+}
+
+struct binary_handler_tracking::thread_dump
+{
+  uint64_t index;
+  uint64_t dropped;
+  std::vector<event> events;
+};
+
+void binary_handler_tracking::dump(
+    const char* filename, asio::error_code& ec)
+{
+  static tracking_state* state = get_state();
+
+  static_mutex::scoped_lock lock(state->mutex_);
+  thread_state* threads = state->threads_;
+  lock.unlock();
+
+  // Copy each thread's buffer while the thread continues to record events.
+  // Events that may have been overwritten during the copy are discarded.
+  const uint64_t capacity = binary_handler_tracking_events;
+  std::vector<thread_dump> dumps;
+  std::vector<uint64_t> strings;
+  for (thread_state* t = threads; t; t = t->next_)
+  {
+    uint64_t end = t->head_.load(std::memory_order_acquire);
+    uint64_t begin = end > capacity ? end - capacity : 0;
+
+    thread_dump d;
+    d.index = t->index_;
+    d.events.resize(static_cast<std::size_t>(end - begin));
+    for (uint64_t n = begin; n != end; ++n)
+      d.events[static_cast<std::size_t>(n - begin)]
+        = t->events_[n & (capacity - 1)];
+
+    // The fence orders the copy before the second read of the sequence
+    // number, so that any event overwritten during the copy is detected.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t head = t->head_.load(std::memory_order_relaxed);
+    uint64_t first_valid = head >= capacity ? head - capacity + 1 : 0;
+    if (first_valid > begin)
+    {
+      std::size_t overwritten = static_cast<std::size_t>(
+          (std::min)(first_valid, end) - begin);
+      d.events.erase(d.events.begin(), d.events.begin() + overwritten);
+      begin += overwritten;
+    }
+    d.dropped = begin;
+
+    for (std::size_t i = 0; i < d.events.size(); ++i)
+    {
+      if (d.events[i].string1)
+        strings.push_back(d.events[i].string1);
+      if (d.events[i].string2)
+        strings.push_back(d.events[i].string2);
+    }
+
+    dumps.push_back(d);
+  }
+
+  std::sort(strings.begin(), strings.end());
+  strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+
+  std::FILE* file = std::fopen(filename, "wb");
+  if (!file)
+  {
+    ec = asio::error_code(errno,
+        asio::error::get_system_category());
+    return;
+  }
+
+  uint32_t header[6] = { binary_handler_tracking_version, 0x01020304,
+    static_cast<uint32_t>(sizeof(event)),
+    static_cast<uint32_t>(strings.size()),
+    static_cast<uint32_t>(dumps.size()), 0 };
+  bool ok = std::fwrite(binary_handler_tracking_magic,
+      sizeof(binary_handler_tracking_magic), 1, file) == 1;
+  ok = ok && std::fwrite(header, sizeof(header), 1, file) == 1;
+
+  for (std::size_t i = 0; ok && i < strings.size(); ++i)
+  {
+    const char* s = reinterpret_cast<const char*>(
+        static_cast<std::uintptr_t>(strings[i]));
+    uint32_t length = static_cast<uint32_t>(std::strlen(s));
+    uint32_t reserved = 0;
+    ok = std::fwrite(&strings[i], sizeof(uint64_t), 1, file) == 1
+      && std::fwrite(&length, sizeof(length), 1, file) == 1
+      && std::fwrite(&reserved, sizeof(reserved), 1, file) == 1
+      && std::fwrite(s, 1, length, file) == length;
+  }
+
+  for (std::size_t i = 0; ok && i < dumps.size(); ++i)
+  {
+    uint64_t count = dumps[i].events.size();
+    ok = std::fwrite(&dumps[i].index, sizeof(uint64_t), 1, file) == 1
+      && std::fwrite(&dumps[i].dropped, sizeof(uint64_t), 1, file) == 1
+      && std::fwrite(&count, sizeof(uint64_t), 1, file) == 1
+      && (count == 0 || std::fwrite(&dumps[i].events[0],
+            sizeof(event), dumps[i].events.size(), file)
+          == dumps[i].events.size());
+  }
+
+  if (std::fclose(file) != 0)
+    ok = false;
+
+  if (ok)
+    ec = asio::error_code();
+  else
+    ec = asio::error_code(errno, asio::error::get_system_category());
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+
+#endif // ASIO_DETAIL_IMPL_BINARY_HANDLER_TRACKING_IPP
@@ -169,7 +169,7 @@ void dev_poll_reactor::start_op(int op_type, socket_type descriptor,
         if (op->perform())
         {
           lock.unlock();
-          scheduler_.post_immediate_completion(op, is_continuation);
+          scheduler_.post_speculative_completion(op, is_continuation);
           return;
         }
       }
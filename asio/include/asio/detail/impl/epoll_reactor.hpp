@@ -57,6 +57,8 @@ void epoll_reactor::schedule_timer(timer_queue<Time_Traits>& queue,
 
   bool earliest = queue.enqueue_timer(time, timer, op);
   scheduler_.work_started();
+  if (scheduler_metrics* metrics = scheduler_.metrics())
+    metrics->timer_scheduled();
   if (earliest)
     update_timeout();
 }
@@ -70,6 +72,8 @@ std::size_t epoll_reactor::cancel_timer(timer_queue<Time_Traits>& queue,
   op_queue<operation> ops;
   std::size_t n = queue.cancel_timer(timer, ops, max_cancelled);
   lock.unlock();
+  if (scheduler_metrics* metrics = scheduler_.metrics())
+    metrics->timers_finished(n);
   scheduler_.post_deferred_completions(ops);
   return n;
 }
@@ -83,6 +87,8 @@ void epoll_reactor::cancel_timer_by_key(timer_queue<Time_Traits>& queue,
   op_queue<operation> ops;
   queue.cancel_timer_by_key(timer, ops, cancellation_key);
   lock.unlock();
+  if (scheduler_metrics* metrics = scheduler_.metrics())
+    metrics->timers_finished(ops);
   scheduler_.post_deferred_completions(ops);
 }
 
@@ -96,6 +102,8 @@ void epoll_reactor::move_timer(timer_queue<Time_Traits>& queue,
   queue.cancel_timer(target, ops);
   queue.move_timer(target, source);
   lock.unlock();
+  if (scheduler_metrics* metrics = scheduler_.metrics())
+    metrics->timers_finished(ops);
   scheduler_.post_deferred_completions(ops);
 }
 
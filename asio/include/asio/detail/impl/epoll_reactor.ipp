@@ -20,6 +20,7 @@
 #if defined(ASIO_HAS_EPOLL)
 
 #include <cstddef>
+#include <time.h>
 #include <sys/epoll.h>
 #include "asio/detail/epoll_reactor.hpp"
 #include "asio/detail/scheduler.hpp"
@@ -43,6 +44,10 @@ epoll_reactor::epoll_reactor(asio::execution_context& ctx)
     interrupter_(),
     epoll_fd_(do_epoll_create()),
     timer_fd_(do_timerfd_create()),
+    events_(scheduler_.task_event_batch_size() != 0
+        ? scheduler_.task_event_batch_size() : 128),
+    busy_poll_usec_(scheduler_.task_busy_poll_usec()),
+    busy_poll_budget_usec_(busy_poll_usec_),
     shutdown_(false),
     registered_descriptors_mutex_(mutex_.enabled())
 {
@@ -165,6 +170,10 @@ int epoll_reactor::register_descriptor(socket_type descriptor,
     descriptor_data->shutdown_ = false;
     for (int i = 0; i < max_ops; ++i)
       descriptor_data->try_speculative_[i] = true;
+#if defined(ASIO_HAS_MSG_ZEROCOPY)
+    descriptor_data->zero_copy_.sent = 0;
+    descriptor_data->zero_copy_.completed = 0;
+#endif // defined(ASIO_HAS_MSG_ZEROCOPY)
   }
 
   epoll_event ev = { 0, { 0 } };
@@ -262,7 +271,7 @@ void epoll_reactor::start_op(int op_type, socket_type descriptor,
             if (descriptor_data->registered_events_ != 0)
               descriptor_data->try_speculative_[op_type] = false;
           descriptor_lock.unlock();
-          scheduler_.post_immediate_completion(op, is_continuation);
+          scheduler_.post_speculative_completion(op, is_continuation);
           return;
         }
       }
@@ -495,9 +504,22 @@ void epoll_reactor::run(long usec, op_queue<operation>& ops)
     }
   }
 
+  // Spin for a while before blocking, if busy polling has been enabled. This
+  // avoids the cost of sleeping and waking when events arrive soon.
+  int num_events = 0;
+  if (timeout != 0 && busy_poll_usec_ > 0)
+    num_events = busy_poll(timeout);
+
   // Block on the epoll descriptor.
-  epoll_event events[128];
-  int num_events = epoll_wait(epoll_fd_, events, 128, timeout);
+  epoll_event* events = &events_[0];
+  if (num_events <= 0)
+  {
+    num_events = epoll_wait(epoll_fd_, events,
+        static_cast<int>(events_.size()), timeout);
+  }
+
+  if (scheduler_metrics* metrics = scheduler_.metrics())
+    metrics->reactor_wait(num_events);
 
 #if defined(ASIO_ENABLE_HANDLER_TRACKING)
   // Trace the waiting events.
@@ -580,7 +602,15 @@ void epoll_reactor::run(long usec, op_queue<operation>& ops)
   if (check_timers)
   {
     mutex::scoped_lock common_lock(mutex_);
-    timer_queues_.get_ready_timers(ops);
+    if (scheduler_metrics* metrics = scheduler_.metrics())
+    {
+      op_queue<operation> timer_ops;
+      timer_queues_.get_ready_timers(timer_ops);
+      metrics->timers_finished(timer_ops);
+      ops.push(timer_ops);
+    }
+    else
+      timer_queues_.get_ready_timers(ops);
 
 #if defined(ASIO_HAS_TIMERFD)
     if (timer_fd_ != -1)
@@ -653,6 +683,8 @@ int epoll_reactor::do_timerfd_create()
 
 epoll_reactor::descriptor_state* epoll_reactor::allocate_descriptor_state()
 {
+  if (scheduler_metrics* metrics = scheduler_.metrics())
+    metrics->descriptor_registered();
   mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
   return registered_descriptors_.alloc(ASIO_CONCURRENCY_HINT_IS_LOCKING(
         REACTOR_IO, scheduler_.concurrency_hint()));
@@ -660,6 +692,8 @@ epoll_reactor::descriptor_state* epoll_reactor::allocate_descriptor_state()
 
 void epoll_reactor::free_descriptor_state(epoll_reactor::descriptor_state* s)
 {
+  if (scheduler_metrics* metrics = scheduler_.metrics())
+    metrics->descriptor_deregistered();
   mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
   registered_descriptors_.free(s);
 }
@@ -691,6 +725,54 @@ void epoll_reactor::update_timeout()
   interrupt();
 }
 
+int epoll_reactor::busy_poll(int& msec)
+{
+  long budget_usec = busy_poll_budget_usec_;
+  if (msec > 0 && budget_usec > msec * 1000L)
+    budget_usec = msec * 1000L;
+
+  timespec start;
+  ::clock_gettime(CLOCK_MONOTONIC, &start);
+
+  int num_events = 0;
+  long elapsed_usec = 0;
+  do
+  {
+    num_events = epoll_wait(epoll_fd_, &events_[0],
+        static_cast<int>(events_.size()), 0);
+    if (num_events != 0)
+      break;
+
+    timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    elapsed_usec = (now.tv_sec - start.tv_sec) * 1000000L
+      + (now.tv_nsec - start.tv_nsec) / 1000;
+  } while (elapsed_usec < budget_usec);
+
+  if (num_events > 0)
+  {
+    busy_poll_budget_usec_ = busy_poll_usec_;
+  }
+  else if (num_events == 0)
+  {
+    // The thread is mostly idle, so spin for less time on the next call.
+    long min_budget_usec = busy_poll_usec_ / 16;
+    if (min_budget_usec < 1)
+      min_budget_usec = 1;
+    busy_poll_budget_usec_ /= 2;
+    if (busy_poll_budget_usec_ < min_budget_usec)
+      busy_poll_budget_usec_ = min_budget_usec;
+
+    if (msec > 0)
+    {
+      long elapsed_msec = elapsed_usec / 1000;
+      msec = (elapsed_msec < msec) ? static_cast<int>(msec - elapsed_msec) : 0;
+    }
+  }
+
+  return num_events;
+}
+
 int epoll_reactor::get_timeout(int msec)
 {
   // By default we will wait no longer than 5 minutes. This will ensure that
@@ -0,0 +1,1085 @@
+//
+// detail/impl/io_uring_reactor.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_IO_URING_REACTOR_IPP
+#define ASIO_DETAIL_IMPL_IO_URING_REACTOR_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_IO_URING)
+
+#include <cstddef>
+#include <cstring>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include "asio/detail/io_uring_reactor.hpp"
+#include "asio/detail/scheduler.hpp"
+#include "asio/detail/throw_error.hpp"
+#include "asio/error.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+io_uring_reactor::io_uring_reactor(asio::execution_context& ctx)
+  : execution_context_service_base<io_uring_reactor>(ctx),
+    scheduler_(use_service<scheduler>(ctx)),
+    mutex_(ASIO_CONCURRENCY_HINT_IS_LOCKING(
+          REACTOR_REGISTRATION, scheduler_.concurrency_hint())),
+    interrupter_(),
+    ring_fd_(-1),
+    sq_ring_(0),
+    sq_ring_size_(0),
+    cq_ring_(0),
+    cq_ring_size_(0),
+    sqes_(0),
+    pending_sqes_(0),
+    waiting_(false),
+    direct_requests_in_ring_(0),
+    shutdown_(false),
+    registered_descriptors_mutex_(mutex_.enabled())
+{
+  do_ring_create();
+
+  // Arm the interrupter's descriptor.
+  mutex::scoped_lock lock(mutex_);
+  start_interrupter_poll();
+}
+
+io_uring_reactor::~io_uring_reactor()
+{
+  do_ring_destroy();
+}
+
+void io_uring_reactor::shutdown()
+{
+  mutex::scoped_lock lock(mutex_);
+  shutdown_ = true;
+  lock.unlock();
+
+  // The kernel may still be reading from or writing to the buffers owned by
+  // direct requests, so wait until it has let go of them.
+  drain_direct_requests();
+
+  op_queue<operation> ops;
+
+  while (descriptor_state* state = registered_descriptors_.first())
+  {
+    for (int i = 0; i < max_ops; ++i)
+      ops.push(state->op_queue_[i]);
+    state->shutdown_ = true;
+    registered_descriptors_.free(state);
+  }
+
+  timer_queues_.get_all_timers(ops);
+
+  scheduler_.abandon_operations(ops);
+}
+
+void io_uring_reactor::notify_fork(
+    asio::execution_context::fork_event fork_ev)
+{
+  if (fork_ev == asio::execution_context::fork_child)
+  {
+    // The ring's memory is shared with the parent, so the child must discard
+    // its mapping and start again with a ring of its own.
+    do_ring_destroy();
+    do_ring_create();
+
+    interrupter_.recreate();
+
+    mutex::scoped_lock lock(mutex_);
+    pending_sqes_ = 0;
+    waiting_ = false;
+    direct_requests_in_ring_ = 0;
+    start_interrupter_poll();
+    lock.unlock();
+
+    // Resubmit requests for all queued operations.
+    mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
+    for (descriptor_state* state = registered_descriptors_.first();
+        state != 0; state = state->next_)
+    {
+      mutex::scoped_lock descriptor_lock(state->mutex_);
+      state->requests_in_ring_ = 0;
+      for (int i = 0; i < max_ops; ++i)
+      {
+        state->request_[i] = descriptor_state::no_request;
+        if (!state->shutdown_ && !state->op_queue_[i].empty())
+          start_request(state, i);
+      }
+    }
+  }
+}
+
+void io_uring_reactor::init_task()
+{
+  scheduler_.init_task();
+}
+
+int io_uring_reactor::register_descriptor(socket_type descriptor,
+    io_uring_reactor::per_descriptor_data& descriptor_data)
+{
+  descriptor_data = allocate_descriptor_state();
+
+  ASIO_HANDLER_REACTOR_REGISTRATION((
+        context(), static_cast<uintmax_t>(descriptor),
+        reinterpret_cast<uintmax_t>(descriptor_data)));
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  descriptor_data->reactor_ = this;
+  descriptor_data->descriptor_ = descriptor;
+  descriptor_data->requests_in_ring_ = 0;
+  descriptor_data->shutdown_ = false;
+  descriptor_data->cleanup_pending_ = false;
+  for (int i = 0; i < max_ops; ++i)
+  {
+    descriptor_data->try_speculative_[i] = true;
+    descriptor_data->request_[i] = descriptor_state::no_request;
+    descriptor_data->direct_eof_on_zero_[i] = false;
+  }
+
+  struct stat st;
+  if (::fstat(descriptor, &st) != 0)
+    return errno;
+
+  // Regular files and directories are always reported as ready. As with the
+  // epoll_reactor, we will allow this descriptor to be used and fail later if
+  // an operation on it would otherwise require a trip through the reactor.
+  descriptor_data->pollable_ = !S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode);
+
+  return 0;
+}
+
+int io_uring_reactor::register_internal_descriptor(
+    int op_type, socket_type descriptor,
+    io_uring_reactor::per_descriptor_data& descriptor_data, reactor_op* op)
+{
+  descriptor_data = allocate_descriptor_state();
+
+  ASIO_HANDLER_REACTOR_REGISTRATION((
+        context(), static_cast<uintmax_t>(descriptor),
+        reinterpret_cast<uintmax_t>(descriptor_data)));
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  descriptor_data->reactor_ = this;
+  descriptor_data->descriptor_ = descriptor;
+  descriptor_data->pollable_ = true;
+  descriptor_data->requests_in_ring_ = 0;
+  descriptor_data->shutdown_ = false;
+  descriptor_data->cleanup_pending_ = false;
+  for (int i = 0; i < max_ops; ++i)
+  {
+    descriptor_data->try_speculative_[i] = true;
+    descriptor_data->request_[i] = descriptor_state::no_request;
+    descriptor_data->direct_eof_on_zero_[i] = false;
+  }
+  descriptor_data->op_queue_[op_type].push(op);
+  start_request(descriptor_data, op_type);
+
+  return 0;
+}
+
+void io_uring_reactor::move_descriptor(socket_type,
+    io_uring_reactor::per_descriptor_data& target_descriptor_data,
+    io_uring_reactor::per_descriptor_data& source_descriptor_data)
+{
+  target_descriptor_data = source_descriptor_data;
+  source_descriptor_data = 0;
+}
+
+void io_uring_reactor::start_op(int op_type, socket_type,
+    io_uring_reactor::per_descriptor_data& descriptor_data, reactor_op* op,
+    bool is_continuation, bool allow_speculative)
+{
+  if (!descriptor_data)
+  {
+    op->ec_ = asio::error::bad_descriptor;
+    post_immediate_completion(op, is_continuation);
+    return;
+  }
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  if (descriptor_data->shutdown_)
+  {
+    post_immediate_completion(op, is_continuation);
+    return;
+  }
+
+  if (descriptor_data->op_queue_[op_type].empty())
+  {
+    if (allow_speculative
+        && (op_type != read_op
+          || descriptor_data->op_queue_[except_op].empty()))
+    {
+      if (descriptor_data->try_speculative_[op_type])
+      {
+        if (reactor_op::status status = op->perform())
+        {
+          if (status == reactor_op::done_and_exhausted)
+            if (descriptor_data->pollable_)
+              descriptor_data->try_speculative_[op_type] = false;
+          descriptor_lock.unlock();
+          scheduler_.post_speculative_completion(op, is_continuation);
+          return;
+        }
+
+        // The descriptor is not ready. Subsequent operations will go straight
+        // to the ring until the descriptor is next reported as ready.
+        if (descriptor_data->pollable_)
+          descriptor_data->try_speculative_[op_type] = false;
+      }
+    }
+
+    if (!descriptor_data->pollable_)
+    {
+      op->ec_ = asio::error::operation_not_supported;
+      scheduler_.post_immediate_completion(op, is_continuation);
+      return;
+    }
+
+    descriptor_data->op_queue_[op_type].push(op);
+    scheduler_.work_started();
+
+    // A poll request may have been left in the ring by a cancellation. If so,
+    // it will report the descriptor's readiness for the new operation.
+    if (descriptor_data->request_[op_type] == descriptor_state::no_request)
+      start_request(descriptor_data, op_type);
+    return;
+  }
+
+  descriptor_data->op_queue_[op_type].push(op);
+  scheduler_.work_started();
+}
+
+void io_uring_reactor::cancel_ops(socket_type,
+    io_uring_reactor::per_descriptor_data& descriptor_data)
+{
+  if (!descriptor_data)
+    return;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  op_queue<operation> ops;
+  for (int i = 0; i < max_ops; ++i)
+  {
+    // An operation that has been submitted directly is owned by the kernel
+    // until its completion is reaped, so it can only be cancelled there.
+    op_queue<reactor_op> direct_ops;
+    if (descriptor_data->request_[i] == descriptor_state::direct_request)
+    {
+      direct_ops.push(descriptor_data->op_queue_[i].front());
+      descriptor_data->op_queue_[i].pop();
+      cancel_request(descriptor_data, i);
+    }
+
+    while (reactor_op* op = descriptor_data->op_queue_[i].front())
+    {
+      op->ec_ = asio::error::operation_aborted;
+      descriptor_data->op_queue_[i].pop();
+      ops.push(op);
+    }
+
+    descriptor_data->op_queue_[i].push(direct_ops);
+  }
+
+  descriptor_lock.unlock();
+
+  scheduler_.post_deferred_completions(ops);
+}
+
+void io_uring_reactor::cancel_ops_by_key(socket_type,
+    io_uring_reactor::per_descriptor_data& descriptor_data,
+    int op_type, void* cancellation_key)
+{
+  if (!descriptor_data)
+    return;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  op_queue<operation> ops;
+  op_queue<reactor_op> other_ops;
+  if (descriptor_data->request_[op_type] == descriptor_state::direct_request)
+  {
+    reactor_op* op = descriptor_data->op_queue_[op_type].front();
+    descriptor_data->op_queue_[op_type].pop();
+    if (op->cancellation_key_ == cancellation_key)
+      cancel_request(descriptor_data, op_type);
+    other_ops.push(op);
+  }
+
+  while (reactor_op* op = descriptor_data->op_queue_[op_type].front())
+  {
+    descriptor_data->op_queue_[op_type].pop();
+    if (op->cancellation_key_ == cancellation_key)
+    {
+      op->ec_ = asio::error::operation_aborted;
+      ops.push(op);
+    }
+    else
+      other_ops.push(op);
+  }
+  descriptor_data->op_queue_[op_type].push(other_ops);
+
+  descriptor_lock.unlock();
+
+  scheduler_.post_deferred_completions(ops);
+}
+
+void io_uring_reactor::deregister_descriptor(socket_type descriptor,
+    io_uring_reactor::per_descriptor_data& descriptor_data, bool)
+{
+  if (!descriptor_data)
+    return;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  if (!descriptor_data->shutdown_)
+  {
+    // Unlike epoll, the ring holds a reference to the descriptor's file while
+    // a request is outstanding, so requests must be cancelled even when the
+    // descriptor is about to be closed.
+    op_queue<operation> ops;
+    for (int i = 0; i < max_ops; ++i)
+    {
+      op_queue<reactor_op> direct_ops;
+      if (descriptor_data->request_[i] == descriptor_state::direct_request)
+      {
+        direct_ops.push(descriptor_data->op_queue_[i].front());
+        descriptor_data->op_queue_[i].pop();
+      }
+
+      if (descriptor_data->request_[i] != descriptor_state::no_request)
+        cancel_request(descriptor_data, i);
+
+      while (reactor_op* op = descriptor_data->op_queue_[i].front())
+      {
+        op->ec_ = asio::error::operation_aborted;
+        descriptor_data->op_queue_[i].pop();
+        ops.push(op);
+      }
+
+      descriptor_data->op_queue_[i].push(direct_ops);
+    }
+
+    descriptor_data->descriptor_ = -1;
+    descriptor_data->shutdown_ = true;
+
+    descriptor_lock.unlock();
+
+    ASIO_HANDLER_REACTOR_DEREGISTRATION((
+          context(), static_cast<uintmax_t>(descriptor),
+          reinterpret_cast<uintmax_t>(descriptor_data)));
+    (void)descriptor;
+
+    scheduler_.post_deferred_completions(ops);
+
+    // Leave descriptor_data set so that it will be freed by the subsequent
+    // call to cleanup_descriptor_data.
+  }
+  else
+  {
+    // We are shutting down, so prevent cleanup_descriptor_data from freeing
+    // the descriptor_data object and let the destructor free it instead.
+    descriptor_data = 0;
+  }
+}
+
+void io_uring_reactor::deregister_internal_descriptor(socket_type descriptor,
+    io_uring_reactor::per_descriptor_data& descriptor_data)
+{
+  if (!descriptor_data)
+    return;
+
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  if (!descriptor_data->shutdown_)
+  {
+    op_queue<operation> ops;
+    for (int i = 0; i < max_ops; ++i)
+    {
+      if (descriptor_data->request_[i] != descriptor_state::no_request)
+        cancel_request(descriptor_data, i);
+      ops.push(descriptor_data->op_queue_[i]);
+    }
+
+    descriptor_data->descriptor_ = -1;
+    descriptor_data->shutdown_ = true;
+
+    descriptor_lock.unlock();
+
+    ASIO_HANDLER_REACTOR_DEREGISTRATION((
+          context(), static_cast<uintmax_t>(descriptor),
+          reinterpret_cast<uintmax_t>(descriptor_data)));
+    (void)descriptor;
+
+    // Leave descriptor_data set so that it will be freed by the subsequent
+    // call to cleanup_descriptor_data.
+  }
+  else
+  {
+    // We are shutting down, so prevent cleanup_descriptor_data from freeing
+    // the descriptor_data object and let the destructor free it instead.
+    descriptor_data = 0;
+  }
+}
+
+void io_uring_reactor::cleanup_descriptor_data(
+    per_descriptor_data& descriptor_data)
+{
+  if (descriptor_data)
+  {
+    // The state cannot be reused while the ring still refers to it. If any
+    // requests are outstanding, the state is freed when the last one has been
+    // reaped.
+    mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+    bool in_ring = descriptor_data->requests_in_ring_ > 0;
+    descriptor_data->cleanup_pending_ = in_ring;
+    descriptor_lock.unlock();
+
+    if (!in_ring)
+      free_descriptor_state(descriptor_data);
+    descriptor_data = 0;
+  }
+}
+
+void io_uring_reactor::run(long usec, op_queue<operation>& ops)
+{
+  // This code relies on the fact that the scheduler queues the reactor task
+  // behind all descriptor operations generated by this function. This means,
+  // that by the time we reach this point, any previously returned descriptor
+  // operations have already been dequeued. Therefore it is now safe for us to
+  // reuse and return them for the scheduler to queue again.
+
+  // Calculate timeout. While waiting_ is set, other threads submit their
+  // requests immediately rather than leaving them for the next call to run().
+  long timeout = 0;
+  bool waiting = false;
+  {
+    mutex::scoped_lock lock(mutex_);
+    pending_sqes_ = 0;
+    if (usec != 0)
+    {
+      timeout = get_timeout(usec);
+      waiting = waiting_ = (timeout != 0);
+    }
+  }
+
+  // Submit all pending requests and wait for completions in a single call.
+  unsigned to_submit = __atomic_load_n(sq_tail_, __ATOMIC_ACQUIRE)
+    - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  bool cq_empty = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE) == *cq_head_;
+  bool cq_overflow = (__atomic_load_n(sq_flags_, __ATOMIC_RELAXED)
+      & IORING_SQ_CQ_OVERFLOW) != 0;
+  if (to_submit != 0 || cq_overflow || (waiting && cq_empty))
+    do_enter(to_submit, (waiting && cq_empty) ? 1 : 0, timeout);
+
+  if (waiting)
+  {
+    mutex::scoped_lock lock(mutex_);
+    waiting_ = false;
+  }
+
+  // Dispatch the completed requests.
+  bool rearm_interrupter = false;
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  for (; head != tail; ++head)
+  {
+    ::io_uring_cqe* cqe = &cqes_[head & cq_mask_];
+    uintptr_t user_data = static_cast<uintptr_t>(cqe->user_data);
+    int result = cqe->res;
+
+    if (user_data == 0)
+    {
+      // Ignore the completion of a cancellation request.
+    }
+    else if (user_data == reinterpret_cast<uintptr_t>(&interrupter_))
+    {
+      interrupter_.reset();
+      rearm_interrupter = true;
+    }
+    else
+    {
+      descriptor_state* descriptor_data = reinterpret_cast<descriptor_state*>(
+          user_data & ~static_cast<uintptr_t>(3));
+      int op_type = static_cast<int>(user_data & 3);
+      if (complete_request(descriptor_data, op_type, result, ops))
+        free_descriptor_state(descriptor_data);
+    }
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+  mutex::scoped_lock common_lock(mutex_);
+  if (rearm_interrupter)
+    start_interrupter_poll();
+  timer_queues_.get_ready_timers(ops);
+}
+
+void io_uring_reactor::interrupt()
+{
+  interrupter_.interrupt();
+}
+
+void io_uring_reactor::do_ring_create()
+{
+  std::memset(&params_, 0, sizeof(params_));
+  ring_fd_ = static_cast<int>(::syscall(__NR_io_uring_setup,
+        static_cast<unsigned>(ring_size), &params_));
+  if (ring_fd_ == -1)
+  {
+    asio::error_code ec(errno,
+        asio::error::get_system_category());
+    asio::detail::throw_error(ec, "io_uring");
+  }
+
+  // The timeout argument to io_uring_enter is needed for timed waits.
+  if ((params_.features & IORING_FEAT_EXT_ARG) == 0)
+  {
+    do_ring_destroy();
+    asio::error_code ec(asio::error::operation_not_supported);
+    asio::detail::throw_error(ec, "io_uring");
+  }
+
+  sq_ring_size_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params_.cq_off.cqes
+    + params_.cq_entries * sizeof(::io_uring_cqe);
+  if (params_.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    if (cq_ring_size_ > sq_ring_size_)
+      sq_ring_size_ = cq_ring_size_;
+    cq_ring_size_ = sq_ring_size_;
+  }
+
+  void* sq_ring = ::mmap(0, sq_ring_size_, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  void* cq_ring = sq_ring;
+  if (sq_ring != MAP_FAILED && !(params_.features & IORING_FEAT_SINGLE_MMAP))
+  {
+    cq_ring = ::mmap(0, cq_ring_size_, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+  }
+  void* sqes = MAP_FAILED;
+  if (sq_ring != MAP_FAILED && cq_ring != MAP_FAILED)
+  {
+    sqes = ::mmap(0, params_.sq_entries * sizeof(::io_uring_sqe),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        ring_fd_, IORING_OFF_SQES);
+  }
+
+  sq_ring_ = (sq_ring != MAP_FAILED) ? sq_ring : 0;
+  cq_ring_ = (cq_ring != MAP_FAILED) ? cq_ring : 0;
+  sqes_ = (sqes != MAP_FAILED) ? static_cast<::io_uring_sqe*>(sqes) : 0;
+  if (sqes == MAP_FAILED)
+  {
+    asio::error_code ec(errno,
+        asio::error::get_system_category());
+    do_ring_destroy();
+    asio::detail::throw_error(ec, "io_uring");
+  }
+
+  char* sq = static_cast<char*>(sq_ring_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.tail);
+  sq_flags_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.flags);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.array);
+  sq_mask_ = *reinterpret_cast<unsigned*>(sq + params_.sq_off.ring_mask);
+
+  char* cq = static_cast<char*>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.tail);
+  cqes_ = reinterpret_cast<::io_uring_cqe*>(cq + params_.cq_off.cqes);
+  cq_mask_ = *reinterpret_cast<unsigned*>(cq + params_.cq_off.ring_mask);
+
+  // Entries are always used in ring order, so the indirection array can be
+  // filled in once.
+  for (unsigned i = 0; i < params_.sq_entries; ++i)
+    sq_array_[i] = i;
+}
+
+void io_uring_reactor::do_ring_destroy()
+{
+  if (sqes_)
+    ::munmap(sqes_, params_.sq_entries * sizeof(::io_uring_sqe));
+  if (cq_ring_ && cq_ring_ != sq_ring_)
+    ::munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_)
+    ::munmap(sq_ring_, sq_ring_size_);
+  if (ring_fd_ != -1)
+    ::close(ring_fd_);
+  sqes_ = 0;
+  cq_ring_ = 0;
+  sq_ring_ = 0;
+  ring_fd_ = -1;
+}
+
+::io_uring_sqe* io_uring_reactor::get_sqe()
+{
+  unsigned tail = *sq_tail_;
+  if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= params_.sq_entries)
+  {
+    submit_sqes();
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE)
+        >= params_.sq_entries)
+      return 0;
+  }
+
+  ::io_uring_sqe* sqe = &sqes_[tail & sq_mask_];
+  std::memset(sqe, 0, sizeof(::io_uring_sqe));
+  return sqe;
+}
+
+void io_uring_reactor::commit_sqe()
+{
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  ++pending_sqes_;
+}
+
+void io_uring_reactor::submit_sqes()
+{
+  if (pending_sqes_ != 0)
+  {
+    pending_sqes_ = 0;
+    do_enter(*sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE), 0, 0);
+  }
+}
+
+int io_uring_reactor::do_enter(unsigned to_submit,
+    unsigned min_complete, long usec)
+{
+  unsigned flags = 0;
+  ::io_uring_getevents_arg arg;
+  ::__kernel_timespec ts;
+  void* argp = 0;
+  std::size_t argsz = 0;
+
+  if (min_complete > 0)
+  {
+    flags |= IORING_ENTER_GETEVENTS;
+    if (usec >= 0)
+    {
+      ts.tv_sec = usec / 1000000;
+      ts.tv_nsec = (usec % 1000000) * 1000;
+      std::memset(&arg, 0, sizeof(arg));
+      arg.ts = reinterpret_cast<uintptr_t>(&ts);
+      flags |= IORING_ENTER_EXT_ARG;
+      argp = &arg;
+      argsz = sizeof(arg);
+    }
+  }
+  else if (__atomic_load_n(sq_flags_, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW)
+  {
+    // Flush completions that did not fit in the completion queue.
+    flags |= IORING_ENTER_GETEVENTS;
+  }
+
+  int result;
+  do
+  {
+    result = static_cast<int>(::syscall(__NR_io_uring_enter,
+          ring_fd_, to_submit, min_complete, flags, argp, argsz));
+  } while (result < 0 && errno == EINTR && min_complete == 0);
+
+  return result;
+}
+
+void io_uring_reactor::start_interrupter_poll()
+{
+  if (::io_uring_sqe* sqe = get_sqe())
+  {
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = interrupter_.read_descriptor();
+    sqe->poll32_events = POLLIN;
+#if __BYTE_ORDER == __BIG_ENDIAN
+    sqe->poll32_events = (sqe->poll32_events << 16)
+      | (sqe->poll32_events >> 16);
+#endif // __BYTE_ORDER == __BIG_ENDIAN
+    sqe->user_data = reinterpret_cast<uintptr_t>(&interrupter_);
+    commit_sqe();
+  }
+}
+
+void io_uring_reactor::start_request(
+    io_uring_reactor::descriptor_state* descriptor_data,
+    int op_type, bool allow_direct)
+{
+  // Out-of-band data must be read before normal data, so normal reads are not
+  // submitted directly while exception operations are waiting.
+  reactor_op* op = descriptor_data->op_queue_[op_type].front();
+  reactor_op::direct_request req;
+  bool direct = allow_direct && op_type != except_op
+    && (op_type != read_op || descriptor_data->op_queue_[except_op].empty())
+    && op->prepare_direct(req);
+
+  mutex::scoped_lock lock(mutex_);
+
+  ::io_uring_sqe* sqe = get_sqe();
+  if (!sqe)
+  {
+    lock.unlock();
+
+    op_queue<operation> ops;
+    while (reactor_op* failed_op = descriptor_data->op_queue_[op_type].front())
+    {
+      failed_op->ec_ = asio::error::no_buffer_space;
+      descriptor_data->op_queue_[op_type].pop();
+      ops.push(failed_op);
+    }
+    scheduler_.post_deferred_completions(ops);
+    return;
+  }
+
+  if (direct)
+  {
+    const std::size_t max_size = 0x7ffff000;
+    sqe->opcode = (req.type == reactor_op::direct_recv)
+      ? IORING_OP_RECV : IORING_OP_SEND;
+    sqe->fd = req.descriptor;
+    sqe->addr = reinterpret_cast<uintptr_t>(req.data);
+    sqe->len = static_cast<unsigned>(req.size < max_size ? req.size : max_size);
+    sqe->msg_flags = (req.type == reactor_op::direct_send)
+      ? (req.flags | MSG_NOSIGNAL) : req.flags;
+    descriptor_data->request_[op_type] = descriptor_state::direct_request;
+    descriptor_data->direct_eof_on_zero_[op_type] =
+      req.type == reactor_op::direct_recv && req.is_stream && req.size > 0;
+    ++direct_requests_in_ring_;
+  }
+  else
+  {
+    static const unsigned flag[max_ops] = { POLLIN, POLLOUT, POLLPRI };
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = descriptor_data->descriptor_;
+    sqe->poll32_events = flag[op_type] | POLLERR | POLLHUP;
+#if __BYTE_ORDER == __BIG_ENDIAN
+    sqe->poll32_events = (sqe->poll32_events << 16)
+      | (sqe->poll32_events >> 16);
+#endif // __BYTE_ORDER == __BIG_ENDIAN
+    descriptor_data->request_[op_type] = descriptor_state::poll_request;
+  }
+
+  sqe->user_data = reinterpret_cast<uintptr_t>(descriptor_data) | op_type;
+  commit_sqe();
+  ++descriptor_data->requests_in_ring_;
+
+  // If a thread is blocked waiting for completions, the request will not be
+  // seen by the kernel until it is submitted from here.
+  if (waiting_ || pending_sqes_ >= submit_batch_size)
+    submit_sqes();
+}
+
+void io_uring_reactor::cancel_request(
+    io_uring_reactor::descriptor_state* descriptor_data, int op_type)
+{
+  mutex::scoped_lock lock(mutex_);
+  if (::io_uring_sqe* sqe = get_sqe())
+  {
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<uintptr_t>(descriptor_data) | op_type;
+    sqe->user_data = 0;
+    commit_sqe();
+
+    // Submit immediately so that the kernel releases the descriptor promptly.
+    submit_sqes();
+  }
+}
+
+bool io_uring_reactor::complete_request(
+    io_uring_reactor::descriptor_state* descriptor_data,
+    int op_type, int result, op_queue<operation>& ops)
+{
+  mutex::scoped_lock descriptor_lock(descriptor_data->mutex_);
+
+  descriptor_state::request_type type = descriptor_data->request_[op_type];
+  descriptor_data->request_[op_type] = descriptor_state::no_request;
+  --descriptor_data->requests_in_ring_;
+
+  if (type == descriptor_state::poll_request)
+  {
+    if (result != -ECANCELED && !descriptor_data->shutdown_)
+    {
+      unsigned event_mask = 0;
+      if (op_type == read_op)
+        event_mask |= ASIO_HANDLER_REACTOR_READ_EVENT;
+      else if (op_type == write_op)
+        event_mask |= ASIO_HANDLER_REACTOR_WRITE_EVENT;
+      if (result < 0 || (result & (POLLERR | POLLHUP)) != 0)
+        event_mask |= ASIO_HANDLER_REACTOR_ERROR_EVENT;
+      ASIO_HANDLER_REACTOR_EVENTS((context(),
+            reinterpret_cast<uintmax_t>(descriptor_data), event_mask));
+      (void)event_mask;
+
+      // The descriptor operation doesn't count as work in and of itself, so we
+      // don't call work_started() here. This still allows the scheduler to
+      // stop if the only remaining operations are descriptor operations. The
+      // request is resubmitted, if needed, after the operations are performed.
+      if (!ops.is_enqueued(descriptor_data))
+      {
+        descriptor_data->set_ready_events(1u << op_type);
+        ops.push(descriptor_data);
+      }
+      else
+      {
+        descriptor_data->add_ready_events(1u << op_type);
+      }
+
+      return false;
+    }
+  }
+  else if (type == descriptor_state::direct_request)
+  {
+    --direct_requests_in_ring_;
+
+    if ((result == -EAGAIN || result == -EINTR) && !descriptor_data->shutdown_)
+    {
+      // The kernel declined to wait for the descriptor, so fall back to
+      // waiting for readiness and performing the operation ourselves.
+      start_request(descriptor_data, op_type, false);
+    }
+    else
+    {
+      reactor_op* op = descriptor_data->op_queue_[op_type].front();
+      descriptor_data->op_queue_[op_type].pop();
+
+      // Discard any would_block error left by an earlier attempt to perform
+      // the operation speculatively.
+      op->ec_ = asio::error_code();
+      op->bytes_transferred_ = 0;
+      if (result == -ECANCELED)
+        op->ec_ = asio::error::operation_aborted;
+      else if (result < 0)
+        op->ec_ = asio::error_code(-result,
+            asio::error::get_system_category());
+      else if (result == 0 && descriptor_data->direct_eof_on_zero_[op_type])
+        op->ec_ = asio::error::eof;
+      else
+        op->bytes_transferred_ = static_cast<std::size_t>(result);
+
+      ASIO_HANDLER_REACTOR_OPERATION((*op, "io_uring_direct",
+            op->ec_, op->bytes_transferred_));
+
+      ops.push(op);
+    }
+  }
+
+  if (!descriptor_data->shutdown_
+      && !descriptor_data->op_queue_[op_type].empty()
+      && descriptor_data->request_[op_type] == descriptor_state::no_request)
+  {
+    start_request(descriptor_data, op_type);
+  }
+
+  return descriptor_data->shutdown_ && descriptor_data->cleanup_pending_
+    && descriptor_data->requests_in_ring_ == 0;
+}
+
+void io_uring_reactor::drain_direct_requests()
+{
+  {
+    mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
+    for (descriptor_state* state = registered_descriptors_.first();
+        state != 0; state = state->next_)
+    {
+      mutex::scoped_lock descriptor_lock(state->mutex_);
+      state->shutdown_ = true;
+      for (int i = 0; i < max_ops; ++i)
+        if (state->request_[i] == descriptor_state::direct_request)
+          cancel_request(state, i);
+    }
+  }
+
+  // Reap completions until the kernel has finished with every direct request.
+  // The operations themselves stay on their queues and are abandoned.
+  while (direct_requests_in_ring_ > 0)
+  {
+    if (do_enter(0, 1, -1) < 0 && errno != EINTR)
+      break;
+
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head)
+    {
+      ::io_uring_cqe* cqe = &cqes_[head & cq_mask_];
+      uintptr_t user_data = static_cast<uintptr_t>(cqe->user_data);
+      if (user_data != 0
+          && user_data != reinterpret_cast<uintptr_t>(&interrupter_))
+      {
+        descriptor_state* state = reinterpret_cast<descriptor_state*>(
+            user_data & ~static_cast<uintptr_t>(3));
+        int op_type = static_cast<int>(user_data & 3);
+        mutex::scoped_lock descriptor_lock(state->mutex_);
+        if (state->request_[op_type] == descriptor_state::direct_request)
+          --direct_requests_in_ring_;
+        state->request_[op_type] = descriptor_state::no_request;
+        --state->requests_in_ring_;
+      }
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+}
+
+io_uring_reactor::descriptor_state*
+io_uring_reactor::allocate_descriptor_state()
+{
+  mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
+  return registered_descriptors_.alloc(ASIO_CONCURRENCY_HINT_IS_LOCKING(
+        REACTOR_IO, scheduler_.concurrency_hint()));
+}
+
+void io_uring_reactor::free_descriptor_state(
+    io_uring_reactor::descriptor_state* s)
+{
+  mutex::scoped_lock descriptors_lock(registered_descriptors_mutex_);
+  registered_descriptors_.free(s);
+}
+
+void io_uring_reactor::do_add_timer_queue(timer_queue_base& queue)
+{
+  mutex::scoped_lock lock(mutex_);
+  timer_queues_.insert(&queue);
+}
+
+void io_uring_reactor::do_remove_timer_queue(timer_queue_base& queue)
+{
+  mutex::scoped_lock lock(mutex_);
+  timer_queues_.erase(&queue);
+}
+
+void io_uring_reactor::update_timeout()
+{
+  // A thread that is not blocked will pick up the new timeout the next time
+  // it calls run().
+  if (waiting_)
+    interrupt();
+}
+
+long io_uring_reactor::get_timeout(long usec)
+{
+  // By default we will wait no longer than 5 minutes. This will ensure that
+  // any changes to the system clock are detected after no longer than this.
+  const long max_usec = 5 * 60 * 1000 * 1000;
+  return timer_queues_.wait_duration_usec(
+      (usec < 0 || max_usec < usec) ? max_usec : usec);
+}
+
+struct io_uring_reactor::perform_io_cleanup_on_block_exit
+{
+  explicit perform_io_cleanup_on_block_exit(io_uring_reactor* r)
+    : reactor_(r), first_op_(0)
+  {
+  }
+
+  ~perform_io_cleanup_on_block_exit()
+  {
+    if (first_op_)
+    {
+      // Post the remaining completed operations for invocation.
+      if (!ops_.empty())
+        reactor_->scheduler_.post_deferred_completions(ops_);
+
+      // A user-initiated operation has completed, but there's no need to
+      // explicitly call work_finished() here. Instead, we'll take advantage of
+      // the fact that the scheduler will call work_finished() once we return.
+    }
+    else
+    {
+      // No user-initiated operations have completed, so we need to compensate
+      // for the work_finished() call that the scheduler will make once this
+      // operation returns.
+      reactor_->scheduler_.compensating_work_started();
+    }
+  }
+
+  io_uring_reactor* reactor_;
+  op_queue<operation> ops_;
+  operation* first_op_;
+};
+
+io_uring_reactor::descriptor_state::descriptor_state(bool locking)
+  : operation(&io_uring_reactor::descriptor_state::do_complete),
+    mutex_(locking)
+{
+}
+
+operation* io_uring_reactor::descriptor_state::perform_io(uint32_t events)
+{
+  mutex_.lock();
+  perform_io_cleanup_on_block_exit io_cleanup(reactor_);
+  mutex::scoped_lock descriptor_lock(mutex_, mutex::scoped_lock::adopt_lock);
+
+  // Exception operations must be processed first to ensure that any
+  // out-of-band data is read before normal data.
+  for (int j = max_ops - 1; j >= 0; --j)
+  {
+    if ((events & (1u << j)) && request_[j] != direct_request)
+    {
+      try_speculative_[j] = true;
+      while (reactor_op* op = op_queue_[j].front())
+      {
+        if (reactor_op::status status = op->perform())
+        {
+          op_queue_[j].pop();
+          io_cleanup.ops_.push(op);
+          if (status == reactor_op::done_and_exhausted)
+          {
+            try_speculative_[j] = false;
+            break;
+          }
+        }
+        else
+          break;
+      }
+
+      // Wait again for any operations that could not be completed.
+      if (!shutdown_ && !op_queue_[j].empty() && request_[j] == no_request)
+        reactor_->start_request(this, j);
+    }
+  }
+
+  // The first operation will be returned for completion now. The others will
+  // be posted for later by the io_cleanup object's destructor.
+  io_cleanup.first_op_ = io_cleanup.ops_.front();
+  io_cleanup.ops_.pop();
+  return io_cleanup.first_op_;
+}
+
+void io_uring_reactor::descriptor_state::do_complete(
+    void* owner, operation* base,
+    const asio::error_code& ec, std::size_t bytes_transferred)
+{
+  if (owner)
+  {
+    descriptor_state* descriptor_data = static_cast<descriptor_state*>(base);
+    uint32_t events = static_cast<uint32_t>(bytes_transferred);
+    if (operation* op = descriptor_data->perform_io(events))
+    {
+      op->complete(owner, ec, 0);
+    }
+  }
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_IO_URING)
+
+#endif // ASIO_DETAIL_IMPL_IO_URING_REACTOR_IPP
@@ -220,7 +220,7 @@ void kqueue_reactor::start_op(int op_type, socket_type descriptor,
       if (op->perform())
       {
         descriptor_lock.unlock();
-        scheduler_.post_immediate_completion(op, is_continuation);
+        scheduler_.post_speculative_completion(op, is_continuation);
         return;
       }
 
@@ -17,12 +17,14 @@
 
 #include "asio/detail/config.hpp"
 
+#include <algorithm>
 #include "asio/detail/concurrency_hint.hpp"
 #include "asio/detail/event.hpp"
 #include "asio/detail/limits.hpp"
 #include "asio/detail/reactor.hpp"
 #include "asio/detail/scheduler.hpp"
 #include "asio/detail/scheduler_thread_info.hpp"
+#include "asio/detail/scoped_ptr.hpp"
 #include "asio/detail/signal_blocker.hpp"
 
 #include "asio/detail/push_options.hpp"
@@ -62,9 +64,13 @@ struct scheduler::task_cleanup
 
     // Enqueue the completed operations and reinsert the task at the end of
     // the operation queue.
+    if (scheduler_->metrics_)
+      scheduler_->metrics_->operations_queued(this_thread_->private_op_queue);
+
     lock_->lock();
     scheduler_->task_interrupted_ = true;
     scheduler_->op_queue_.push(this_thread_->private_op_queue);
+    scheduler_->collect_remote_ops();
     scheduler_->op_queue_.push(&scheduler_->task_operation_);
   }
 
@@ -103,6 +109,49 @@ struct scheduler::work_cleanup
   thread_info* this_thread_;
 };
 
+struct scheduler::stealable_cleanup
+{
+  ~stealable_cleanup()
+  {
+    if (!this_thread_->stealable)
+      return;
+
+    // Move any operations still on this thread's queue to the main queue so
+    // that they can be run by another thread.
+    lock_->lock();
+    std::vector<thread_info*>& threads = scheduler_->stealable_threads_;
+    threads.erase(std::find(threads.begin(), threads.end(), this_thread_));
+
+    op_queue<operation> ops;
+    {
+      asio::detail::mutex::scoped_lock stealable_lock(
+          this_thread_->stealable->lock);
+      ops.push(this_thread_->stealable->ops);
+    }
+    this_thread_->stealable = 0;
+
+    if (!ops.empty())
+    {
+      scheduler_->op_queue_.push(ops);
+      scheduler_->wake_one_thread_and_unlock(*lock_);
+    }
+  }
+
+  scheduler* scheduler_;
+  mutex::scoped_lock* lock_;
+  thread_info* this_thread_;
+};
+
+struct scheduler::inline_completion_cleanup
+{
+  ~inline_completion_cleanup()
+  {
+    this_thread_->leave_inline_completion();
+  }
+
+  thread_info_base* this_thread_;
+};
+
 scheduler::scheduler(asio::execution_context& ctx,
     int concurrency_hint, bool own_thread)
   : asio::detail::execution_context_service_base<scheduler>(ctx),
@@ -111,14 +160,21 @@ scheduler::scheduler(asio::execution_context& ctx,
           SCHEDULER, concurrency_hint)
         || !ASIO_CONCURRENCY_HINT_IS_LOCKING(
           REACTOR_IO, concurrency_hint)),
+    work_stealing_(ASIO_CONCURRENCY_HINT_IS_WORK_STEALING(concurrency_hint)),
     mutex_(ASIO_CONCURRENCY_HINT_IS_LOCKING(
           SCHEDULER, concurrency_hint)),
     task_(0),
     task_interrupted_(true),
     outstanding_work_(0),
+    idle_stealers_(0),
     stopped_(false),
     shutdown_(false),
     concurrency_hint_(concurrency_hint),
+    task_event_batch_size_(0),
+    task_busy_poll_usec_(0),
+    inline_completion_depth_(0),
+    metrics_(0),
+    stall_detector_(0),
     thread_(0)
 {
   ASIO_HANDLER_TRACKING_INIT;
@@ -161,6 +217,7 @@ void scheduler::shutdown()
   }
 
   // Destroy handler objects.
+  remote_op_queue_.pop_all(op_queue_);
   while (!op_queue_.empty())
   {
     operation* o = op_queue_.front();
@@ -196,13 +253,38 @@ std::size_t scheduler::run(asio::error_code& ec)
   thread_info this_thread;
   this_thread.private_outstanding_work = 0;
   thread_call_stack::context ctx(this, this_thread);
+  stall_detector::thread_registration registration(stall_detector_);
+
+  // In work stealing mode, this thread gets its own queue for the duration of
+  // the call.
+  scoped_ptr<scheduler_stealable_queue> stealable(
+      work_stealing_ ? new scheduler_stealable_queue : 0);
 
   mutex::scoped_lock lock(mutex_);
 
+  if (stealable.get())
+  {
+    stealable->stopped = stopped_;
+    stealable_threads_.push_back(&this_thread);
+    this_thread.stealable = stealable.get();
+  }
+  stealable_cleanup on_exit = { this, &lock, &this_thread };
+  (void)on_exit;
+
   std::size_t n = 0;
   for (; do_run_one(lock, this_thread, ec); lock.lock())
+  {
     if (n != (std::numeric_limits<std::size_t>::max)())
       ++n;
+
+    // Run handlers from this thread's own queue without taking the lock, but
+    // periodically go back to the main queue so that the task and handlers
+    // posted from other threads are not starved.
+    for (int i = 0; this_thread.stealable && i < max_stealable_run
+        && do_run_one_stealable(lock, this_thread, ec); ++i)
+      if (n != (std::numeric_limits<std::size_t>::max)())
+        ++n;
+  }
   return n;
 }
 
@@ -218,6 +300,7 @@ std::size_t scheduler::run_one(asio::error_code& ec)
   thread_info this_thread;
   this_thread.private_outstanding_work = 0;
   thread_call_stack::context ctx(this, this_thread);
+  stall_detector::thread_registration registration(stall_detector_);
 
   mutex::scoped_lock lock(mutex_);
 
@@ -236,6 +319,7 @@ std::size_t scheduler::wait_one(long usec, asio::error_code& ec)
   thread_info this_thread;
   this_thread.private_outstanding_work = 0;
   thread_call_stack::context ctx(this, this_thread);
+  stall_detector::thread_registration registration(stall_detector_);
 
   mutex::scoped_lock lock(mutex_);
 
@@ -254,6 +338,7 @@ std::size_t scheduler::poll(asio::error_code& ec)
   thread_info this_thread;
   this_thread.private_outstanding_work = 0;
   thread_call_stack::context ctx(this, this_thread);
+  stall_detector::thread_registration registration(stall_detector_);
 
   mutex::scoped_lock lock(mutex_);
 
@@ -285,6 +370,7 @@ std::size_t scheduler::poll_one(asio::error_code& ec)
   thread_info this_thread;
   this_thread.private_outstanding_work = 0;
   thread_call_stack::context ctx(this, this_thread);
+  stall_detector::thread_registration registration(stall_detector_);
 
   mutex::scoped_lock lock(mutex_);
 
@@ -316,6 +402,13 @@ void scheduler::restart()
 {
   mutex::scoped_lock lock(mutex_);
   stopped_ = false;
+
+  for (std::size_t i = 0; i < stealable_threads_.size(); ++i)
+  {
+    asio::detail::mutex::scoped_lock stealable_lock(
+        stealable_threads_[i]->stealable->lock);
+    stealable_threads_[i]->stealable->stopped = false;
+  }
 }
 
 void scheduler::compensating_work_started()
@@ -338,7 +431,17 @@ void scheduler::capture_current_exception()
 void scheduler::post_immediate_completion(
     scheduler::operation* op, bool is_continuation)
 {
+  if (metrics_)
+    metrics_->operation_queued(op);
+
 #if defined(ASIO_HAS_THREADS)
+  if (thread_info* this_thread = stealable_thread_info())
+  {
+    work_started();
+    post_stealable(*this_thread, op);
+    return;
+  }
+
   if (one_thread_ || is_continuation)
   {
     if (thread_info_base* this_thread = thread_call_stack::contains(this))
@@ -353,15 +456,44 @@ void scheduler::post_immediate_completion(
 #endif // defined(ASIO_HAS_THREADS)
 
   work_started();
-  mutex::scoped_lock lock(mutex_);
-  op_queue_.push(op);
-  wake_one_thread_and_unlock(lock);
+  post_remote(op);
+}
+
+void scheduler::post_speculative_completion(
+    scheduler::operation* op, bool is_continuation)
+{
+  if (inline_completion_depth_ > 0)
+  {
+    if (thread_info_base* this_thread = thread_call_stack::contains(this))
+    {
+      if (this_thread->enter_inline_completion(inline_completion_depth_))
+      {
+        inline_completion_cleanup on_exit = { this_thread };
+        (void)on_exit;
+
+        op->complete(this, asio::error_code(), 0);
+        return;
+      }
+    }
+  }
+
+  post_immediate_completion(op, is_continuation);
 }
 
 void scheduler::post_immediate_completions(std::size_t n,
     op_queue<scheduler::operation>& ops, bool is_continuation)
 {
+  if (metrics_)
+    metrics_->operations_queued(ops);
+
 #if defined(ASIO_HAS_THREADS)
+  if (thread_info* this_thread = stealable_thread_info())
+  {
+    increment(outstanding_work_, static_cast<long>(n));
+    post_stealable(*this_thread, ops);
+    return;
+  }
+
   if (one_thread_ || is_continuation)
   {
     if (thread_info_base* this_thread = thread_call_stack::contains(this))
@@ -377,14 +509,21 @@ void scheduler::post_immediate_completions(std::size_t n,
 #endif // defined(ASIO_HAS_THREADS)
 
   increment(outstanding_work_, static_cast<long>(n));
-  mutex::scoped_lock lock(mutex_);
-  op_queue_.push(ops);
-  wake_one_thread_and_unlock(lock);
+  post_remote(ops);
 }
 
 void scheduler::post_deferred_completion(scheduler::operation* op)
 {
+  if (metrics_)
+    metrics_->operation_queued(op);
+
 #if defined(ASIO_HAS_THREADS)
+  if (thread_info* this_thread = stealable_thread_info())
+  {
+    post_stealable(*this_thread, op);
+    return;
+  }
+
   if (one_thread_)
   {
     if (thread_info_base* this_thread = thread_call_stack::contains(this))
@@ -395,9 +534,7 @@ void scheduler::post_deferred_completion(scheduler::operation* op)
   }
 #endif // defined(ASIO_HAS_THREADS)
 
-  mutex::scoped_lock lock(mutex_);
-  op_queue_.push(op);
-  wake_one_thread_and_unlock(lock);
+  post_remote(op);
 }
 
 void scheduler::post_deferred_completions(
@@ -405,7 +542,16 @@ void scheduler::post_deferred_completions(
 {
   if (!ops.empty())
   {
+    if (metrics_)
+      metrics_->operations_queued(ops);
+
 #if defined(ASIO_HAS_THREADS)
+    if (thread_info* this_thread = stealable_thread_info())
+    {
+      post_stealable(*this_thread, ops);
+      return;
+    }
+
     if (one_thread_)
     {
       if (thread_info_base* this_thread = thread_call_stack::contains(this))
@@ -416,19 +562,18 @@ void scheduler::post_deferred_completions(
     }
 #endif // defined(ASIO_HAS_THREADS)
 
-    mutex::scoped_lock lock(mutex_);
-    op_queue_.push(ops);
-    wake_one_thread_and_unlock(lock);
+    post_remote(ops);
   }
 }
 
 void scheduler::do_dispatch(
     scheduler::operation* op)
 {
+  if (metrics_)
+    metrics_->operation_queued(op);
+
   work_started();
-  mutex::scoped_lock lock(mutex_);
-  op_queue_.push(op);
-  wake_one_thread_and_unlock(lock);
+  post_remote(op);
 }
 
 void scheduler::abandon_operations(
@@ -444,6 +589,7 @@ std::size_t scheduler::do_run_one(mutex::scoped_lock& lock,
 {
   while (!stopped_)
   {
+    collect_remote_ops();
     if (!op_queue_.empty())
     {
       // Prepare to execute first handler from queue.
@@ -453,6 +599,15 @@ std::size_t scheduler::do_run_one(mutex::scoped_lock& lock,
 
       if (o == &task_operation_)
       {
+        // In work stealing mode, a thread must not block in the task while
+        // handlers are waiting on its own queue.
+        if (!more_handlers && this_thread.stealable)
+        {
+          asio::detail::mutex::scoped_lock stealable_lock(
+              this_thread.stealable->lock);
+          more_handlers = !this_thread.stealable->ops.empty();
+        }
+
         task_interrupted_ = more_handlers;
 
         if (more_handlers && !one_thread_)
@@ -466,6 +621,7 @@ std::size_t scheduler::do_run_one(mutex::scoped_lock& lock,
         // Run the task. May throw an exception. Only block if the operation
         // queue is empty and we're not polling, otherwise we want to return
         // as soon as possible.
+        scheduler_metrics::task_scope measure(metrics_);
         task_->run(more_handlers ? 0 : -1, this_thread.private_op_queue);
       }
       else
@@ -482,12 +638,43 @@ std::size_t scheduler::do_run_one(mutex::scoped_lock& lock,
         (void)on_exit;
 
         // Complete the operation. May throw an exception. Deletes the object.
+        scheduler_metrics::execution_scope measure(metrics_, o);
+        stall_detector::execution_scope watch(stall_detector_, o);
         o->complete(this, ec, task_result);
         this_thread.rethrow_pending_exception();
 
         return 1;
       }
     }
+    else if (work_stealing_)
+    {
+      // Look for work on the threads' own queues before going to sleep. The
+      // idle count is raised first so that any thread queueing work after the
+      // search is sure to see it and wake this one.
+      ++idle_stealers_;
+      if (operation* o = steal_one(this_thread))
+      {
+        --idle_stealers_;
+        std::size_t task_result = o->task_result_;
+        lock.unlock();
+
+        // Ensure the count of outstanding work is decremented on block exit.
+        work_cleanup on_exit = { this, &lock, &this_thread };
+        (void)on_exit;
+
+        // Complete the operation. May throw an exception. Deletes the object.
+        scheduler_metrics::execution_scope measure(metrics_, o);
+        stall_detector::execution_scope watch(stall_detector_, o);
+        o->complete(this, ec, task_result);
+        this_thread.rethrow_pending_exception();
+
+        return 1;
+      }
+
+      wakeup_event_.clear(lock);
+      wakeup_event_.wait(lock);
+      --idle_stealers_;
+    }
     else
     {
       wakeup_event_.clear(lock);
@@ -505,12 +692,14 @@ std::size_t scheduler::do_wait_one(mutex::scoped_lock& lock,
   if (stopped_)
     return 0;
 
+  collect_remote_ops();
   operation* o = op_queue_.front();
   if (o == 0)
   {
     wakeup_event_.clear(lock);
     wakeup_event_.wait_for_usec(lock, usec);
     usec = 0; // Wait at most once.
+    collect_remote_ops();
     o = op_queue_.front();
   }
 
@@ -533,6 +722,7 @@ std::size_t scheduler::do_wait_one(mutex::scoped_lock& lock,
       // Run the task. May throw an exception. Only block if the operation
       // queue is empty and we're not polling, otherwise we want to return
       // as soon as possible.
+      scheduler_metrics::task_scope measure(metrics_);
       task_->run(more_handlers ? 0 : usec, this_thread.private_op_queue);
     }
 
@@ -563,6 +753,8 @@ std::size_t scheduler::do_wait_one(mutex::scoped_lock& lock,
   (void)on_exit;
 
   // Complete the operation. May throw an exception. Deletes the object.
+  scheduler_metrics::execution_scope measure(metrics_, o);
+  stall_detector::execution_scope watch(stall_detector_, o);
   o->complete(this, ec, task_result);
   this_thread.rethrow_pending_exception();
 
@@ -576,6 +768,7 @@ std::size_t scheduler::do_poll_one(mutex::scoped_lock& lock,
   if (stopped_)
     return 0;
 
+  collect_remote_ops();
   operation* o = op_queue_.front();
   if (o == &task_operation_)
   {
@@ -589,6 +782,7 @@ std::size_t scheduler::do_poll_one(mutex::scoped_lock& lock,
       // Run the task. May throw an exception. Only block if the operation
       // queue is empty and we're not polling, otherwise we want to return
       // as soon as possible.
+      scheduler_metrics::task_scope measure(metrics_);
       task_->run(0, this_thread.private_op_queue);
     }
 
@@ -618,18 +812,153 @@ std::size_t scheduler::do_poll_one(mutex::scoped_lock& lock,
   (void)on_exit;
 
   // Complete the operation. May throw an exception. Deletes the object.
+  scheduler_metrics::execution_scope measure(metrics_, o);
+  stall_detector::execution_scope watch(stall_detector_, o);
   o->complete(this, ec, task_result);
   this_thread.rethrow_pending_exception();
 
   return 1;
 }
 
+void scheduler::post_remote(scheduler::operation* op)
+{
+  // Only the thread that makes the queue non-empty needs to wake another. Any
+  // thread that subsequently dequeues a handler will collect the operation.
+  if (remote_op_queue_.push(op))
+  {
+    mutex::scoped_lock lock(mutex_);
+    wake_one_thread_and_unlock(lock);
+  }
+}
+
+void scheduler::post_remote(op_queue<scheduler::operation>& ops)
+{
+  if (remote_op_queue_.push(ops))
+  {
+    mutex::scoped_lock lock(mutex_);
+    wake_one_thread_and_unlock(lock);
+  }
+}
+
+scheduler::thread_info* scheduler::stealable_thread_info()
+{
+  if (work_stealing_)
+    if (thread_info_base* this_thread = thread_call_stack::contains(this))
+      if (static_cast<thread_info*>(this_thread)->stealable)
+        return static_cast<thread_info*>(this_thread);
+  return 0;
+}
+
+void scheduler::post_stealable(scheduler::thread_info& this_thread,
+    scheduler::operation* op)
+{
+  {
+    asio::detail::mutex::scoped_lock stealable_lock(
+        this_thread.stealable->lock);
+    this_thread.stealable->ops.push(op);
+  }
+
+  if (idle_stealers_ > 0)
+  {
+    mutex::scoped_lock lock(mutex_);
+    wakeup_event_.maybe_unlock_and_signal_one(lock);
+  }
+}
+
+void scheduler::post_stealable(scheduler::thread_info& this_thread,
+    op_queue<scheduler::operation>& ops)
+{
+  {
+    asio::detail::mutex::scoped_lock stealable_lock(
+        this_thread.stealable->lock);
+    this_thread.stealable->ops.push(ops);
+  }
+
+  if (idle_stealers_ > 0)
+  {
+    mutex::scoped_lock lock(mutex_);
+    wakeup_event_.maybe_unlock_and_signal_one(lock);
+  }
+}
+
+std::size_t scheduler::do_run_one_stealable(mutex::scoped_lock& lock,
+    scheduler::thread_info& this_thread,
+    const asio::error_code& ec)
+{
+  operation* o = 0;
+  {
+    asio::detail::mutex::scoped_lock stealable_lock(
+        this_thread.stealable->lock);
+    if (this_thread.stealable->stopped)
+      return 0;
+    o = this_thread.stealable->ops.front();
+    this_thread.stealable->ops.pop();
+  }
+
+  if (o == 0)
+    return 0;
+
+  std::size_t task_result = o->task_result_;
+  lock.unlock();
+
+  // Ensure the count of outstanding work is decremented on block exit.
+  work_cleanup on_exit = { this, &lock, &this_thread };
+  (void)on_exit;
+
+  // Complete the operation. May throw an exception. Deletes the object.
+  scheduler_metrics::execution_scope measure(metrics_, o);
+  stall_detector::execution_scope watch(stall_detector_, o);
+  o->complete(this, ec, task_result);
+  this_thread.rethrow_pending_exception();
+
+  return 1;
+}
+
+scheduler::operation* scheduler::steal_one(scheduler::thread_info& this_thread)
+{
+  std::size_t num_threads = stealable_threads_.size();
+  if (num_threads == 0)
+    return 0;
+
+  // Pick a random thread to start from, using a per-thread xorshift sequence.
+  unsigned int seed = this_thread.steal_seed;
+  if (seed == 0)
+    seed = static_cast<unsigned int>(
+        reinterpret_cast<std::size_t>(&this_thread) >> 4) | 1;
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  this_thread.steal_seed = seed;
+
+  for (std::size_t i = 0; i < num_threads; ++i)
+  {
+    thread_info* victim = stealable_threads_[(seed + i) % num_threads];
+    asio::detail::mutex::scoped_lock stealable_lock(victim->stealable->lock);
+    if (operation* o = victim->stealable->ops.front())
+    {
+      victim->stealable->ops.pop();
+      return o;
+    }
+  }
+
+  return 0;
+}
+
 void scheduler::stop_all_threads(
     mutex::scoped_lock& lock)
 {
   stopped_ = true;
   wakeup_event_.signal_all(lock);
 
+  // Threads running handlers from their own queues do so without the lock, so
+  // they must be told separately.
+  for (std::size_t i = 0; i < stealable_threads_.size(); ++i)
+  {
+    asio::detail::mutex::scoped_lock stealable_lock(
+        stealable_threads_[i]->stealable->lock);
+    stealable_threads_[i]->stealable->stopped = true;
+  }
+
   if (!task_interrupted_ && task_)
   {
     task_interrupted_ = true;
@@ -646,9 +975,13 @@ void scheduler::wake_one_thread_and_unlock(
     {
       task_interrupted_ = true;
       task_->interrupt();
+      if (metrics_)
+        metrics_->wakeup();
     }
     lock.unlock();
   }
+  else if (metrics_)
+    metrics_->wakeup();
 }
 
 } // namespace detail
@@ -1251,6 +1251,241 @@ bool non_blocking_recvfrom1(socket_type s,
 
 #endif // defined(ASIO_HAS_IOCP)
 
+#if defined(ASIO_HAS_UDP_GSO)
+
+signed_size_type recvfrom_segments(socket_type s, buf* bufs, size_t count,
+    int flags, socket_addr_type* addr, std::size_t* addrlen,
+    std::size_t* segment_size, asio::error_code& ec)
+{
+  union
+  {
+    cmsghdr header;
+    char buffer[CMSG_SPACE(sizeof(int))];
+  } control;
+  msghdr msg = msghdr();
+  init_msghdr_msg_name(msg.msg_name, addr);
+  msg.msg_namelen = static_cast<int>(*addrlen);
+  msg.msg_iov = bufs;
+  msg.msg_iovlen = static_cast<int>(count);
+  msg.msg_control = control.buffer;
+  msg.msg_controllen = sizeof(control.buffer);
+  signed_size_type result = ::recvmsg(s, &msg, flags);
+  get_last_error(ec, result < 0);
+  *addrlen = msg.msg_namelen;
+
+  if (result >= 0)
+  {
+    // Datagrams that were coalesced by the kernel carry the size of the
+    // original datagrams. Otherwise, only one datagram was received. The size
+    // is not trusted if the control data was truncated.
+    *segment_size = result;
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (msg.msg_flags & MSG_CTRUNC)
+      cmsg = 0;
+    for (; cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+      if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO
+          && cmsg->cmsg_len >= CMSG_LEN(sizeof(int)))
+      {
+        int size = 0;
+        std::memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+        if (size > 0)
+          *segment_size = size;
+      }
+    }
+  }
+
+  return result;
+}
+
+size_t sync_recvfrom_segments(socket_type s, state_type state, buf* bufs,
+    size_t count, int flags, socket_addr_type* addr,
+    std::size_t* addrlen, std::size_t* segment_size,
+    asio::error_code& ec)
+{
+  if (s == invalid_socket)
+  {
+    ec = asio::error::bad_descriptor;
+    return 0;
+  }
+
+  // Read some data.
+  for (;;)
+  {
+    // Try to complete the operation without blocking.
+    signed_size_type bytes = socket_ops::recvfrom_segments(
+        s, bufs, count, flags, addr, addrlen, segment_size, ec);
+
+    // Check if operation succeeded.
+    if (bytes >= 0)
+      return bytes;
+
+    // Operation failed.
+    if ((state & user_set_non_blocking)
+        || (ec != asio::error::would_block
+          && ec != asio::error::try_again))
+      return 0;
+
+    // Wait for socket to become ready.
+    if (socket_ops::poll_read(s, 0, -1, ec) < 0)
+      return 0;
+  }
+}
+
+bool non_blocking_recvfrom_segments(socket_type s,
+    buf* bufs, size_t count, int flags,
+    socket_addr_type* addr, std::size_t* addrlen,
+    std::size_t* segment_size, asio::error_code& ec,
+    size_t& bytes_transferred)
+{
+  for (;;)
+  {
+    // Read some data.
+    signed_size_type bytes = socket_ops::recvfrom_segments(
+        s, bufs, count, flags, addr, addrlen, segment_size, ec);
+
+    // Check if operation succeeded.
+    if (bytes >= 0)
+    {
+      bytes_transferred = bytes;
+      return true;
+    }
+
+    // Retry operation if interrupted by signal.
+    if (ec == asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == asio::error::would_block
+        || ec == asio::error::try_again)
+      return false;
+
+    // Operation failed.
+    bytes_transferred = 0;
+    return true;
+  }
+}
+
+#endif // defined(ASIO_HAS_UDP_GSO)
+
+signed_size_type recvmmsg(socket_type s, datagram_buf* dgrams,
+    size_t count, int flags, asio::error_code& ec)
+{
+#if defined(ASIO_HAS_MMSG)
+  if (count > max_datagram_batch)
+    count = max_datagram_batch;
+  mmsghdr msgs[max_datagram_batch];
+  for (size_t i = 0; i < count; ++i)
+  {
+    msgs[i].msg_hdr = msghdr();
+    init_msghdr_msg_name(msgs[i].msg_hdr.msg_name, dgrams[i].addr);
+    msgs[i].msg_hdr.msg_namelen = static_cast<int>(dgrams[i].addrlen);
+    msgs[i].msg_hdr.msg_iov = &dgrams[i].data;
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_len = 0;
+  }
+  // Block for the first datagram only, even if the socket is blocking.
+  signed_size_type result = ::recvmmsg(s, msgs,
+      static_cast<unsigned int>(count), flags | MSG_WAITFORONE, 0);
+  get_last_error(ec, result < 0);
+  for (signed_size_type i = 0; i < result; ++i)
+  {
+    dgrams[i].addrlen = msgs[i].msg_hdr.msg_namelen;
+    dgrams[i].bytes_transferred = msgs[i].msg_len;
+  }
+  return result;
+#else // defined(ASIO_HAS_MMSG)
+  // Without a batched receive, take one datagram per call so that a blocking
+  // socket never waits for more than the first.
+  if (count == 0)
+  {
+    ec.assign(0, ec.category());
+    return 0;
+  }
+  signed_size_type bytes = socket_ops::recvfrom(s, &dgrams[0].data, 1,
+      flags, dgrams[0].addr, &dgrams[0].addrlen, ec);
+  if (bytes < 0)
+    return socket_error_retval;
+  dgrams[0].bytes_transferred = bytes;
+  return 1;
+#endif // defined(ASIO_HAS_MMSG)
+}
+
+size_t sync_recvmmsg(socket_type s, state_type state,
+    datagram_buf* dgrams, size_t count, int flags, asio::error_code& ec)
+{
+  if (s == invalid_socket)
+  {
+    ec = asio::error::bad_descriptor;
+    return 0;
+  }
+
+  // A request to read 0 datagrams is a no-op.
+  if (count == 0)
+  {
+    ec.assign(0, ec.category());
+    return 0;
+  }
+
+  // Read some datagrams.
+  for (;;)
+  {
+    // Try to complete the operation without blocking.
+    signed_size_type datagrams = socket_ops::recvmmsg(
+        s, dgrams, count, flags, ec);
+
+    // Check if operation succeeded.
+    if (datagrams >= 0)
+      return datagrams;
+
+    // Operation failed.
+    if ((state & user_set_non_blocking)
+        || (ec != asio::error::would_block
+          && ec != asio::error::try_again))
+      return 0;
+
+    // Wait for socket to become ready.
+    if (socket_ops::poll_read(s, 0, -1, ec) < 0)
+      return 0;
+  }
+}
+
+#if !defined(ASIO_HAS_IOCP)
+
+bool non_blocking_recvmmsg(socket_type s,
+    datagram_buf* dgrams, size_t count, int flags,
+    asio::error_code& ec, size_t& datagrams_transferred)
+{
+  for (;;)
+  {
+    // Read some datagrams.
+    signed_size_type datagrams = socket_ops::recvmmsg(
+        s, dgrams, count, flags, ec);
+
+    // Check if operation succeeded.
+    if (datagrams >= 0)
+    {
+      datagrams_transferred = datagrams;
+      return true;
+    }
+
+    // Retry operation if interrupted by signal.
+    if (ec == asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == asio::error::would_block
+        || ec == asio::error::try_again)
+      return false;
+
+    // Operation failed.
+    datagrams_transferred = 0;
+    return true;
+  }
+}
+
+#endif // !defined(ASIO_HAS_IOCP)
+
 signed_size_type recvmsg(socket_type s, buf* bufs, size_t count,
     int in_flags, int& out_flags, asio::error_code& ec)
 {
@@ -1588,6 +1823,114 @@ bool non_blocking_send1(socket_type s,
   }
 }
 
+#if defined(ASIO_HAS_MSG_ZEROCOPY)
+
+bool non_blocking_send_zero_copy(socket_type s,
+    const buf* bufs, size_t count, int flags, zero_copy_state& zc,
+    uint32_t& seq, bool& completion_pending,
+    asio::error_code& ec, size_t& bytes_transferred)
+{
+  completion_pending = false;
+
+  for (;;)
+  {
+    // Write some data, letting the kernel reference the buffers directly.
+    signed_size_type bytes = socket_ops::send(s,
+        bufs, count, flags | MSG_ZEROCOPY, ec);
+
+    // Check if operation succeeded. The kernel assigns consecutive sequence
+    // numbers to zero-copy sends that transfer data.
+    if (bytes >= 0)
+    {
+      bytes_transferred = bytes;
+      if (bytes > 0)
+      {
+        seq = zc.sent++;
+        completion_pending = true;
+      }
+      return true;
+    }
+
+    // Retry operation if interrupted by signal.
+    if (ec == asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == asio::error::would_block
+        || ec == asio::error::try_again)
+      return false;
+
+    // The socket has too many zero-copy sends awaiting completion, so fall
+    // back to a copying send.
+    if (ec == asio::error::no_buffer_space)
+      return non_blocking_send(s, bufs, count, flags, ec, bytes_transferred);
+
+    // Operation failed.
+    bytes_transferred = 0;
+    return true;
+  }
+}
+
+bool non_blocking_zero_copy_complete(socket_type s,
+    zero_copy_state& zc, uint32_t seq, asio::error_code& ec)
+{
+  for (;;)
+  {
+    // Check whether the send has already been reported as complete.
+    if (static_cast<int32_t>(zc.completed - seq) > 0)
+    {
+      ec.assign(0, ec.category());
+      return true;
+    }
+
+    // Read a notification from the socket's error queue.
+    union
+    {
+      cmsghdr header;
+      char buffer[CMSG_SPACE(sizeof(sock_extended_err))
+        + CMSG_SPACE(sizeof(sockaddr_in6))];
+    } control;
+    msghdr msg = msghdr();
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+    signed_size_type result = ::recvmsg(s, &msg, MSG_ERRQUEUE);
+    get_last_error(ec, result < 0);
+
+    if (result < 0)
+    {
+      // Retry operation if interrupted by signal.
+      if (ec == asio::error::interrupted)
+        continue;
+
+      // Check if we need to run the operation again.
+      if (ec == asio::error::would_block
+          || ec == asio::error::try_again)
+        return false;
+
+      // Operation failed.
+      return true;
+    }
+
+    // Each notification covers an inclusive range of sequence numbers. Those
+    // for stream sockets are delivered in order.
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+      if ((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+          || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+      {
+        sock_extended_err err;
+        std::memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+        if (err.ee_errno == 0 && err.ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+          if (static_cast<int32_t>(err.ee_data + 1 - zc.completed) > 0)
+            zc.completed = err.ee_data + 1;
+      }
+    }
+  }
+}
+
+#endif // defined(ASIO_HAS_MSG_ZEROCOPY)
+
 #endif // defined(ASIO_HAS_IOCP)
 
 signed_size_type sendto(socket_type s, const buf* bufs, size_t count,
@@ -1802,6 +2145,239 @@ bool non_blocking_sendto1(socket_type s,
 
 #endif // !defined(ASIO_HAS_IOCP)
 
+#if defined(ASIO_HAS_UDP_GSO)
+
+signed_size_type sendto_segments(socket_type s, const buf* bufs,
+    size_t count, int flags, const socket_addr_type* addr,
+    std::size_t addrlen, std::size_t segment_size, asio::error_code& ec)
+{
+  // The size of each datagram is passed to the kernel as 16 bits.
+  if (segment_size == 0 || segment_size > 65535)
+  {
+    ec = asio::error::invalid_argument;
+    return socket_error_retval;
+  }
+
+  union
+  {
+    cmsghdr header;
+    char buffer[CMSG_SPACE(sizeof(uint16_t))];
+  } control;
+  std::memset(&control, 0, sizeof(control));
+  msghdr msg = msghdr();
+  init_msghdr_msg_name(msg.msg_name, addr);
+  msg.msg_namelen = static_cast<int>(addrlen);
+  msg.msg_iov = const_cast<buf*>(bufs);
+  msg.msg_iovlen = static_cast<int>(count);
+  msg.msg_control = control.buffer;
+  msg.msg_controllen = sizeof(control.buffer);
+
+  // Ask the kernel to split the data into datagrams of the given size.
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+  uint16_t size = static_cast<uint16_t>(segment_size);
+  std::memcpy(CMSG_DATA(cmsg), &size, sizeof(size));
+
+#if defined(ASIO_HAS_MSG_NOSIGNAL)
+  flags |= MSG_NOSIGNAL;
+#endif // defined(ASIO_HAS_MSG_NOSIGNAL)
+  signed_size_type result = ::sendmsg(s, &msg, flags);
+  get_last_error(ec, result < 0);
+  return result;
+}
+
+size_t sync_sendto_segments(socket_type s, state_type state,
+    const buf* bufs, size_t count, int flags, const socket_addr_type* addr,
+    std::size_t addrlen, std::size_t segment_size, asio::error_code& ec)
+{
+  if (s == invalid_socket)
+  {
+    ec = asio::error::bad_descriptor;
+    return 0;
+  }
+
+  // Write some data.
+  for (;;)
+  {
+    // Try to complete the operation without blocking.
+    signed_size_type bytes = socket_ops::sendto_segments(
+        s, bufs, count, flags, addr, addrlen, segment_size, ec);
+
+    // Check if operation succeeded.
+    if (bytes >= 0)
+      return bytes;
+
+    // Operation failed.
+    if ((state & user_set_non_blocking)
+        || (ec != asio::error::would_block
+          && ec != asio::error::try_again))
+      return 0;
+
+    // Wait for socket to become ready.
+    if (socket_ops::poll_write(s, 0, -1, ec) < 0)
+      return 0;
+  }
+}
+
+bool non_blocking_sendto_segments(socket_type s,
+    const buf* bufs, size_t count, int flags,
+    const socket_addr_type* addr, std::size_t addrlen,
+    std::size_t segment_size, asio::error_code& ec,
+    size_t& bytes_transferred)
+{
+  for (;;)
+  {
+    // Write some data.
+    signed_size_type bytes = socket_ops::sendto_segments(
+        s, bufs, count, flags, addr, addrlen, segment_size, ec);
+
+    // Check if operation succeeded.
+    if (bytes >= 0)
+    {
+      bytes_transferred = bytes;
+      return true;
+    }
+
+    // Retry operation if interrupted by signal.
+    if (ec == asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == asio::error::would_block
+        || ec == asio::error::try_again)
+      return false;
+
+    // Operation failed.
+    bytes_transferred = 0;
+    return true;
+  }
+}
+
+#endif // defined(ASIO_HAS_UDP_GSO)
+
+signed_size_type sendmmsg(socket_type s, datagram_buf* dgrams,
+    size_t count, int flags, asio::error_code& ec)
+{
+#if defined(ASIO_HAS_MMSG)
+  if (count > max_datagram_batch)
+    count = max_datagram_batch;
+  mmsghdr msgs[max_datagram_batch];
+  for (size_t i = 0; i < count; ++i)
+  {
+    msgs[i].msg_hdr = msghdr();
+    init_msghdr_msg_name(msgs[i].msg_hdr.msg_name, dgrams[i].addr);
+    msgs[i].msg_hdr.msg_namelen = static_cast<int>(dgrams[i].addrlen);
+    msgs[i].msg_hdr.msg_iov = &dgrams[i].data;
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_len = 0;
+  }
+#if defined(ASIO_HAS_MSG_NOSIGNAL)
+  flags |= MSG_NOSIGNAL;
+#endif // defined(ASIO_HAS_MSG_NOSIGNAL)
+  signed_size_type result = ::sendmmsg(s, msgs,
+      static_cast<unsigned int>(count), flags);
+  get_last_error(ec, result < 0);
+  for (signed_size_type i = 0; i < result; ++i)
+    dgrams[i].bytes_transferred = msgs[i].msg_len;
+  return result;
+#else // defined(ASIO_HAS_MMSG)
+  // Without a batched send, send datagrams one at a time until one fails. A
+  // failure after the first datagram is left to be reported by the next call.
+  size_t n = 0;
+  for (; n < count && n < max_datagram_batch; ++n)
+  {
+    signed_size_type bytes = socket_ops::sendto(s, &dgrams[n].data, 1,
+        flags, dgrams[n].addr, dgrams[n].addrlen, ec);
+    if (bytes < 0)
+    {
+      if (n == 0)
+        return socket_error_retval;
+      break;
+    }
+    dgrams[n].bytes_transferred = bytes;
+  }
+  ec.assign(0, ec.category());
+  return n;
+#endif // defined(ASIO_HAS_MMSG)
+}
+
+size_t sync_sendmmsg(socket_type s, state_type state,
+    datagram_buf* dgrams, size_t count, int flags, asio::error_code& ec)
+{
+  if (s == invalid_socket)
+  {
+    ec = asio::error::bad_descriptor;
+    return 0;
+  }
+
+  // Write all of the datagrams, returning early only on error.
+  ec.assign(0, ec.category());
+  size_t total = 0;
+  while (total < count)
+  {
+    // Try to complete the operation without blocking.
+    signed_size_type datagrams = socket_ops::sendmmsg(
+        s, dgrams + total, count - total, flags, ec);
+
+    // Check if operation succeeded.
+    if (datagrams >= 0)
+    {
+      total += datagrams;
+      continue;
+    }
+
+    // Operation failed.
+    if ((state & user_set_non_blocking)
+        || (ec != asio::error::would_block
+          && ec != asio::error::try_again))
+      return total;
+
+    // Wait for socket to become ready.
+    if (socket_ops::poll_write(s, 0, -1, ec) < 0)
+      return total;
+  }
+
+  return total;
+}
+
+#if !defined(ASIO_HAS_IOCP)
+
+bool non_blocking_sendmmsg(socket_type s,
+    datagram_buf* dgrams, size_t count, int flags,
+    asio::error_code& ec, size_t& datagrams_transferred)
+{
+  for (;;)
+  {
+    // Write some datagrams.
+    signed_size_type datagrams = socket_ops::sendmmsg(
+        s, dgrams, count, flags, ec);
+
+    // Check if operation succeeded.
+    if (datagrams >= 0)
+    {
+      datagrams_transferred = datagrams;
+      return true;
+    }
+
+    // Retry operation if interrupted by signal.
+    if (ec == asio::error::interrupted)
+      continue;
+
+    // Check if we need to run the operation again.
+    if (ec == asio::error::would_block
+        || ec == asio::error::try_again)
+      return false;
+
+    // Operation failed.
+    datagrams_transferred = 0;
+    return true;
+  }
+}
+
+#endif // !defined(ASIO_HAS_IOCP)
+
 socket_type socket(int af, int type, int protocol,
     asio::error_code& ec)
 {
@@ -1914,6 +2490,18 @@ int setsockopt(socket_type s, state_type& state, int level, int optname,
   get_last_error(ec, result != 0);
   if (result == 0)
   {
+#if defined(ASIO_HAS_MSG_ZEROCOPY)
+    // Zero-copy sends are used only once the kernel has accepted the option.
+    if (level == SOL_SOCKET && optname == SO_ZEROCOPY
+        && optlen == sizeof(int))
+    {
+      if (*static_cast<const int*>(optval))
+        state |= zero_copy;
+      else
+        state &= ~zero_copy;
+    }
+#endif // defined(ASIO_HAS_MSG_ZEROCOPY)
+
 #if defined(__MACH__) && defined(__APPLE__) \
   || defined(__NetBSD__) || defined(__FreeBSD__) \
   || defined(__OpenBSD__) || defined(__QNX__)
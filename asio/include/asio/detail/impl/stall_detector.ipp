@@ -0,0 +1,188 @@
+//
+// detail/impl/stall_detector.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_STALL_DETECTOR_IPP
+#define ASIO_DETAIL_IMPL_STALL_DETECTOR_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_STALL_DETECTION)
+
+#include <cstdio>
+#include <vector>
+#include "asio/detail/chrono.hpp"
+#include "asio/detail/stall_detector.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+class stall_detector::monitor_function
+{
+public:
+  explicit monitor_function(stall_detector* d)
+    : this_(d)
+  {
+  }
+
+  void operator()()
+  {
+    this_->run_monitor();
+  }
+
+private:
+  stall_detector* this_;
+};
+
+stall_detector::stall_detector(execution_context& ctx)
+  : execution_context_service_base<stall_detector>(ctx),
+    records_(0),
+    threshold_(0),
+    handler_(0),
+    handler_context_(0),
+    shutdown_(false)
+{
+}
+
+stall_detector::~stall_detector()
+{
+  shutdown();
+}
+
+void stall_detector::shutdown()
+{
+  mutex::scoped_lock lock(mutex_);
+  shutdown_ = true;
+  event_.signal(lock);
+  lock.unlock();
+
+  if (thread_.get())
+  {
+    thread_->join();
+    thread_.reset();
+  }
+}
+
+void stall_detector::start(long threshold_usec,
+    stall_handler_type handler, void* context)
+{
+  mutex::scoped_lock lock(mutex_);
+  threshold_ = static_cast<uint64_t>(threshold_usec) * 1000;
+  handler_ = handler ? handler : &stall_detector::write_report;
+  handler_context_ = context;
+  if (!thread_.get() && !shutdown_)
+    thread_.reset(new thread(monitor_function(this)));
+}
+
+uint64_t stall_detector::now()
+{
+  uint64_t t = static_cast<uint64_t>(
+      chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count());
+  return t != 0 ? t : 1;
+}
+
+void stall_detector::register_record(stall_record& record)
+{
+  mutex::scoped_lock lock(mutex_);
+  record.next_ = records_;
+  record.prev_ = 0;
+  if (records_)
+    records_->prev_ = &record;
+  records_ = &record;
+}
+
+void stall_detector::deregister_record(stall_record& record)
+{
+  mutex::scoped_lock lock(mutex_);
+  if (records_ == &record)
+    records_ = record.next_;
+  if (record.prev_)
+    record.prev_->next_ = record.next_;
+  if (record.next_)
+    record.next_->prev_ = record.prev_;
+  record.next_ = 0;
+  record.prev_ = 0;
+}
+
+void stall_detector::write_report(const stall_report& report, void*)
+{
+  if (report.file)
+  {
+    std::fprintf(stderr, "asio: handler stalled for %lu ms in %s%s%s(%s:%d)\n",
+        static_cast<unsigned long>(report.duration / 1000000),
+        report.function ? "'" : "", report.function ? report.function : "",
+        report.function ? "' " : "", report.file, report.line);
+  }
+  else
+  {
+    std::fprintf(stderr, "asio: handler stalled for %lu ms\n",
+        static_cast<unsigned long>(report.duration / 1000000));
+  }
+}
+
+void stall_detector::run_monitor()
+{
+  // Check several times per threshold period, so that a stall is reported
+  // soon after it exceeds the threshold.
+  long interval_usec = static_cast<long>(threshold_ / 4000);
+  if (interval_usec < 1000)
+    interval_usec = 1000;
+
+  std::vector<stall_report> reports;
+  mutex::scoped_lock lock(mutex_);
+  while (!shutdown_)
+  {
+    event_.wait_for_usec(lock, interval_usec);
+    if (shutdown_)
+      break;
+
+    uint64_t current_time = now();
+    for (stall_record* r = records_; r; r = r->next_)
+    {
+      uint64_t start = 0;
+      stall_report report;
+      if (r->read(start, report) && start != r->reported_start_
+          && current_time > start && current_time - start >= threshold_)
+      {
+        r->reported_start_ = start;
+        report.duration = current_time - start;
+        reports.push_back(report);
+      }
+    }
+
+    // Make the reports without holding the lock, so that the handler may take
+    // as long as it needs without blocking the threads running the io_context.
+    if (!reports.empty())
+    {
+      stall_handler_type handler = handler_;
+      void* context = handler_context_;
+      lock.unlock();
+      for (std::size_t i = 0; i < reports.size(); ++i)
+        handler(reports[i], context);
+      reports.clear();
+      lock.lock();
+    }
+  }
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_STALL_DETECTION)
+
+#endif // ASIO_DETAIL_IMPL_STALL_DETECTOR_IPP
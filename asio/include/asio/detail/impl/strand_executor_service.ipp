@@ -26,7 +26,10 @@ namespace detail {
 strand_executor_service::strand_executor_service(execution_context& ctx)
   : execution_context_service_base<strand_executor_service>(ctx),
     mutex_(),
+#if !defined(ASIO_HAS_LOCK_FREE_STRANDS)
+    mutexes_(ctx, default_num_mutexes),
     salt_(0),
+#endif // !defined(ASIO_HAS_LOCK_FREE_STRANDS)
     impl_list_(0)
 {
 }
@@ -40,11 +43,18 @@ void strand_executor_service::shutdown()
   strand_impl* impl = impl_list_;
   while (impl)
   {
+#if defined(ASIO_HAS_LOCK_FREE_STRANDS)
+    std::size_t state = impl->state_.exchange(
+        strand_impl::shut_down, std::memory_order_acquire);
+    push_waiting(ops, state);
+    ops.push(impl->ready_queue_);
+#else // defined(ASIO_HAS_LOCK_FREE_STRANDS)
     impl->mutex_->lock();
     impl->shutdown_ = true;
     ops.push(impl->waiting_queue_);
     ops.push(impl->ready_queue_);
     impl->mutex_->unlock();
+#endif // defined(ASIO_HAS_LOCK_FREE_STRANDS)
     impl = impl->next_;
   }
 }
@@ -53,6 +63,11 @@ strand_executor_service::implementation_type
 strand_executor_service::create_implementation()
 {
   implementation_type new_impl(new strand_impl);
+#if defined(ASIO_HAS_LOCK_FREE_STRANDS)
+  new_impl->state_ = strand_impl::unlocked;
+
+  asio::detail::mutex::scoped_lock lock(mutex_);
+#else // defined(ASIO_HAS_LOCK_FREE_STRANDS)
   new_impl->locked_ = false;
   new_impl->shutdown_ = false;
 
@@ -63,10 +78,9 @@ strand_executor_service::create_implementation()
   std::size_t mutex_index = reinterpret_cast<std::size_t>(new_impl.get());
   mutex_index += (reinterpret_cast<std::size_t>(new_impl.get()) >> 3);
   mutex_index ^= salt + 0x9e3779b9 + (mutex_index << 6) + (mutex_index >> 2);
-  mutex_index = mutex_index % num_mutexes;
-  if (!mutexes_[mutex_index].get())
-    mutexes_[mutex_index].reset(new mutex);
-  new_impl->mutex_ = mutexes_[mutex_index].get();
+  mutex_index = mutex_index % mutexes_.size();
+  new_impl->mutex_ = mutexes_.acquire(mutex_index);
+#endif // defined(ASIO_HAS_LOCK_FREE_STRANDS)
 
   // Insert implementation into linked list of all implementations.
   new_impl->next_ = impl_list_;
@@ -83,6 +97,10 @@ strand_executor_service::strand_impl::~strand_impl()
 {
   asio::detail::mutex::scoped_lock lock(service_->mutex_);
 
+#if !defined(ASIO_HAS_LOCK_FREE_STRANDS)
+  strand_pool<mutex>::release(mutex_);
+#endif // !defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
   // Remove implementation from linked list of all implementations.
   if (service_->impl_list_ == this)
     service_->impl_list_ = next_;
@@ -92,6 +110,46 @@ strand_executor_service::strand_impl::~strand_impl()
     next_->prev_= prev_;
 }
 
+#if defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
+bool strand_executor_service::enqueue(const implementation_type& impl,
+    scheduler_operation* op)
+{
+  std::size_t state = impl->state_.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    if (state == strand_impl::shut_down)
+    {
+      op->destroy();
+      return false;
+    }
+    else if (state == strand_impl::unlocked)
+    {
+      // The function is acquiring the strand lock and so is responsible for
+      // scheduling the strand.
+      if (impl->state_.compare_exchange_weak(state, strand_impl::locked,
+            std::memory_order_acquire, std::memory_order_relaxed))
+      {
+        impl->ready_queue_.push(op);
+        return true;
+      }
+    }
+    else
+    {
+      // Some other function already holds the strand lock. Enqueue for later.
+      op_queue_access::next(op, state == strand_impl::locked
+          ? static_cast<scheduler_operation*>(0)
+          : reinterpret_cast<scheduler_operation*>(state));
+      if (impl->state_.compare_exchange_weak(state,
+            reinterpret_cast<std::size_t>(op),
+            std::memory_order_release, std::memory_order_relaxed))
+        return false;
+    }
+  }
+}
+
+#else // defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
 bool strand_executor_service::enqueue(const implementation_type& impl,
     scheduler_operation* op)
 {
@@ -120,12 +178,78 @@ bool strand_executor_service::enqueue(const implementation_type& impl,
   }
 }
 
+#endif // defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
 bool strand_executor_service::running_in_this_thread(
     const implementation_type& impl)
 {
   return !!call_stack<strand_impl>::contains(impl.get());
 }
 
+#if defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
+bool strand_executor_service::push_waiting_to_ready(implementation_type& impl)
+{
+  std::size_t state = impl->state_.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    if (state == strand_impl::shut_down)
+    {
+      return false;
+    }
+    else if (state == strand_impl::locked)
+    {
+      // Keep the strand lock if a handler exited with an exception and left
+      // ready handlers behind.
+      if (!impl->ready_queue_.empty())
+        return true;
+
+      // No handlers are waiting, so release the strand lock.
+      if (impl->state_.compare_exchange_weak(state, strand_impl::unlocked,
+            std::memory_order_release, std::memory_order_relaxed))
+        return false;
+    }
+    else
+    {
+      // Take the waiting handlers while keeping the strand lock.
+      if (impl->state_.compare_exchange_weak(state, strand_impl::locked,
+            std::memory_order_acquire, std::memory_order_relaxed))
+      {
+        push_waiting(impl->ready_queue_, state);
+        return true;
+      }
+    }
+  }
+}
+
+void strand_executor_service::push_waiting(
+    op_queue<scheduler_operation>& ops, std::size_t state)
+{
+  if (state == strand_impl::unlocked || state == strand_impl::locked
+      || state == strand_impl::shut_down)
+    return;
+
+  // Reverse the chain so that handlers run in the order they were enqueued.
+  scheduler_operation* o = reinterpret_cast<scheduler_operation*>(state);
+  scheduler_operation* reversed = 0;
+  while (o)
+  {
+    scheduler_operation* next = op_queue_access::next(o);
+    op_queue_access::next(o, reversed);
+    reversed = o;
+    o = next;
+  }
+
+  while (reversed)
+  {
+    scheduler_operation* next = op_queue_access::next(reversed);
+    ops.push(reversed);
+    reversed = next;
+  }
+}
+
+#else // defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
 bool strand_executor_service::push_waiting_to_ready(implementation_type& impl)
 {
   impl->mutex_->lock();
@@ -135,6 +259,8 @@ bool strand_executor_service::push_waiting_to_ready(implementation_type& impl)
   return more_handlers;
 }
 
+#endif // defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
 void strand_executor_service::run_ready_handlers(implementation_type& impl)
 {
   // Indicate that this strand is executing on the current thread.
@@ -46,6 +46,7 @@ strand_service::strand_service(asio::io_context& io_context)
     io_context_(io_context),
     io_context_impl_(asio::use_service<io_context_impl>(io_context)),
     mutex_(),
+    implementations_(io_context, default_num_implementations),
     salt_(0)
 {
 }
@@ -56,9 +57,9 @@ void strand_service::shutdown()
 
   asio::detail::mutex::scoped_lock lock(mutex_);
 
-  for (std::size_t i = 0; i < num_implementations; ++i)
+  for (std::size_t i = 0; i < implementations_.size(); ++i)
   {
-    if (strand_impl* impl = implementations_[i].get())
+    if (strand_impl* impl = implementations_.get(i))
     {
       ops.push(impl->waiting_queue_);
       ops.push(impl->ready_queue_);
@@ -78,11 +79,9 @@ void strand_service::construct(strand_service::implementation_type& impl)
   index += (reinterpret_cast<std::size_t>(&impl) >> 3);
   index ^= salt + 0x9e3779b9 + (index << 6) + (index >> 2);
 #endif // defined(ASIO_ENABLE_SEQUENTIAL_STRAND_ALLOCATION)
-  index = index % num_implementations;
+  index = index % implementations_.size();
 
-  if (!implementations_[index].get())
-    implementations_[index].reset(new strand_impl);
-  impl = implementations_[index].get();
+  impl = implementations_.acquire(index);
 }
 
 bool strand_service::running_in_this_thread(
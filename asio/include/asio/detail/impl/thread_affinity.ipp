@@ -0,0 +1,172 @@
+//
+// detail/impl/thread_affinity.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_THREAD_AFFINITY_IPP
+#define ASIO_DETAIL_IMPL_THREAD_AFFINITY_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(__linux__)
+# include <sched.h>
+# include <cerrno>
+# include <cstdio>
+#elif defined(ASIO_WINDOWS) && !defined(ASIO_WINDOWS_APP) \
+  && !defined(UNDER_CE)
+# include "asio/detail/socket_types.hpp"
+#endif
+
+#include "asio/detail/thread.hpp"
+#include "asio/detail/thread_affinity.hpp"
+#include "asio/error.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+namespace thread_affinity {
+
+std::vector<int> available_cpus()
+{
+  std::vector<int> cpus;
+
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (::sched_getaffinity(0, sizeof(set), &set) == 0)
+  {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+      if (CPU_ISSET(cpu, &set))
+        cpus.push_back(cpu);
+  }
+#elif defined(ASIO_WINDOWS) && !defined(ASIO_WINDOWS_APP) \
+  && !defined(UNDER_CE)
+  DWORD_PTR process_mask = 0, system_mask = 0;
+  if (::GetProcessAffinityMask(::GetCurrentProcess(),
+        &process_mask, &system_mask))
+  {
+    for (int cpu = 0; cpu < static_cast<int>(sizeof(DWORD_PTR) * 8); ++cpu)
+      if (process_mask & (static_cast<DWORD_PTR>(1) << cpu))
+        cpus.push_back(cpu);
+  }
+#endif
+
+  if (cpus.empty())
+  {
+    std::size_t n = asio::detail::thread::hardware_concurrency();
+    for (std::size_t cpu = 0; cpu < (n ? n : 1); ++cpu)
+      cpus.push_back(static_cast<int>(cpu));
+  }
+
+  return cpus;
+}
+
+std::vector<int> numa_node_cpus(int node, asio::error_code& ec)
+{
+  std::vector<int> cpus;
+
+#if defined(__linux__)
+  if (node < 0)
+  {
+    ec = asio::error::invalid_argument;
+    return cpus;
+  }
+
+  // The node's CPUs are listed as comma-separated ranges, e.g. "0-3,8-11".
+  char path[64];
+  std::sprintf(path, "/sys/devices/system/node/node%d/cpulist", node);
+  std::FILE* f = std::fopen(path, "r");
+  if (!f)
+  {
+    ec = asio::error_code(errno, asio::error::get_system_category());
+    return cpus;
+  }
+
+  int first = 0, last = 0;
+  while (std::fscanf(f, "%d", &first) == 1)
+  {
+    last = first;
+    int c = std::fgetc(f);
+    if (c == '-')
+    {
+      if (std::fscanf(f, "%d", &last) != 1)
+        break;
+      c = std::fgetc(f);
+    }
+    for (int cpu = first; cpu <= last; ++cpu)
+      cpus.push_back(cpu);
+    if (c != ',')
+      break;
+  }
+  std::fclose(f);
+
+  ec = asio::error_code();
+#else // defined(__linux__)
+  (void)node;
+  ec = asio::error::operation_not_supported;
+#endif // defined(__linux__)
+
+  return cpus;
+}
+
+asio::error_code pin_this_thread(int cpu, asio::error_code& ec)
+{
+#if defined(__linux__)
+  if (cpu < 0 || cpu >= CPU_SETSIZE)
+  {
+    ec = asio::error::invalid_argument;
+    return ec;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (::sched_setaffinity(0, sizeof(set), &set) != 0)
+  {
+    ec = asio::error_code(errno, asio::error::get_system_category());
+    return ec;
+  }
+
+  ec = asio::error_code();
+#elif defined(ASIO_WINDOWS) && !defined(ASIO_WINDOWS_APP) \
+  && !defined(UNDER_CE)
+  if (cpu < 0 || cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8))
+  {
+    ec = asio::error::invalid_argument;
+    return ec;
+  }
+
+  if (!::SetThreadAffinityMask(::GetCurrentThread(),
+        static_cast<DWORD_PTR>(1) << cpu))
+  {
+    DWORD last_error = ::GetLastError();
+    ec = asio::error_code(last_error, asio::error::get_system_category());
+    return ec;
+  }
+
+  ec = asio::error_code();
+#else
+  (void)cpu;
+  ec = asio::error::operation_not_supported;
+#endif
+
+  return ec;
+}
+
+} // namespace thread_affinity
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_IMPL_THREAD_AFFINITY_IPP
@@ -0,0 +1,290 @@
+//
+// detail/impl/thread_info_base.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_THREAD_INFO_BASE_IPP
+#define ASIO_DETAIL_IMPL_THREAD_INFO_BASE_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/detail/atomic_count.hpp"
+#include "asio/detail/static_mutex.hpp"
+#include "asio/detail/thread_info_base.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+struct thread_info_base::shared_cache
+{
+  static_mutex mutex_;
+
+  // The lists of free blocks of each class, and the total number of blocks in
+  // those lists.
+  free_block* lists_[block_classes];
+  std::size_t counts_[block_classes];
+
+  // The counts added by all threads.
+  memory_statistics statistics_;
+};
+
+thread_info_base::shared_cache& thread_info_base::get_shared_cache()
+{
+  static shared_cache cache = { ASIO_STATIC_MUTEX_INIT,
+    { 0 }, { 0 }, { 0, 0, 0, 0, 0, 0, 0 } };
+  static bool initialised = (cache.mutex_.init(), true);
+  (void)initialised;
+  return cache;
+}
+
+// The counts for threads that have no cache. Every such allocation and
+// deallocation goes to the heap, so these are the only counts needed.
+struct thread_info_base::untracked_statistics
+{
+  untracked_statistics()
+    : allocations_(0),
+      oversized_allocations_(0),
+      deallocations_(0)
+  {
+  }
+
+  atomic_count allocations_;
+  atomic_count oversized_allocations_;
+  atomic_count deallocations_;
+};
+
+thread_info_base::untracked_statistics&
+thread_info_base::get_untracked_statistics()
+{
+  static untracked_statistics statistics;
+  return statistics;
+}
+
+void* thread_info_base::allocate_oversized(
+    thread_info_base* this_thread, std::size_t size, std::size_t align)
+{
+  void* const pointer = aligned_new(align, size + 1);
+  static_cast<unsigned char*>(pointer)[size] = 0;
+
+  if (this_thread)
+  {
+    if ((++this_thread->statistics_.allocations % statistics_interval) == 0)
+      this_thread->flush_statistics();
+    ++this_thread->statistics_.heap_allocations;
+    ++this_thread->statistics_.oversized_allocations;
+  }
+  else
+  {
+    untracked_statistics& statistics = get_untracked_statistics();
+    increment(statistics.allocations_, 1);
+    increment(statistics.oversized_allocations_, 1);
+  }
+
+  return pointer;
+}
+
+void thread_info_base::deallocate_oversized(
+    thread_info_base* this_thread, void* pointer)
+{
+  if (this_thread)
+  {
+    ++this_thread->statistics_.deallocations;
+    ++this_thread->statistics_.heap_deallocations;
+  }
+  else
+    increment(get_untracked_statistics().deallocations_, 1);
+
+  aligned_delete(pointer);
+}
+
+void* thread_info_base::allocate_block(
+    thread_info_base* this_thread, std::size_t block)
+{
+  // A thread without a cache goes straight to the heap, without touching the
+  // shared cache or its lock.
+  if (!this_thread)
+  {
+    increment(get_untracked_statistics().allocations_, 1);
+    return aligned_new(ASIO_DEFAULT_ALIGN, block_size(block));
+  }
+
+  shared_cache& cache = get_shared_cache();
+  static_mutex::scoped_lock lock(cache.mutex_);
+  this_thread->move_statistics(cache.statistics_);
+
+  if (free_block* list = cache.lists_[block])
+  {
+    ++cache.statistics_.shared_cache_hits;
+
+    // Take the whole list, keeping the rest of its blocks for later.
+    cache.lists_[block] = list->next_list;
+    cache.counts_[block] -= list->count;
+    this_thread->free_lists_[block] = list->next;
+    this_thread->free_counts_[block] = list->count - 1;
+
+    return list;
+  }
+
+  ++cache.statistics_.heap_allocations;
+  lock.unlock();
+
+  return aligned_new(ASIO_DEFAULT_ALIGN, block_size(block));
+}
+
+void thread_info_base::deallocate_block(thread_info_base* this_thread,
+    std::size_t block, void* pointer)
+{
+  if (!this_thread)
+  {
+    increment(get_untracked_statistics().deallocations_, 1);
+    aligned_delete(pointer);
+    return;
+  }
+
+  free_block* b = static_cast<free_block*>(pointer);
+  b->next = 0;
+  b->next_list = 0;
+  b->count = 1;
+
+  free_block* excess = 0;
+  {
+    shared_cache& cache = get_shared_cache();
+    static_mutex::scoped_lock lock(cache.mutex_);
+
+    this_thread->move_statistics(cache.statistics_);
+
+    // Move the thread's full list to the shared cache, and start a new list
+    // with the freed block.
+    free_block* list = this_thread->free_lists_[block];
+    if (list)
+    {
+      list->count = this_thread->free_counts_[block];
+      this_thread->free_lists_[block] = b;
+      this_thread->free_counts_[block] = 1;
+    }
+    else
+    {
+      // The thread does not cache blocks of this class.
+      list = b;
+    }
+
+    if (cache.counts_[block] + list->count <= shared_cache_size)
+    {
+      list->next_list = cache.lists_[block];
+      cache.lists_[block] = list;
+      cache.counts_[block] += list->count;
+    }
+    else
+    {
+      cache.statistics_.heap_deallocations += list->count;
+      excess = list;
+    }
+  }
+
+  while (excess)
+  {
+    free_block* next = excess->next;
+    aligned_delete(excess);
+    excess = next;
+  }
+}
+
+void thread_info_base::flush_statistics()
+{
+  shared_cache& cache = get_shared_cache();
+  static_mutex::scoped_lock lock(cache.mutex_);
+  move_statistics(cache.statistics_);
+}
+
+void thread_info_base::release_memory()
+{
+  // Avoid taking the lock in tight io_context::poll_one() loops that do not
+  // allocate.
+  bool used = statistics_.allocations != 0 || statistics_.deallocations != 0;
+  for (int block = 0; block < block_classes && !used; ++block)
+    used = free_lists_[block] != 0;
+  if (!used)
+    return;
+
+  free_block* excess = 0;
+  {
+    shared_cache& cache = get_shared_cache();
+    static_mutex::scoped_lock lock(cache.mutex_);
+    move_statistics(cache.statistics_);
+
+    for (int block = 0; block < block_classes; ++block)
+    {
+      if (free_block* list = free_lists_[block])
+      {
+        list->count = free_counts_[block];
+        if (cache.counts_[block] + list->count <= shared_cache_size)
+        {
+          list->next_list = cache.lists_[block];
+          cache.lists_[block] = list;
+          cache.counts_[block] += list->count;
+        }
+        else
+        {
+          cache.statistics_.heap_deallocations += list->count;
+          list->next_list = excess;
+          excess = list;
+        }
+        free_lists_[block] = 0;
+        free_counts_[block] = 0;
+      }
+    }
+  }
+
+  while (excess)
+  {
+    free_block* next_list = excess->next_list;
+    while (excess)
+    {
+      free_block* next = excess->next;
+      aligned_delete(excess);
+      excess = next;
+    }
+    excess = next_list;
+  }
+}
+
+thread_info_base::memory_statistics thread_info_base::get_statistics(
+    thread_info_base* this_thread)
+{
+  memory_statistics statistics;
+  {
+    shared_cache& cache = get_shared_cache();
+    static_mutex::scoped_lock lock(cache.mutex_);
+    if (this_thread)
+      this_thread->move_statistics(cache.statistics_);
+    statistics = cache.statistics_;
+  }
+
+  untracked_statistics& untracked = get_untracked_statistics();
+  uint64_t allocations = static_cast<long>(untracked.allocations_);
+  uint64_t deallocations = static_cast<long>(untracked.deallocations_);
+  statistics.allocations += allocations;
+  statistics.heap_allocations += allocations;
+  statistics.oversized_allocations +=
+    static_cast<long>(untracked.oversized_allocations_);
+  statistics.deallocations += deallocations;
+  statistics.heap_deallocations += deallocations;
+  return statistics;
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_IMPL_THREAD_INFO_BASE_IPP
@@ -0,0 +1,346 @@
+//
+// detail/io_uring_reactor.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IO_URING_REACTOR_HPP
+#define ASIO_DETAIL_IO_URING_REACTOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_IO_URING)
+
+#include <linux/io_uring.h>
+#include "asio/detail/atomic_count.hpp"
+#include "asio/detail/conditionally_enabled_mutex.hpp"
+#include "asio/detail/limits.hpp"
+#include "asio/detail/object_pool.hpp"
+#include "asio/detail/op_queue.hpp"
+#include "asio/detail/reactor_op.hpp"
+#include "asio/detail/select_interrupter.hpp"
+#include "asio/detail/socket_types.hpp"
+#include "asio/detail/timer_queue_base.hpp"
+#include "asio/detail/timer_queue_set.hpp"
+#include "asio/detail/wait_op.hpp"
+#include "asio/execution_context.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+class io_uring_reactor
+  : public execution_context_service_base<io_uring_reactor>
+{
+private:
+  // The mutex type used by this reactor.
+  typedef conditionally_enabled_mutex mutex;
+
+public:
+  enum op_types { read_op = 0, write_op = 1,
+    connect_op = 1, except_op = 2, max_ops = 3 };
+
+  // Per-descriptor queues.
+  class descriptor_state : operation
+  {
+    friend class io_uring_reactor;
+    friend class object_pool_access;
+
+    descriptor_state* next_;
+    descriptor_state* prev_;
+
+    // The kind of request currently in the ring for each operation type.
+    enum request_type { no_request, poll_request, direct_request };
+
+    mutex mutex_;
+    io_uring_reactor* reactor_;
+    int descriptor_;
+    bool pollable_;
+    op_queue<reactor_op> op_queue_[max_ops];
+    bool try_speculative_[max_ops];
+    request_type request_[max_ops];
+    bool direct_eof_on_zero_[max_ops];
+    int requests_in_ring_;
+    bool shutdown_;
+    bool cleanup_pending_;
+
+    ASIO_DECL descriptor_state(bool locking);
+    void set_ready_events(uint32_t events) { task_result_ = events; }
+    void add_ready_events(uint32_t events) { task_result_ |= events; }
+    ASIO_DECL operation* perform_io(uint32_t events);
+    ASIO_DECL static void do_complete(
+        void* owner, operation* base,
+        const asio::error_code& ec, std::size_t bytes_transferred);
+  };
+
+  // Per-descriptor data.
+  typedef descriptor_state* per_descriptor_data;
+
+  // Constructor.
+  ASIO_DECL io_uring_reactor(asio::execution_context& ctx);
+
+  // Destructor.
+  ASIO_DECL ~io_uring_reactor();
+
+  // Destroy all user-defined handler objects owned by the service.
+  ASIO_DECL void shutdown();
+
+  // Recreate internal descriptors following a fork.
+  ASIO_DECL void notify_fork(
+      asio::execution_context::fork_event fork_ev);
+
+  // Initialise the task.
+  ASIO_DECL void init_task();
+
+  // Register a socket with the reactor. Returns 0 on success, system error
+  // code on failure.
+  ASIO_DECL int register_descriptor(socket_type descriptor,
+      per_descriptor_data& descriptor_data);
+
+  // Register a descriptor with an associated single operation. Returns 0 on
+  // success, system error code on failure.
+  ASIO_DECL int register_internal_descriptor(
+      int op_type, socket_type descriptor,
+      per_descriptor_data& descriptor_data, reactor_op* op);
+
+  // Move descriptor registration from one descriptor_data object to another.
+  ASIO_DECL void move_descriptor(socket_type descriptor,
+      per_descriptor_data& target_descriptor_data,
+      per_descriptor_data& source_descriptor_data);
+
+  // Post a reactor operation for immediate completion.
+  void post_immediate_completion(operation* op, bool is_continuation);
+
+  // Start a new operation. The reactor operation will be submitted to the
+  // kernel directly if it supports it, otherwise it will be performed when the
+  // given descriptor is flagged as ready, or an error has occurred.
+  ASIO_DECL void start_op(int op_type, socket_type descriptor,
+      per_descriptor_data& descriptor_data, reactor_op* op,
+      bool is_continuation, bool allow_speculative);
+
+  // Cancel all operations associated with the given descriptor. The
+  // handlers associated with the descriptor will be invoked with the
+  // operation_aborted error.
+  ASIO_DECL void cancel_ops(socket_type descriptor,
+      per_descriptor_data& descriptor_data);
+
+  // Cancel all operations associated with the given descriptor and key. The
+  // handlers associated with the descriptor will be invoked with the
+  // operation_aborted error.
+  ASIO_DECL void cancel_ops_by_key(socket_type descriptor,
+      per_descriptor_data& descriptor_data,
+      int op_type, void* cancellation_key);
+
+  // Cancel any operations that are running against the descriptor and remove
+  // its registration from the reactor. The reactor resources associated with
+  // the descriptor must be released by calling cleanup_descriptor_data.
+  ASIO_DECL void deregister_descriptor(socket_type descriptor,
+      per_descriptor_data& descriptor_data, bool closing);
+
+  // Remove the descriptor's registration from the reactor. The reactor
+  // resources associated with the descriptor must be released by calling
+  // cleanup_descriptor_data.
+  ASIO_DECL void deregister_internal_descriptor(
+      socket_type descriptor, per_descriptor_data& descriptor_data);
+
+  // Perform any post-deregistration cleanup tasks associated with the
+  // descriptor data.
+  ASIO_DECL void cleanup_descriptor_data(
+      per_descriptor_data& descriptor_data);
+
+  // Add a new timer queue to the reactor.
+  template <typename Time_Traits>
+  void add_timer_queue(timer_queue<Time_Traits>& timer_queue);
+
+  // Remove a timer queue from the reactor.
+  template <typename Time_Traits>
+  void remove_timer_queue(timer_queue<Time_Traits>& timer_queue);
+
+  // Schedule a new operation in the given timer queue to expire at the
+  // specified absolute time.
+  template <typename Time_Traits>
+  void schedule_timer(timer_queue<Time_Traits>& queue,
+      const typename Time_Traits::time_type& time,
+      typename timer_queue<Time_Traits>::per_timer_data& timer, wait_op* op);
+
+  // Cancel the timer operations associated with the given token. Returns the
+  // number of operations that have been posted or dispatched.
+  template <typename Time_Traits>
+  std::size_t cancel_timer(timer_queue<Time_Traits>& queue,
+      typename timer_queue<Time_Traits>::per_timer_data& timer,
+      std::size_t max_cancelled = (std::numeric_limits<std::size_t>::max)());
+
+  // Cancel the timer operations associated with the given key.
+  template <typename Time_Traits>
+  void cancel_timer_by_key(timer_queue<Time_Traits>& queue,
+      typename timer_queue<Time_Traits>::per_timer_data* timer,
+      void* cancellation_key);
+
+  // Move the timer operations associated with the given timer.
+  template <typename Time_Traits>
+  void move_timer(timer_queue<Time_Traits>& queue,
+      typename timer_queue<Time_Traits>::per_timer_data& target,
+      typename timer_queue<Time_Traits>::per_timer_data& source);
+
+  // Submit pending requests and wait once until interrupted or completions
+  // are ready to be dispatched.
+  ASIO_DECL void run(long usec, op_queue<operation>& ops);
+
+  // Interrupt the wait for completions.
+  ASIO_DECL void interrupt();
+
+private:
+  // The number of submission queue entries in the ring. The completion queue
+  // is sized by the kernel to twice this number.
+  enum { ring_size = 4096 };
+
+  // Submissions are flushed immediately once this many are pending.
+  enum { submit_batch_size = 128 };
+
+  // Create the ring and map its queues. Throws an exception if the ring cannot
+  // be created.
+  ASIO_DECL void do_ring_create();
+
+  // Unmap the ring's queues and close the ring descriptor.
+  ASIO_DECL void do_ring_destroy();
+
+  // Get a free submission queue entry, flushing pending submissions if the
+  // queue is full. Must be called with mutex_ held.
+  ASIO_DECL ::io_uring_sqe* get_sqe();
+
+  // Make the entry returned by get_sqe() visible to the kernel. Must be called
+  // with mutex_ held.
+  ASIO_DECL void commit_sqe();
+
+  // Submit all pending entries to the kernel. Must be called with mutex_ held.
+  ASIO_DECL void submit_sqes();
+
+  // Enter the kernel to submit entries and optionally wait for completions.
+  ASIO_DECL int do_enter(unsigned to_submit,
+      unsigned min_complete, long usec);
+
+  // Arm the interrupter's descriptor. Must be called with mutex_ held.
+  ASIO_DECL void start_interrupter_poll();
+
+  // Submit a request for the first operation of the given type. The operation
+  // is submitted directly only if allow_direct is true and the operation
+  // supports it, otherwise a poll request is submitted. Must be called with
+  // the descriptor's mutex held.
+  ASIO_DECL void start_request(descriptor_state* descriptor_data,
+      int op_type, bool allow_direct = true);
+
+  // Cancel the request of the given type that is in the ring. Must be called
+  // with the descriptor's mutex held.
+  ASIO_DECL void cancel_request(descriptor_state* descriptor_data,
+      int op_type);
+
+  // Process a completed request for a descriptor. Returns true if the
+  // descriptor has no requests left in the ring and is ready to be freed.
+  ASIO_DECL bool complete_request(descriptor_state* descriptor_data,
+      int op_type, int result, op_queue<operation>& ops);
+
+  // Cancel all direct requests and wait for the kernel to release them.
+  ASIO_DECL void drain_direct_requests();
+
+  // Allocate a new descriptor state object.
+  ASIO_DECL descriptor_state* allocate_descriptor_state();
+
+  // Free an existing descriptor state object.
+  ASIO_DECL void free_descriptor_state(descriptor_state* s);
+
+  // Helper function to add a new timer queue.
+  ASIO_DECL void do_add_timer_queue(timer_queue_base& queue);
+
+  // Helper function to remove a timer queue.
+  ASIO_DECL void do_remove_timer_queue(timer_queue_base& queue);
+
+  // Called to recalculate and update the timeout.
+  ASIO_DECL void update_timeout();
+
+  // Get the timeout value for the wait. The timeout value is returned as a
+  // number of microseconds, and is never negative.
+  ASIO_DECL long get_timeout(long usec);
+
+  // The scheduler implementation used to post completions.
+  scheduler& scheduler_;
+
+  // Mutex to protect access to internal data, including the submission queue.
+  mutex mutex_;
+
+  // The interrupter is used to break a blocking wait for completions.
+  select_interrupter interrupter_;
+
+  // The ring file descriptor.
+  int ring_fd_;
+
+  // The ring's parameters, as filled in by the kernel.
+  ::io_uring_params params_;
+
+  // The mapped submission queue ring, completion queue ring and entries.
+  void* sq_ring_;
+  std::size_t sq_ring_size_;
+  void* cq_ring_;
+  std::size_t cq_ring_size_;
+  ::io_uring_sqe* sqes_;
+
+  // Pointers into the submission queue ring.
+  unsigned* sq_head_;
+  unsigned* sq_tail_;
+  unsigned* sq_flags_;
+  unsigned* sq_array_;
+  unsigned sq_mask_;
+
+  // Pointers into the completion queue ring.
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  ::io_uring_cqe* cqes_;
+  unsigned cq_mask_;
+
+  // The number of entries that have been committed since the last submission.
+  unsigned pending_sqes_;
+
+  // Whether a thread is blocked waiting for completions.
+  bool waiting_;
+
+  // The number of direct requests that are in the ring.
+  atomic_count direct_requests_in_ring_;
+
+  // The timer queues.
+  timer_queue_set timer_queues_;
+
+  // Whether the service has been shut down.
+  bool shutdown_;
+
+  // Mutex to protect access to the registered descriptors.
+  mutex registered_descriptors_mutex_;
+
+  // Keep track of all registered descriptors.
+  object_pool<descriptor_state> registered_descriptors_;
+
+  // Helper class to do post-perform_io cleanup.
+  struct perform_io_cleanup_on_block_exit;
+  friend struct perform_io_cleanup_on_block_exit;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#include "asio/detail/impl/io_uring_reactor.hpp"
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/io_uring_reactor.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_HAS_IO_URING)
+
+#endif // ASIO_DETAIL_IO_URING_REACTOR_HPP
@@ -0,0 +1,166 @@
+//
+// detail/mpsc_op_queue.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_MPSC_OP_QUEUE_HPP
+#define ASIO_DETAIL_MPSC_OP_QUEUE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/detail/noncopyable.hpp"
+#include "asio/detail/op_queue.hpp"
+
+#if defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+# include <atomic>
+#else // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+# include "asio/detail/mutex.hpp"
+#endif // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+// An intrusive queue of operations that may be pushed to concurrently from
+// any number of threads without locking. Operations are removed only in bulk,
+// and are handed over in the order in which they were pushed.
+template <typename Operation>
+class mpsc_op_queue
+  : private noncopyable
+{
+public:
+  // Constructor.
+  mpsc_op_queue()
+    : head_(0)
+  {
+  }
+
+  // Destructor destroys all operations.
+  ~mpsc_op_queue()
+  {
+    op_queue<Operation> ops;
+    pop_all(ops);
+  }
+
+  // Push an operation. Returns true if the queue was empty beforehand.
+  bool push(Operation* o)
+  {
+    return push_chain(o, o);
+  }
+
+  // Push all operations from another queue, preserving their order. Returns
+  // true if this queue was empty beforehand. The source queue may contain
+  // operations of a derived type.
+  template <typename OtherOperation>
+  bool push(op_queue<OtherOperation>& q)
+  {
+    // The queue is held newest first, so link the operations in reverse.
+    Operation* first = 0;
+    Operation* last = 0;
+    while (Operation* o = q.front())
+    {
+      q.pop();
+      op_queue_access::next(o, first);
+      first = o;
+      if (!last)
+        last = o;
+    }
+    return first ? push_chain(first, last) : false;
+  }
+
+  // Move all operations to the back of the given queue.
+  void pop_all(op_queue<Operation>& ops)
+  {
+    Operation* o = exchange_head();
+
+    // Reverse the chain so that operations are dequeued oldest first.
+    Operation* reversed = 0;
+    while (o)
+    {
+      Operation* next = op_queue_access::next(o);
+      op_queue_access::next(o, reversed);
+      reversed = o;
+      o = next;
+    }
+
+    while (reversed)
+    {
+      Operation* next = op_queue_access::next(reversed);
+      ops.push(reversed);
+      reversed = next;
+    }
+  }
+
+  // Whether the queue is empty. The result may be stale by the time it is
+  // used, and is intended only to avoid unnecessary calls to pop_all().
+  bool empty() const
+  {
+#if defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+    return head_.load(std::memory_order_relaxed) == 0;
+#else // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+    mutex::scoped_lock lock(mutex_);
+    return head_ == 0;
+#endif // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+  }
+
+private:
+  // Push a chain of operations, linked newest first.
+  bool push_chain(Operation* first, Operation* last)
+  {
+#if defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+    Operation* head = head_.load(std::memory_order_relaxed);
+    do
+    {
+      op_queue_access::next(last, head);
+    } while (!head_.compare_exchange_weak(head, first,
+          std::memory_order_release, std::memory_order_relaxed));
+    return head == 0;
+#else // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+    mutex::scoped_lock lock(mutex_);
+    op_queue_access::next(last, head_);
+    bool was_empty = (head_ == 0);
+    head_ = first;
+    return was_empty;
+#endif // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+  }
+
+  // Detach all operations from the queue.
+  Operation* exchange_head()
+  {
+#if defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+    return head_.exchange(0, std::memory_order_acquire);
+#else // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+    mutex::scoped_lock lock(mutex_);
+    Operation* head = head_;
+    head_ = 0;
+    return head;
+#endif // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+  }
+
+#if defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+  // The most recently pushed operation.
+  std::atomic<Operation*> head_;
+#else // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+  // Mutex to protect access to the head of the queue.
+  mutable mutex mutex_;
+
+  // The most recently pushed operation.
+  Operation* head_;
+#endif // defined(ASIO_HAS_THREADS) && defined(ASIO_HAS_STD_ATOMIC)
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_MPSC_OP_QUEUE_HPP
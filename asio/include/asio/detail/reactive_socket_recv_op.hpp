@@ -46,6 +46,9 @@ public:
       buffers_(buffers),
       flags_(flags)
   {
+#if defined(ASIO_HAS_IO_URING)
+    this->direct_func_ = &reactive_socket_recv_op_base::do_prepare_direct;
+#endif // defined(ASIO_HAS_IO_URING)
   }
 
   static status do_perform(reactor_op* base)
@@ -85,6 +88,28 @@ public:
     return result;
   }
 
+#if defined(ASIO_HAS_IO_URING)
+  static bool do_prepare_direct(reactor_op* base, direct_request& req)
+  {
+    reactive_socket_recv_op_base* o(
+        static_cast<reactive_socket_recv_op_base*>(base));
+
+    typedef buffer_sequence_adapter<asio::mutable_buffer,
+        MutableBufferSequence> bufs_type;
+
+    if (!bufs_type::is_single_buffer)
+      return false;
+
+    req.type = direct_recv;
+    req.descriptor = o->socket_;
+    req.data = bufs_type::first(o->buffers_).data();
+    req.size = bufs_type::first(o->buffers_).size();
+    req.flags = o->flags_;
+    req.is_stream = (o->state_ & socket_ops::stream_oriented) != 0;
+    return true;
+  }
+#endif // defined(ASIO_HAS_IO_URING)
+
 private:
   socket_type socket_;
   socket_ops::state_type state_;
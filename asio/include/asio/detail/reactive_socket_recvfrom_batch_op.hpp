@@ -0,0 +1,167 @@
+//
+// detail/reactive_socket_recvfrom_batch_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_REACTIVE_SOCKET_RECVFROM_BATCH_OP_HPP
+#define ASIO_DETAIL_REACTIVE_SOCKET_RECVFROM_BATCH_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/buffer.hpp"
+#include "asio/detail/bind_handler.hpp"
+#include "asio/detail/fenced_block.hpp"
+#include "asio/detail/handler_alloc_helpers.hpp"
+#include "asio/detail/handler_invoke_helpers.hpp"
+#include "asio/detail/handler_work.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/reactor_op.hpp"
+#include "asio/detail/socket_ops.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+template <typename Endpoint>
+class reactive_socket_recvfrom_batch_op_base : public reactor_op
+{
+public:
+  reactive_socket_recvfrom_batch_op_base(const asio::error_code& success_ec,
+      socket_type socket, const mutable_buffer* buffers, Endpoint* senders,
+      std::size_t* sizes, std::size_t count,
+      socket_base::message_flags flags, func_type complete_func)
+    : reactor_op(success_ec,
+        &reactive_socket_recvfrom_batch_op_base::do_perform, complete_func),
+      socket_(socket),
+      buffers_(buffers),
+      senders_(senders),
+      sizes_(sizes),
+      count_(count),
+      flags_(flags)
+  {
+  }
+
+  static status do_perform(reactor_op* base)
+  {
+    reactive_socket_recvfrom_batch_op_base* o(
+        static_cast<reactive_socket_recvfrom_batch_op_base*>(base));
+
+    std::size_t count = o->count_;
+    if (count > socket_ops::max_datagram_batch)
+      count = socket_ops::max_datagram_batch;
+
+    socket_ops::datagram_buf dgrams[socket_ops::max_datagram_batch];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      socket_ops::init_buf(dgrams[i].data,
+          o->buffers_[i].data(), o->buffers_[i].size());
+      dgrams[i].addr = o->senders_[i].data();
+      dgrams[i].addrlen = o->senders_[i].capacity();
+      dgrams[i].bytes_transferred = 0;
+    }
+
+    status result = socket_ops::non_blocking_recvmmsg(o->socket_,
+        dgrams, count, o->flags_, o->ec_, o->bytes_transferred_)
+      ? done : not_done;
+
+    if (result && !o->ec_)
+    {
+      for (std::size_t i = 0; i < o->bytes_transferred_; ++i)
+      {
+        o->senders_[i].resize(dgrams[i].addrlen);
+        o->sizes_[i] = dgrams[i].bytes_transferred;
+      }
+    }
+
+    ASIO_HANDLER_REACTOR_OPERATION((*o, "non_blocking_recvmmsg",
+          o->ec_, o->bytes_transferred_));
+
+    return result;
+  }
+
+private:
+  socket_type socket_;
+  const mutable_buffer* buffers_;
+  Endpoint* senders_;
+  std::size_t* sizes_;
+  std::size_t count_;
+  socket_base::message_flags flags_;
+};
+
+template <typename Endpoint, typename Handler, typename IoExecutor>
+class reactive_socket_recvfrom_batch_op :
+  public reactive_socket_recvfrom_batch_op_base<Endpoint>
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(reactive_socket_recvfrom_batch_op);
+
+  reactive_socket_recvfrom_batch_op(const asio::error_code& success_ec,
+      socket_type socket, const mutable_buffer* buffers, Endpoint* senders,
+      std::size_t* sizes, std::size_t count,
+      socket_base::message_flags flags, Handler& handler,
+      const IoExecutor& io_ex)
+    : reactive_socket_recvfrom_batch_op_base<Endpoint>(success_ec, socket,
+        buffers, senders, sizes, count, flags,
+        &reactive_socket_recvfrom_batch_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const asio::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    reactive_socket_recvfrom_batch_op* o(
+        static_cast<reactive_socket_recvfrom_batch_op*>(base));
+    ptr p = { asio::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, asio::error_code, std::size_t>
+      handler(o->handler_, o->ec_, o->bytes_transferred_);
+    p.h = asio::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_REACTIVE_SOCKET_RECVFROM_BATCH_OP_HPP
@@ -0,0 +1,187 @@
+//
+// detail/reactive_socket_send_zero_copy_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_REACTIVE_SOCKET_SEND_ZERO_COPY_OP_HPP
+#define ASIO_DETAIL_REACTIVE_SOCKET_SEND_ZERO_COPY_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_MSG_ZEROCOPY)
+
+#include "asio/detail/bind_handler.hpp"
+#include "asio/detail/buffer_sequence_adapter.hpp"
+#include "asio/detail/fenced_block.hpp"
+#include "asio/detail/handler_alloc_helpers.hpp"
+#include "asio/detail/handler_invoke_helpers.hpp"
+#include "asio/detail/handler_work.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/reactor_op.hpp"
+#include "asio/detail/socket_ops.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+// Sends data without copying it into the kernel, using MSG_ZEROCOPY. The
+// operation stays at the head of the reactor's write queue until the kernel
+// reports, via the socket's error queue, that it has finished with the
+// buffers. This also prevents later writes from overtaking it.
+template <typename ConstBufferSequence>
+class reactive_socket_send_zero_copy_op_base : public reactor_op
+{
+public:
+  reactive_socket_send_zero_copy_op_base(const asio::error_code& success_ec,
+      socket_type socket, socket_ops::zero_copy_state& zero_copy_state,
+      const ConstBufferSequence& buffers,
+      socket_base::message_flags flags, func_type complete_func)
+    : reactor_op(success_ec,
+        &reactive_socket_send_zero_copy_op_base::do_perform, complete_func),
+      socket_(socket),
+      zero_copy_state_(zero_copy_state),
+      buffers_(buffers),
+      flags_(flags),
+      seq_(0),
+      completion_pending_(false)
+  {
+  }
+
+  static status do_perform(reactor_op* base)
+  {
+    reactive_socket_send_zero_copy_op_base* o(
+        static_cast<reactive_socket_send_zero_copy_op_base*>(base));
+
+    if (!o->completion_pending_)
+    {
+      typedef buffer_sequence_adapter<asio::const_buffer,
+          ConstBufferSequence> bufs_type;
+
+      bufs_type bufs(o->buffers_);
+
+      // Small writes are cheaper to copy than to track.
+      bool result;
+      if (bufs.total_size() < min_zero_copy_size)
+      {
+        result = socket_ops::non_blocking_send(o->socket_,
+            bufs.buffers(), bufs.count(), o->flags_,
+            o->ec_, o->bytes_transferred_);
+      }
+      else
+      {
+        result = socket_ops::non_blocking_send_zero_copy(o->socket_,
+            bufs.buffers(), bufs.count(), o->flags_, o->zero_copy_state_,
+            o->seq_, o->completion_pending_, o->ec_, o->bytes_transferred_);
+      }
+
+      ASIO_HANDLER_REACTOR_OPERATION((*o, "non_blocking_send_zero_copy",
+            o->ec_, o->bytes_transferred_));
+
+      if (!result)
+        return not_done;
+      if (!o->completion_pending_)
+        return done;
+    }
+
+    // Wait until the kernel has finished with the buffers.
+    asio::error_code ec;
+    if (!socket_ops::non_blocking_zero_copy_complete(
+          o->socket_, o->zero_copy_state_, o->seq_, ec))
+      return not_done;
+
+    if (ec)
+      o->ec_ = ec;
+    return done;
+  }
+
+private:
+  // The smallest write for which a zero-copy send is attempted.
+  enum { min_zero_copy_size = 16384 };
+
+  socket_type socket_;
+  socket_ops::zero_copy_state& zero_copy_state_;
+  ConstBufferSequence buffers_;
+  socket_base::message_flags flags_;
+  uint32_t seq_;
+  bool completion_pending_;
+};
+
+template <typename ConstBufferSequence, typename Handler, typename IoExecutor>
+class reactive_socket_send_zero_copy_op :
+  public reactive_socket_send_zero_copy_op_base<ConstBufferSequence>
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(reactive_socket_send_zero_copy_op);
+
+  reactive_socket_send_zero_copy_op(const asio::error_code& success_ec,
+      socket_type socket, socket_ops::zero_copy_state& zero_copy_state,
+      const ConstBufferSequence& buffers, socket_base::message_flags flags,
+      Handler& handler, const IoExecutor& io_ex)
+    : reactive_socket_send_zero_copy_op_base<ConstBufferSequence>(
+        success_ec, socket, zero_copy_state, buffers, flags,
+        &reactive_socket_send_zero_copy_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const asio::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    reactive_socket_send_zero_copy_op* o(
+        static_cast<reactive_socket_send_zero_copy_op*>(base));
+    ptr p = { asio::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, asio::error_code, std::size_t>
+      handler(o->handler_, o->ec_, o->bytes_transferred_);
+    p.h = asio::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_MSG_ZEROCOPY)
+
+#endif // ASIO_DETAIL_REACTIVE_SOCKET_SEND_ZERO_COPY_OP_HPP
@@ -29,8 +29,12 @@
 #include "asio/detail/reactive_null_buffers_op.hpp"
 #include "asio/detail/reactive_socket_accept_op.hpp"
 #include "asio/detail/reactive_socket_connect_op.hpp"
+#include "asio/detail/reactive_socket_recvfrom_batch_op.hpp"
 #include "asio/detail/reactive_socket_recvfrom_op.hpp"
+#include "asio/detail/reactive_socket_recvfrom_segments_op.hpp"
+#include "asio/detail/reactive_socket_sendto_batch_op.hpp"
 #include "asio/detail/reactive_socket_sendto_op.hpp"
+#include "asio/detail/reactive_socket_sendto_segments_op.hpp"
 #include "asio/detail/reactive_socket_service_base.hpp"
 #include "asio/detail/reactor.hpp"
 #include "asio/detail/reactor_op.hpp"
@@ -319,6 +323,133 @@ public:
     p.v = p.p = 0;
   }
 
+  // Send a batch of datagrams, each to its own endpoint. Returns the number of
+  // datagrams sent.
+  size_t send_batch(implementation_type& impl, const const_buffer* buffers,
+      const endpoint_type* destinations, std::size_t count,
+      socket_base::message_flags flags, asio::error_code& ec)
+  {
+    std::size_t total = 0;
+    while (total < count)
+    {
+      std::size_t n = count - total;
+      if (n > socket_ops::max_datagram_batch)
+        n = socket_ops::max_datagram_batch;
+
+      socket_ops::datagram_buf dgrams[socket_ops::max_datagram_batch];
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        socket_ops::init_buf(dgrams[i].data,
+            buffers[total + i].data(), buffers[total + i].size());
+        dgrams[i].addr = const_cast<socket_addr_type*>(
+            destinations[total + i].data());
+        dgrams[i].addrlen = destinations[total + i].size();
+        dgrams[i].bytes_transferred = 0;
+      }
+
+      total += socket_ops::sync_sendmmsg(impl.socket_,
+          impl.state_, dgrams, n, flags, ec);
+      if (ec)
+        break;
+    }
+
+    return total;
+  }
+
+  // Start an asynchronous send of a batch of datagrams. The buffers and
+  // destination endpoints must be valid for the lifetime of the asynchronous
+  // operation.
+  template <typename Handler, typename IoExecutor>
+  void async_send_batch(implementation_type& impl,
+      const const_buffer* buffers, const endpoint_type* destinations,
+      std::size_t count, socket_base::message_flags flags,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    typename associated_cancellation_slot<Handler>::type slot
+      = asio::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_socket_sendto_batch_op<
+        endpoint_type, Handler, IoExecutor> op;
+    typename op::ptr p = { asio::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, impl.socket_,
+        buffers, destinations, count, flags, handler, io_ex);
+
+    // Optionally register for per-operation cancellation.
+    if (slot.is_connected())
+    {
+      p.p->cancellation_key_ =
+        &slot.template emplace<reactor_op_cancellation>(
+            &reactor_, &impl.reactor_data_, impl.socket_, reactor::write_op);
+    }
+
+    ASIO_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
+          &impl, impl.socket_, "async_send_batch"));
+
+    start_op(impl, reactor::write_op, p.p, is_continuation, true, count == 0);
+    p.v = p.p = 0;
+  }
+
+#if defined(ASIO_HAS_UDP_GSO)
+  // Send data to the specified endpoint as a sequence of datagrams of the
+  // given size. Returns the number of bytes sent.
+  template <typename ConstBufferSequence>
+  size_t send_segments(implementation_type& impl,
+      const ConstBufferSequence& buffers, const endpoint_type& destination,
+      std::size_t segment_size, socket_base::message_flags flags,
+      asio::error_code& ec)
+  {
+    buffer_sequence_adapter<asio::const_buffer,
+        ConstBufferSequence> bufs(buffers);
+
+    return socket_ops::sync_sendto_segments(impl.socket_, impl.state_,
+        bufs.buffers(), bufs.count(), flags, destination.data(),
+        destination.size(), segment_size, ec);
+  }
+
+  // Start an asynchronous send of data as a sequence of datagrams of the given
+  // size. The data being sent must be valid for the lifetime of the
+  // asynchronous operation.
+  template <typename ConstBufferSequence, typename Handler, typename IoExecutor>
+  void async_send_segments(implementation_type& impl,
+      const ConstBufferSequence& buffers, const endpoint_type& destination,
+      std::size_t segment_size, socket_base::message_flags flags,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    typename associated_cancellation_slot<Handler>::type slot
+      = asio::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_socket_sendto_segments_op<ConstBufferSequence,
+        endpoint_type, Handler, IoExecutor> op;
+    typename op::ptr p = { asio::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, impl.socket_, buffers,
+        destination, segment_size, flags, handler, io_ex);
+
+    // Optionally register for per-operation cancellation.
+    if (slot.is_connected())
+    {
+      p.p->cancellation_key_ =
+        &slot.template emplace<reactor_op_cancellation>(
+            &reactor_, &impl.reactor_data_, impl.socket_, reactor::write_op);
+    }
+
+    ASIO_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
+          &impl, impl.socket_, "async_send_segments"));
+
+    start_op(impl, reactor::write_op, p.p, is_continuation, true, false);
+    p.v = p.p = 0;
+  }
+#endif // defined(ASIO_HAS_UDP_GSO)
+
   // Receive a datagram with the endpoint of the sender. Returns the number of
   // bytes received.
   template <typename MutableBufferSequence>
@@ -449,6 +580,143 @@ public:
     p.v = p.p = 0;
   }
 
+  // Receive a batch of datagrams with the endpoint of each sender. Returns the
+  // number of datagrams received.
+  size_t receive_batch(implementation_type& impl,
+      const mutable_buffer* buffers, endpoint_type* senders,
+      std::size_t* sizes, std::size_t count,
+      socket_base::message_flags flags, asio::error_code& ec)
+  {
+    if (count > socket_ops::max_datagram_batch)
+      count = socket_ops::max_datagram_batch;
+
+    socket_ops::datagram_buf dgrams[socket_ops::max_datagram_batch];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      socket_ops::init_buf(dgrams[i].data,
+          buffers[i].data(), buffers[i].size());
+      dgrams[i].addr = senders[i].data();
+      dgrams[i].addrlen = senders[i].capacity();
+      dgrams[i].bytes_transferred = 0;
+    }
+
+    std::size_t datagrams = socket_ops::sync_recvmmsg(impl.socket_,
+        impl.state_, dgrams, count, flags, ec);
+
+    if (!ec)
+    {
+      for (std::size_t i = 0; i < datagrams; ++i)
+      {
+        senders[i].resize(dgrams[i].addrlen);
+        sizes[i] = dgrams[i].bytes_transferred;
+      }
+    }
+
+    return datagrams;
+  }
+
+  // Start an asynchronous receive of a batch of datagrams. The buffers, sender
+  // endpoints and sizes must be valid for the lifetime of the asynchronous
+  // operation.
+  template <typename Handler, typename IoExecutor>
+  void async_receive_batch(implementation_type& impl,
+      const mutable_buffer* buffers, endpoint_type* senders,
+      std::size_t* sizes, std::size_t count,
+      socket_base::message_flags flags, Handler& handler,
+      const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    typename associated_cancellation_slot<Handler>::type slot
+      = asio::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_socket_recvfrom_batch_op<
+        endpoint_type, Handler, IoExecutor> op;
+    typename op::ptr p = { asio::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, impl.socket_,
+        buffers, senders, sizes, count, flags, handler, io_ex);
+
+    // Optionally register for per-operation cancellation.
+    if (slot.is_connected())
+    {
+      p.p->cancellation_key_ =
+        &slot.template emplace<reactor_op_cancellation>(
+            &reactor_, &impl.reactor_data_, impl.socket_, reactor::read_op);
+    }
+
+    ASIO_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
+          &impl, impl.socket_, "async_receive_batch"));
+
+    start_op(impl, reactor::read_op, p.p, is_continuation, true, count == 0);
+    p.v = p.p = 0;
+  }
+
+#if defined(ASIO_HAS_UDP_GSO)
+  // Receive one or more datagrams of the same size that have been coalesced
+  // by the kernel. Returns the number of bytes received.
+  template <typename MutableBufferSequence>
+  size_t receive_segments(implementation_type& impl,
+      const MutableBufferSequence& buffers, endpoint_type& sender_endpoint,
+      std::size_t& segment_size, socket_base::message_flags flags,
+      asio::error_code& ec)
+  {
+    buffer_sequence_adapter<asio::mutable_buffer,
+        MutableBufferSequence> bufs(buffers);
+
+    std::size_t addr_len = sender_endpoint.capacity();
+    std::size_t bytes_recvd = socket_ops::sync_recvfrom_segments(
+        impl.socket_, impl.state_, bufs.buffers(), bufs.count(), flags,
+        sender_endpoint.data(), &addr_len, &segment_size, ec);
+
+    if (!ec)
+      sender_endpoint.resize(addr_len);
+
+    return bytes_recvd;
+  }
+
+  // Start an asynchronous receive of coalesced datagrams. The buffer for the
+  // data being received, the sender_endpoint and the segment_size must all be
+  // valid for the lifetime of the asynchronous operation.
+  template <typename MutableBufferSequence,
+      typename Handler, typename IoExecutor>
+  void async_receive_segments(implementation_type& impl,
+      const MutableBufferSequence& buffers, endpoint_type& sender_endpoint,
+      std::size_t& segment_size, socket_base::message_flags flags,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    typename associated_cancellation_slot<Handler>::type slot
+      = asio::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_socket_recvfrom_segments_op<MutableBufferSequence,
+        endpoint_type, Handler, IoExecutor> op;
+    typename op::ptr p = { asio::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, impl.socket_, buffers,
+        sender_endpoint, segment_size, flags, handler, io_ex);
+
+    // Optionally register for per-operation cancellation.
+    if (slot.is_connected())
+    {
+      p.p->cancellation_key_ =
+        &slot.template emplace<reactor_op_cancellation>(
+            &reactor_, &impl.reactor_data_, impl.socket_, reactor::read_op);
+    }
+
+    ASIO_HANDLER_CREATION((reactor_.context(), *p.p, "socket",
+          &impl, impl.socket_, "async_receive_segments"));
+
+    start_op(impl, reactor::read_op, p.p, is_continuation, true, false);
+    p.v = p.p = 0;
+  }
+#endif // defined(ASIO_HAS_UDP_GSO)
+
   // Accept a new connection.
   template <typename Socket>
   asio::error_code accept(implementation_type& impl,
@@ -46,6 +46,30 @@ public:
     return perform_func_(this);
   }
 
+#if defined(ASIO_HAS_IO_URING)
+  // The kinds of request that may be submitted directly to the kernel.
+  enum direct_type { direct_recv, direct_send };
+
+  // Describes a request that may be submitted directly to the kernel, rather
+  // than waiting for the descriptor to become ready and calling perform().
+  struct direct_request
+  {
+    direct_type type;
+    int descriptor;
+    void* data;
+    std::size_t size;
+    int flags;
+    bool is_stream;
+  };
+
+  // Prepare a direct request for the operation. Returns false if the operation
+  // does not support direct submission.
+  bool prepare_direct(direct_request& req)
+  {
+    return direct_func_ ? direct_func_(this, req) : false;
+  }
+#endif // defined(ASIO_HAS_IO_URING)
+
 protected:
   typedef status (*perform_func_type)(reactor_op*);
 
@@ -55,10 +79,20 @@ protected:
       ec_(success_ec),
       cancellation_key_(0),
       bytes_transferred_(0),
+#if defined(ASIO_HAS_IO_URING)
+      direct_func_(0),
+#endif // defined(ASIO_HAS_IO_URING)
       perform_func_(perform_func)
   {
   }
 
+#if defined(ASIO_HAS_IO_URING)
+  typedef bool (*direct_func_type)(reactor_op*, direct_request&);
+
+  // Set by derived operation types that support direct submission.
+  direct_func_type direct_func_;
+#endif // defined(ASIO_HAS_IO_URING)
+
 private:
   perform_func_type perform_func_;
 };
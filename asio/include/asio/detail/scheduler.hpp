@@ -17,14 +17,18 @@
 
 #include "asio/detail/config.hpp"
 
+#include <vector>
 #include "asio/error_code.hpp"
 #include "asio/execution_context.hpp"
 #include "asio/detail/atomic_count.hpp"
 #include "asio/detail/conditionally_enabled_event.hpp"
 #include "asio/detail/conditionally_enabled_mutex.hpp"
+#include "asio/detail/mpsc_op_queue.hpp"
 #include "asio/detail/op_queue.hpp"
 #include "asio/detail/reactor_fwd.hpp"
+#include "asio/detail/scheduler_metrics.hpp"
 #include "asio/detail/scheduler_operation.hpp"
+#include "asio/detail/stall_detector.hpp"
 #include "asio/detail/thread.hpp"
 #include "asio/detail/thread_context.hpp"
 
@@ -109,6 +113,13 @@ public:
   ASIO_DECL void post_immediate_completion(
       operation* op, bool is_continuation);
 
+  // Request invocation of an operation that completed within its initiating
+  // function. If inline completion is enabled and the calling thread is
+  // running the scheduler, the operation is invoked before returning.
+  // Otherwise it is posted as for post_immediate_completion().
+  ASIO_DECL void post_speculative_completion(
+      operation* op, bool is_continuation);
+
   // Request invocation of the given operations and return immediately. Assumes
   // that work_started() has not yet been called for the operations.
   ASIO_DECL void post_immediate_completions(std::size_t n,
@@ -136,6 +147,61 @@ public:
     return concurrency_hint_;
   }
 
+  // Set the tuning options used by the task. Must be called before the task
+  // is initialised.
+  void set_task_options(std::size_t event_batch_size, long busy_poll_usec)
+  {
+    task_event_batch_size_ = event_batch_size;
+    task_busy_poll_usec_ = busy_poll_usec;
+  }
+
+  // Get the maximum number of events the task should dequeue per wait. A value
+  // of 0 means the task's default is used.
+  std::size_t task_event_batch_size() const
+  {
+    return task_event_batch_size_;
+  }
+
+  // Get the number of microseconds the task should spin polling for events
+  // before blocking. A value of 0 disables busy polling.
+  long task_busy_poll_usec() const
+  {
+    return task_busy_poll_usec_;
+  }
+
+  // Set the maximum nesting depth at which completed operations may be invoked
+  // from within their initiating functions. A value of 0 disables this.
+  void set_inline_completion_depth(std::size_t depth)
+  {
+    inline_completion_depth_ = depth;
+  }
+
+  // Set the object used to collect metrics. Must be called before the
+  // scheduler is used.
+  void set_metrics(scheduler_metrics* metrics)
+  {
+    metrics_ = metrics;
+  }
+
+  // Get the object used to collect metrics, or 0 if they are not collected.
+  scheduler_metrics* metrics() const
+  {
+    return metrics_;
+  }
+
+  // Set the object used to detect stalled handlers. Must be called before the
+  // scheduler is used.
+  void set_stall_detector(stall_detector* detector)
+  {
+    stall_detector_ = detector;
+  }
+
+  // Get the amount of outstanding work.
+  long outstanding_work() const
+  {
+    return outstanding_work_;
+  }
+
 private:
   // The mutex type used by this scheduler.
   typedef conditionally_enabled_mutex mutex;
@@ -158,6 +224,40 @@ private:
   ASIO_DECL std::size_t do_poll_one(mutex::scoped_lock& lock,
       thread_info& this_thread, const asio::error_code& ec);
 
+  // Queue operations on the current thread's stealable queue, waking an idle
+  // thread to steal them if there is one.
+  ASIO_DECL void post_stealable(thread_info& this_thread, operation* op);
+  ASIO_DECL void post_stealable(thread_info& this_thread,
+      op_queue<operation>& ops);
+
+  // Run at most one operation from the current thread's stealable queue,
+  // without taking the scheduler's lock.
+  ASIO_DECL std::size_t do_run_one_stealable(mutex::scoped_lock& lock,
+      thread_info& this_thread, const asio::error_code& ec);
+
+  // Take an operation from the stealable queue of a randomly chosen thread.
+  // Assumes that the mutex is held.
+  ASIO_DECL operation* steal_one(thread_info& this_thread);
+
+  // Get the current thread's info if it may queue stealable operations.
+  ASIO_DECL thread_info* stealable_thread_info();
+
+  // Queue an operation that may be posted from any thread, waking a thread if
+  // needed. Assumes that work_started() was previously called.
+  ASIO_DECL void post_remote(operation* op);
+
+  // Queue operations that may be posted from any thread, waking a thread if
+  // needed. Assumes that work_started() was previously called.
+  ASIO_DECL void post_remote(op_queue<operation>& ops);
+
+  // Move remotely posted operations to the main queue. Assumes that the mutex
+  // is held.
+  void collect_remote_ops()
+  {
+    if (!remote_op_queue_.empty())
+      remote_op_queue_.pop_all(op_queue_);
+  }
+
   // Stop the task and all idle threads.
   ASIO_DECL void stop_all_threads(mutex::scoped_lock& lock);
 
@@ -177,9 +277,23 @@ private:
   struct work_cleanup;
   friend struct work_cleanup;
 
+  // Helper class to return a thread's stealable operations on block exit.
+  struct stealable_cleanup;
+  friend struct stealable_cleanup;
+
+  // Helper class to end an inline completion on block exit.
+  struct inline_completion_cleanup;
+
   // Whether to optimise for single-threaded use cases.
   const bool one_thread_;
 
+  // Whether each thread has its own queue from which other threads may steal.
+  const bool work_stealing_;
+
+  // The maximum number of operations a thread runs from its stealable queue
+  // before it next checks the main queue.
+  enum { max_stealable_run = 61 };
+
   // Mutex to protect access to internal data.
   mutable mutex mutex_;
 
@@ -204,6 +318,17 @@ private:
   // The queue of handlers that are ready to be delivered.
   op_queue<operation> op_queue_;
 
+  // Handlers posted from threads that are not running the scheduler. These are
+  // queued without locking, and are moved to op_queue_ by whichever thread
+  // next dequeues a handler.
+  mpsc_op_queue<operation> remote_op_queue_;
+
+  // The threads with stealable queues. Protected by the mutex.
+  std::vector<thread_info*> stealable_threads_;
+
+  // The number of threads waiting for work that are able to steal it.
+  atomic_count idle_stealers_;
+
   // Flag to indicate that the dispatcher has been stopped.
   bool stopped_;
 
@@ -213,6 +338,22 @@ private:
   // The concurrency hint used to initialise the scheduler.
   const int concurrency_hint_;
 
+  // The maximum number of events to be dequeued by the task per wait.
+  std::size_t task_event_batch_size_;
+
+  // The duration for which the task should busy poll before blocking.
+  long task_busy_poll_usec_;
+
+  // The maximum nesting depth of operations invoked from within their
+  // initiating functions.
+  std::size_t inline_completion_depth_;
+
+  // The object used to collect metrics, if any.
+  scheduler_metrics* metrics_;
+
+  // The object used to detect stalled handlers, if any.
+  stall_detector* stall_detector_;
+
   // The thread that is running the scheduler.
   asio::detail::thread* thread_;
 };
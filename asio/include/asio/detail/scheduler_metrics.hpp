@@ -0,0 +1,335 @@
+//
+// detail/scheduler_metrics.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_SCHEDULER_METRICS_HPP
+#define ASIO_DETAIL_SCHEDULER_METRICS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <vector>
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/op_queue.hpp"
+#include "asio/detail/scheduler_operation.hpp"
+#include "asio/execution_context.hpp"
+
+#if defined(ASIO_HAS_IO_CONTEXT_METRICS)
+# include <atomic>
+# include "asio/detail/chrono.hpp"
+#endif // defined(ASIO_HAS_IO_CONTEXT_METRICS)
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+// Buckets durations, in nanoseconds, for a histogram. Values below 16 have a
+// bucket each. Above that, each power of two is split into 8 buckets, so a
+// value's bucket identifies it to within 12.5%.
+struct duration_histogram_buckets
+{
+  enum { sub_buckets = 8, count = 62 * sub_buckets };
+
+  // Get the bucket that holds a value.
+  static std::size_t bucket(uint64_t value)
+  {
+    int shift = 0;
+    for (uint64_t v = value >> 4; v != 0; v >>= 1)
+      ++shift;
+    return static_cast<std::size_t>(value >> shift) + shift * sub_buckets;
+  }
+
+  // Get the smallest value held by a bucket.
+  static uint64_t lower_bound(std::size_t bucket)
+  {
+    if (bucket < 2 * sub_buckets)
+      return bucket;
+    std::size_t shift = bucket / sub_buckets - 1;
+    return static_cast<uint64_t>(sub_buckets + bucket % sub_buckets) << shift;
+  }
+};
+
+#if defined(ASIO_HAS_IO_CONTEXT_METRICS)
+
+// Counters describing the load on an io_context. The service is created only
+// when metrics are requested, and the scheduler and reactor update it only if
+// it exists. All counters are atomic, so they may be read from any thread
+// without locking.
+class scheduler_metrics
+  : public execution_context_service_base<scheduler_metrics>
+{
+public:
+  // Constructor.
+  explicit scheduler_metrics(execution_context& ctx)
+    : execution_context_service_base<scheduler_metrics>(ctx)
+  {
+    std::atomic<uint64_t>* counters[] = { &operations_queued_,
+      &operations_executed_, &wakeups_, &task_runs_, &task_time_,
+      &handler_time_, &reactor_waits_, &reactor_events_ };
+    for (std::size_t i = 0; i < sizeof(counters) / sizeof(counters[0]); ++i)
+      counters[i]->store(0, std::memory_order_relaxed);
+    registered_descriptors_.store(0, std::memory_order_relaxed);
+    pending_timers_.store(0, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < duration_histogram_buckets::count; ++i)
+    {
+      queue_delay_[i].store(0, std::memory_order_relaxed);
+      run_time_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // Destroy all user-defined handler objects owned by the service.
+  void shutdown()
+  {
+  }
+
+  // Measures a handler's run time and the time it waited in the queue.
+  class execution_scope
+  {
+  public:
+    execution_scope(scheduler_metrics* metrics, scheduler_operation* op)
+      : metrics_(metrics),
+        start_(metrics ? now() : 0)
+    {
+      if (metrics_ && op->queued_time_ != 0)
+      {
+        unsigned int ticks = static_cast<unsigned int>(start_ >> tick_shift)
+          - op->queued_time_;
+        metrics_->record(metrics_->queue_delay_,
+            static_cast<uint64_t>(ticks) << tick_shift);
+      }
+    }
+
+    ~execution_scope()
+    {
+      if (metrics_)
+      {
+        uint64_t elapsed = now() - start_;
+        add(metrics_->operations_executed_, 1);
+        add(metrics_->handler_time_, elapsed);
+        metrics_->record(metrics_->run_time_, elapsed);
+      }
+    }
+
+  private:
+    scheduler_metrics* metrics_;
+    uint64_t start_;
+  };
+
+  // Measures the time spent running the task.
+  class task_scope
+  {
+  public:
+    explicit task_scope(scheduler_metrics* metrics)
+      : metrics_(metrics),
+        start_(metrics ? now() : 0)
+    {
+    }
+
+    ~task_scope()
+    {
+      if (metrics_)
+      {
+        add(metrics_->task_runs_, 1);
+        add(metrics_->task_time_, now() - start_);
+      }
+    }
+
+  private:
+    scheduler_metrics* metrics_;
+    uint64_t start_;
+  };
+
+  // Record that an operation has been queued for execution.
+  void operation_queued(scheduler_operation* op)
+  {
+    op->queued_time_ = queued_time();
+    add(operations_queued_, 1);
+  }
+
+  // Record that a number of operations have been queued for execution.
+  void operations_queued(op_queue<scheduler_operation>& ops)
+  {
+    unsigned int t = queued_time();
+    uint64_t n = 0;
+    for (scheduler_operation* op = ops.front();
+        op; op = op_queue_access::next(op), ++n)
+      op->queued_time_ = t;
+    add(operations_queued_, n);
+  }
+
+  // Record that a sleeping thread was woken, or the task interrupted.
+  void wakeup()
+  {
+    add(wakeups_, 1);
+  }
+
+  // Record a wait by the reactor and the number of events it returned.
+  void reactor_wait(int events)
+  {
+    add(reactor_waits_, 1);
+    if (events > 0)
+      add(reactor_events_, static_cast<uint64_t>(events));
+  }
+
+  // Record that a descriptor has been registered with the reactor.
+  void descriptor_registered()
+  {
+    registered_descriptors_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Record that a descriptor has been deregistered from the reactor.
+  void descriptor_deregistered()
+  {
+    registered_descriptors_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // Record that a timer wait has been started.
+  void timer_scheduled()
+  {
+    pending_timers_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Record that timer waits have expired or been cancelled.
+  void timers_finished(std::size_t n)
+  {
+    pending_timers_.fetch_sub(static_cast<long>(n),
+        std::memory_order_relaxed);
+  }
+
+  // Record that the timer waits in a queue have expired or been cancelled.
+  void timers_finished(op_queue<scheduler_operation>& ops)
+  {
+    std::size_t n = 0;
+    for (scheduler_operation* op = ops.front();
+        op; op = op_queue_access::next(op))
+      ++n;
+    timers_finished(n);
+  }
+
+  // Accessors for the counters. Times are in nanoseconds.
+  uint64_t operations_queued() const { return get(operations_queued_); }
+  uint64_t operations_executed() const { return get(operations_executed_); }
+  uint64_t wakeups() const { return get(wakeups_); }
+  uint64_t task_runs() const { return get(task_runs_); }
+  uint64_t task_time() const { return get(task_time_); }
+  uint64_t handler_time() const { return get(handler_time_); }
+  uint64_t reactor_waits() const { return get(reactor_waits_); }
+  uint64_t reactor_events() const { return get(reactor_events_); }
+
+  long registered_descriptors() const
+  {
+    return registered_descriptors_.load(std::memory_order_relaxed);
+  }
+
+  long pending_timers() const
+  {
+    return pending_timers_.load(std::memory_order_relaxed);
+  }
+
+  // Copy the histograms of queueing delay and run time.
+  void get_histograms(std::vector<uint64_t>& queue_delay,
+      std::vector<uint64_t>& run_time) const
+  {
+    queue_delay.resize(duration_histogram_buckets::count);
+    run_time.resize(duration_histogram_buckets::count);
+    for (std::size_t i = 0; i < duration_histogram_buckets::count; ++i)
+    {
+      queue_delay[i] = get(queue_delay_[i]);
+      run_time[i] = get(run_time_[i]);
+    }
+  }
+
+private:
+  // Queueing times are stored in the operation as 32 bits of the clock, in
+  // units of 16 nanoseconds. This limits the measurable delay to about 68
+  // seconds.
+  enum { tick_shift = 4 };
+
+  static uint64_t now()
+  {
+    return static_cast<uint64_t>(
+        chrono::duration_cast<chrono::nanoseconds>(
+          chrono::steady_clock::now().time_since_epoch()).count());
+  }
+
+  static unsigned int queued_time()
+  {
+    unsigned int t = static_cast<unsigned int>(now() >> tick_shift);
+    return t != 0 ? t : 1;
+  }
+
+  static void add(std::atomic<uint64_t>& counter, uint64_t n)
+  {
+    counter.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  static uint64_t get(const std::atomic<uint64_t>& counter)
+  {
+    return counter.load(std::memory_order_relaxed);
+  }
+
+  static void record(std::atomic<uint64_t>* histogram, uint64_t value)
+  {
+    add(histogram[duration_histogram_buckets::bucket(value)], 1);
+  }
+
+  std::atomic<uint64_t> operations_queued_;
+  std::atomic<uint64_t> operations_executed_;
+  std::atomic<uint64_t> wakeups_;
+  std::atomic<uint64_t> task_runs_;
+  std::atomic<uint64_t> task_time_;
+  std::atomic<uint64_t> handler_time_;
+  std::atomic<uint64_t> reactor_waits_;
+  std::atomic<uint64_t> reactor_events_;
+  std::atomic<long> registered_descriptors_;
+  std::atomic<long> pending_timers_;
+  std::atomic<uint64_t> queue_delay_[duration_histogram_buckets::count];
+  std::atomic<uint64_t> run_time_[duration_histogram_buckets::count];
+};
+
+#else // defined(ASIO_HAS_IO_CONTEXT_METRICS)
+
+// Metrics are not supported. The scheduler and reactor hold a null pointer
+// to this class, so none of its functions are called.
+class scheduler_metrics
+{
+public:
+  struct execution_scope
+  {
+    execution_scope(scheduler_metrics*, scheduler_operation*) {}
+  };
+
+  struct task_scope
+  {
+    explicit task_scope(scheduler_metrics*) {}
+  };
+
+  void operation_queued(scheduler_operation*) {}
+  void operations_queued(op_queue<scheduler_operation>&) {}
+  void wakeup() {}
+  void reactor_wait(int) {}
+  void descriptor_registered() {}
+  void descriptor_deregistered() {}
+  void timer_scheduled() {}
+  void timers_finished(std::size_t) {}
+  void timers_finished(op_queue<scheduler_operation>&) {}
+};
+
+#endif // defined(ASIO_HAS_IO_CONTEXT_METRICS)
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_SCHEDULER_METRICS_HPP
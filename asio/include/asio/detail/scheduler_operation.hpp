@@ -52,7 +52,8 @@ protected:
   scheduler_operation(func_type func)
     : next_(0),
       func_(func),
-      task_result_(0)
+      task_result_(0),
+      queued_time_(0)
   {
   }
 
@@ -63,11 +64,15 @@ protected:
 
 private:
   friend class op_queue_access;
+  friend class stall_detector;
   scheduler_operation* next_;
   func_type func_;
 protected:
   friend class scheduler;
   unsigned int task_result_; // Passed into bytes transferred.
+private:
+  friend class scheduler_metrics;
+  unsigned int queued_time_; // Set only when metrics are being collected.
 };
 
 } // namespace detail
@@ -15,6 +15,7 @@
 # pragma once
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
+#include "asio/detail/mutex.hpp"
 #include "asio/detail/op_queue.hpp"
 #include "asio/detail/thread_info_base.hpp"
 
@@ -26,10 +27,37 @@ namespace detail {
 class scheduler;
 class scheduler_operation;
 
+// A thread's queue of handlers, from which other threads may steal.
+struct scheduler_stealable_queue
+{
+  scheduler_stealable_queue()
+    : stopped(false)
+  {
+  }
+
+  mutex lock;
+  op_queue<scheduler_operation> ops;
+
+  // Set when the scheduler is stopped, so that the owning thread stops running
+  // handlers from the queue.
+  bool stopped;
+};
+
 struct scheduler_thread_info : public thread_info_base
 {
+  scheduler_thread_info()
+    : stealable(0),
+      steal_seed(0)
+  {
+  }
+
   op_queue<scheduler_operation> private_op_queue;
   long private_outstanding_work;
+
+  // Used only when the scheduler is in work stealing mode. Handlers posted by
+  // this thread are queued here, and may be taken by other threads.
+  scheduler_stealable_queue* stealable;
+  unsigned int steal_seed;
 };
 
 } // namespace detail
@@ -18,6 +18,7 @@
 #include "asio/detail/config.hpp"
 
 #include "asio/error_code.hpp"
+#include "asio/detail/cstdint.hpp"
 #include "asio/detail/memory.hpp"
 #include "asio/detail/socket_types.hpp"
 
@@ -52,11 +53,29 @@ enum
   datagram_oriented = 32,
 
   // The socket may have been dup()-ed.
-  possible_dup = 64
+  possible_dup = 64,
+
+  // The user enabled zero-copy sends.
+  zero_copy = 128
 };
 
 typedef unsigned char state_type;
 
+#if defined(ASIO_HAS_MSG_ZEROCOPY)
+
+// Counters used to match the zero-copy sends made on a socket with the
+// notifications the kernel queues once it has finished with the sent data.
+struct zero_copy_state
+{
+  // The sequence number of the next zero-copy send.
+  uint32_t sent;
+
+  // One past the highest sequence number known to have completed.
+  uint32_t completed;
+};
+
+#endif // defined(ASIO_HAS_MSG_ZEROCOPY)
+
 struct noop_deleter { void operator()(void*) {} };
 typedef shared_ptr<void> shared_cancel_token_type;
 typedef weak_ptr<void> weak_cancel_token_type;
@@ -136,6 +155,23 @@ ASIO_DECL void init_buf(buf& b, void* data, size_t size);
 
 ASIO_DECL void init_buf(buf& b, const void* data, size_t size);
 
+// A single datagram within a batched send or receive.
+struct datagram_buf
+{
+  // The datagram's data.
+  buf data;
+
+  // The peer's address and its length.
+  socket_addr_type* addr;
+  std::size_t addrlen;
+
+  // The number of bytes of the datagram that were transferred.
+  std::size_t bytes_transferred;
+};
+
+// The maximum number of datagrams transferred by a single system call.
+enum { max_datagram_batch = 64 };
+
 ASIO_DECL signed_size_type recv(socket_type s, buf* bufs,
     size_t count, int flags, asio::error_code& ec);
 
@@ -202,6 +238,40 @@ ASIO_DECL bool non_blocking_recvfrom1(socket_type s,
 
 #endif // defined(ASIO_HAS_IOCP)
 
+#if defined(ASIO_HAS_UDP_GSO)
+
+ASIO_DECL signed_size_type recvfrom_segments(socket_type s, buf* bufs,
+    size_t count, int flags, socket_addr_type* addr,
+    std::size_t* addrlen, std::size_t* segment_size,
+    asio::error_code& ec);
+
+ASIO_DECL size_t sync_recvfrom_segments(socket_type s, state_type state,
+    buf* bufs, size_t count, int flags, socket_addr_type* addr,
+    std::size_t* addrlen, std::size_t* segment_size,
+    asio::error_code& ec);
+
+ASIO_DECL bool non_blocking_recvfrom_segments(socket_type s,
+    buf* bufs, size_t count, int flags,
+    socket_addr_type* addr, std::size_t* addrlen,
+    std::size_t* segment_size, asio::error_code& ec,
+    size_t& bytes_transferred);
+
+#endif // defined(ASIO_HAS_UDP_GSO)
+
+ASIO_DECL signed_size_type recvmmsg(socket_type s, datagram_buf* dgrams,
+    size_t count, int flags, asio::error_code& ec);
+
+ASIO_DECL size_t sync_recvmmsg(socket_type s, state_type state,
+    datagram_buf* dgrams, size_t count, int flags, asio::error_code& ec);
+
+#if !defined(ASIO_HAS_IOCP)
+
+ASIO_DECL bool non_blocking_recvmmsg(socket_type s,
+    datagram_buf* dgrams, size_t count, int flags,
+    asio::error_code& ec, size_t& datagrams_transferred);
+
+#endif // !defined(ASIO_HAS_IOCP)
+
 ASIO_DECL signed_size_type recvmsg(socket_type s, buf* bufs,
     size_t count, int in_flags, int& out_flags,
     asio::error_code& ec);
@@ -253,6 +323,18 @@ ASIO_DECL bool non_blocking_send1(socket_type s,
     const void* data, size_t size, int flags,
     asio::error_code& ec, size_t& bytes_transferred);
 
+#if defined(ASIO_HAS_MSG_ZEROCOPY)
+
+ASIO_DECL bool non_blocking_send_zero_copy(socket_type s,
+    const buf* bufs, size_t count, int flags, zero_copy_state& zc,
+    uint32_t& seq, bool& completion_pending,
+    asio::error_code& ec, size_t& bytes_transferred);
+
+ASIO_DECL bool non_blocking_zero_copy_complete(socket_type s,
+    zero_copy_state& zc, uint32_t seq, asio::error_code& ec);
+
+#endif // defined(ASIO_HAS_MSG_ZEROCOPY)
+
 #endif // defined(ASIO_HAS_IOCP)
 
 ASIO_DECL signed_size_type sendto(socket_type s, const buf* bufs,
@@ -285,6 +367,38 @@ ASIO_DECL bool non_blocking_sendto1(socket_type s,
 
 #endif // !defined(ASIO_HAS_IOCP)
 
+#if defined(ASIO_HAS_UDP_GSO)
+
+ASIO_DECL signed_size_type sendto_segments(socket_type s, const buf* bufs,
+    size_t count, int flags, const socket_addr_type* addr,
+    std::size_t addrlen, std::size_t segment_size, asio::error_code& ec);
+
+ASIO_DECL size_t sync_sendto_segments(socket_type s, state_type state,
+    const buf* bufs, size_t count, int flags, const socket_addr_type* addr,
+    std::size_t addrlen, std::size_t segment_size, asio::error_code& ec);
+
+ASIO_DECL bool non_blocking_sendto_segments(socket_type s,
+    const buf* bufs, size_t count, int flags,
+    const socket_addr_type* addr, std::size_t addrlen,
+    std::size_t segment_size, asio::error_code& ec,
+    size_t& bytes_transferred);
+
+#endif // defined(ASIO_HAS_UDP_GSO)
+
+ASIO_DECL signed_size_type sendmmsg(socket_type s, datagram_buf* dgrams,
+    size_t count, int flags, asio::error_code& ec);
+
+ASIO_DECL size_t sync_sendmmsg(socket_type s, state_type state,
+    datagram_buf* dgrams, size_t count, int flags, asio::error_code& ec);
+
+#if !defined(ASIO_HAS_IOCP)
+
+ASIO_DECL bool non_blocking_sendmmsg(socket_type s,
+    datagram_buf* dgrams, size_t count, int flags,
+    asio::error_code& ec, size_t& datagrams_transferred);
+
+#endif // !defined(ASIO_HAS_IOCP)
+
 ASIO_DECL socket_type socket(int af, int type, int protocol,
     asio::error_code& ec);
 
@@ -89,6 +89,12 @@
 #  include <sys/filio.h>
 #  include <sys/sockio.h>
 # endif
+# if defined(ASIO_HAS_MSG_ZEROCOPY)
+#  include <linux/errqueue.h>
+# endif // defined(ASIO_HAS_MSG_ZEROCOPY)
+# if defined(ASIO_HAS_UDP_GSO)
+#  include <netinet/udp.h>
+# endif // defined(ASIO_HAS_UDP_GSO)
 #endif
 
 #include "asio/detail/push_options.hpp"
@@ -0,0 +1,181 @@
+//
+// detail/stall_detector.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_STALL_DETECTOR_HPP
+#define ASIO_DETAIL_STALL_DETECTOR_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/detail/scheduler_operation.hpp"
+#include "asio/detail/stall_record.hpp"
+
+#if defined(ASIO_HAS_STALL_DETECTION)
+# include "asio/detail/call_stack.hpp"
+# include "asio/detail/event.hpp"
+# include "asio/detail/mutex.hpp"
+# include "asio/detail/scoped_ptr.hpp"
+# include "asio/detail/thread.hpp"
+# include "asio/execution_context.hpp"
+#endif // defined(ASIO_HAS_STALL_DETECTION)
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+#if defined(ASIO_HAS_STALL_DETECTION)
+
+// Watches the threads running an io_context and reports handlers that run for
+// longer than a threshold. The service is created only when stall detection
+// is requested, and the scheduler updates it only if it exists.
+class stall_detector
+  : public execution_context_service_base<stall_detector>
+{
+public:
+  // Constructor.
+  ASIO_DECL explicit stall_detector(execution_context& ctx);
+
+  // Destructor.
+  ASIO_DECL ~stall_detector();
+
+  // Stop the monitoring thread.
+  ASIO_DECL void shutdown();
+
+  // Start monitoring with the given threshold. If no handler is given, stalls
+  // are reported on standard error.
+  ASIO_DECL void start(long threshold_usec,
+      stall_handler_type handler, void* context);
+
+  // Registers the current thread's record for the duration of a call to run(),
+  // run_one(), poll() or poll_one().
+  class thread_registration
+  {
+  public:
+    explicit thread_registration(stall_detector* detector)
+      : detector_(detector),
+        context_(detector, record_)
+    {
+      if (detector_)
+        detector_->register_record(record_);
+    }
+
+    ~thread_registration()
+    {
+      if (detector_)
+        detector_->deregister_record(record_);
+    }
+
+  private:
+    stall_detector* detector_;
+    stall_record record_;
+    call_stack<stall_detector, stall_record>::context context_;
+  };
+
+  // Marks a handler as running on the current thread.
+  class execution_scope
+  {
+  public:
+    execution_scope(stall_detector* detector, scheduler_operation* op)
+      : record_(detector
+          ? call_stack<stall_detector, stall_record>::contains(detector) : 0)
+    {
+      if (record_)
+      {
+        record_->handler_started(now(),
+            reinterpret_cast<const void*>(op->func_));
+      }
+    }
+
+    ~execution_scope()
+    {
+      if (record_)
+        record_->handler_finished();
+    }
+
+  private:
+    stall_record* record_;
+  };
+
+private:
+  // Get the current time in nanoseconds. Never returns 0.
+  ASIO_DECL static uint64_t now();
+
+  // Add a record to the list of monitored threads.
+  ASIO_DECL void register_record(stall_record& record);
+
+  // Remove a record from the list of monitored threads.
+  ASIO_DECL void deregister_record(stall_record& record);
+
+  // Report a stall on standard error.
+  ASIO_DECL static void write_report(const stall_report& report, void*);
+
+  // Run the monitoring thread.
+  ASIO_DECL void run_monitor();
+
+  // Helper class to run the monitoring thread.
+  class monitor_function;
+  friend class monitor_function;
+
+  // Mutex to protect access to the internal data.
+  mutex mutex_;
+
+  // Event used to wake the monitoring thread when shutting down.
+  event event_;
+
+  // The records of the threads running the io_context.
+  stall_record* records_;
+
+  // How long a handler may run before it is reported.
+  uint64_t threshold_;
+
+  // The function called to report a stall, and its context argument.
+  stall_handler_type handler_;
+  void* handler_context_;
+
+  // Whether the monitoring thread should exit.
+  bool shutdown_;
+
+  // The monitoring thread.
+  scoped_ptr<thread> thread_;
+};
+
+#else // defined(ASIO_HAS_STALL_DETECTION)
+
+// Stall detection is not supported. The scheduler holds a null pointer to
+// this class, so none of its functions are called.
+class stall_detector
+{
+public:
+  struct thread_registration
+  {
+    explicit thread_registration(stall_detector*) {}
+  };
+
+  struct execution_scope
+  {
+    execution_scope(stall_detector*, scheduler_operation*) {}
+  };
+};
+
+#endif // defined(ASIO_HAS_STALL_DETECTION)
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/stall_detector.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // ASIO_DETAIL_STALL_DETECTOR_HPP
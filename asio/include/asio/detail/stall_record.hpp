@@ -0,0 +1,191 @@
+//
+// detail/stall_record.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_STALL_RECORD_HPP
+#define ASIO_DETAIL_STALL_RECORD_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/detail/cstdint.hpp"
+
+#if defined(ASIO_HAS_STALL_DETECTION)
+# include <atomic>
+# include "asio/detail/call_stack.hpp"
+# include "asio/detail/noncopyable.hpp"
+#endif // defined(ASIO_HAS_STALL_DETECTION)
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+// Describes a handler that has run for longer than the stall threshold.
+struct stall_report
+{
+  // How long, in nanoseconds, the handler had been running when the stall was
+  // detected. The handler may still be running when the report is made.
+  uint64_t duration;
+
+  // The address of the function that invoked the handler. The function is
+  // specialised on the handler's type, so its symbol identifies the handler.
+  const void* completion_function;
+
+  // The innermost ASIO_HANDLER_LOCATION active within the handler when the
+  // stall was detected, or null pointers and a line of 0 if there was none.
+  const char* file;
+  int line;
+  const char* function;
+};
+
+// The function called to report a stalled handler.
+typedef void (*stall_handler_type)(const stall_report& report, void* context);
+
+#if defined(ASIO_HAS_STALL_DETECTION)
+
+class stall_detector;
+
+// The state of a thread that is running an io_context monitored for stalls.
+// The running thread writes the state, and the monitoring thread reads it.
+class stall_record
+  : private noncopyable
+{
+public:
+  stall_record()
+    : start_(0),
+      completion_function_(0),
+      sequence_(0),
+      file_(0),
+      line_(0),
+      function_(0),
+      reported_start_(0),
+      next_(0),
+      prev_(0)
+  {
+  }
+
+  // Get the record of the innermost handler running on the current thread.
+  static stall_record* current()
+  {
+    return call_stack<stall_detector, stall_record>::top();
+  }
+
+  // Record the start of a handler. The start time is never 0.
+  void handler_started(uint64_t start, const void* completion_function)
+  {
+    completion_function_.store(completion_function, std::memory_order_relaxed);
+    start_.store(start, std::memory_order_release);
+  }
+
+  // Record the end of a handler.
+  void handler_finished()
+  {
+    start_.store(0, std::memory_order_relaxed);
+  }
+
+  // Publish the innermost source location. Readers use the sequence number to
+  // detect a location that is updated while being read.
+  void set_location(const char* file, int line, const char* function)
+  {
+    unsigned int sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    file_.store(file, std::memory_order_relaxed);
+    line_.store(line, std::memory_order_relaxed);
+    function_.store(function, std::memory_order_relaxed);
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  // Read the handler's state from another thread. Returns false if no handler
+  // is running.
+  bool read(uint64_t& start, stall_report& report) const
+  {
+    start = start_.load(std::memory_order_acquire);
+    if (start == 0)
+      return false;
+
+    report.completion_function =
+      completion_function_.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+      unsigned int sequence = sequence_.load(std::memory_order_acquire);
+      report.file = file_.load(std::memory_order_relaxed);
+      report.line = line_.load(std::memory_order_relaxed);
+      report.function = function_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if ((sequence & 1) == 0
+          && sequence == sequence_.load(std::memory_order_relaxed))
+        return true;
+    }
+  }
+
+private:
+  friend class stall_detector;
+  friend class stall_location;
+
+  std::atomic<uint64_t> start_;
+  std::atomic<const void*> completion_function_;
+  std::atomic<unsigned int> sequence_;
+  std::atomic<const char*> file_;
+  std::atomic<int> line_;
+  std::atomic<const char*> function_;
+
+  // Used only by the monitoring thread, with the detector's mutex held.
+  uint64_t reported_start_;
+  stall_record* next_;
+  stall_record* prev_;
+};
+
+// Publishes a source location for the duration of a scope, so that it may be
+// included in stall reports. Used to implement ASIO_HANDLER_LOCATION.
+class stall_location
+  : private noncopyable
+{
+public:
+  stall_location(const char* file, int line, const char* function)
+    : record_(stall_record::current())
+  {
+    // Only threads running handlers for a monitored io_context are recorded.
+    if (record_ && record_->start_.load(std::memory_order_relaxed) == 0)
+      record_ = 0;
+
+    if (record_)
+    {
+      file_ = record_->file_.load(std::memory_order_relaxed);
+      line_ = record_->line_.load(std::memory_order_relaxed);
+      function_ = record_->function_.load(std::memory_order_relaxed);
+      record_->set_location(file, line, function);
+    }
+  }
+
+  ~stall_location()
+  {
+    if (record_)
+      record_->set_location(file_, line_, function_);
+  }
+
+private:
+  stall_record* record_;
+  const char* file_;
+  int line_;
+  const char* function_;
+};
+
+#endif // defined(ASIO_HAS_STALL_DETECTION)
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_STALL_RECORD_HPP
@@ -22,11 +22,15 @@
 #include "asio/detail/mutex.hpp"
 #include "asio/detail/op_queue.hpp"
 #include "asio/detail/scheduler_operation.hpp"
-#include "asio/detail/scoped_ptr.hpp"
+#include "asio/detail/strand_pool.hpp"
 #include "asio/detail/type_traits.hpp"
 #include "asio/execution.hpp"
 #include "asio/execution_context.hpp"
 
+#if defined(ASIO_HAS_LOCK_FREE_STRANDS)
+# include <atomic>
+#endif // defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
 #include "asio/detail/push_options.hpp"
 
 namespace asio {
@@ -46,6 +50,25 @@ public:
   private:
     friend class strand_executor_service;
 
+#if defined(ASIO_HAS_LOCK_FREE_STRANDS)
+    // Special values of the strand's state.
+    enum
+    {
+      // No handler holds the strand's lock.
+      unlocked = 0,
+
+      // A handler holds the strand's lock and no handlers are waiting.
+      locked = 1,
+
+      // The strand has been shut down and will accept no further handlers.
+      shut_down = 2
+    };
+
+    // The state of the strand. If no other value applies, the strand is
+    // locked and this is a pointer to the handler that most recently started
+    // waiting. The waiting handlers are linked from newest to oldest.
+    std::atomic<std::size_t> state_;
+#else // defined(ASIO_HAS_LOCK_FREE_STRANDS)
     // Mutex to protect access to internal data.
     mutex* mutex_;
 
@@ -62,6 +85,7 @@ public:
     // after the next time the strand is scheduled. This queue must only be
     // modified while the mutex is locked.
     op_queue<scheduler_operation> waiting_queue_;
+#endif // defined(ASIO_HAS_LOCK_FREE_STRANDS)
 
     // The handlers that are ready to be run. Logically speaking, these are the
     // handlers that hold the strand's lock. The ready queue is only modified
@@ -135,6 +159,13 @@ private:
   // handlers were transferred.
   ASIO_DECL static bool push_waiting_to_ready(implementation_type& impl);
 
+#if defined(ASIO_HAS_LOCK_FREE_STRANDS)
+  // Moves a chain of waiting handlers, linked from newest to oldest, to the
+  // back of the given queue in the order in which they started waiting.
+  ASIO_DECL static void push_waiting(op_queue<scheduler_operation>& ops,
+      std::size_t state);
+#endif // defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
   // Invokes all ready-to-run handlers.
   ASIO_DECL static void run_ready_handlers(implementation_type& impl);
 
@@ -146,15 +177,17 @@ private:
   // Mutex to protect access to the service-wide state.
   mutex mutex_;
 
-  // Number of mutexes shared between all strand objects.
-  enum { num_mutexes = 193 };
+#if !defined(ASIO_HAS_LOCK_FREE_STRANDS)
+  // Default number of mutexes shared between all strand objects.
+  enum { default_num_mutexes = 193 };
 
   // Pool of mutexes.
-  scoped_ptr<mutex> mutexes_[num_mutexes];
+  strand_pool<mutex> mutexes_;
 
   // Extra value used when hashing to prevent recycled memory locations from
   // getting the same mutex.
   std::size_t salt_;
+#endif // !defined(ASIO_HAS_LOCK_FREE_STRANDS)
 
   // The head of a linked list of all implementations.
   strand_impl* impl_list_;
@@ -0,0 +1,219 @@
+//
+// detail/strand_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_STRAND_POOL_HPP
+#define ASIO_DETAIL_STRAND_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "asio/detail/atomic_count.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/noncopyable.hpp"
+#include "asio/execution_context.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+// Holds the configuration and statistics shared by the strand pools that
+// belong to an execution context.
+class strand_pool_service
+  : public execution_context_service_base<strand_pool_service>
+{
+public:
+  // Constructor.
+  explicit strand_pool_service(execution_context& ctx)
+    : execution_context_service_base<strand_pool_service>(ctx),
+      requested_size_(0),
+      pool_size_(0),
+      acquisitions_(0),
+      collisions_(0)
+  {
+  }
+
+  // Destroy all user-defined handler objects owned by the service.
+  void shutdown()
+  {
+  }
+
+  // Set the number of entries in pools created after this call. A value of 0
+  // means each pool uses its default size.
+  void set_pool_size(std::size_t size)
+  {
+    mutex::scoped_lock lock(mutex_);
+    requested_size_ = size;
+  }
+
+  // Choose the size of a new pool.
+  std::size_t new_pool_size(std::size_t default_size)
+  {
+    mutex::scoped_lock lock(mutex_);
+    pool_size_ = requested_size_ != 0 ? requested_size_ : default_size;
+    return pool_size_;
+  }
+
+  // Record that a pool entry has been assigned to a new strand.
+  void record_acquisition(bool collision)
+  {
+    mutex::scoped_lock lock(mutex_);
+    ++acquisitions_;
+    if (collision)
+      ++collisions_;
+  }
+
+  // Get the size of the most recently created pool, the number of entries
+  // assigned, and the number of those that were already in use.
+  void get_statistics(std::size_t& pool_size,
+      std::size_t& acquisitions, std::size_t& collisions)
+  {
+    mutex::scoped_lock lock(mutex_);
+    pool_size = pool_size_;
+    acquisitions = acquisitions_;
+    collisions = collisions_;
+  }
+
+private:
+  // Mutex to protect access to the service's data.
+  mutex mutex_;
+
+  // The pool size requested by the user, or 0 for the default.
+  std::size_t requested_size_;
+
+  // The size of the most recently created pool.
+  std::size_t pool_size_;
+
+  // The number of entries assigned to strands.
+  std::size_t acquisitions_;
+
+  // The number of entries assigned while in use by another strand.
+  std::size_t collisions_;
+};
+
+// A pool of objects that are shared between strands, such as the mutexes that
+// protect the strands' queues. The size of the pool is chosen at run time.
+// Each object is created on first use and occupies whole cache lines, so that
+// objects used by different threads do not share a line. Each object is
+// reference counted, and is destroyed when both the pool and the last strand
+// using it have released it, so that a strand may outlive the pool. The pool
+// itself is not thread-safe and must be protected by the owner's mutex.
+template <typename Object>
+class strand_pool
+  : private noncopyable
+{
+public:
+  // The size in bytes to which each object is aligned and padded.
+  enum { cache_line_size = 64 };
+
+  // Constructor.
+  strand_pool(execution_context& ctx, std::size_t default_size)
+    : service_(asio::use_service<strand_pool_service>(ctx)),
+      nodes_(service_.new_pool_size(default_size))
+  {
+  }
+
+  // Destructor releases the pool's reference to each object.
+  ~strand_pool()
+  {
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+      if (nodes_[i])
+        release(nodes_[i]);
+  }
+
+  // Get the number of entries in the pool.
+  std::size_t size() const
+  {
+    return nodes_.size();
+  }
+
+  // Get the object at the given index, or 0 if it has not been created.
+  Object* get(std::size_t index) const
+  {
+    return nodes_[index];
+  }
+
+  // Get the object at the given index for use by a new strand, creating the
+  // object if required. Counts a collision if another strand is using it. The
+  // strand must release the object when it has finished using it.
+  Object* acquire(std::size_t index)
+  {
+    node*& n = nodes_[index];
+    if (!n)
+    {
+      // Free the memory if the object's constructor throws.
+      struct memory_guard
+      {
+        ~memory_guard() { if (p) aligned_delete(p); }
+        void* p;
+      } memory = { aligned_new(cache_line_size, sizeof(node)) };
+
+      n = new (memory.p) node;
+      memory.p = 0;
+    }
+
+    // The pool holds one reference, and so a count above one means that a
+    // strand is using the object.
+    bool collision = static_cast<long>(n->use_count_) > 1;
+    ref_count_up(n->use_count_);
+    service_.record_acquisition(collision);
+    return n;
+  }
+
+  // Record that another strand has started sharing an object with an existing
+  // strand. Does not require the owner's mutex.
+  static void retain(Object* object)
+  {
+    ref_count_up(static_cast<node*>(object)->use_count_);
+  }
+
+  // Record that a strand has finished using an object, destroying it if it
+  // is no longer referenced. Does not require the owner's mutex.
+  static void release(Object* object)
+  {
+    node* n = static_cast<node*>(object);
+    if (ref_count_down(n->use_count_))
+    {
+      n->~node();
+      aligned_delete(n);
+    }
+  }
+
+private:
+  // An object together with its reference count.
+  struct node : Object
+  {
+    node()
+      : use_count_(1)
+    {
+    }
+
+    atomic_count use_count_;
+  };
+
+  // The service that holds the configuration and statistics.
+  strand_pool_service& service_;
+
+  // The objects in the pool, or 0 for those not yet created.
+  std::vector<node*> nodes_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_STRAND_POOL_HPP
@@ -20,7 +20,7 @@
 #include "asio/detail/mutex.hpp"
 #include "asio/detail/op_queue.hpp"
 #include "asio/detail/operation.hpp"
-#include "asio/detail/scoped_ptr.hpp"
+#include "asio/detail/strand_pool.hpp"
 
 #include "asio/detail/push_options.hpp"
 
@@ -83,6 +83,24 @@ public:
   // Construct a new strand implementation.
   ASIO_DECL void construct(implementation_type& impl);
 
+  // Make a strand implementation that shares the state of another. May be
+  // called after the service has been destroyed.
+  static void copy(implementation_type& impl,
+      const implementation_type& other_impl)
+  {
+    strand_pool<strand_impl>::retain(other_impl);
+    impl = other_impl;
+  }
+
+  // Destroy a strand implementation. May be called after the service has
+  // been destroyed.
+  static void destroy(implementation_type& impl)
+  {
+    if (impl)
+      strand_pool<strand_impl>::release(impl);
+    impl = 0;
+  }
+
   // Request the io_context to invoke the given handler.
   template <typename Handler>
   void dispatch(implementation_type& impl, Handler& handler);
@@ -116,15 +134,15 @@ private:
   // Mutex to protect access to the array of implementations.
   asio::detail::mutex mutex_;
 
-  // Number of implementations shared between all strand objects.
+  // Default number of implementations shared between all strand objects.
 #if defined(ASIO_STRAND_IMPLEMENTATIONS)
-  enum { num_implementations = ASIO_STRAND_IMPLEMENTATIONS };
+  enum { default_num_implementations = ASIO_STRAND_IMPLEMENTATIONS };
 #else // defined(ASIO_STRAND_IMPLEMENTATIONS)
-  enum { num_implementations = 193 };
+  enum { default_num_implementations = 193 };
 #endif // defined(ASIO_STRAND_IMPLEMENTATIONS)
 
   // Pool of implementations.
-  scoped_ptr<strand_impl> implementations_[num_implementations];
+  strand_pool<strand_impl> implementations_;
 
   // Extra value used when hashing to prevent recycled memory locations from
   // getting the same strand implementation.
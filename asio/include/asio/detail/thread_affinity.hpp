@@ -0,0 +1,48 @@
+//
+// detail/thread_affinity.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_THREAD_AFFINITY_HPP
+#define ASIO_DETAIL_THREAD_AFFINITY_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <vector>
+#include "asio/error_code.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+namespace thread_affinity {
+
+// Get the CPUs on which the calling process is permitted to run. If these
+// cannot be determined, returns one entry for each hardware thread.
+ASIO_DECL std::vector<int> available_cpus();
+
+// Get the CPUs that belong to a NUMA node.
+ASIO_DECL std::vector<int> numa_node_cpus(int node, asio::error_code& ec);
+
+// Restrict the calling thread to run only on the specified CPU.
+ASIO_DECL asio::error_code pin_this_thread(int cpu, asio::error_code& ec);
+
+} // namespace thread_affinity
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/thread_affinity.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // ASIO_DETAIL_THREAD_AFFINITY_HPP
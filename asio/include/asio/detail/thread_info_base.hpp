@@ -16,8 +16,8 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include "asio/detail/config.hpp"
-#include <climits>
 #include <cstddef>
+#include "asio/detail/cstdint.hpp"
 #include "asio/detail/memory.hpp"
 #include "asio/detail/noncopyable.hpp"
 
@@ -34,86 +34,72 @@ namespace asio {
 namespace detail {
 
 #ifndef ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE
-# define ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE 2
+# define ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE 8
 #endif // ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE
 
+#ifndef ASIO_RECYCLING_ALLOCATOR_SHARED_CACHE_SIZE
+# define ASIO_RECYCLING_ALLOCATOR_SHARED_CACHE_SIZE 256
+#endif // ASIO_RECYCLING_ALLOCATOR_SHARED_CACHE_SIZE
+
 class thread_info_base
   : private noncopyable
 {
 public:
-  struct default_tag
-  {
-    enum
-    {
-      cache_size = ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE,
-      begin_mem_index = 0,
-      end_mem_index = cache_size
-    };
-  };
+  // Tags identifying the purpose of an allocation. Memory for all purposes is
+  // recycled through the same caches.
+  struct default_tag {};
+  struct awaitable_frame_tag {};
+  struct executor_function_tag {};
+  struct cancellation_signal_tag {};
+  struct parallel_group_tag {};
 
-  struct awaitable_frame_tag
+  // Memory is recycled in blocks of fixed sizes, with two size classes per
+  // power of two from 64 to 8192 bytes. Each thread keeps a list of free
+  // blocks of each class, holding up to cache_size blocks. When a list
+  // overflows it is moved whole to a cache shared between threads, and a
+  // thread with an empty list takes one from the shared cache, so that memory
+  // freed by one thread may be reused by another. Threads without a cache
+  // allocate from, and free to, the heap directly.
+  enum
   {
-    enum
-    {
-      cache_size = ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE,
-      begin_mem_index = default_tag::end_mem_index,
-      end_mem_index = begin_mem_index + cache_size
-    };
+    cache_size = ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE,
+    shared_cache_size = ASIO_RECYCLING_ALLOCATOR_SHARED_CACHE_SIZE,
+    min_block_size = 64,
+    max_block_size = 8192,
+    block_classes = 15
   };
 
-  struct executor_function_tag
+  // Counters describing how memory was obtained and released.
+  struct memory_statistics
   {
-    enum
-    {
-      cache_size = ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE,
-      begin_mem_index = awaitable_frame_tag::end_mem_index,
-      end_mem_index = begin_mem_index + cache_size
-    };
+    uint64_t allocations;
+    uint64_t thread_cache_hits;
+    uint64_t shared_cache_hits;
+    uint64_t heap_allocations;
+    uint64_t oversized_allocations;
+    uint64_t deallocations;
+    uint64_t heap_deallocations;
   };
 
-  struct cancellation_signal_tag
-  {
-    enum
-    {
-      cache_size = ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE,
-      begin_mem_index = executor_function_tag::end_mem_index,
-      end_mem_index = begin_mem_index + cache_size
-    };
-  };
-
-  struct parallel_group_tag
-  {
-    enum
-    {
-      cache_size = ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE,
-      begin_mem_index = cancellation_signal_tag::end_mem_index,
-      end_mem_index = begin_mem_index + cache_size
-    };
-  };
-
-  enum { max_mem_index = parallel_group_tag::end_mem_index };
-
   thread_info_base()
+    : inline_completion_depth_(0)
 #if defined(ASIO_HAS_STD_EXCEPTION_PTR) \
   && !defined(ASIO_NO_EXCEPTIONS)
-    : has_pending_exception_(0)
+    , has_pending_exception_(0)
 #endif // defined(ASIO_HAS_STD_EXCEPTION_PTR)
        // && !defined(ASIO_NO_EXCEPTIONS)
   {
-    for (int i = 0; i < max_mem_index; ++i)
-      reusable_memory_[i] = 0;
+    for (int i = 0; i < block_classes; ++i)
+    {
+      free_lists_[i] = 0;
+      free_counts_[i] = 0;
+    }
+    clear_statistics(statistics_);
   }
 
   ~thread_info_base()
   {
-    for (int i = 0; i < max_mem_index; ++i)
-    {
-      // The following test for non-null pointers is technically redundant, but
-      // it is significantly faster when using a tight io_context::poll() loop
-      // in latency sensitive applications.
-      if (reusable_memory_[i])
-        aligned_delete(reusable_memory_[i]);
-    }
+    release_memory();
   }
 
   static void* allocate(thread_info_base* this_thread,
@@ -128,47 +114,35 @@ public:
     deallocate(default_tag(), this_thread, pointer, size);
   }
 
+  // Blocks are one byte larger than requested. The extra byte records the
+  // block's size class, or 0 if the block was allocated directly.
   template <typename Purpose>
   static void* allocate(Purpose, thread_info_base* this_thread,
       std::size_t size, std::size_t align = ASIO_DEFAULT_ALIGN)
   {
-    std::size_t chunks = (size + chunk_size - 1) / chunk_size;
+    std::size_t block = block_class(size + 1);
+    if (block >= block_classes || align > ASIO_DEFAULT_ALIGN)
+      return allocate_oversized(this_thread, size, align);
 
     if (this_thread)
     {
-      for (int mem_index = Purpose::begin_mem_index;
-          mem_index < Purpose::end_mem_index; ++mem_index)
-      {
-        if (this_thread->reusable_memory_[mem_index])
-        {
-          void* const pointer = this_thread->reusable_memory_[mem_index];
-          unsigned char* const mem = static_cast<unsigned char*>(pointer);
-          if (static_cast<std::size_t>(mem[0]) >= chunks
-              && reinterpret_cast<std::size_t>(pointer) % align == 0)
-          {
-            this_thread->reusable_memory_[mem_index] = 0;
-            mem[size] = mem[0];
-            return pointer;
-          }
-        }
-      }
+      if ((++this_thread->statistics_.allocations % statistics_interval) == 0)
+        this_thread->flush_statistics();
 
-      for (int mem_index = Purpose::begin_mem_index;
-          mem_index < Purpose::end_mem_index; ++mem_index)
+      if (free_block* b = this_thread->free_lists_[block])
       {
-        if (this_thread->reusable_memory_[mem_index])
-        {
-          void* const pointer = this_thread->reusable_memory_[mem_index];
-          this_thread->reusable_memory_[mem_index] = 0;
-          aligned_delete(pointer);
-          break;
-        }
+        this_thread->free_lists_[block] = b->next;
+        --this_thread->free_counts_[block];
+        ++this_thread->statistics_.thread_cache_hits;
+        static_cast<unsigned char*>(static_cast<void*>(b))[size] =
+          static_cast<unsigned char>(block + 1);
+        return b;
       }
     }
 
-    void* const pointer = aligned_new(align, chunks * chunk_size + 1);
-    unsigned char* const mem = static_cast<unsigned char*>(pointer);
-    mem[size] = (chunks <= UCHAR_MAX) ? static_cast<unsigned char>(chunks) : 0;
+    void* const pointer = allocate_block(this_thread, block);
+    static_cast<unsigned char*>(pointer)[size] =
+      static_cast<unsigned char>(block + 1);
     return pointer;
   }
 
@@ -176,25 +150,52 @@ public:
   static void deallocate(Purpose, thread_info_base* this_thread,
       void* pointer, std::size_t size)
   {
-    if (size <= chunk_size * UCHAR_MAX)
+    std::size_t block = static_cast<unsigned char*>(pointer)[size];
+    if (block == 0)
+    {
+      deallocate_oversized(this_thread, pointer);
+      return;
+    }
+
+    --block;
+    if (this_thread)
     {
-      if (this_thread)
+      ++this_thread->statistics_.deallocations;
+      if (this_thread->free_counts_[block] < cache_size)
       {
-        for (int mem_index = Purpose::begin_mem_index;
-            mem_index < Purpose::end_mem_index; ++mem_index)
-        {
-          if (this_thread->reusable_memory_[mem_index] == 0)
-          {
-            unsigned char* const mem = static_cast<unsigned char*>(pointer);
-            mem[0] = mem[size];
-            this_thread->reusable_memory_[mem_index] = pointer;
-            return;
-          }
-        }
+        free_block* b = static_cast<free_block*>(pointer);
+        b->next = this_thread->free_lists_[block];
+        this_thread->free_lists_[block] = b;
+        ++this_thread->free_counts_[block];
+        return;
       }
     }
 
-    aligned_delete(pointer);
+    deallocate_block(this_thread, block, pointer);
+  }
+
+  // Get the counters for all threads. A thread's counts are included after
+  // it exchanges blocks with the shared cache, after every few hundred
+  // allocations, and when it stops running handlers.
+  ASIO_DECL static memory_statistics get_statistics(
+      thread_info_base* this_thread);
+
+  // Record that a handler is about to be invoked from within an initiating
+  // function. Returns false, and records nothing, if the thread is already
+  // nested to the given depth.
+  bool enter_inline_completion(std::size_t max_depth)
+  {
+    if (inline_completion_depth_ >= max_depth)
+      return false;
+    ++inline_completion_depth_;
+    return true;
+  }
+
+  // Record that a handler invoked from within an initiating function has
+  // returned.
+  void leave_inline_completion()
+  {
+    --inline_completion_depth_;
   }
 
   void capture_current_exception()
@@ -237,8 +238,97 @@ public:
   }
 
 private:
-  enum { chunk_size = 4 };
-  void* reusable_memory_[max_mem_index];
+  // How often a thread adds its counts to the shared statistics.
+  enum { statistics_interval = 1024 };
+
+  // The header of a free block. A list of blocks in the shared cache is
+  // linked to the next list through its first block.
+  struct free_block
+  {
+    free_block* next;
+    free_block* next_list;
+    std::size_t count;
+  };
+
+  // Get the class of block that holds the given number of bytes, or
+  // block_classes if the size is too large.
+  static std::size_t block_class(std::size_t size)
+  {
+    if (size <= min_block_size)
+      return 0;
+    if (size > max_block_size)
+      return block_classes;
+    std::size_t bits = 7;
+    while ((static_cast<std::size_t>(1) << bits) < size)
+      ++bits;
+    return (size <= (static_cast<std::size_t>(3) << (bits - 2)))
+      ? 2 * (bits - 7) + 1 : 2 * (bits - 6);
+  }
+
+  // Get the size of a block of the given class.
+  static std::size_t block_size(std::size_t block)
+  {
+    return static_cast<std::size_t>(2 + (block & 1)) << (block / 2 + 5);
+  }
+
+  static void clear_statistics(memory_statistics& s)
+  {
+    s.allocations = 0;
+    s.thread_cache_hits = 0;
+    s.shared_cache_hits = 0;
+    s.heap_allocations = 0;
+    s.oversized_allocations = 0;
+    s.deallocations = 0;
+    s.heap_deallocations = 0;
+  }
+
+  // Add the thread's counts to the given counters, and reset them.
+  void move_statistics(memory_statistics& s)
+  {
+    s.allocations += statistics_.allocations;
+    s.thread_cache_hits += statistics_.thread_cache_hits;
+    s.shared_cache_hits += statistics_.shared_cache_hits;
+    s.heap_allocations += statistics_.heap_allocations;
+    s.oversized_allocations += statistics_.oversized_allocations;
+    s.deallocations += statistics_.deallocations;
+    s.heap_deallocations += statistics_.heap_deallocations;
+    clear_statistics(statistics_);
+  }
+
+  // Allocate a block that is too large or too strictly aligned to recycle.
+  ASIO_DECL static void* allocate_oversized(thread_info_base* this_thread,
+      std::size_t size, std::size_t align);
+
+  // Free a block that was too large or too strictly aligned to recycle.
+  ASIO_DECL static void deallocate_oversized(
+      thread_info_base* this_thread, void* pointer);
+
+  // Obtain a block when the thread's list is empty from the shared cache or
+  // the heap, or from the heap if the thread has no cache.
+  ASIO_DECL static void* allocate_block(
+      thread_info_base* this_thread, std::size_t block);
+
+  // Release a block when the thread's list is full to the shared cache or the
+  // heap, or to the heap if the thread has no cache.
+  ASIO_DECL static void deallocate_block(thread_info_base* this_thread,
+      std::size_t block, void* pointer);
+
+  // Add the thread's counts to the shared statistics.
+  ASIO_DECL void flush_statistics();
+
+  // Move the thread's free blocks to the shared cache.
+  ASIO_DECL void release_memory();
+
+  struct shared_cache;
+  ASIO_DECL static shared_cache& get_shared_cache();
+
+  struct untracked_statistics;
+  ASIO_DECL static untracked_statistics& get_untracked_statistics();
+
+  free_block* free_lists_[block_classes];
+  std::size_t free_counts_[block_classes];
+  memory_statistics statistics_;
+  std::size_t inline_completion_depth_;
 
 #if defined(ASIO_HAS_STD_EXCEPTION_PTR) \
   && !defined(ASIO_NO_EXCEPTIONS)
@@ -253,4 +343,8 @@ private:
 
 #include "asio/detail/pop_options.hpp"
 
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/thread_info_base.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
 #endif // ASIO_DETAIL_THREAD_INFO_BASE_HPP
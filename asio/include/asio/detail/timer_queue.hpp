@@ -31,7 +31,7 @@
 namespace asio {
 namespace detail {
 
-template <typename Time_Traits>
+template <typename Time_Traits, typename>
 class timer_queue
   : public timer_queue_base
 {
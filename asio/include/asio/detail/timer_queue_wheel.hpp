@@ -0,0 +1,538 @@
+//
+// detail/timer_queue_wheel.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_TIMER_QUEUE_WHEEL_HPP
+#define ASIO_DETAIL_TIMER_QUEUE_WHEEL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include "asio/detail/chrono_time_traits.hpp"
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/date_time_fwd.hpp"
+#include "asio/detail/limits.hpp"
+#include "asio/detail/op_queue.hpp"
+#include "asio/detail/timer_queue.hpp"
+#include "asio/detail/type_traits.hpp"
+#include "asio/detail/wait_op.hpp"
+#include "asio/error.hpp"
+#include "asio/timing_wheel_traits.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace detail {
+
+// Determine the timing wheel resolution, in microseconds, for the given time
+// traits. A value of 0 selects the heap-based timer_queue.
+template <typename Time_Traits>
+struct timer_queue_tick_usec
+  : timing_wheel_resolution<Time_Traits>
+{
+};
+
+template <typename Clock, typename WaitTraits>
+struct timer_queue_tick_usec<chrono_time_traits<Clock, WaitTraits> >
+  : timing_wheel_resolution<WaitTraits>
+{
+};
+
+// Template specialisation that holds timers in a hashed hierarchical timing
+// wheel. Each level of the wheel has 64 slots, and a slot at one level spans
+// all 64 slots of the level below. A timer is placed at the lowest level at
+// which its expiry tick and the current tick share all higher-order digits,
+// and is moved down a level whenever the current tick reaches the start of
+// its slot. Scheduling and cancelling a timer is therefore constant time.
+template <typename Time_Traits>
+class timer_queue<Time_Traits,
+    typename enable_if<(timer_queue_tick_usec<Time_Traits>::value > 0)>::type>
+  : public timer_queue_base
+{
+public:
+  // The time type.
+  typedef typename Time_Traits::time_type time_type;
+
+  // The duration type.
+  typedef typename Time_Traits::duration_type duration_type;
+
+  // Per-timer data.
+  class per_timer_data
+  {
+  public:
+    per_timer_data() :
+      slot_((std::numeric_limits<std::size_t>::max)()),
+      tick_(0), time_(),
+      next_(0), prev_(0),
+      slot_next_(0), slot_prev_(0)
+    {
+    }
+
+  private:
+    friend class timer_queue;
+
+    // The operations waiting on the timer.
+    op_queue<wait_op> op_queue_;
+
+    // The index of the slot holding the timer.
+    std::size_t slot_;
+
+    // The tick at which the timer expires.
+    uint64_t tick_;
+
+    // The time when the timer should fire.
+    time_type time_;
+
+    // Pointers to adjacent timers in a linked list.
+    per_timer_data* next_;
+    per_timer_data* prev_;
+
+    // Pointers to adjacent timers in the same slot.
+    per_timer_data* slot_next_;
+    per_timer_data* slot_prev_;
+  };
+
+  // Constructor.
+  timer_queue()
+    : timers_(),
+      origin_(Time_Traits::now()),
+      current_tick_(0)
+  {
+    for (std::size_t i = 0; i < num_levels; ++i)
+      occupied_[i] = 0;
+    for (std::size_t i = 0; i <= due_slot; ++i)
+      slots_[i] = 0;
+  }
+
+  // Add a new timer to the queue. Returns true if this is the timer that is
+  // earliest in the queue, in which case the reactor's event demultiplexing
+  // function call may need to be interrupted and restarted.
+  bool enqueue_timer(const time_type& time, per_timer_data& timer, wait_op* op)
+  {
+    bool earliest = false;
+
+    // Enqueue the timer object.
+    if (timer.prev_ == 0 && &timer != timers_)
+    {
+      if (this->is_positive_infinity(time))
+      {
+        // No slot is required for timers that never expire.
+        timer.slot_ = (std::numeric_limits<std::size_t>::max)();
+      }
+      else
+      {
+        timer.time_ = time;
+        timer.tick_ = expiry_tick(time);
+        earliest = slots_[due_slot] == 0 && timer.tick_ < next_event_tick();
+        link_timer(timer);
+      }
+
+      // Insert the new timer into the linked list of active timers.
+      timer.next_ = timers_;
+      timer.prev_ = 0;
+      if (timers_)
+        timers_->prev_ = &timer;
+      timers_ = &timer;
+    }
+
+    // Enqueue the individual timer operation.
+    timer.op_queue_.push(op);
+
+    // Interrupt reactor only if newly added timer is first to expire.
+    return earliest;
+  }
+
+  // Whether there are no timers in the queue.
+  virtual bool empty() const
+  {
+    return timers_ == 0;
+  }
+
+  // Get the time until the next tick at which the wheel has work to do.
+  virtual long wait_duration_msec(long max_duration) const
+  {
+    int64_t usec = usec_to_next_event();
+    if (usec < 0)
+      return max_duration;
+    int64_t msec = (usec + 999) / 1000;
+    if (msec > max_duration)
+      return max_duration;
+    return static_cast<long>(msec);
+  }
+
+  // Get the time until the next tick at which the wheel has work to do.
+  virtual long wait_duration_usec(long max_duration) const
+  {
+    int64_t usec = usec_to_next_event();
+    if (usec < 0 || usec > max_duration)
+      return max_duration;
+    return static_cast<long>(usec);
+  }
+
+  // Dequeue all timers not later than the current time.
+  virtual void get_ready_timers(op_queue<operation>& ops)
+  {
+    if (!timers_)
+      return;
+
+    const time_type now = Time_Traits::now();
+    int64_t now_usec = elapsed_usec(now);
+    uint64_t now_tick = now_usec > 0
+      ? static_cast<uint64_t>(now_usec) / tick_usec() : 0;
+
+    // Advance the wheel, one occupied slot at a time, to the current tick.
+    // Timers that reach their expiry tick are moved to the due slot.
+    for (uint64_t tick = next_event_tick();
+        tick <= now_tick; tick = next_event_tick())
+    {
+      current_tick_ = tick;
+      for (std::size_t level = num_levels - 1; level > 0; --level)
+      {
+        std::size_t shift = level * slot_bits;
+        if ((tick & ((static_cast<uint64_t>(1) << shift) - 1)) == 0)
+          relink_slot(level * num_slots + ((tick >> shift) & slot_mask));
+      }
+      relink_slot(tick & slot_mask);
+    }
+    if (current_tick_ < now_tick)
+      current_tick_ = now_tick;
+
+    per_timer_data* timer = slots_[due_slot];
+    slots_[due_slot] = 0;
+    while (timer)
+    {
+      per_timer_data* next = timer->slot_next_;
+      timer->slot_ = (std::numeric_limits<std::size_t>::max)();
+      timer->slot_next_ = 0;
+      timer->slot_prev_ = 0;
+      if (Time_Traits::less_than(now, timer->time_))
+      {
+        // The clock has moved backwards. Try again on the next tick.
+        timer->tick_ = current_tick_ + 1;
+        link_timer(*timer);
+      }
+      else
+      {
+        while (wait_op* op = timer->op_queue_.front())
+        {
+          timer->op_queue_.pop();
+          op->ec_ = asio::error_code();
+          ops.push(op);
+        }
+        remove_timer(*timer);
+      }
+      timer = next;
+    }
+  }
+
+  // Dequeue all timers.
+  virtual void get_all_timers(op_queue<operation>& ops)
+  {
+    while (timers_)
+    {
+      per_timer_data* timer = timers_;
+      timers_ = timers_->next_;
+      ops.push(timer->op_queue_);
+      timer->next_ = 0;
+      timer->prev_ = 0;
+      timer->slot_ = (std::numeric_limits<std::size_t>::max)();
+      timer->slot_next_ = 0;
+      timer->slot_prev_ = 0;
+    }
+
+    for (std::size_t i = 0; i < num_levels; ++i)
+      occupied_[i] = 0;
+    for (std::size_t i = 0; i <= due_slot; ++i)
+      slots_[i] = 0;
+  }
+
+  // Cancel and dequeue operations for the given timer.
+  std::size_t cancel_timer(per_timer_data& timer, op_queue<operation>& ops,
+      std::size_t max_cancelled = (std::numeric_limits<std::size_t>::max)())
+  {
+    std::size_t num_cancelled = 0;
+    if (timer.prev_ != 0 || &timer == timers_)
+    {
+      while (wait_op* op = (num_cancelled != max_cancelled)
+          ? timer.op_queue_.front() : 0)
+      {
+        op->ec_ = asio::error::operation_aborted;
+        timer.op_queue_.pop();
+        ops.push(op);
+        ++num_cancelled;
+      }
+      if (timer.op_queue_.empty())
+        remove_timer(timer);
+    }
+    return num_cancelled;
+  }
+
+  // Cancel and dequeue a specific operation for the given timer.
+  void cancel_timer_by_key(per_timer_data* timer,
+      op_queue<operation>& ops, void* cancellation_key)
+  {
+    if (timer->prev_ != 0 || timer == timers_)
+    {
+      op_queue<wait_op> other_ops;
+      while (wait_op* op = timer->op_queue_.front())
+      {
+        timer->op_queue_.pop();
+        if (op->cancellation_key_ == cancellation_key)
+        {
+          op->ec_ = asio::error::operation_aborted;
+          ops.push(op);
+        }
+        else
+          other_ops.push(op);
+      }
+      timer->op_queue_.push(other_ops);
+      if (timer->op_queue_.empty())
+        remove_timer(*timer);
+    }
+  }
+
+  // Move operations from one timer to another, empty timer.
+  void move_timer(per_timer_data& target, per_timer_data& source)
+  {
+    target.op_queue_.push(source.op_queue_);
+
+    target.time_ = source.time_;
+    target.tick_ = source.tick_;
+    target.slot_ = source.slot_;
+    source.slot_ = (std::numeric_limits<std::size_t>::max)();
+
+    if (target.slot_ <= due_slot && slots_[target.slot_] == &source)
+      slots_[target.slot_] = &target;
+    if (source.slot_prev_)
+      source.slot_prev_->slot_next_ = &target;
+    if (source.slot_next_)
+      source.slot_next_->slot_prev_ = &target;
+    target.slot_next_ = source.slot_next_;
+    target.slot_prev_ = source.slot_prev_;
+    source.slot_next_ = 0;
+    source.slot_prev_ = 0;
+
+    if (timers_ == &source)
+      timers_ = &target;
+    if (source.prev_)
+      source.prev_->next_ = &target;
+    if (source.next_)
+      source.next_->prev_= &target;
+    target.next_ = source.next_;
+    target.prev_ = source.prev_;
+    source.next_ = 0;
+    source.prev_ = 0;
+  }
+
+private:
+  // The layout of the wheel. The final slot holds timers that are due.
+  enum
+  {
+    slot_bits = 6,
+    num_slots = 1 << slot_bits,
+    slot_mask = num_slots - 1,
+    num_levels = 8,
+    due_slot = num_levels * num_slots
+  };
+
+  // The duration of a single tick of the wheel, in microseconds.
+  static uint64_t tick_usec()
+  {
+    return static_cast<uint64_t>(timer_queue_tick_usec<Time_Traits>::value);
+  }
+
+  // Get the number of microseconds from the origin to the specified time.
+  int64_t elapsed_usec(const time_type& time) const
+  {
+    return Time_Traits::to_posix_duration(
+        Time_Traits::subtract(time, origin_)).total_microseconds();
+  }
+
+  // Get the first tick that begins strictly after the specified time.
+  uint64_t expiry_tick(const time_type& time) const
+  {
+    int64_t usec = elapsed_usec(time);
+    if (usec < 0)
+      return 0;
+    return static_cast<uint64_t>(usec) / tick_usec() + 1;
+  }
+
+  // Get the number of microseconds until the wheel next has work to do, or -1
+  // if there are no timers in the wheel.
+  int64_t usec_to_next_event() const
+  {
+    if (slots_[due_slot])
+      return 0;
+
+    uint64_t tick = next_event_tick();
+    if (tick > static_cast<uint64_t>(
+          (std::numeric_limits<int64_t>::max)()) / tick_usec())
+      return -1;
+
+    int64_t usec = static_cast<int64_t>(tick * tick_usec())
+      - elapsed_usec(Time_Traits::now());
+    return usec > 0 ? usec : 0;
+  }
+
+  // Get the next tick at which a slot of the wheel must be processed, or the
+  // maximum tick value if the wheel is empty.
+  uint64_t next_event_tick() const
+  {
+    for (std::size_t level = 0; level < num_levels; ++level)
+    {
+      std::size_t shift = level * slot_bits;
+      std::size_t digit = (current_tick_ >> shift) & slot_mask;
+      uint64_t later = digit == slot_mask ? 0
+        : occupied_[level] & (~static_cast<uint64_t>(0) << (digit + 1));
+      if (later)
+      {
+        uint64_t base = (current_tick_ >> (shift + slot_bits))
+          << (shift + slot_bits);
+        return base | (static_cast<uint64_t>(lowest_bit(later)) << shift);
+      }
+    }
+    return (std::numeric_limits<uint64_t>::max)();
+  }
+
+  // Get the index of the lowest set bit in a non-zero value.
+  static std::size_t lowest_bit(uint64_t bits)
+  {
+    std::size_t n = 0;
+    if ((bits & 0xFFFFFFFFu) == 0) { n += 32; bits >>= 32; }
+    if ((bits & 0xFFFFu) == 0) { n += 16; bits >>= 16; }
+    if ((bits & 0xFFu) == 0) { n += 8; bits >>= 8; }
+    if ((bits & 0xFu) == 0) { n += 4; bits >>= 4; }
+    if ((bits & 0x3u) == 0) { n += 2; bits >>= 2; }
+    if ((bits & 0x1u) == 0) { n += 1; }
+    return n;
+  }
+
+  // Insert a timer into the slot that corresponds to its expiry tick.
+  void link_timer(per_timer_data& timer)
+  {
+    std::size_t slot = due_slot;
+    if (timer.tick_ > current_tick_)
+    {
+      // Timers beyond the range of the wheel are placed in the furthest slot,
+      // and are reinserted when that slot is reached.
+      uint64_t limit = current_tick_
+        | ((static_cast<uint64_t>(1) << (num_levels * slot_bits)) - 1);
+      uint64_t tick = timer.tick_ < limit ? timer.tick_ : limit;
+
+      std::size_t level = 0;
+      uint64_t diff = tick ^ current_tick_;
+      while (diff >> ((level + 1) * slot_bits))
+        ++level;
+
+      std::size_t index = (tick >> (level * slot_bits)) & slot_mask;
+      slot = level * num_slots + index;
+      occupied_[level] |= static_cast<uint64_t>(1) << index;
+    }
+
+    timer.slot_ = slot;
+    timer.slot_prev_ = 0;
+    timer.slot_next_ = slots_[slot];
+    if (slots_[slot])
+      slots_[slot]->slot_prev_ = &timer;
+    slots_[slot] = &timer;
+  }
+
+  // Remove a timer from its slot.
+  void unlink_timer(per_timer_data& timer)
+  {
+    std::size_t slot = timer.slot_;
+    if (slot > due_slot)
+      return;
+
+    if (slots_[slot] == &timer)
+      slots_[slot] = timer.slot_next_;
+    if (timer.slot_prev_)
+      timer.slot_prev_->slot_next_ = timer.slot_next_;
+    if (timer.slot_next_)
+      timer.slot_next_->slot_prev_ = timer.slot_prev_;
+    timer.slot_next_ = 0;
+    timer.slot_prev_ = 0;
+    timer.slot_ = (std::numeric_limits<std::size_t>::max)();
+
+    if (slots_[slot] == 0 && slot != due_slot)
+      occupied_[slot / num_slots] &=
+        ~(static_cast<uint64_t>(1) << (slot % num_slots));
+  }
+
+  // Reinsert all timers in a slot relative to the current tick.
+  void relink_slot(std::size_t slot)
+  {
+    per_timer_data* timer = slots_[slot];
+    slots_[slot] = 0;
+    occupied_[slot / num_slots] &=
+      ~(static_cast<uint64_t>(1) << (slot % num_slots));
+    while (timer)
+    {
+      per_timer_data* next = timer->slot_next_;
+      link_timer(*timer);
+      timer = next;
+    }
+  }
+
+  // Remove a timer from the wheel and list of timers.
+  void remove_timer(per_timer_data& timer)
+  {
+    unlink_timer(timer);
+
+    // Remove the timer from the linked list of active timers.
+    if (timers_ == &timer)
+      timers_ = timer.next_;
+    if (timer.prev_)
+      timer.prev_->next_ = timer.next_;
+    if (timer.next_)
+      timer.next_->prev_= timer.prev_;
+    timer.next_ = 0;
+    timer.prev_ = 0;
+  }
+
+  // Determine if the specified absolute time is positive infinity.
+  template <typename Time_Type>
+  static bool is_positive_infinity(const Time_Type&)
+  {
+    return false;
+  }
+
+  // Determine if the specified absolute time is positive infinity.
+  template <typename T, typename TimeSystem>
+  static bool is_positive_infinity(
+      const boost::date_time::base_time<T, TimeSystem>& time)
+  {
+    return time.is_pos_infinity();
+  }
+
+  // The head of a linked list of all active timers.
+  per_timer_data* timers_;
+
+  // The time corresponding to tick 0.
+  time_type origin_;
+
+  // The most recent tick to have been processed.
+  uint64_t current_tick_;
+
+  // Bitmasks of the non-empty slots at each level.
+  uint64_t occupied_[num_levels];
+
+  // The slots of the wheel, with the due slot at the end.
+  per_timer_data* slots_[due_slot + 1];
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_TIMER_QUEUE_WHEEL_HPP
@@ -0,0 +1,83 @@
+//
+// handler_memory.hpp
+// ~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_HANDLER_MEMORY_HPP
+#define ASIO_HANDLER_MEMORY_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/detail/cstdint.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+
+/// Statistics describing the recycling of memory allocated for handlers.
+/**
+ * Memory for handlers and operations that use the default allocator is
+ * recycled through the caches of threads that are running an io_context, and
+ * through a cache shared between those threads. Other threads allocate from
+ * the heap. The hit rate of the caches is given by:
+ *
+ * @code (thread_cache_hits + shared_cache_hits) / allocations @endcode
+ *
+ * A low hit rate for a program with many threads may be improved by defining
+ * @c ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE or
+ * @c ASIO_RECYCLING_ALLOCATOR_SHARED_CACHE_SIZE to a larger value.
+ */
+struct handler_memory_statistics
+{
+  /// The number of allocations.
+  uint64_t allocations;
+
+  /// The number of allocations satisfied from the allocating thread's cache.
+  uint64_t thread_cache_hits;
+
+  /// The number of allocations satisfied from the shared cache.
+  uint64_t shared_cache_hits;
+
+  /// The number of allocations satisfied from the heap.
+  uint64_t heap_allocations;
+
+  /// The number of heap allocations that were too large, or too strictly
+  /// aligned, to be recycled.
+  uint64_t oversized_allocations;
+
+  /// The number of deallocations.
+  uint64_t deallocations;
+
+  /// The number of deallocations, and of blocks evicted from the caches, that
+  /// returned memory to the heap.
+  uint64_t heap_deallocations;
+};
+
+/// Obtain statistics describing the recycling of memory allocated for
+/// handlers.
+/**
+ * The statistics are cumulative for all threads. To avoid contention, a
+ * thread that is running an io_context adds its counts periodically, when it
+ * exchanges memory with the shared cache, and when it returns from run(),
+ * run_one(), poll() or poll_one(). The counts of the calling thread are
+ * always included.
+ */
+ASIO_DECL handler_memory_statistics get_handler_memory_statistics();
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/impl/handler_memory.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // ASIO_HANDLER_MEMORY_HPP
@@ -0,0 +1,81 @@
+//
+// handler_tracking.hpp
+// ~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_HANDLER_TRACKING_HPP
+#define ASIO_HANDLER_TRACKING_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/error_code.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+
+/// Start recording handler tracking events.
+/**
+ * When the program is compiled with @c ASIO_ENABLE_BINARY_HANDLER_TRACKING
+ * defined, events are recorded from program startup until
+ * stop_handler_tracking() is called. Otherwise this function has no effect.
+ */
+ASIO_DECL void start_handler_tracking();
+
+/// Stop recording handler tracking events.
+/**
+ * Events that have already been recorded are kept, and may be written using
+ * dump_handler_tracking(). Handlers that are created while tracking is stopped
+ * are not tracked, even if tracking is started again before they complete.
+ */
+ASIO_DECL void stop_handler_tracking();
+
+/// Determine whether handler tracking events are being recorded.
+ASIO_DECL bool handler_tracking_started();
+
+/// Write the recorded handler tracking events to a file.
+/**
+ * Writes the most recent events recorded by each thread to the named file, in
+ * a binary format that is decoded by the @c handlerdecode.pl tool. Recording
+ * continues while the events are written.
+ *
+ * @param filename The name of the file to be written.
+ *
+ * @throws asio::system_error Thrown on failure. If the program was not
+ * compiled with @c ASIO_ENABLE_BINARY_HANDLER_TRACKING, the error is
+ * asio::error::operation_not_supported.
+ */
+ASIO_DECL void dump_handler_tracking(const char* filename);
+
+/// Write the recorded handler tracking events to a file.
+/**
+ * Writes the most recent events recorded by each thread to the named file, in
+ * a binary format that is decoded by the @c handlerdecode.pl tool. Recording
+ * continues while the events are written.
+ *
+ * @param filename The name of the file to be written.
+ *
+ * @param ec Set to indicate what error occurred, if any. If the program was
+ * not compiled with @c ASIO_ENABLE_BINARY_HANDLER_TRACKING, the error is
+ * asio::error::operation_not_supported.
+ */
+ASIO_DECL ASIO_SYNC_OP_VOID dump_handler_tracking(
+    const char* filename, asio::error_code& ec);
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/impl/handler_tracking.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // ASIO_HANDLER_TRACKING_HPP
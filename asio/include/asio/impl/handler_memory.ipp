@@ -0,0 +1,48 @@
+//
+// impl/handler_memory.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_IMPL_HANDLER_MEMORY_IPP
+#define ASIO_IMPL_HANDLER_MEMORY_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/detail/thread_context.hpp"
+#include "asio/detail/thread_info_base.hpp"
+#include "asio/handler_memory.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+
+handler_memory_statistics get_handler_memory_statistics()
+{
+  detail::thread_info_base::memory_statistics s =
+    detail::thread_info_base::get_statistics(
+        detail::thread_context::top_of_thread_call_stack());
+
+  handler_memory_statistics stats;
+  stats.allocations = s.allocations;
+  stats.thread_cache_hits = s.thread_cache_hits;
+  stats.shared_cache_hits = s.shared_cache_hits;
+  stats.heap_allocations = s.heap_allocations;
+  stats.oversized_allocations = s.oversized_allocations;
+  stats.deallocations = s.deallocations;
+  stats.heap_deallocations = s.heap_deallocations;
+  return stats;
+}
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_IMPL_HANDLER_MEMORY_IPP
@@ -0,0 +1,74 @@
+//
+// impl/handler_tracking.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_IMPL_HANDLER_TRACKING_IPP
+#define ASIO_IMPL_HANDLER_TRACKING_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/detail/handler_tracking.hpp"
+#include "asio/detail/throw_error.hpp"
+#include "asio/error.hpp"
+#include "asio/handler_tracking.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+
+void start_handler_tracking()
+{
+#if defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+  detail::binary_handler_tracking::enable(true);
+#endif // defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+}
+
+void stop_handler_tracking()
+{
+#if defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+  detail::binary_handler_tracking::enable(false);
+#endif // defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+}
+
+bool handler_tracking_started()
+{
+#if defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+  return detail::binary_handler_tracking::enabled();
+#else // defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+  return false;
+#endif // defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+}
+
+void dump_handler_tracking(const char* filename)
+{
+  asio::error_code ec;
+  dump_handler_tracking(filename, ec);
+  asio::detail::throw_error(ec, "dump_handler_tracking");
+}
+
+ASIO_SYNC_OP_VOID dump_handler_tracking(
+    const char* filename, asio::error_code& ec)
+{
+#if defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+  detail::binary_handler_tracking::dump(filename, ec);
+#else // defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+  (void)filename;
+  ec = asio::error::operation_not_supported;
+#endif // defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+}
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_IMPL_HANDLER_TRACKING_IPP
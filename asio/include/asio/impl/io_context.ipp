@@ -19,8 +19,11 @@
 #include "asio/io_context.hpp"
 #include "asio/detail/concurrency_hint.hpp"
 #include "asio/detail/limits.hpp"
+#include "asio/detail/scheduler_metrics.hpp"
 #include "asio/detail/scoped_ptr.hpp"
 #include "asio/detail/service_registry.hpp"
+#include "asio/detail/stall_detector.hpp"
+#include "asio/detail/strand_pool.hpp"
 #include "asio/detail/throw_error.hpp"
 
 #if defined(ASIO_HAS_IOCP)
@@ -45,6 +48,40 @@ io_context::io_context(int concurrency_hint)
 {
 }
 
+io_context::io_context(const io_context::options& opts)
+  : impl_(add_impl(new impl_type(*this,
+          opts.concurrency_hint == -1 ? ASIO_CONCURRENCY_HINT_DEFAULT
+          : opts.concurrency_hint == 1 ? ASIO_CONCURRENCY_HINT_1
+          : opts.concurrency_hint, false)))
+{
+#if !defined(ASIO_HAS_IOCP)
+  impl_.set_task_options(opts.event_batch_size, opts.busy_poll_usec);
+  impl_.set_inline_completion_depth(opts.inline_completion_depth);
+#endif // !defined(ASIO_HAS_IOCP)
+
+  if (opts.strand_pool_size != 0)
+  {
+    asio::use_service<detail::strand_pool_service>(*this).set_pool_size(
+        opts.strand_pool_size);
+  }
+
+#if defined(ASIO_HAS_IO_CONTEXT_METRICS)
+  if (opts.enable_metrics)
+    impl_.set_metrics(&asio::use_service<detail::scheduler_metrics>(*this));
+#endif // defined(ASIO_HAS_IO_CONTEXT_METRICS)
+
+#if defined(ASIO_HAS_STALL_DETECTION)
+  if (opts.stall_threshold_usec > 0)
+  {
+    detail::stall_detector& detector =
+      asio::use_service<detail::stall_detector>(*this);
+    detector.start(opts.stall_threshold_usec,
+        opts.stall_handler, opts.stall_handler_context);
+    impl_.set_stall_detector(&detector);
+  }
+#endif // defined(ASIO_HAS_STALL_DETECTION)
+}
+
 io_context::impl_type& io_context::add_impl(io_context::impl_type* impl)
 {
   asio::detail::scoped_ptr<impl_type> scoped_impl(impl);
@@ -131,6 +168,86 @@ void io_context::restart()
   impl_.restart();
 }
 
+io_context::strand_statistics io_context::get_strand_statistics()
+{
+  strand_statistics stats = { 0, 0, 0 };
+  if (has_service<detail::strand_pool_service>(*this))
+  {
+    asio::use_service<detail::strand_pool_service>(*this).get_statistics(
+        stats.pool_size, stats.strands, stats.collisions);
+  }
+  return stats;
+}
+
+io_context::metrics io_context::get_metrics() const
+{
+  metrics m = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    duration_histogram(), duration_histogram() };
+#if !defined(ASIO_HAS_IOCP)
+  m.outstanding_work = static_cast<uint64_t>(impl_.outstanding_work());
+#endif // !defined(ASIO_HAS_IOCP)
+
+#if defined(ASIO_HAS_IO_CONTEXT_METRICS)
+  if (const detail::scheduler_metrics* s = impl_.metrics())
+  {
+    m.operations_queued = s->operations_queued();
+    m.operations_executed = s->operations_executed();
+    m.wakeups = s->wakeups();
+    m.task_runs = s->task_runs();
+    m.task_time = s->task_time();
+    m.handler_time = s->handler_time();
+    m.reactor_waits = s->reactor_waits();
+    m.reactor_events = s->reactor_events();
+    long descriptors = s->registered_descriptors();
+    m.registered_descriptors = static_cast<uint64_t>(
+        descriptors > 0 ? descriptors : 0);
+    long timers = s->pending_timers();
+    m.pending_timers = static_cast<uint64_t>(timers > 0 ? timers : 0);
+    s->get_histograms(m.queue_delay.counts_, m.run_time.counts_);
+  }
+#endif // defined(ASIO_HAS_IO_CONTEXT_METRICS)
+
+  return m;
+}
+
+io_context::duration_histogram::duration_histogram()
+  : counts_(detail::duration_histogram_buckets::count)
+{
+}
+
+uint64_t io_context::duration_histogram::bucket_lower_bound(
+    std::size_t bucket) const
+{
+  return detail::duration_histogram_buckets::lower_bound(bucket);
+}
+
+uint64_t io_context::duration_histogram::total_count() const
+{
+  uint64_t total = 0;
+  for (std::size_t i = 0; i < counts_.size(); ++i)
+    total += counts_[i];
+  return total;
+}
+
+uint64_t io_context::duration_histogram::value_at_percentile(
+    double percentile) const
+{
+  uint64_t total = total_count();
+  if (total == 0)
+    return 0;
+
+  double target = total * (percentile < 0 ? 0
+      : percentile > 100 ? 100 : percentile) / 100;
+  uint64_t seen = 0;
+  for (std::size_t i = 0; i < counts_.size(); ++i)
+  {
+    seen += counts_[i];
+    if (seen != 0 && seen >= target)
+      return bucket_lower_bound(i);
+  }
+  return bucket_lower_bound(counts_.size() - 1);
+}
+
 io_context::service::service(asio::io_context& owner)
   : execution_context::service(owner)
 {
@@ -0,0 +1,89 @@
+//
+// impl/io_context_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_IMPL_IO_CONTEXT_POOL_HPP
+#define ASIO_IMPL_IO_CONTEXT_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/throw_error.hpp"
+#include "asio/post.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+
+inline io_context_pool::executor_type
+io_context_pool::get_executor(std::size_t shard)
+{
+  return get_io_context(shard).get_executor();
+}
+
+template <typename Function>
+void io_context_pool::post(std::size_t shard, ASIO_MOVE_ARG(Function) f)
+{
+  asio::post(get_io_context(shard), ASIO_MOVE_CAST(Function)(f));
+}
+
+#if defined(ASIO_HAS_MOVE)
+
+template <typename Endpoint>
+basic_socket_acceptor<typename Endpoint::protocol_type,
+    io_context_pool::executor_type>
+io_context_pool::make_acceptor(std::size_t shard,
+    const Endpoint& endpoint, int backlog)
+{
+  asio::error_code ec;
+  basic_socket_acceptor<typename Endpoint::protocol_type, executor_type>
+    acceptor(make_acceptor(shard, endpoint, ec, backlog));
+  asio::detail::throw_error(ec, "make_acceptor");
+  return acceptor;
+}
+
+template <typename Endpoint>
+basic_socket_acceptor<typename Endpoint::protocol_type,
+    io_context_pool::executor_type>
+io_context_pool::make_acceptor(std::size_t shard,
+    const Endpoint& endpoint, asio::error_code& ec, int backlog)
+{
+  basic_socket_acceptor<typename Endpoint::protocol_type, executor_type>
+    acceptor(get_executor(shard));
+
+  acceptor.open(endpoint.protocol(), ec);
+  if (ec)
+    return acceptor;
+
+#if defined(SO_REUSEPORT)
+  acceptor.set_option(socket_base::reuse_port(true), ec);
+#endif // defined(SO_REUSEPORT)
+  if (!ec)
+    acceptor.set_option(socket_base::reuse_address(true), ec);
+  if (!ec)
+    acceptor.bind(endpoint, ec);
+  if (!ec)
+    acceptor.listen(backlog, ec);
+  if (ec)
+  {
+    asio::error_code ignored_ec;
+    acceptor.close(ignored_ec);
+  }
+
+  return acceptor;
+}
+
+#endif // defined(ASIO_HAS_MOVE)
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_IMPL_IO_CONTEXT_POOL_HPP
@@ -0,0 +1,231 @@
+//
+// impl/io_context_pool.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_IMPL_IO_CONTEXT_POOL_IPP
+#define ASIO_IMPL_IO_CONTEXT_POOL_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <exception>
+#include <stdexcept>
+#include "asio/detail/call_stack.hpp"
+#include "asio/detail/scoped_ptr.hpp"
+#include "asio/detail/thread_affinity.hpp"
+#include "asio/detail/throw_error.hpp"
+#include "asio/detail/throw_exception.hpp"
+#include "asio/executor_work_guard.hpp"
+#include "asio/io_context_pool.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+
+struct io_context_pool::shard
+{
+  explicit shard(int cpu)
+    : io_context_(1),
+      work_(io_context_.get_executor()),
+      cpu_(cpu)
+  {
+  }
+
+  asio::io_context io_context_;
+  executor_work_guard<io_context::executor_type> work_;
+
+  // The CPU to which the thread should be pinned, and then the CPU to which it
+  // is pinned. Negative if the thread is not pinned.
+  int cpu_;
+};
+
+struct io_context_pool::thread_function
+{
+  io_context_pool* pool_;
+  std::size_t index_;
+
+  void operator()()
+  {
+#if !defined(ASIO_NO_EXCEPTIONS)
+    try
+    {
+#endif// !defined(ASIO_NO_EXCEPTIONS)
+      pool_->run_shard(index_);
+#if !defined(ASIO_NO_EXCEPTIONS)
+    }
+    catch (...)
+    {
+      std::terminate();
+    }
+#endif// !defined(ASIO_NO_EXCEPTIONS)
+  }
+};
+
+io_context_pool::io_context_pool()
+  : num_started_(0)
+{
+  start(detail::thread_affinity::available_cpus());
+}
+
+io_context_pool::io_context_pool(const std::vector<int>& cpus)
+  : num_started_(0)
+{
+  start(cpus);
+}
+
+io_context_pool::io_context_pool(std::size_t num_shards)
+  : num_started_(0)
+{
+  start(std::vector<int>(num_shards, -1));
+}
+
+io_context_pool::~io_context_pool()
+{
+  stop();
+  join();
+  for (std::size_t i = 0; i < shards_.size(); ++i)
+    delete shards_[i];
+}
+
+io_context& io_context_pool::get_io_context(std::size_t shard)
+{
+  if (shard >= shards_.size())
+  {
+    std::out_of_range ex("io_context_pool shard");
+    asio::detail::throw_exception(ex);
+  }
+  return shards_[shard]->io_context_;
+}
+
+int io_context_pool::cpu(std::size_t shard) const
+{
+  if (shard >= shards_.size())
+  {
+    std::out_of_range ex("io_context_pool shard");
+    asio::detail::throw_exception(ex);
+  }
+  return shards_[shard]->cpu_;
+}
+
+std::size_t io_context_pool::current_shard() const ASIO_NOEXCEPT
+{
+  if (std::size_t* index = shard_call_stack::contains(this))
+    return *index;
+  return shards_.size();
+}
+
+void io_context_pool::stop()
+{
+  for (std::size_t i = 0; i < shards_.size(); ++i)
+    shards_[i]->io_context_.stop();
+}
+
+void io_context_pool::join()
+{
+  if (!threads_.empty())
+  {
+    for (std::size_t i = 0; i < shards_.size(); ++i)
+      shards_[i]->work_.reset();
+    threads_.join();
+  }
+}
+
+std::vector<int> io_context_pool::available_cpus()
+{
+  return detail::thread_affinity::available_cpus();
+}
+
+std::vector<int> io_context_pool::numa_node_cpus(int node)
+{
+  asio::error_code ec;
+  std::vector<int> cpus = detail::thread_affinity::numa_node_cpus(node, ec);
+  asio::detail::throw_error(ec, "numa_node_cpus");
+  return cpus;
+}
+
+std::vector<int> io_context_pool::numa_node_cpus(
+    int node, asio::error_code& ec)
+{
+  return detail::thread_affinity::numa_node_cpus(node, ec);
+}
+
+void io_context_pool::start(const std::vector<int>& cpus)
+{
+  if (cpus.empty())
+  {
+    std::invalid_argument ex("io_context_pool requires at least one shard");
+    asio::detail::throw_exception(ex);
+  }
+
+#if !defined(ASIO_NO_EXCEPTIONS)
+  try
+  {
+#endif // !defined(ASIO_NO_EXCEPTIONS)
+    shards_.reserve(cpus.size());
+    for (std::size_t i = 0; i < cpus.size(); ++i)
+    {
+      detail::scoped_ptr<shard> s(new shard(cpus[i]));
+      shards_.push_back(s.get());
+      s.release();
+    }
+
+    for (std::size_t i = 0; i < shards_.size(); ++i)
+    {
+      thread_function f = { this, i };
+      threads_.create_thread(f);
+    }
+#if !defined(ASIO_NO_EXCEPTIONS)
+  }
+  catch (...)
+  {
+    // The destructor does not run when a constructor throws, so stop and join
+    // any threads that were started before destroying the shards.
+    stop();
+    threads_.join();
+    for (std::size_t i = 0; i < shards_.size(); ++i)
+      delete shards_[i];
+    shards_.clear();
+    throw;
+  }
+#endif // !defined(ASIO_NO_EXCEPTIONS)
+
+  // Wait until each thread has tried to pin itself, so that cpu() reports
+  // the outcome.
+  detail::mutex::scoped_lock lock(mutex_);
+  while (num_started_ < shards_.size())
+    started_event_.wait(lock);
+}
+
+void io_context_pool::run_shard(std::size_t index)
+{
+  shard* s = shards_[index];
+  shard_call_stack::context ctx(this, index);
+
+  {
+    detail::mutex::scoped_lock lock(mutex_);
+    if (s->cpu_ >= 0)
+    {
+      asio::error_code ec;
+      if (detail::thread_affinity::pin_this_thread(s->cpu_, ec))
+        s->cpu_ = -1;
+    }
+    if (++num_started_ == shards_.size())
+      started_event_.signal_all(lock);
+  }
+
+  s->io_context_.run();
+}
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_IMPL_IO_CONTEXT_POOL_IPP
@@ -23,6 +23,7 @@
 #include "asio/detail/base_from_cancellation_state.hpp"
 #include "asio/detail/base_from_completion_cond.hpp"
 #include "asio/detail/bind_handler.hpp"
+#include "asio/detail/composed_op_memory.hpp"
 #include "asio/detail/consuming_buffers.hpp"
 #include "asio/detail/dependent_type.hpp"
 #include "asio/detail/handler_alloc_helpers.hpp"
@@ -335,7 +336,8 @@ namespace detail
         stream_(stream),
         buffers_(buffers),
         start_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -346,7 +348,8 @@ namespace detail
         stream_(other.stream_),
         buffers_(other.buffers_),
         start_(other.start_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -360,7 +363,8 @@ namespace detail
         stream_(other.stream_),
         buffers_(ASIO_MOVE_CAST(buffers_type)(other.buffers_)),
         start_(other.start_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -394,6 +398,7 @@ namespace detail
           }
         }
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(
             static_cast<const asio::error_code&>(ec),
             static_cast<const std::size_t&>(buffers_.total_consumed()));
@@ -408,6 +413,7 @@ namespace detail
     buffers_type buffers_;
     int start_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream, typename MutableBufferSequence,
@@ -545,14 +551,16 @@ struct associator<Associator,
     detail::read_op<AsyncReadStream, MutableBufferSequence,
       MutableBufferIterator, CompletionCondition, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_op<AsyncReadStream, MutableBufferSequence,
         MutableBufferIterator, CompletionCondition, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -616,7 +624,8 @@ namespace detail
         buffers_(ASIO_MOVE_CAST(BufferSequence)(buffers)),
         start_(0),
         total_transferred_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -628,7 +637,8 @@ namespace detail
         buffers_(other.buffers_),
         start_(other.start_),
         total_transferred_(other.total_transferred_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -643,7 +653,8 @@ namespace detail
         buffers_(ASIO_MOVE_CAST(DynamicBuffer_v1)(other.buffers_)),
         start_(other.start_),
         total_transferred_(other.total_transferred_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -686,6 +697,7 @@ namespace detail
           }
         }
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(
             static_cast<const asio::error_code&>(ec),
             static_cast<const std::size_t&>(total_transferred_));
@@ -698,6 +710,7 @@ namespace detail
     int start_;
     std::size_t total_transferred_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream, typename DynamicBuffer_v1,
@@ -821,14 +834,16 @@ struct associator<Associator,
     detail::read_dynbuf_v1_op<AsyncReadStream,
       DynamicBuffer_v1, CompletionCondition, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_dynbuf_v1_op<AsyncReadStream,
         DynamicBuffer_v1, CompletionCondition, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -933,7 +948,8 @@ namespace detail
         start_(0),
         total_transferred_(0),
         bytes_available_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -946,7 +962,8 @@ namespace detail
         start_(other.start_),
         total_transferred_(other.total_transferred_),
         bytes_available_(other.bytes_available_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -962,7 +979,8 @@ namespace detail
         start_(other.start_),
         total_transferred_(other.total_transferred_),
         bytes_available_(other.bytes_available_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -1007,6 +1025,7 @@ namespace detail
           }
         }
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(
             static_cast<const asio::error_code&>(ec),
             static_cast<const std::size_t&>(total_transferred_));
@@ -1020,6 +1039,7 @@ namespace detail
     std::size_t total_transferred_;
     std::size_t bytes_available_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream, typename DynamicBuffer_v2,
@@ -1143,14 +1163,16 @@ struct associator<Associator,
     detail::read_dynbuf_v2_op<AsyncReadStream,
       DynamicBuffer_v2, CompletionCondition, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_dynbuf_v2_op<AsyncReadStream,
         DynamicBuffer_v2, CompletionCondition, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -24,6 +24,7 @@
 #include "asio/buffers_iterator.hpp"
 #include "asio/detail/base_from_cancellation_state.hpp"
 #include "asio/detail/bind_handler.hpp"
+#include "asio/detail/composed_op_memory.hpp"
 #include "asio/detail/handler_alloc_helpers.hpp"
 #include "asio/detail/handler_cont_helpers.hpp"
 #include "asio/detail/handler_invoke_helpers.hpp"
@@ -819,7 +820,8 @@ namespace detail
         delim_(delim),
         start_(0),
         search_position_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -831,7 +833,8 @@ namespace detail
         delim_(other.delim_),
         start_(other.start_),
         search_position_(other.search_position_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -844,7 +847,8 @@ namespace detail
         delim_(other.delim_),
         start_(other.start_),
         search_position_(other.search_position_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -928,6 +932,7 @@ namespace detail
           (ec || search_position_ == not_found)
           ? 0 : search_position_;
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(result_ec, result_n);
       }
     }
@@ -939,6 +944,7 @@ namespace detail
     int start_;
     std::size_t search_position_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream,
@@ -1057,14 +1063,16 @@ struct associator<Associator,
     detail::read_until_delim_op_v1<AsyncReadStream,
       DynamicBuffer_v1, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_until_delim_op_v1<AsyncReadStream,
         DynamicBuffer_v1, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -1110,7 +1118,8 @@ namespace detail
         delim_(delim),
         start_(0),
         search_position_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -1122,7 +1131,8 @@ namespace detail
         delim_(other.delim_),
         start_(other.start_),
         search_position_(other.search_position_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -1135,7 +1145,8 @@ namespace detail
         delim_(ASIO_MOVE_CAST(std::string)(other.delim_)),
         start_(other.start_),
         search_position_(other.search_position_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -1230,6 +1241,7 @@ namespace detail
           (ec || search_position_ == not_found)
           ? 0 : search_position_;
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(result_ec, result_n);
       }
     }
@@ -1241,6 +1253,7 @@ namespace detail
     int start_;
     std::size_t search_position_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream,
@@ -1359,14 +1372,16 @@ struct associator<Associator,
     detail::read_until_delim_string_op_v1<AsyncReadStream,
       DynamicBuffer_v1, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_until_delim_string_op_v1<AsyncReadStream,
         DynamicBuffer_v1, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -1417,7 +1432,8 @@ namespace detail
         expr_(expr),
         start_(0),
         search_position_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -1429,7 +1445,8 @@ namespace detail
         expr_(other.expr_),
         start_(other.start_),
         search_position_(other.search_position_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -1442,7 +1459,8 @@ namespace detail
         expr_(other.expr_),
         start_(other.start_),
         search_position_(other.search_position_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -1540,6 +1558,7 @@ namespace detail
           (ec || search_position_ == not_found)
           ? 0 : search_position_;
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(result_ec, result_n);
       }
     }
@@ -1551,6 +1570,7 @@ namespace detail
     int start_;
     std::size_t search_position_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream, typename DynamicBuffer_v1,
@@ -1668,14 +1688,16 @@ struct associator<Associator,
     detail::read_until_expr_op_v1<AsyncReadStream,
       DynamicBuffer_v1, RegEx, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_until_expr_op_v1<AsyncReadStream,
         DynamicBuffer_v1, RegEx, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -1724,7 +1746,8 @@ namespace detail
         match_condition_(match_condition),
         start_(0),
         search_position_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -1736,7 +1759,8 @@ namespace detail
         match_condition_(other.match_condition_),
         start_(other.start_),
         search_position_(other.search_position_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -1749,7 +1773,8 @@ namespace detail
         match_condition_(other.match_condition_),
         start_(other.start_),
         search_position_(other.search_position_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -1843,6 +1868,7 @@ namespace detail
           (ec || search_position_ == not_found)
           ? 0 : search_position_;
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(result_ec, result_n);
       }
     }
@@ -1854,6 +1880,7 @@ namespace detail
     int start_;
     std::size_t search_position_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream, typename DynamicBuffer_v1,
@@ -1975,14 +2002,16 @@ struct associator<Associator,
     detail::read_until_match_op_v1<AsyncReadStream,
       DynamicBuffer_v1, MatchCondition, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_until_match_op_v1<AsyncReadStream,
         DynamicBuffer_v1, MatchCondition, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -2097,7 +2126,8 @@ namespace detail
         start_(0),
         search_position_(0),
         bytes_to_read_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -2110,7 +2140,8 @@ namespace detail
         start_(other.start_),
         search_position_(other.search_position_),
         bytes_to_read_(other.bytes_to_read_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -2124,7 +2155,8 @@ namespace detail
         start_(other.start_),
         search_position_(other.search_position_),
         bytes_to_read_(other.bytes_to_read_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -2212,6 +2244,7 @@ namespace detail
           (ec || search_position_ == not_found)
           ? 0 : search_position_;
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(result_ec, result_n);
       }
     }
@@ -2224,6 +2257,7 @@ namespace detail
     std::size_t search_position_;
     std::size_t bytes_to_read_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream,
@@ -2341,14 +2375,16 @@ struct associator<Associator,
     detail::read_until_delim_op_v2<AsyncReadStream,
       DynamicBuffer_v2, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_until_delim_op_v2<AsyncReadStream,
         DynamicBuffer_v2, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -2391,7 +2427,8 @@ namespace detail
         start_(0),
         search_position_(0),
         bytes_to_read_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -2404,7 +2441,8 @@ namespace detail
         start_(other.start_),
         search_position_(other.search_position_),
         bytes_to_read_(other.bytes_to_read_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -2418,7 +2456,8 @@ namespace detail
         start_(other.start_),
         search_position_(other.search_position_),
         bytes_to_read_(other.bytes_to_read_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -2517,6 +2556,7 @@ namespace detail
           (ec || search_position_ == not_found)
           ? 0 : search_position_;
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(result_ec, result_n);
       }
     }
@@ -2529,6 +2569,7 @@ namespace detail
     std::size_t search_position_;
     std::size_t bytes_to_read_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream,
@@ -2647,14 +2688,16 @@ struct associator<Associator,
     detail::read_until_delim_string_op_v2<AsyncReadStream,
       DynamicBuffer_v2, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_until_delim_string_op_v2<AsyncReadStream,
         DynamicBuffer_v2, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -2703,7 +2746,8 @@ namespace detail
         start_(0),
         search_position_(0),
         bytes_to_read_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -2716,7 +2760,8 @@ namespace detail
         start_(other.start_),
         search_position_(other.search_position_),
         bytes_to_read_(other.bytes_to_read_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -2730,7 +2775,8 @@ namespace detail
         start_(other.start_),
         search_position_(other.search_position_),
         bytes_to_read_(other.bytes_to_read_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -2832,6 +2878,7 @@ namespace detail
           (ec || search_position_ == not_found)
           ? 0 : search_position_;
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(result_ec, result_n);
       }
     }
@@ -2844,6 +2891,7 @@ namespace detail
     std::size_t search_position_;
     std::size_t bytes_to_read_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream, typename DynamicBuffer_v2,
@@ -2962,14 +3010,16 @@ struct associator<Associator,
     detail::read_until_expr_op_v2<AsyncReadStream,
       DynamicBuffer_v2, RegEx, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_until_expr_op_v2<AsyncReadStream,
         DynamicBuffer_v2, RegEx, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -3014,7 +3064,8 @@ namespace detail
         start_(0),
         search_position_(0),
         bytes_to_read_(0),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(handler))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -3027,7 +3078,8 @@ namespace detail
         start_(other.start_),
         search_position_(other.search_position_),
         bytes_to_read_(other.bytes_to_read_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -3041,7 +3093,8 @@ namespace detail
         start_(other.start_),
         search_position_(other.search_position_),
         bytes_to_read_(other.bytes_to_read_),
-        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(ReadHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -3139,6 +3192,7 @@ namespace detail
           (ec || search_position_ == not_found)
           ? 0 : search_position_;
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(ReadHandler)(handler_)(result_ec, result_n);
       }
     }
@@ -3151,6 +3205,7 @@ namespace detail
     std::size_t search_position_;
     std::size_t bytes_to_read_;
     ReadHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncReadStream, typename DynamicBuffer_v2,
@@ -3272,14 +3327,16 @@ struct associator<Associator,
     detail::read_until_match_op_v2<AsyncReadStream,
       DynamicBuffer_v2, MatchCondition, ReadHandler>,
     DefaultCandidate>
-  : Associator<ReadHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, ReadHandler, DefaultCandidate>
 {
-  static typename Associator<ReadHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::type get(
       const detail::read_until_match_op_v2<AsyncReadStream,
         DynamicBuffer_v2, MatchCondition, ReadHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<ReadHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      ReadHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -24,17 +24,22 @@
 #include "asio/impl/execution_context.ipp"
 #include "asio/impl/executor.ipp"
 #include "asio/impl/handler_alloc_hook.ipp"
+#include "asio/impl/handler_memory.ipp"
+#include "asio/impl/handler_tracking.ipp"
 #include "asio/impl/io_context.ipp"
+#include "asio/impl/io_context_pool.ipp"
 #include "asio/impl/multiple_exceptions.ipp"
 #include "asio/impl/serial_port_base.ipp"
 #include "asio/impl/system_context.ipp"
 #include "asio/impl/thread_pool.ipp"
+#include "asio/detail/impl/binary_handler_tracking.ipp"
 #include "asio/detail/impl/buffer_sequence_adapter.ipp"
 #include "asio/detail/impl/descriptor_ops.ipp"
 #include "asio/detail/impl/dev_poll_reactor.ipp"
 #include "asio/detail/impl/epoll_reactor.ipp"
 #include "asio/detail/impl/eventfd_select_interrupter.ipp"
 #include "asio/detail/impl/handler_tracking.ipp"
+#include "asio/detail/impl/io_uring_reactor.ipp"
 #include "asio/detail/impl/kqueue_reactor.ipp"
 #include "asio/detail/impl/null_event.ipp"
 #include "asio/detail/impl/pipe_select_interrupter.ipp"
@@ -52,9 +57,12 @@
 #include "asio/detail/impl/signal_set_service.ipp"
 #include "asio/detail/impl/socket_ops.ipp"
 #include "asio/detail/impl/socket_select_interrupter.ipp"
+#include "asio/detail/impl/stall_detector.ipp"
 #include "asio/detail/impl/strand_executor_service.ipp"
 #include "asio/detail/impl/strand_service.ipp"
+#include "asio/detail/impl/thread_affinity.ipp"
 #include "asio/detail/impl/thread_context.ipp"
+#include "asio/detail/impl/thread_info_base.ipp"
 #include "asio/detail/impl/throw_error.ipp"
 #include "asio/detail/impl/timer_queue_ptime.ipp"
 #include "asio/detail/impl/timer_queue_set.ipp"
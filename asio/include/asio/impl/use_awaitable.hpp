@@ -269,7 +269,9 @@ public:
 
     co_await [&](auto* frame)
       {
+#if defined(ASIO_ENABLE_HANDLER_TRACKING)
         ASIO_HANDLER_LOCATION((u.file_name_, u.line_, u.function_name_));
+#endif // defined(ASIO_ENABLE_HANDLER_TRACKING)
         handler_type handler(frame->detach_thread());
         std::move(initiation)(std::move(handler), std::move(args)...);
         return static_cast<handler_type*>(nullptr);
@@ -22,6 +22,7 @@
 #include "asio/detail/base_from_cancellation_state.hpp"
 #include "asio/detail/base_from_completion_cond.hpp"
 #include "asio/detail/bind_handler.hpp"
+#include "asio/detail/composed_op_memory.hpp"
 #include "asio/detail/consuming_buffers.hpp"
 #include "asio/detail/dependent_type.hpp"
 #include "asio/detail/handler_alloc_helpers.hpp"
@@ -300,7 +301,8 @@ namespace detail
         stream_(stream),
         buffers_(buffers),
         start_(0),
-        handler_(ASIO_MOVE_CAST(WriteHandler)(handler))
+        handler_(ASIO_MOVE_CAST(WriteHandler)(handler)),
+        memory_(handler_, sizeof(*this))
     {
     }
 
@@ -311,7 +313,8 @@ namespace detail
         stream_(other.stream_),
         buffers_(other.buffers_),
         start_(other.start_),
-        handler_(other.handler_)
+        handler_(other.handler_),
+        memory_(other.memory_)
     {
     }
 
@@ -325,7 +328,8 @@ namespace detail
         stream_(other.stream_),
         buffers_(ASIO_MOVE_CAST(buffers_type)(other.buffers_)),
         start_(other.start_),
-        handler_(ASIO_MOVE_CAST(WriteHandler)(other.handler_))
+        handler_(ASIO_MOVE_CAST(WriteHandler)(other.handler_)),
+        memory_(ASIO_MOVE_CAST(composed_op_memory)(other.memory_))
     {
     }
 #endif // defined(ASIO_HAS_MOVE)
@@ -359,6 +363,7 @@ namespace detail
           }
         }
 
+        memory_.release();
         ASIO_MOVE_OR_LVALUE(WriteHandler)(handler_)(
             static_cast<const asio::error_code&>(ec),
             static_cast<const std::size_t&>(buffers_.total_consumed()));
@@ -373,6 +378,7 @@ namespace detail
     buffers_type buffers_;
     int start_;
     WriteHandler handler_;
+    composed_op_memory memory_;
   };
 
   template <typename AsyncWriteStream, typename ConstBufferSequence,
@@ -510,14 +516,16 @@ struct associator<Associator,
     detail::write_op<AsyncWriteStream, ConstBufferSequence,
       ConstBufferIterator, CompletionCondition, WriteHandler>,
     DefaultCandidate>
-  : Associator<WriteHandler, DefaultCandidate>
+  : detail::composed_op_associator<Associator, WriteHandler, DefaultCandidate>
 {
-  static typename Associator<WriteHandler, DefaultCandidate>::type get(
+  static typename detail::composed_op_associator<Associator,
+      WriteHandler, DefaultCandidate>::type get(
       const detail::write_op<AsyncWriteStream, ConstBufferSequence,
         ConstBufferIterator, CompletionCondition, WriteHandler>& h,
       const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
   {
-    return Associator<WriteHandler, DefaultCandidate>::get(h.handler_, c);
+    return detail::composed_op_associator<Associator,
+      WriteHandler, DefaultCandidate>::get(h.handler_, h.memory_, c);
   }
 };
 
@@ -19,7 +19,10 @@
 #include <cstddef>
 #include <stdexcept>
 #include <typeinfo>
+#include <vector>
 #include "asio/async_result.hpp"
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/stall_record.hpp"
 #include "asio/detail/wrapped_handler.hpp"
 #include "asio/error_code.hpp"
 #include "asio/execution.hpp"
@@ -243,6 +246,249 @@ public:
   /// The type used to count the number of handlers executed by the context.
   typedef std::size_t count_type;
 
+#if defined(GENERATING_DOCUMENTATION)
+  /// Information describing a stalled handler.
+  struct stall_report
+  {
+    /// How long, in nanoseconds, the handler had been running when the stall
+    /// was detected. The handler may still be running when it is reported.
+    uint64_t duration;
+
+    /// The address of the completion routine of the outermost operation run
+    /// by the scheduler. Resolving the address to a symbol identifies that
+    /// operation, which is not necessarily the stalled handler. With the
+    /// <tt>epoll</tt> reactor, socket operations are completed by
+    /// @c descriptor_state::do_complete, which runs every handler that became
+    /// ready together. Strands are completed by the strand's invoker, which
+    /// runs the handlers queued on the strand. Use the handler location to
+    /// identify the handler itself.
+    const void* completion_function;
+
+    /// The file of the innermost @c ASIO_HANDLER_LOCATION active within the
+    /// handler, or a null pointer if there is none.
+    const char* file;
+
+    /// The line of the innermost @c ASIO_HANDLER_LOCATION, or 0.
+    int line;
+
+    /// The function of the innermost @c ASIO_HANDLER_LOCATION, or a null
+    /// pointer.
+    const char* function;
+  };
+#else // defined(GENERATING_DOCUMENTATION)
+  typedef detail::stall_report stall_report;
+#endif // defined(GENERATING_DOCUMENTATION)
+
+  /// The type of a function used to report stalled handlers.
+  typedef void (*stall_handler_type)(const stall_report& report, void* context);
+
+  /// Options used to tune the behaviour of an io_context.
+  /**
+   * The event batch size and busy poll options are honoured by
+   * <tt>epoll</tt>-based implementations and ignored elsewhere. The inline
+   * completion depth is honoured by all reactor-based implementations.
+   */
+  class options
+  {
+  public:
+    /// Default constructor. All options take their default values.
+    options()
+      : concurrency_hint(-1),
+        event_batch_size(0),
+        busy_poll_usec(0),
+        inline_completion_depth(0),
+        strand_pool_size(0),
+        enable_metrics(false),
+        stall_threshold_usec(0),
+        stall_handler(0),
+        stall_handler_context(0)
+    {
+    }
+
+    /// A suggestion to the implementation on how many threads it should allow
+    /// to run simultaneously. The default of -1 has the same effect as
+    /// default constructing the io_context.
+    int concurrency_hint;
+
+    /// The maximum number of readiness events to dequeue from the operating
+    /// system in a single wait. A value of 0 selects the implementation's
+    /// default, currently 128.
+    std::size_t event_batch_size;
+
+    /// The maximum time, in microseconds, for which a thread running the
+    /// io_context will spin polling for events before it blocks. While spins
+    /// fail to find events the duration is progressively reduced, and it is
+    /// restored when events arrive. A value of 0 disables busy polling.
+    long busy_poll_usec;
+
+    /// The maximum nesting depth at which handlers may be invoked directly
+    /// from an initiating function. When an asynchronous socket or descriptor
+    /// operation is started from a thread that is running the io_context, and
+    /// the operation completes on its first attempt, its handler is invoked
+    /// before the initiating function returns rather than being posted. Once
+    /// this many such handlers are active on a thread, further completions are
+    /// posted as normal. A value of 0, the default, disables inline completion.
+    /**
+     * @note Enabling inline completion relaxes the guarantee that a handler is
+     * never invoked from within the initiating function. Code that starts an
+     * asynchronous operation must not rely on any state set up after the
+     * initiating function returns.
+     */
+    std::size_t inline_completion_depth;
+
+    /// The number of entries in each pool of state shared between strands.
+    /// Strands created by make_strand() share a pool of mutexes, and
+    /// io_context::strand objects share a pool of strand implementations.
+    /// Strands that hash to the same entry contend with each other, so a
+    /// larger pool suits a program with many concurrent strands. A value of
+    /// 0 selects the default, currently 193.
+    std::size_t strand_pool_size;
+
+    /// Whether the io_context collects the runtime metrics returned by
+    /// get_metrics(). Collection adds two clock reads to each handler and an
+    /// atomic increment to each queued operation, so it is off by default.
+    /// The option is ignored by IOCP-based implementations, and when the
+    /// program is compiled with @c ASIO_DISABLE_IO_CONTEXT_METRICS defined.
+    bool enable_metrics;
+
+    /// The time, in microseconds, for which a handler may run before it is
+    /// reported as stalling the io_context. When non-zero, a monitoring thread
+    /// checks the threads running the io_context several times per threshold
+    /// period, and reports each stalled handler once while it is still
+    /// running. A value of 0, the default, disables stall detection. The
+    /// option is ignored by IOCP-based implementations, and unless the program
+    /// is compiled with @c ASIO_ENABLE_STALL_DETECTION defined.
+    /**
+     * The reports identify the innermost @c ASIO_HANDLER_LOCATION active
+     * within the stalled handler. Annotating a handler with:
+     *
+     * @code ASIO_HANDLER_LOCATION((__FILE__, __LINE__, __func__)); @endcode
+     *
+     * ensures that its stalls are attributed to it.
+     */
+    long stall_threshold_usec;
+
+    /// The function called, from the monitoring thread, to report a stalled
+    /// handler. If null, stalls are reported on standard error.
+    stall_handler_type stall_handler;
+
+    /// The context argument passed to the stall handler.
+    void* stall_handler_context;
+  };
+
+  /// Statistics describing the use of the pools shared between strands.
+  /**
+   * The counts combine strands created by make_strand() with io_context::strand
+   * objects. A high ratio of collisions to strands suggests that
+   * options::strand_pool_size should be increased.
+   */
+  struct strand_statistics
+  {
+    /// The number of entries in each pool.
+    std::size_t pool_size;
+
+    /// The number of strands that have been created.
+    std::size_t strands;
+
+    /// The number of strands that were assigned an entry already in use by
+    /// another strand.
+    std::size_t collisions;
+  };
+
+  /// A histogram of durations, in nanoseconds.
+  /**
+   * Values below 16 nanoseconds are counted exactly. Above that, each power of
+   * two is divided into 8 buckets, so that any value is known to within 12.5%.
+   */
+  class duration_histogram
+  {
+  public:
+    /// Construct an empty histogram.
+    ASIO_DECL duration_histogram();
+
+    /// Get the number of buckets in the histogram.
+    std::size_t bucket_count() const
+    {
+      return counts_.size();
+    }
+
+    /// Get the smallest duration counted by a bucket.
+    ASIO_DECL uint64_t bucket_lower_bound(std::size_t bucket) const;
+
+    /// Get the number of samples counted by a bucket.
+    uint64_t bucket_samples(std::size_t bucket) const
+    {
+      return counts_[bucket];
+    }
+
+    /// Get the total number of samples in the histogram.
+    ASIO_DECL uint64_t total_count() const;
+
+    /// Get the duration below which the given percentage of samples fall.
+    /**
+     * @param percentile A value between 0 and 100.
+     *
+     * @returns The lower bound of the bucket that holds the sample at the
+     * given percentile, or 0 if the histogram is empty.
+     */
+    ASIO_DECL uint64_t value_at_percentile(double percentile) const;
+
+  private:
+    friend class io_context;
+    std::vector<uint64_t> counts_;
+  };
+
+  /// Runtime metrics describing the load on an io_context.
+  /**
+   * Metrics are collected only when the io_context is constructed with
+   * options::enable_metrics set. Otherwise all values other than
+   * @c outstanding_work are zero.
+   */
+  struct metrics
+  {
+    /// The number of operations that have been queued for execution.
+    uint64_t operations_queued;
+
+    /// The number of handlers that have been executed.
+    uint64_t operations_executed;
+
+    /// The number of unfinished operations and work guards keeping the
+    /// io_context running.
+    uint64_t outstanding_work;
+
+    /// The number of times a thread was woken, or the reactor interrupted, to
+    /// execute newly queued work.
+    uint64_t wakeups;
+
+    /// The number of times the reactor task has been run.
+    uint64_t task_runs;
+
+    /// The total time, in nanoseconds, spent running the reactor task,
+    /// including time spent blocked waiting for events.
+    uint64_t task_time;
+
+    /// The total time, in nanoseconds, spent executing handlers.
+    uint64_t handler_time;
+
+    /// The number of waits performed by the reactor.
+    uint64_t reactor_waits;
+
+    /// The number of readiness events returned by the reactor's waits.
+    uint64_t reactor_events;
+
+    /// The number of descriptors currently registered with the reactor.
+    uint64_t registered_descriptors;
+
+    /// The number of timer waits currently pending.
+    uint64_t pending_timers;
+
+    /// The time that handlers spent queued before they were executed.
+    duration_histogram queue_delay;
+
+    /// The time that handlers spent executing.
+    duration_histogram run_time;
+  };
+
   /// Constructor.
   ASIO_DECL io_context();
 
@@ -255,6 +501,14 @@ public:
    */
   ASIO_DECL explicit io_context(int concurrency_hint);
 
+  /// Constructor.
+  /**
+   * Construct with options that tune the io_context's behaviour.
+   *
+   * @param opts The options to be used by the io_context.
+   */
+  ASIO_DECL explicit io_context(const options& opts);
+
   /// Destructor.
   /**
    * On destruction, the io_context performs the following sequence of
@@ -535,6 +789,25 @@ public:
    */
   ASIO_DECL void restart();
 
+  /// Obtain statistics describing the use of the pools shared between strands.
+  /**
+   * @returns The pool size and the number of strands and collisions counted
+   * since the io_context was constructed.
+   */
+  ASIO_DECL strand_statistics get_strand_statistics();
+
+  /// Obtain the runtime metrics collected by the io_context.
+  /**
+   * The metrics are read without locking and may be called from any thread,
+   * including while other threads are running the io_context. Each value is
+   * read separately, so values may be mutually inconsistent by the operations
+   * that complete while they are being read.
+   *
+   * The reactor counters are collected only by <tt>epoll</tt>-based
+   * implementations.
+   */
+  ASIO_DECL metrics get_metrics() const;
+
 #if !defined(ASIO_NO_DEPRECATED)
   /// (Deprecated: Use restart().) Reset the io_context in preparation for a
   /// subsequent run() invocation.
@@ -0,0 +1,275 @@
+//
+// io_context_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_IO_CONTEXT_POOL_HPP
+#define ASIO_IO_CONTEXT_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <vector>
+#include "asio/basic_socket_acceptor.hpp"
+#include "asio/detail/call_stack.hpp"
+#include "asio/detail/event.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/noncopyable.hpp"
+#include "asio/detail/thread_group.hpp"
+#include "asio/error_code.hpp"
+#include "asio/io_context.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+
+/// A pool of io_context objects, each run by its own thread.
+/**
+ * The io_context_pool class supports servers that are divided into shards,
+ * with one shard for each CPU. Each shard has an io_context that is run by a
+ * single thread, and that thread may be pinned to a CPU. Objects that are
+ * created on a shard's io_context have their handlers run only by that
+ * thread, and so those handlers never migrate between CPUs.
+ *
+ * Shards may communicate by posting function objects to one another. These
+ * are added to the target io_context's queue of remotely posted handlers,
+ * which does not require a lock.
+ *
+ * A server may accept connections on every shard by creating an acceptor on
+ * each shard with make_acceptor(). The acceptors are bound to the same
+ * endpoint using the SO_REUSEPORT socket option, so that the kernel
+ * distributes incoming connections between them.
+ *
+ * @par Example
+ * @code asio::io_context_pool pool;
+ * asio::ip::tcp::endpoint endpoint(asio::ip::tcp::v4(), 8080);
+ *
+ * for (std::size_t i = 0; i < pool.size(); ++i)
+ * {
+ *   // Each server object accepts and handles connections on one shard.
+ *   servers.emplace_back(new server(pool.make_acceptor(i, endpoint)));
+ * }
+ *
+ * pool.join(); @endcode
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Safe, except that stop() and join() must not be
+ * called concurrently with the destructor.
+ */
+class io_context_pool
+  : private noncopyable
+{
+public:
+  /// The type of the executor associated with each shard.
+  typedef io_context::executor_type executor_type;
+
+  /// Constructs a pool with one shard for each CPU on which the process is
+  /// permitted to run.
+  /**
+   * Each shard's thread is pinned to its CPU.
+   */
+  ASIO_DECL io_context_pool();
+
+  /// Constructs a pool with one shard for each CPU in a list.
+  /**
+   * Each shard's thread is pinned to the corresponding CPU. If a thread
+   * cannot be pinned, for example because the CPU is not available to the
+   * process, the thread runs without being pinned and cpu() returns -1 for
+   * that shard.
+   *
+   * @param cpus The CPUs to which the shards' threads are pinned. A CPU may
+   * appear more than once. The functions available_cpus() and numa_node_cpus()
+   * may be used to obtain a list.
+   */
+  ASIO_DECL explicit io_context_pool(const std::vector<int>& cpus);
+
+  /// Constructs a pool with a specified number of shards, whose threads are
+  /// not pinned.
+  ASIO_DECL explicit io_context_pool(std::size_t num_shards);
+
+  /// Destructor.
+  /**
+   * Automatically stops and joins the pool, if not explicitly done beforehand.
+   */
+  ASIO_DECL ~io_context_pool();
+
+  /// Get the number of shards in the pool.
+  std::size_t size() const ASIO_NOEXCEPT
+  {
+    return shards_.size();
+  }
+
+  /// Get the io_context for a shard.
+  /**
+   * @throws std::out_of_range Thrown if @c shard is not less than size().
+   */
+  ASIO_DECL io_context& get_io_context(std::size_t shard);
+
+  /// Get the executor for a shard.
+  /**
+   * @throws std::out_of_range Thrown if @c shard is not less than size().
+   */
+  executor_type get_executor(std::size_t shard);
+
+  /// Get the CPU to which a shard's thread is pinned.
+  /**
+   * @returns The CPU, or -1 if the thread is not pinned.
+   *
+   * @throws std::out_of_range Thrown if @c shard is not less than size().
+   */
+  ASIO_DECL int cpu(std::size_t shard) const;
+
+  /// Get the shard whose thread is calling the function.
+  /**
+   * @returns The index of the shard, or size() if the calling thread is not
+   * running any of the pool's io_context objects.
+   */
+  ASIO_DECL std::size_t current_shard() const ASIO_NOEXCEPT;
+
+  /// Submit a function object to be run on a shard.
+  /**
+   * The function object is always queued, even if it is submitted from the
+   * target shard's thread.
+   *
+   * @param shard The index of the shard.
+   *
+   * @param f The function object to be run. It must be callable with the
+   * signature @c void().
+   *
+   * @throws std::out_of_range Thrown if @c shard is not less than size().
+   */
+  template <typename Function>
+  void post(std::size_t shard, ASIO_MOVE_ARG(Function) f);
+
+#if defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Create an acceptor on a shard.
+  /**
+   * This function creates an acceptor on the shard's io_context, and sets the
+   * SO_REUSEPORT socket option, where available, and the SO_REUSEADDR socket
+   * option before binding it to the specified endpoint and listening on it.
+   * Calling this function once for each shard with the same endpoint creates
+   * acceptors between which the kernel distributes incoming connections.
+   *
+   * @param shard The index of the shard.
+   *
+   * @param endpoint The endpoint on which the acceptor will listen.
+   *
+   * @param backlog The maximum length of the queue of pending connections.
+   *
+   * @throws asio::system_error Thrown on failure.
+   */
+  template <typename Endpoint>
+  basic_socket_acceptor<typename Endpoint::protocol_type, executor_type>
+  make_acceptor(std::size_t shard, const Endpoint& endpoint,
+      int backlog = socket_base::max_listen_connections);
+
+  /// Create an acceptor on a shard.
+  /**
+   * This function creates an acceptor on the shard's io_context, and sets the
+   * SO_REUSEPORT socket option, where available, and the SO_REUSEADDR socket
+   * option before binding it to the specified endpoint and listening on it.
+   *
+   * @param shard The index of the shard.
+   *
+   * @param endpoint The endpoint on which the acceptor will listen.
+   *
+   * @param ec Set to indicate what error occurred, if any. On failure the
+   * returned acceptor is closed.
+   *
+   * @param backlog The maximum length of the queue of pending connections.
+   */
+  template <typename Endpoint>
+  basic_socket_acceptor<typename Endpoint::protocol_type, executor_type>
+  make_acceptor(std::size_t shard, const Endpoint& endpoint,
+      asio::error_code& ec, int backlog = socket_base::max_listen_connections);
+#endif // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Stops the threads.
+  /**
+   * This function stops every shard's io_context as soon as possible. As a
+   * result of calling @c stop(), pending handlers may never be invoked.
+   */
+  ASIO_DECL void stop();
+
+  /// Joins the threads.
+  /**
+   * This function blocks until the threads in the pool have completed. If @c
+   * stop() is not called prior to @c join(), the @c join() call will wait
+   * until no shard has any outstanding work.
+   *
+   * Each shard's thread exits as soon as its own io_context runs out of work,
+   * even if another shard may later post to it. A shard that is waiting for
+   * messages from other shards should be kept running with an
+   * executor_work_guard.
+   */
+  ASIO_DECL void join();
+
+  /// Get the CPUs on which the calling process is permitted to run.
+  ASIO_DECL static std::vector<int> available_cpus();
+
+  /// Get the CPUs that belong to a NUMA node.
+  /**
+   * This function is supported on Linux only.
+   *
+   * @throws asio::system_error Thrown on failure.
+   */
+  ASIO_DECL static std::vector<int> numa_node_cpus(int node);
+
+  /// Get the CPUs that belong to a NUMA node.
+  /**
+   * This function is supported on Linux only.
+   *
+   * @param node The NUMA node.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  ASIO_DECL static std::vector<int> numa_node_cpus(
+      int node, asio::error_code& ec);
+
+private:
+  struct shard;
+  struct thread_function;
+  friend struct thread_function;
+
+  // Records the pool and shard, if any, whose io_context the current thread
+  // is running.
+  typedef detail::call_stack<const io_context_pool, std::size_t>
+    shard_call_stack;
+
+  // Create the shards and start their threads.
+  ASIO_DECL void start(const std::vector<int>& cpus);
+
+  // Pin the calling thread and run a shard's io_context.
+  ASIO_DECL void run_shard(std::size_t index);
+
+  // The shards, each of which is owned by the pool.
+  std::vector<shard*> shards_;
+
+  // The threads that run the shards.
+  detail::thread_group threads_;
+
+  // Used to wait for the threads to be pinned.
+  detail::mutex mutex_;
+  detail::event started_event_;
+  std::size_t num_started_;
+};
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#include "asio/impl/io_context_pool.hpp"
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/impl/io_context_pool.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // ASIO_IO_CONTEXT_POOL_HPP
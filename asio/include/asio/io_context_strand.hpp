@@ -103,15 +103,42 @@ public:
     service_.construct(impl_);
   }
 
+  /// Copy constructor.
+  /**
+   * The new strand shares the state of @c other, so that handlers dispatched
+   * through either object are not run concurrently.
+   */
+  strand(const strand& other) ASIO_NOEXCEPT
+    : service_(other.service_)
+  {
+    asio::detail::strand_service::copy(impl_, other.impl_);
+  }
+
+#if defined(ASIO_HAS_MOVE)
+  /// Move constructor.
+  /**
+   * The new strand takes over the state of @c other, which may then only be
+   * destroyed.
+   */
+  strand(strand&& other) ASIO_NOEXCEPT
+    : service_(other.service_),
+      impl_(other.impl_)
+  {
+    other.impl_ = 0;
+  }
+#endif // defined(ASIO_HAS_MOVE)
+
   /// Destructor.
   /**
    * Destroys a strand.
    *
    * Handlers posted through the strand that have not yet been invoked will
    * still be dispatched in a way that meets the guarantee of non-concurrency.
+   * A strand may be destroyed after its io_context.
    */
   ~strand()
   {
+    asio::detail::strand_service::destroy(impl_);
   }
 
   /// Obtain the underlying execution context.
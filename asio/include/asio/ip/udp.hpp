@@ -17,6 +17,7 @@
 
 #include "asio/detail/config.hpp"
 #include "asio/basic_datagram_socket.hpp"
+#include "asio/detail/socket_option.hpp"
 #include "asio/detail/socket_types.hpp"
 #include "asio/ip/basic_endpoint.hpp"
 #include "asio/ip/basic_resolver.hpp"
@@ -81,6 +82,84 @@ public:
   /// The UDP resolver type.
   typedef basic_resolver<udp> resolver;
 
+  /// Socket option for the size of datagrams sent using segmentation offload.
+  /**
+   * Implements the IPPROTO_UDP/UDP_SEGMENT socket option. This option is
+   * available on Linux only.
+   *
+   * When set to a non-zero value, each send operation on the socket is split
+   * into datagrams of the given size by the kernel, or by the network
+   * interface, in the same way as basic_datagram_socket::send_segments().
+   *
+   * @par Examples
+   * Setting the option:
+   * @code
+   * asio::ip::udp::socket socket(my_context);
+   * ...
+   * asio::ip::udp::segment_size option(1200);
+   * socket.set_option(option);
+   * @endcode
+   *
+   * @par
+   * Getting the current option value:
+   * @code
+   * asio::ip::udp::socket socket(my_context);
+   * ...
+   * asio::ip::udp::segment_size option;
+   * socket.get_option(option);
+   * int size = option.value();
+   * @endcode
+   *
+   * @par Concepts:
+   * Socket_Option, Integer_Socket_Option.
+   */
+#if defined(GENERATING_DOCUMENTATION)
+  typedef implementation_defined segment_size;
+#elif defined(ASIO_HAS_UDP_GSO)
+  typedef asio::detail::socket_option::integer<
+    ASIO_OS_DEF(IPPROTO_UDP), UDP_SEGMENT> segment_size;
+#endif
+
+  /// Socket option to allow received datagrams to be coalesced.
+  /**
+   * Implements the IPPROTO_UDP/UDP_GRO socket option. This option is available
+   * on Linux only.
+   *
+   * When enabled, the kernel may coalesce consecutive datagrams of the same
+   * size from the same sender into a single receive. Use
+   * basic_datagram_socket::receive_segments() or
+   * basic_datagram_socket::async_receive_segments() to learn the size of the
+   * individual datagrams.
+   *
+   * @par Examples
+   * Setting the option:
+   * @code
+   * asio::ip::udp::socket socket(my_context);
+   * ...
+   * asio::ip::udp::receive_offload option(true);
+   * socket.set_option(option);
+   * @endcode
+   *
+   * @par
+   * Getting the current option value:
+   * @code
+   * asio::ip::udp::socket socket(my_context);
+   * ...
+   * asio::ip::udp::receive_offload option;
+   * socket.get_option(option);
+   * bool is_set = option.value();
+   * @endcode
+   *
+   * @par Concepts:
+   * Socket_Option, Boolean_Socket_Option.
+   */
+#if defined(GENERATING_DOCUMENTATION)
+  typedef implementation_defined receive_offload;
+#elif defined(ASIO_HAS_UDP_GSO)
+  typedef asio::detail::socket_option::boolean<
+    ASIO_OS_DEF(IPPROTO_UDP), UDP_GRO> receive_offload;
+#endif
+
   /// Compare two protocols for equality.
   friend bool operator==(const udp& p1, const udp& p2)
   {
@@ -396,6 +396,47 @@ public:
       reuse_address;
 #endif
 
+  /// Socket option to allow several sockets to bind to the same address and
+  /// port.
+  /**
+   * Implements the SOL_SOCKET/SO_REUSEPORT socket option. This option is
+   * available only on platforms that define SO_REUSEPORT.
+   *
+   * When the option is set on a number of acceptors before they are bound to
+   * the same endpoint, the kernel distributes incoming connections between
+   * them. On Linux, all of the sockets must be created by processes with the
+   * same effective user ID.
+   *
+   * @par Examples
+   * Setting the option:
+   * @code
+   * asio::ip::tcp::acceptor acceptor(my_context);
+   * ...
+   * asio::socket_base::reuse_port option(true);
+   * acceptor.set_option(option);
+   * @endcode
+   *
+   * @par
+   * Getting the current option value:
+   * @code
+   * asio::ip::tcp::acceptor acceptor(my_context);
+   * ...
+   * asio::socket_base::reuse_port option;
+   * acceptor.get_option(option);
+   * bool is_set = option.value();
+   * @endcode
+   *
+   * @par Concepts:
+   * Socket_Option, Boolean_Socket_Option.
+   */
+#if defined(GENERATING_DOCUMENTATION)
+  typedef implementation_defined reuse_port;
+#elif defined(SO_REUSEPORT)
+  typedef asio::detail::socket_option::boolean<
+    ASIO_OS_DEF(SOL_SOCKET), SO_REUSEPORT>
+      reuse_port;
+#endif
+
   /// Socket option to specify whether the socket lingers on close if unsent
   /// data is present.
   /**
@@ -503,6 +544,49 @@ public:
     enable_connection_aborted;
 #endif
 
+  /// Socket option to enable zero-copy sends.
+  /**
+   * Implements the SOL_SOCKET/SO_ZEROCOPY socket option. This option is
+   * available on Linux only.
+   *
+   * Once the option has been set on a stream socket, asynchronous send
+   * operations of 16 KB or more ask the kernel to transmit directly from the
+   * caller's buffers rather than copying them. Such an operation completes only
+   * after the kernel has reported that it no longer needs the buffers, and so
+   * the buffers must remain valid and unmodified until then. If the operation
+   * is cancelled, the kernel may still be transmitting from the buffers when
+   * the handler is called.
+   *
+   * @par Examples
+   * Setting the option:
+   * @code
+   * asio::ip::tcp::socket socket(my_context);
+   * ...
+   * asio::socket_base::zero_copy option(true);
+   * socket.set_option(option);
+   * @endcode
+   *
+   * @par
+   * Getting the current option value:
+   * @code
+   * asio::ip::tcp::socket socket(my_context);
+   * ...
+   * asio::socket_base::zero_copy option;
+   * socket.get_option(option);
+   * bool is_set = option.value();
+   * @endcode
+   *
+   * @par Concepts:
+   * Socket_Option, Boolean_Socket_Option.
+   */
+#if defined(GENERATING_DOCUMENTATION)
+  typedef implementation_defined zero_copy;
+#elif defined(ASIO_HAS_MSG_ZEROCOPY)
+  typedef asio::detail::socket_option::boolean<
+    ASIO_OS_DEF(SOL_SOCKET), SO_ZEROCOPY>
+      zero_copy;
+#endif
+
   /// IO control command to get the amount of data that can be read without
   /// blocking.
   /**
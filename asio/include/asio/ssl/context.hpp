@@ -201,6 +201,211 @@ public:
   ASIO_DECL ASIO_SYNC_OP_VOID set_verify_depth(
       int depth, asio::error_code& ec);
 
+  /// Set the sizes of the buffers used by streams.
+  /**
+   * This function may be used to configure the sizes of the buffers that are
+   * used by streams constructed with the context to hold data read from and
+   * written to the underlying transport. The buffers are allocated when a
+   * stream first performs an operation.
+   *
+   * @param input_size The size of the buffer used to hold data received from
+   * the transport.
+   *
+   * @param output_size The size of the buffer used to hold data to be sent to
+   * the transport.
+   *
+   * @throws asio::system_error Thrown on failure.
+   *
+   * @note The default size of each buffer, 17 KiB, is sufficient to hold the
+   * largest possible TLS record. Smaller buffers reduce the memory used by each
+   * connection at the expense of more operations on the transport.
+   */
+  ASIO_DECL void set_buffer_sizes(
+      std::size_t input_size, std::size_t output_size);
+
+  /// Set the sizes of the buffers used by streams.
+  /**
+   * This function may be used to configure the sizes of the buffers that are
+   * used by streams constructed with the context to hold data read from and
+   * written to the underlying transport. The buffers are allocated when a
+   * stream first performs an operation.
+   *
+   * @param input_size The size of the buffer used to hold data received from
+   * the transport.
+   *
+   * @param output_size The size of the buffer used to hold data to be sent to
+   * the transport.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @note The default size of each buffer, 17 KiB, is sufficient to hold the
+   * largest possible TLS record. Smaller buffers reduce the memory used by each
+   * connection at the expense of more operations on the transport.
+   */
+  ASIO_DECL ASIO_SYNC_OP_VOID set_buffer_sizes(std::size_t input_size,
+      std::size_t output_size, asio::error_code& ec);
+
+  /// Get the size of the buffer used by streams to hold received data.
+  std::size_t input_buffer_size() const
+  {
+    return input_buffer_size_;
+  }
+
+  /// Get the size of the buffer used by streams to hold data to be sent.
+  std::size_t output_buffer_size() const
+  {
+    return output_buffer_size_;
+  }
+
+  /// Set whether streams release their buffers while waiting for data.
+  /**
+   * This function may be used to configure streams constructed with the
+   * context to return their buffers to a pool, shared with other streams
+   * using the same execution context, while they wait for data to be received
+   * and no other operation is in progress. The buffers are obtained again once
+   * the transport becomes readable.
+   *
+   * @param enable Whether idle buffers are released. Disabled by default.
+   *
+   * @note Buffers are released only by streams over a basic_stream_socket.
+   * Each read that must wait then checks the socket for available data and
+   * waits for readiness before reading, which reduces the memory used by idle
+   * connections at the expense of extra operations on busy ones.
+   */
+  void set_release_idle_buffers(bool enable)
+  {
+    release_idle_buffers_ = enable;
+  }
+
+  /// Get whether streams release their buffers while waiting for data.
+  bool release_idle_buffers() const
+  {
+    return release_idle_buffers_;
+  }
+
+  /// Set the maximum number of sessions cached for resumption.
+  /**
+   * This function may be used to bound the number of sessions that are kept
+   * for resumption. For a client, these are the sessions stored for the peers
+   * identified using ssl::stream::set_session_cache_peer(). For a server, they
+   * are the sessions resumed by session ID rather than by session ticket.
+   *
+   * @param max_sessions The maximum number of sessions. A value of zero
+   * disables the caching of sessions.
+   *
+   * @throws asio::system_error Thrown on failure.
+   *
+   * @note Calls @c SSL_CTX_sess_set_cache_size. The session cache installs
+   * the context's new session callback. A callback that was installed with
+   * @c SSL_CTX_sess_set_new_cb beforehand continues to be called, but one that
+   * is installed afterwards prevents sessions from being stored for peers.
+   */
+  ASIO_DECL void set_session_cache_size(std::size_t max_sessions);
+
+  /// Set the maximum number of sessions cached for resumption.
+  /**
+   * This function may be used to bound the number of sessions that are kept
+   * for resumption. For a client, these are the sessions stored for the peers
+   * identified using ssl::stream::set_session_cache_peer(). For a server, they
+   * are the sessions resumed by session ID rather than by session ticket.
+   *
+   * @param max_sessions The maximum number of sessions. A value of zero
+   * disables the caching of sessions.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @note Calls @c SSL_CTX_sess_set_cache_size. The session cache installs
+   * the context's new session callback. A callback that was installed with
+   * @c SSL_CTX_sess_set_new_cb beforehand continues to be called, but one that
+   * is installed afterwards prevents sessions from being stored for peers.
+   */
+  ASIO_DECL ASIO_SYNC_OP_VOID set_session_cache_size(
+      std::size_t max_sessions, asio::error_code& ec);
+
+  /// Rotate the key used to protect session tickets.
+  /**
+   * This function may be used by a server to replace the key used to protect
+   * the session tickets it issues with a new, randomly generated key. Tickets
+   * protected by the previous key continue to be accepted until the key is
+   * rotated again, and a client resuming such a ticket is issued a new one.
+   *
+   * @throws asio::system_error Thrown on failure.
+   *
+   * @note Calls @c SSL_CTX_set_tlsext_ticket_key_evp_cb or
+   * @c SSL_CTX_set_tlsext_ticket_key_cb.
+   */
+  ASIO_DECL void rotate_session_ticket_key();
+
+  /// Rotate the key used to protect session tickets.
+  /**
+   * This function may be used by a server to replace the key used to protect
+   * the session tickets it issues with a new, randomly generated key. Tickets
+   * protected by the previous key continue to be accepted until the key is
+   * rotated again, and a client resuming such a ticket is issued a new one.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @note Calls @c SSL_CTX_set_tlsext_ticket_key_evp_cb or
+   * @c SSL_CTX_set_tlsext_ticket_key_cb.
+   */
+  ASIO_DECL ASIO_SYNC_OP_VOID rotate_session_ticket_key(
+      asio::error_code& ec);
+
+  /// Rotate the key used to protect session tickets.
+  /**
+   * This function may be used by a server to replace the key used to protect
+   * the session tickets it issues. Servers that share the same key material
+   * may resume each other's sessions. Tickets protected by the previous key
+   * continue to be accepted until the key is rotated again, and a client
+   * resuming such a ticket is issued a new one.
+   *
+   * @param key A buffer containing 80 bytes of secret key material: a 16 byte
+   * key name, followed by a 32 byte HMAC key and a 32 byte AES key.
+   *
+   * @throws asio::system_error Thrown on failure.
+   *
+   * @note Calls @c SSL_CTX_set_tlsext_ticket_key_evp_cb or
+   * @c SSL_CTX_set_tlsext_ticket_key_cb.
+   */
+  ASIO_DECL void rotate_session_ticket_key(const const_buffer& key);
+
+  /// Rotate the key used to protect session tickets.
+  /**
+   * This function may be used by a server to replace the key used to protect
+   * the session tickets it issues. Servers that share the same key material
+   * may resume each other's sessions. Tickets protected by the previous key
+   * continue to be accepted until the key is rotated again, and a client
+   * resuming such a ticket is issued a new one.
+   *
+   * @param key A buffer containing 80 bytes of secret key material: a 16 byte
+   * key name, followed by a 32 byte HMAC key and a 32 byte AES key.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @note Calls @c SSL_CTX_set_tlsext_ticket_key_evp_cb or
+   * @c SSL_CTX_set_tlsext_ticket_key_cb.
+   */
+  ASIO_DECL ASIO_SYNC_OP_VOID rotate_session_ticket_key(
+      const const_buffer& key, asio::error_code& ec);
+
+  /// Get the number of handshakes that resumed a session.
+  /**
+   * Handshakes are counted for streams constructed after the context's session
+   * cache has been enabled by set_session_cache_size() or
+   * rotate_session_ticket_key(), and for streams on which
+   * ssl::stream::set_session_cache_peer() has been called.
+   */
+  ASIO_DECL std::size_t session_cache_hits() const;
+
+  /// Get the number of handshakes that did not resume a session.
+  /**
+   * Handshakes are counted for streams constructed after the context's session
+   * cache has been enabled by set_session_cache_size() or
+   * rotate_session_ticket_key(), and for streams on which
+   * ssl::stream::set_session_cache_peer() has been called.
+   */
+  ASIO_DECL std::size_t session_cache_misses() const;
+
   /// Set the callback used to verify peer certificates.
   /**
    * This function is used to specify a callback function that will be called
@@ -712,6 +917,10 @@ public:
       asio::error_code& ec);
 
 private:
+  // The default size of the buffers used by streams, which is sufficient to
+  // hold the largest possible TLS record.
+  enum { default_buffer_size = 17 * 1024 };
+
   struct bio_cleanup;
   struct x509_cleanup;
   struct evp_pkey_cleanup;
@@ -744,6 +953,13 @@ private:
   // The underlying native implementation.
   native_handle_type handle_;
 
+  // The sizes of the buffers used by streams constructed with the context.
+  std::size_t input_buffer_size_;
+  std::size_t output_buffer_size_;
+
+  // Whether streams constructed with the context release idle buffers.
+  bool release_idle_buffers_;
+
   // Ensure openssl is initialised.
   asio::ssl::detail::openssl_init<> init_;
 };
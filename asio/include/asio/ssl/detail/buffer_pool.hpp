@@ -0,0 +1,170 @@
+//
+// ssl/detail/buffer_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_BUFFER_POOL_HPP
+#define ASIO_SSL_DETAIL_BUFFER_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <new>
+#include "asio/detail/mutex.hpp"
+#include "asio/execution_context.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace ssl {
+namespace detail {
+
+// A pool of the buffers used by the SSL streams that are associated with an
+// execution context. A stream holds its buffers only while it has operations
+// in progress, and returns them to the pool when it becomes idle.
+class buffer_pool
+  : public asio::detail::execution_context_service_base<buffer_pool>
+{
+public:
+  // The maximum number of unused buffers of each size that are kept by the
+  // pool. Any further buffers are freed when they are returned.
+  enum { max_unused_buffers = 64 };
+
+  // Constructor.
+  buffer_pool(asio::execution_context& ctx)
+    : asio::detail::execution_context_service_base<buffer_pool>(ctx),
+      first_size_class_(0)
+  {
+  }
+
+  // Destructor.
+  ~buffer_pool()
+  {
+    while (size_class* c = first_size_class_)
+    {
+      while (block* b = c->first_)
+      {
+        c->first_ = b->next_;
+        ::operator delete(b);
+      }
+      first_size_class_ = c->next_;
+      delete c;
+    }
+  }
+
+  // Destroy all user-defined handler objects owned by the service.
+  void shutdown()
+  {
+  }
+
+  // Allocate a buffer of the specified size.
+  void* allocate(std::size_t size)
+  {
+    {
+      asio::detail::mutex::scoped_lock lock(mutex_);
+      if (size_class* c = find(size))
+      {
+        if (block* b = c->first_)
+        {
+          c->first_ = b->next_;
+          --c->count_;
+          return b;
+        }
+      }
+    }
+
+    return ::operator new(size < sizeof(block) ? sizeof(block) : size);
+  }
+
+  // Return a buffer of the specified size to the pool.
+  void deallocate(void* p, std::size_t size)
+  {
+    if (!p)
+      return;
+
+    {
+      asio::detail::mutex::scoped_lock lock(mutex_);
+      size_class* c = find(size);
+      if (!c)
+      {
+        c = new (std::nothrow) size_class(size, first_size_class_);
+        if (c)
+          first_size_class_ = c;
+      }
+
+      if (c && c->count_ < max_unused_buffers)
+      {
+        block* b = static_cast<block*>(p);
+        b->next_ = c->first_;
+        c->first_ = b;
+        ++c->count_;
+        return;
+      }
+    }
+
+    ::operator delete(p);
+  }
+
+  // Get the number of unused buffers of the specified size.
+  std::size_t unused_buffers(std::size_t size)
+  {
+    asio::detail::mutex::scoped_lock lock(mutex_);
+    size_class* c = find(size);
+    return c ? c->count_ : 0;
+  }
+
+private:
+  // An unused buffer.
+  struct block
+  {
+    block* next_;
+  };
+
+  // The unused buffers of one size.
+  struct size_class
+  {
+    size_class(std::size_t size, size_class* next)
+      : size_(size),
+        count_(0),
+        first_(0),
+        next_(next)
+    {
+    }
+
+    std::size_t size_;
+    std::size_t count_;
+    block* first_;
+    size_class* next_;
+  };
+
+  // Find the unused buffers of the specified size.
+  size_class* find(std::size_t size) const
+  {
+    for (size_class* c = first_size_class_; c; c = c->next_)
+      if (c->size_ == size)
+        return c;
+    return 0;
+  }
+
+  // Mutex to protect access to the unused buffers.
+  asio::detail::mutex mutex_;
+
+  // The sizes for which buffers have been returned to the pool.
+  size_class* first_size_class_;
+};
+
+} // namespace detail
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_SSL_DETAIL_BUFFER_POOL_HPP
@@ -74,7 +74,11 @@ private:
       engine::want want = eng.handshake(type_, ec);
       if (want != engine::want_input_and_retry
           || bytes_transferred == total_buffer_size_)
+      {
+        // The caller's buffers may not outlive the operation.
+        eng.retain_input();
         return want;
+      }
 
       // Find the next buffer piece to be fed to the engine.
       while (iter != end)
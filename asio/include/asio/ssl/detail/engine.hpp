@@ -17,6 +17,8 @@
 
 #include "asio/detail/config.hpp"
 
+#include <string>
+#include <vector>
 #include "asio/buffer.hpp"
 #include "asio/detail/static_mutex.hpp"
 #include "asio/ssl/detail/openssl_types.hpp"
@@ -30,6 +32,8 @@ namespace asio {
 namespace ssl {
 namespace detail {
 
+class session_cache;
+
 class engine
 {
 public:
@@ -55,6 +59,9 @@ public:
     want_output = 1
   };
 
+  // The largest amount of data carried by one record.
+  enum { max_record_data = 16384 };
+
   // Construct a new engine for the specified context.
   ASIO_DECL explicit engine(SSL_CTX* context);
 
@@ -102,14 +109,64 @@ public:
   ASIO_DECL want read(const asio::mutable_buffer& data,
       asio::error_code& ec, std::size_t& bytes_transferred);
 
-  // Get output data to be written to the transport.
-  ASIO_DECL asio::mutable_buffer get_output(
-      const asio::mutable_buffer& data);
+  // Get the largest amount of data that may be written such that the record
+  // fits in the output buffer without waiting for the transport.
+  ASIO_DECL std::size_t max_write_size() const;
+
+  // Set the buffer into which the engine writes output for the transport.
+  ASIO_DECL void set_output_buffer(const asio::mutable_buffer& data);
+
+  // Get output data to be written to the transport. The data remains in the
+  // output buffer, which must not be modified until release_output() is
+  // called.
+  ASIO_DECL asio::const_buffer get_output();
 
-  // Put input data that was read from the transport.
+  // Release the output data returned by get_output(), once it has been
+  // written to the transport.
+  ASIO_DECL void release_output();
+
+  // Put input data that was read from the transport. The engine consumes the
+  // data directly from the buffer, which must remain valid until the engine
+  // wants more input. No data is accepted while the engine still holds input
+  // from a previous call. Returns the data that was not accepted.
   ASIO_DECL asio::const_buffer put_input(
       const asio::const_buffer& data);
 
+  // Copy any input that the engine holds but has not yet consumed, so that
+  // the buffer passed to put_input() may be reused.
+  ASIO_DECL void retain_input();
+
+  // Make the SSL implementation read from and write to the socket directly,
+  // and allow it to transfer the processing of records to the kernel. Must be
+  // called before the handshake. Returns false if kernel TLS is unavailable.
+  ASIO_DECL bool use_kernel_tls(asio::detail::socket_type s);
+
+  // Determine whether records sent are protected by the kernel.
+  ASIO_DECL bool kernel_tls_send_active() const;
+
+  // Determine whether records received are processed by the kernel.
+  ASIO_DECL bool kernel_tls_receive_active() const;
+
+  // Set the session to be resumed by the handshake.
+  ASIO_DECL asio::error_code set_session(
+      SSL_SESSION* session, asio::error_code& ec);
+
+  // Get a new reference to the session used by the connection, or 0 if
+  // there is none.
+  ASIO_DECL SSL_SESSION* get_session() const;
+
+  // Determine whether the handshake resumed a session.
+  ASIO_DECL bool session_reused() const;
+
+  // Identify the peer under which the context caches the connection's
+  // sessions. A session cached for the peer is resumed by the handshake.
+  ASIO_DECL asio::error_code set_session_cache_peer(
+      const std::string& peer, asio::error_code& ec);
+
+  // Determine whether the engine holds input that it has not yet consumed, or
+  // output that has not yet been released.
+  ASIO_DECL bool has_buffered_data() const;
+
   // Map an error::eof code returned by the underlying transport according to
   // the type and state of the SSL session. Returns a const reference to the
   // error code object, suitable for passing to a completion handler.
@@ -138,6 +195,46 @@ private:
       void* data, std::size_t length, asio::error_code& ec,
       std::size_t* bytes_transferred);
 
+  // Associate the SSL implementation's transport with this engine object.
+  ASIO_DECL void attach_transport();
+
+  // Consume input on behalf of the SSL implementation. Returns 0 if there is
+  // no input available.
+  ASIO_DECL std::size_t read_input(void* data, std::size_t length);
+
+  // Append output on behalf of the SSL implementation. Returns 0 if the output
+  // buffer is full.
+  ASIO_DECL std::size_t write_output(const void* data, std::size_t length);
+
+#if defined(ASIO_USE_WOLFSSL)
+  // Callback used when the SSL implementation wants to receive input.
+  ASIO_DECL static int wolfssl_receive(SSL*, char* data, int length, void* ctx);
+
+  // Callback used when the SSL implementation wants to send output.
+  ASIO_DECL static int wolfssl_send(SSL*, char* data, int length, void* ctx);
+#else // defined(ASIO_USE_WOLFSSL)
+  // Get the BIO method used to connect the SSL implementation to the engine.
+  ASIO_DECL static BIO_METHOD* bio_method();
+
+  // Get the engine associated with a BIO.
+  ASIO_DECL static engine* bio_engine(BIO* b);
+
+  // Callback used when the SSL implementation wants to read input.
+  ASIO_DECL static int bio_read(BIO* b, char* data, int length);
+
+  // Callback used when the SSL implementation wants to write output.
+  ASIO_DECL static int bio_write(BIO* b, const char* data, int length);
+
+  // Callback used to control the BIO.
+  ASIO_DECL static long bio_ctrl(BIO* b, int cmd, long num, void* ptr);
+#endif // defined(ASIO_USE_WOLFSSL)
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+  // Record the completion of a handshake in the context's session cache.
+  ASIO_DECL void handshake_complete();
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+
   // Adapt the SSL_accept function to the signature needed for perform().
   ASIO_DECL int do_accept(void*, std::size_t);
 
@@ -154,7 +251,26 @@ private:
   ASIO_DECL int do_write(void* data, std::size_t length);
 
   SSL* ssl_;
-  BIO* ext_bio_;
+
+  // The input that has been accepted by put_input() but not yet consumed.
+  asio::const_buffer input_;
+
+  // Storage for input that is retained beyond the lifetime of its buffer.
+  std::vector<unsigned char> retained_input_;
+
+  // The buffer into which output for the transport is written.
+  asio::mutable_buffer output_;
+
+  // The number of bytes at the start of the output buffer that have been
+  // returned by get_output() but not yet released.
+  std::size_t output_taken_;
+
+  // The total number of bytes held in the output buffer.
+  std::size_t output_size_;
+
+  // The session cache of the connection's context. Found when a handshake
+  // completes, if it was not identified by set_session_cache_peer().
+  session_cache* session_cache_;
 };
 
 } // namespace detail
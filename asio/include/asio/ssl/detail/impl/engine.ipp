@@ -17,9 +17,12 @@
 
 #include "asio/detail/config.hpp"
 
+#include <cstring>
+#include "asio/detail/static_mutex.hpp"
 #include "asio/detail/throw_error.hpp"
 #include "asio/error.hpp"
 #include "asio/ssl/detail/engine.hpp"
+#include "asio/ssl/detail/session_cache.hpp"
 #include "asio/ssl/error.hpp"
 #include "asio/ssl/verify_context.hpp"
 
@@ -30,7 +33,12 @@ namespace ssl {
 namespace detail {
 
 engine::engine(SSL_CTX* context)
-  : ssl_(::SSL_new(context))
+  : ssl_(::SSL_new(context)),
+    input_(0, 0),
+    output_(0, 0),
+    output_taken_(0),
+    output_size_(0),
+    session_cache_(0)
 {
   if (!ssl_)
   {
@@ -50,18 +58,47 @@ engine::engine(SSL_CTX* context)
   ::SSL_set_mode(ssl_, SSL_MODE_RELEASE_BUFFERS);
 #endif // defined(SSL_MODE_RELEASE_BUFFERS)
 
-  ::BIO* int_bio = 0;
-  ::BIO_new_bio_pair(&int_bio, 0, &ext_bio_, 0);
-  ::SSL_set_bio(ssl_, int_bio, int_bio);
+  // The SSL implementation reads input from, and writes output to, the
+  // buffers used for the transport, rather than to an intermediate buffer.
+#if defined(ASIO_USE_WOLFSSL)
+  ::wolfSSL_SSLSetIORecv(ssl_, &engine::wolfssl_receive);
+  ::wolfSSL_SSLSetIOSend(ssl_, &engine::wolfssl_send);
+#else // defined(ASIO_USE_WOLFSSL)
+  ::BIO* bio = ::BIO_new(bio_method());
+  if (!bio)
+  {
+    ::SSL_free(ssl_);
+    asio::error_code ec(
+        static_cast<int>(::ERR_get_error()),
+        asio::error::get_ssl_category());
+    asio::detail::throw_error(ec, "engine");
+  }
+  ::SSL_set_bio(ssl_, bio, bio);
+#endif // defined(ASIO_USE_WOLFSSL)
+
+  attach_transport();
 }
 
 #if defined(ASIO_HAS_MOVE)
 engine::engine(engine&& other) ASIO_NOEXCEPT
   : ssl_(other.ssl_),
-    ext_bio_(other.ext_bio_)
+    input_(other.input_),
+    retained_input_(
+        ASIO_MOVE_CAST(std::vector<unsigned char>)(
+          other.retained_input_)),
+    output_(other.output_),
+    output_taken_(other.output_taken_),
+    output_size_(other.output_size_),
+    session_cache_(other.session_cache_)
 {
   other.ssl_ = 0;
-  other.ext_bio_ = 0;
+  other.input_ = asio::const_buffer(0, 0);
+  other.output_ = asio::mutable_buffer(0, 0);
+  other.output_taken_ = 0;
+  other.output_size_ = 0;
+
+  if (ssl_)
+    attach_transport();
 }
 #endif // defined(ASIO_HAS_MOVE)
 
@@ -73,9 +110,6 @@ engine::~engine()
     SSL_set_app_data(ssl_, 0);
   }
 
-  if (ext_bio_)
-    ::BIO_free(ext_bio_);
-
   if (ssl_)
     ::SSL_free(ssl_);
 }
@@ -86,9 +120,21 @@ engine& engine::operator=(engine&& other) ASIO_NOEXCEPT
   if (this != &other)
   {
     ssl_ = other.ssl_;
-    ext_bio_ = other.ext_bio_;
+    input_ = other.input_;
+    retained_input_ = ASIO_MOVE_CAST(std::vector<unsigned char>)(
+        other.retained_input_);
+    output_ = other.output_;
+    output_taken_ = other.output_taken_;
+    output_size_ = other.output_size_;
+    session_cache_ = other.session_cache_;
     other.ssl_ = 0;
-    other.ext_bio_ = 0;
+    other.input_ = asio::const_buffer(0, 0);
+    other.output_ = asio::mutable_buffer(0, 0);
+    other.output_taken_ = 0;
+    other.output_size_ = 0;
+
+    if (ssl_)
+      attach_transport();
   }
   return *this;
 }
@@ -194,24 +240,170 @@ engine::want engine::read(const asio::mutable_buffer& data,
       data.size(), ec, &bytes_transferred);
 }
 
-asio::mutable_buffer engine::get_output(
-    const asio::mutable_buffer& data)
+std::size_t engine::max_write_size() const
 {
-  int length = ::BIO_read(ext_bio_,
-      data.data(), static_cast<int>(data.size()));
+  // A record adds a header and, at most, the expansion due to padding and the
+  // message authentication code.
+  const std::size_t max_record_overhead = 5 + 256 + 64;
+
+  std::size_t space = output_.size() - output_size_;
+  if (space <= max_record_overhead)
+    return 0;
+  space -= max_record_overhead;
+  const std::size_t max_data = max_record_data;
+  return space < max_data ? space : max_data;
+}
 
-  return asio::buffer(data,
-      length > 0 ? static_cast<std::size_t>(length) : 0);
+void engine::set_output_buffer(const asio::mutable_buffer& data)
+{
+  output_ = data;
+  output_taken_ = 0;
+  output_size_ = 0;
+}
+
+asio::const_buffer engine::get_output()
+{
+  asio::const_buffer data(
+      static_cast<const unsigned char*>(output_.data()) + output_taken_,
+      output_size_ - output_taken_);
+  output_taken_ = output_size_;
+  return data;
+}
+
+void engine::release_output()
+{
+  // Any output that was written by the SSL implementation while the released
+  // data was being written to the transport is moved to the start of the
+  // buffer.
+  unsigned char* p = static_cast<unsigned char*>(output_.data());
+  std::size_t length = output_size_ - output_taken_;
+  if (length > 0)
+    std::memmove(p, p + output_taken_, length);
+  output_taken_ = 0;
+  output_size_ = length;
 }
 
 asio::const_buffer engine::put_input(
     const asio::const_buffer& data)
 {
-  int length = ::BIO_write(ext_bio_,
-      data.data(), static_cast<int>(data.size()));
+  if (input_.size() != 0)
+    return data;
+
+  input_ = data;
+  return asio::const_buffer(0, 0);
+}
+
+void engine::retain_input()
+{
+  const unsigned char* p = static_cast<const unsigned char*>(input_.data());
+  if (input_.size() != 0 && (retained_input_.empty()
+        || p < &retained_input_[0]
+        || p >= &retained_input_[0] + retained_input_.size()))
+  {
+    retained_input_.assign(p, p + input_.size());
+    input_ = asio::buffer(retained_input_);
+  }
+}
+
+bool engine::use_kernel_tls(asio::detail::socket_type s)
+{
+#if defined(ASIO_HAS_SSL_KERNEL_TLS)
+  // OpenSSL enables kernel TLS as it changes the keys used in each direction,
+  // and so the socket must be used for the whole handshake.
+  if (!::SSL_in_before(ssl_) || input_.size() != 0 || output_size_ != 0)
+    return false;
+
+  ::SSL_set_options(ssl_, SSL_OP_ENABLE_KTLS);
+  if (::SSL_set_fd(ssl_, s) != 1)
+  {
+    ::SSL_clear_options(ssl_, SSL_OP_ENABLE_KTLS);
+    ::ERR_clear_error();
+    return false;
+  }
 
-  return asio::buffer(data +
-      (length > 0 ? static_cast<std::size_t>(length) : 0));
+  return true;
+#else // defined(ASIO_HAS_SSL_KERNEL_TLS)
+  (void)s;
+  return false;
+#endif // defined(ASIO_HAS_SSL_KERNEL_TLS)
+}
+
+bool engine::kernel_tls_send_active() const
+{
+#if defined(ASIO_HAS_SSL_KERNEL_TLS)
+  return BIO_get_ktls_send(::SSL_get_wbio(ssl_)) != 0;
+#else // defined(ASIO_HAS_SSL_KERNEL_TLS)
+  return false;
+#endif // defined(ASIO_HAS_SSL_KERNEL_TLS)
+}
+
+bool engine::kernel_tls_receive_active() const
+{
+#if defined(ASIO_HAS_SSL_KERNEL_TLS)
+  return BIO_get_ktls_recv(::SSL_get_rbio(ssl_)) != 0;
+#else // defined(ASIO_HAS_SSL_KERNEL_TLS)
+  return false;
+#endif // defined(ASIO_HAS_SSL_KERNEL_TLS)
+}
+
+asio::error_code engine::set_session(
+    SSL_SESSION* session, asio::error_code& ec)
+{
+  ::ERR_clear_error();
+
+  if (::SSL_set_session(ssl_, session) != 1)
+  {
+    ec = asio::error_code(
+        static_cast<int>(::ERR_get_error()),
+        asio::error::get_ssl_category());
+    return ec;
+  }
+
+  ec = asio::error_code();
+  return ec;
+}
+
+SSL_SESSION* engine::get_session() const
+{
+  return ::SSL_get1_session(ssl_);
+}
+
+bool engine::session_reused() const
+{
+  return ::SSL_session_reused(ssl_) != 0;
+}
+
+asio::error_code engine::set_session_cache_peer(
+    const std::string& peer, asio::error_code& ec)
+{
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+  ::ERR_clear_error();
+
+  session_cache* cache = session_cache::set_peer(ssl_, peer);
+  if (!cache)
+  {
+    unsigned long error = ::ERR_get_error();
+    ec = error ? asio::error_code(static_cast<int>(error),
+        asio::error::get_ssl_category())
+      : asio::error_code(asio::error::no_memory);
+    return ec;
+  }
+
+  session_cache_ = cache;
+  ec = asio::error_code();
+  return ec;
+#else // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+      //   && !defined(ASIO_USE_WOLFSSL)
+  (void)peer;
+  ec = asio::error::operation_not_supported;
+  return ec;
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+}
+
+bool engine::has_buffered_data() const
+{
+  return input_.size() != 0 || output_size_ != 0;
 }
 
 const asio::error_code& engine::map_error_code(
@@ -222,7 +414,7 @@ const asio::error_code& engine::map_error_code(
     return ec;
 
   // If there's data yet to be read, it's an error.
-  if (BIO_wpending(ext_bio_))
+  if (input_.size() != 0)
   {
     ec = asio::ssl::error::stream_truncated;
     return ec;
@@ -256,12 +448,12 @@ engine::want engine::perform(int (engine::* op)(void*, std::size_t),
     void* data, std::size_t length, asio::error_code& ec,
     std::size_t* bytes_transferred)
 {
-  std::size_t pending_output_before = ::BIO_ctrl_pending(ext_bio_);
+  std::size_t pending_output_before = output_size_ - output_taken_;
   ::ERR_clear_error();
   int result = (this->*op)(data, length);
   int ssl_error = ::SSL_get_error(ssl_, result);
   int sys_error = static_cast<int>(::ERR_get_error());
-  std::size_t pending_output_after = ::BIO_ctrl_pending(ext_bio_);
+  std::size_t pending_output_after = output_size_ - output_taken_;
 
   if (ssl_error == SSL_ERROR_SSL)
   {
@@ -321,17 +513,200 @@ engine::want engine::perform(int (engine::* op)(void*, std::size_t),
   }
 }
 
+void engine::attach_transport()
+{
+#if defined(ASIO_USE_WOLFSSL)
+  ::wolfSSL_SetIOReadCtx(ssl_, this);
+  ::wolfSSL_SetIOWriteCtx(ssl_, this);
+#elif (OPENSSL_VERSION_NUMBER < 0x10100000L) \
+  || (defined(LIBRESSL_VERSION_NUMBER) \
+    && LIBRESSL_VERSION_NUMBER < 0x2070000fL)
+  ::BIO* bio = ::SSL_get_rbio(ssl_);
+  bio->ptr = this;
+  bio->init = 1;
+#else // (OPENSSL_VERSION_NUMBER < 0x10100000L)
+      //   || (defined(LIBRESSL_VERSION_NUMBER)
+      //     && LIBRESSL_VERSION_NUMBER < 0x2070000fL)
+  ::BIO* bio = ::SSL_get_rbio(ssl_);
+#if defined(ASIO_HAS_SSL_KERNEL_TLS)
+  // A socket used for kernel TLS is not associated with the engine.
+  if (::BIO_method_type(bio) == BIO_TYPE_SOCKET)
+    return;
+#endif // defined(ASIO_HAS_SSL_KERNEL_TLS)
+  ::BIO_set_data(bio, this);
+  ::BIO_set_init(bio, 1);
+#endif // (OPENSSL_VERSION_NUMBER < 0x10100000L)
+       //   || (defined(LIBRESSL_VERSION_NUMBER)
+       //     && LIBRESSL_VERSION_NUMBER < 0x2070000fL)
+}
+
+std::size_t engine::read_input(void* data, std::size_t length)
+{
+  std::size_t n = asio::buffer_copy(
+      asio::buffer(data, length), input_);
+  input_ += n;
+  return n;
+}
+
+std::size_t engine::write_output(const void* data, std::size_t length)
+{
+  std::size_t n = asio::buffer_copy(
+      asio::buffer(output_ + output_size_),
+      asio::buffer(data, length));
+  output_size_ += n;
+  return n;
+}
+
+#if defined(ASIO_USE_WOLFSSL)
+int engine::wolfssl_receive(SSL*, char* data, int length, void* ctx)
+{
+  engine* this_engine = static_cast<engine*>(ctx);
+  std::size_t n = this_engine->read_input(data,
+      length > 0 ? static_cast<std::size_t>(length) : 0);
+  return n > 0 ? static_cast<int>(n) : WOLFSSL_CBIO_ERR_WANT_READ;
+}
+
+int engine::wolfssl_send(SSL*, char* data, int length, void* ctx)
+{
+  engine* this_engine = static_cast<engine*>(ctx);
+  std::size_t n = this_engine->write_output(data,
+      length > 0 ? static_cast<std::size_t>(length) : 0);
+  return n > 0 ? static_cast<int>(n) : WOLFSSL_CBIO_ERR_WANT_WRITE;
+}
+#else // defined(ASIO_USE_WOLFSSL)
+BIO_METHOD* engine::bio_method()
+{
+#if (OPENSSL_VERSION_NUMBER < 0x10100000L) \
+  || (defined(LIBRESSL_VERSION_NUMBER) \
+    && LIBRESSL_VERSION_NUMBER < 0x2070000fL)
+  static BIO_METHOD method =
+  {
+    BIO_TYPE_SOURCE_SINK, "asio", &engine::bio_write, &engine::bio_read,
+    0, 0, &engine::bio_ctrl, 0, 0, 0
+  };
+  return &method;
+#else // (OPENSSL_VERSION_NUMBER < 0x10100000L)
+      //   || (defined(LIBRESSL_VERSION_NUMBER)
+      //     && LIBRESSL_VERSION_NUMBER < 0x2070000fL)
+  static asio::detail::static_mutex mutex = ASIO_STATIC_MUTEX_INIT;
+  static BIO_METHOD* method = 0;
+  mutex.init();
+  asio::detail::static_mutex::scoped_lock lock(mutex);
+  if (!method)
+  {
+    method = ::BIO_meth_new(
+        ::BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "asio");
+    if (method)
+    {
+      ::BIO_meth_set_write(method, &engine::bio_write);
+      ::BIO_meth_set_read(method, &engine::bio_read);
+      ::BIO_meth_set_ctrl(method, &engine::bio_ctrl);
+    }
+  }
+  return method;
+#endif // (OPENSSL_VERSION_NUMBER < 0x10100000L)
+       //   || (defined(LIBRESSL_VERSION_NUMBER)
+       //     && LIBRESSL_VERSION_NUMBER < 0x2070000fL)
+}
+
+engine* engine::bio_engine(BIO* b)
+{
+#if (OPENSSL_VERSION_NUMBER < 0x10100000L) \
+  || (defined(LIBRESSL_VERSION_NUMBER) \
+    && LIBRESSL_VERSION_NUMBER < 0x2070000fL)
+  return static_cast<engine*>(b->ptr);
+#else // (OPENSSL_VERSION_NUMBER < 0x10100000L)
+      //   || (defined(LIBRESSL_VERSION_NUMBER)
+      //     && LIBRESSL_VERSION_NUMBER < 0x2070000fL)
+  return static_cast<engine*>(::BIO_get_data(b));
+#endif // (OPENSSL_VERSION_NUMBER < 0x10100000L)
+       //   || (defined(LIBRESSL_VERSION_NUMBER)
+       //     && LIBRESSL_VERSION_NUMBER < 0x2070000fL)
+}
+
+int engine::bio_read(BIO* b, char* data, int length)
+{
+  engine* this_engine = bio_engine(b);
+  BIO_clear_retry_flags(b);
+  std::size_t n = this_engine->read_input(data,
+      length > 0 ? static_cast<std::size_t>(length) : 0);
+  if (n == 0)
+  {
+    BIO_set_retry_read(b);
+    return -1;
+  }
+  return static_cast<int>(n);
+}
+
+int engine::bio_write(BIO* b, const char* data, int length)
+{
+  engine* this_engine = bio_engine(b);
+  BIO_clear_retry_flags(b);
+  std::size_t n = this_engine->write_output(data,
+      length > 0 ? static_cast<std::size_t>(length) : 0);
+  if (n == 0)
+  {
+    BIO_set_retry_write(b);
+    return -1;
+  }
+  return static_cast<int>(n);
+}
+
+long engine::bio_ctrl(BIO* b, int cmd, long, void*)
+{
+  engine* this_engine = bio_engine(b);
+  switch (cmd)
+  {
+  case BIO_CTRL_PENDING:
+    return static_cast<long>(this_engine->input_.size());
+  case BIO_CTRL_WPENDING:
+    return static_cast<long>(
+        this_engine->output_size_ - this_engine->output_taken_);
+  case BIO_CTRL_FLUSH:
+    // Output is flushed by the caller of get_output().
+    return 1;
+  default:
+    return 0;
+  }
+}
+#endif // defined(ASIO_USE_WOLFSSL)
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+void engine::handshake_complete()
+{
+  // The cache is looked up only once the handshake completes, so that it is
+  // found even if it was attached to the context after the engine was created.
+  if (!session_cache_)
+    session_cache_ = session_cache::get(::SSL_get_SSL_CTX(ssl_), false);
+  if (session_cache_)
+    session_cache_->handshake_complete(ssl_);
+}
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+
 int engine::do_accept(void*, std::size_t)
 {
 #if (OPENSSL_VERSION_NUMBER < 0x10000000L)
   asio::detail::static_mutex::scoped_lock lock(accept_mutex());
 #endif // (OPENSSL_VERSION_NUMBER < 0x10000000L)
-  return ::SSL_accept(ssl_);
+  int result = ::SSL_accept(ssl_);
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+  if (result == 1)
+    handshake_complete();
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+  return result;
 }
 
 int engine::do_connect(void*, std::size_t)
 {
-  return ::SSL_connect(ssl_);
+  int result = ::SSL_connect(ssl_);
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+  if (result == 1)
+    handshake_complete();
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+  return result;
 }
 
 int engine::do_shutdown(void*, std::size_t)
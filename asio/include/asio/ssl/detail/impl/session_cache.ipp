@@ -0,0 +1,366 @@
+//
+// ssl/detail/impl/session_cache.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_IMPL_SESSION_CACHE_IPP
+#define ASIO_SSL_DETAIL_IMPL_SESSION_CACHE_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+
+#include <cstring>
+#include <new>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+# include <openssl/core_names.h>
+#else // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+# include <openssl/hmac.h>
+#endif // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+#include "asio/detail/static_mutex.hpp"
+#include "asio/ssl/detail/session_cache.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace ssl {
+namespace detail {
+
+session_cache::session_cache(std::size_t max_sessions)
+  : max_sessions_(max_sessions),
+    ticket_key_count_(0),
+    hits_(0),
+    misses_(0),
+    next_new_session_(0)
+{
+}
+
+session_cache::~session_cache()
+{
+  for (std::list<entry>::iterator i = sessions_.begin();
+      i != sessions_.end(); ++i)
+    ::SSL_SESSION_free(i->session);
+
+  ::OPENSSL_cleanse(ticket_keys_, sizeof(ticket_keys_));
+}
+
+session_cache* session_cache::get(SSL_CTX* ctx, bool create)
+{
+  int index = context_index();
+  if (index < 0)
+    return 0;
+
+  static asio::detail::static_mutex mutex = ASIO_STATIC_MUTEX_INIT;
+  mutex.init();
+  asio::detail::static_mutex::scoped_lock lock(mutex);
+
+  session_cache* cache = static_cast<session_cache*>(
+      ::SSL_CTX_get_ex_data(ctx, index));
+  if (cache || !create)
+    return cache;
+
+  cache = new (std::nothrow) session_cache(
+      static_cast<std::size_t>(::SSL_CTX_sess_get_cache_size(ctx)));
+  if (!cache)
+    return 0;
+
+  if (!::SSL_CTX_set_ex_data(ctx, index, cache))
+  {
+    delete cache;
+    return 0;
+  }
+
+  // Clients must be notified of new sessions so that they may be stored. An
+  // application's own callback continues to receive them.
+  ::SSL_CTX_set_session_cache_mode(ctx,
+      ::SSL_CTX_get_session_cache_mode(ctx) | SSL_SESS_CACHE_CLIENT);
+  cache->next_new_session_ = ::SSL_CTX_sess_get_new_cb(ctx);
+  ::SSL_CTX_sess_set_new_cb(ctx, &session_cache::new_session);
+
+  return cache;
+}
+
+void session_cache::set_max_sessions(SSL_CTX* ctx, std::size_t max_sessions)
+{
+  asio::detail::mutex::scoped_lock lock(mutex_);
+
+  max_sessions_ = max_sessions;
+  evict();
+
+  // The size also bounds the server's cache of stateful sessions, for which a
+  // size of zero would mean that the cache is unbounded.
+  if (max_sessions > 0)
+  {
+    ::SSL_CTX_set_session_cache_mode(ctx,
+        ::SSL_CTX_get_session_cache_mode(ctx) | SSL_SESS_CACHE_BOTH);
+    ::SSL_CTX_sess_set_cache_size(ctx, static_cast<long>(max_sessions));
+  }
+  else
+  {
+    ::SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+  }
+}
+
+bool session_cache::rotate_ticket_key(SSL_CTX* ctx, const unsigned char* key)
+{
+  asio::detail::mutex::scoped_lock lock(mutex_);
+
+  for (std::size_t i = max_ticket_keys - 1; i > 0; --i)
+    std::memcpy(ticket_keys_[i], ticket_keys_[i - 1], ticket_key_size);
+  std::memcpy(ticket_keys_[0], key, ticket_key_size);
+  if (ticket_key_count_ < max_ticket_keys)
+    ++ticket_key_count_;
+
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  return ::SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx,
+      &session_cache::ticket_key_callback) == 1;
+#else // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  return ::SSL_CTX_set_tlsext_ticket_key_cb(ctx,
+      &session_cache::ticket_key_callback) == 1;
+#endif // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+}
+
+session_cache* session_cache::set_peer(SSL* ssl, const std::string& peer)
+{
+  session_cache* cache = get(::SSL_get_SSL_CTX(ssl), true);
+  int index = connection_index();
+  if (!cache || index < 0)
+    return 0;
+
+  std::string* name = new (std::nothrow) std::string(peer);
+  if (!name)
+    return 0;
+
+  delete static_cast<std::string*>(::SSL_get_ex_data(ssl, index));
+  if (!::SSL_set_ex_data(ssl, index, name))
+  {
+    delete name;
+    return 0;
+  }
+
+  SSL_SESSION* session = 0;
+  {
+    asio::detail::mutex::scoped_lock lock(cache->mutex_);
+    std::map<std::string, std::list<entry>::iterator>::iterator i =
+      cache->peers_.find(peer);
+    if (i != cache->peers_.end()
+        && ::SSL_SESSION_is_resumable(i->second->session))
+    {
+      session = i->second->session;
+      ::SSL_SESSION_up_ref(session);
+    }
+  }
+
+  if (session)
+  {
+    int result = ::SSL_set_session(ssl, session);
+    ::SSL_SESSION_free(session);
+    return result == 1 ? cache : 0;
+  }
+
+  return cache;
+}
+
+void session_cache::handshake_complete(SSL* ssl)
+{
+  asio::detail::mutex::scoped_lock lock(mutex_);
+  if (::SSL_session_reused(ssl))
+    ++hits_;
+  else
+    ++misses_;
+}
+
+std::size_t session_cache::hits() const
+{
+  asio::detail::mutex::scoped_lock lock(mutex_);
+  return hits_;
+}
+
+std::size_t session_cache::misses() const
+{
+  asio::detail::mutex::scoped_lock lock(mutex_);
+  return misses_;
+}
+
+int session_cache::context_index()
+{
+  static asio::detail::static_mutex mutex = ASIO_STATIC_MUTEX_INIT;
+  static int index = -1;
+  mutex.init();
+  asio::detail::static_mutex::scoped_lock lock(mutex);
+  if (index < 0)
+  {
+    index = ::SSL_CTX_get_ex_new_index(0, 0, 0, 0,
+        &session_cache::free_cache);
+  }
+  return index;
+}
+
+int session_cache::connection_index()
+{
+  static asio::detail::static_mutex mutex = ASIO_STATIC_MUTEX_INIT;
+  static int index = -1;
+  mutex.init();
+  asio::detail::static_mutex::scoped_lock lock(mutex);
+  if (index < 0)
+  {
+    index = ::SSL_get_ex_new_index(0, 0, 0, 0,
+        &session_cache::free_peer);
+  }
+  return index;
+}
+
+void session_cache::free_cache(void*, void* ptr,
+    CRYPTO_EX_DATA*, int, long, void*)
+{
+  delete static_cast<session_cache*>(ptr);
+}
+
+void session_cache::free_peer(void*, void* ptr,
+    CRYPTO_EX_DATA*, int, long, void*)
+{
+  delete static_cast<std::string*>(ptr);
+}
+
+int session_cache::new_session(SSL* ssl, SSL_SESSION* session)
+{
+  session_cache* cache = get(::SSL_get_SSL_CTX(ssl), false);
+  if (!cache)
+    return 0;
+
+  int index = connection_index();
+  std::string* peer = index < 0 ? 0
+    : static_cast<std::string*>(::SSL_get_ex_data(ssl, index));
+  if (peer && !::SSL_is_server(ssl) && ::SSL_SESSION_is_resumable(session))
+  {
+    asio::detail::mutex::scoped_lock lock(cache->mutex_);
+    if (cache->max_sessions_ > 0)
+    {
+      // The context's own cache may also hold the session, and marks it as
+      // not resumable if it is removed from that cache. A copy is stored
+      // instead, so the reference passed to the callback is not kept.
+      if (SSL_SESSION* copy = ::SSL_SESSION_dup(session))
+        cache->store(*peer, copy);
+    }
+  }
+
+  // The callback that was replaced by the cache decides whether it keeps the
+  // reference.
+  return cache->next_new_session_ ? cache->next_new_session_(ssl, session) : 0;
+}
+
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+int session_cache::ticket_key_callback(SSL* ssl, unsigned char* name,
+    unsigned char* iv, EVP_CIPHER_CTX* cipher, EVP_MAC_CTX* mac, int enc)
+#else // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+int session_cache::ticket_key_callback(SSL* ssl, unsigned char* name,
+    unsigned char* iv, EVP_CIPHER_CTX* cipher, HMAC_CTX* mac, int enc)
+#endif // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+{
+  session_cache* cache = get(::SSL_get_SSL_CTX(ssl), false);
+  if (!cache)
+    return -1;
+
+  asio::detail::mutex::scoped_lock lock(cache->mutex_);
+
+  // Find the key used to protect the ticket. New tickets are protected using
+  // the current key.
+  std::size_t k = 0;
+  if (enc)
+  {
+    if (cache->ticket_key_count_ == 0)
+      return -1;
+    if (::RAND_bytes(iv, EVP_CIPHER_iv_length(::EVP_aes_256_cbc())) != 1)
+      return -1;
+    std::memcpy(name, cache->ticket_keys_[0], 16);
+  }
+  else
+  {
+    while (k < cache->ticket_key_count_
+        && std::memcmp(name, cache->ticket_keys_[k], 16) != 0)
+      ++k;
+    if (k == cache->ticket_key_count_)
+      return 0;
+  }
+
+  unsigned char* hmac_key = cache->ticket_keys_[k] + 16;
+  unsigned char* aes_key = cache->ticket_keys_[k] + 48;
+
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  OSSL_PARAM params[3];
+  params[0] = ::OSSL_PARAM_construct_octet_string(
+      OSSL_MAC_PARAM_KEY, hmac_key, 32);
+  params[1] = ::OSSL_PARAM_construct_utf8_string(
+      OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0);
+  params[2] = ::OSSL_PARAM_construct_end();
+  if (::EVP_MAC_CTX_set_params(mac, params) != 1)
+    return -1;
+#else // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  if (::HMAC_Init_ex(mac, hmac_key, 32, ::EVP_sha256(), 0) != 1)
+    return -1;
+#endif // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+
+  if (enc)
+  {
+    if (::EVP_EncryptInit_ex(cipher, ::EVP_aes_256_cbc(), 0, aes_key, iv) != 1)
+      return -1;
+    return 1;
+  }
+
+  if (::EVP_DecryptInit_ex(cipher, ::EVP_aes_256_cbc(), 0, aes_key, iv) != 1)
+    return -1;
+
+  // A ticket protected by a previous key is accepted, but the client is sent
+  // a new ticket protected by the current key. With TLS 1.3, a new ticket is
+  // always sent so that the client need not reuse a ticket.
+  return (k == 0 && ::SSL_version(ssl) < TLS1_3_VERSION) ? 1 : 2;
+}
+
+void session_cache::store(const std::string& peer, SSL_SESSION* session)
+{
+  std::map<std::string, std::list<entry>::iterator>::iterator i =
+    peers_.find(peer);
+  if (i != peers_.end())
+  {
+    ::SSL_SESSION_free(i->second->session);
+    sessions_.erase(i->second);
+    peers_.erase(i);
+  }
+
+  entry e = { peer, session };
+  sessions_.push_front(e);
+  peers_[peer] = sessions_.begin();
+  evict();
+}
+
+void session_cache::evict()
+{
+  while (sessions_.size() > max_sessions_)
+  {
+    ::SSL_SESSION_free(sessions_.back().session);
+    peers_.erase(sessions_.back().peer);
+    sessions_.pop_back();
+  }
+}
+
+} // namespace detail
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+
+#endif // ASIO_SSL_DETAIL_IMPL_SESSION_CACHE_IPP
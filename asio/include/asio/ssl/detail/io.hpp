@@ -17,10 +17,12 @@
 
 #include "asio/detail/config.hpp"
 
+#include "asio/basic_stream_socket.hpp"
 #include "asio/detail/base_from_cancellation_state.hpp"
 #include "asio/detail/handler_tracking.hpp"
 #include "asio/ssl/detail/engine.hpp"
 #include "asio/ssl/detail/stream_core.hpp"
+#include "asio/socket_base.hpp"
 #include "asio/write.hpp"
 
 #include "asio/detail/push_options.hpp"
@@ -35,6 +37,7 @@ std::size_t io(Stream& next_layer, stream_core& core,
 {
   asio::error_code io_ec;
   std::size_t bytes_transferred = 0;
+  core.start_operation();
   do switch (op(core.engine_, ec, bytes_transferred))
   {
   case engine::want_input_and_retry:
@@ -59,8 +62,8 @@ std::size_t io(Stream& next_layer, stream_core& core,
 
     // Get output data from the engine and write it to the underlying
     // transport.
-    asio::write(next_layer,
-        core.engine_.get_output(core.output_buffer_), io_ec);
+    asio::write(next_layer, core.engine_.get_output(), io_ec);
+    core.engine_.release_output();
     if (!ec)
       ec = io_ec;
 
@@ -71,28 +74,59 @@ std::size_t io(Stream& next_layer, stream_core& core,
 
     // Get output data from the engine and write it to the underlying
     // transport.
-    asio::write(next_layer,
-        core.engine_.get_output(core.output_buffer_), io_ec);
+    asio::write(next_layer, core.engine_.get_output(), io_ec);
+    core.engine_.release_output();
     if (!ec)
       ec = io_ec;
 
     // Operation is complete. Return result to caller.
+    core.finish_operation();
     core.engine_.map_error_code(ec);
     return bytes_transferred;
 
   default:
 
     // Operation is complete. Return result to caller.
+    core.finish_operation();
     core.engine_.map_error_code(ec);
     return bytes_transferred;
 
   } while (!ec);
 
   // Operation failed. Return result to caller.
+  core.finish_operation();
   core.engine_.map_error_code(ec);
   return 0;
 }
 
+// Called when an operation must wait for data to be received. The transport
+// does not support waiting for readiness, so the data is read immediately.
+template <typename Stream, typename Handler>
+inline bool async_wait_readable(Stream&, stream_core&, Handler&)
+{
+  return false;
+}
+
+// If the stream releases idle buffers, return them to the pool and wait for
+// the socket to become readable, unless data has already been received.
+// Returns true if the wait was started.
+template <typename Protocol, typename Executor, typename Handler>
+inline bool async_wait_readable(
+    basic_stream_socket<Protocol, Executor>& socket,
+    stream_core& core, Handler& handler)
+{
+  if (!core.release_idle_buffers_)
+    return false;
+
+  asio::error_code ec;
+  if (socket.available(ec) != 0 || ec || !core.release_buffers())
+    return false;
+
+  socket.async_wait(socket_base::wait_read,
+      ASIO_MOVE_CAST(Handler)(handler));
+  return true;
+}
+
 template <typename Stream, typename Operation, typename Handler>
 class io_op
   : public asio::detail::base_from_cancellation_state<Handler>
@@ -107,6 +141,7 @@ public:
       start_(0),
       want_(engine::want_nothing),
       bytes_transferred_(0),
+      waited_(false),
       handler_(ASIO_MOVE_CAST(Handler)(handler))
   {
   }
@@ -121,6 +156,7 @@ public:
       want_(other.want_),
       ec_(other.ec_),
       bytes_transferred_(other.bytes_transferred_),
+      waited_(other.waited_),
       handler_(other.handler_)
   {
   }
@@ -137,6 +173,7 @@ public:
       want_(other.want_),
       ec_(other.ec_),
       bytes_transferred_(other.bytes_transferred_),
+      waited_(other.waited_),
       handler_(ASIO_MOVE_CAST(Handler)(other.handler_))
   {
   }
@@ -171,6 +208,21 @@ public:
             // Prevent other read operations from being started.
             core_.pending_read_.expires_at(core_.pos_infin());
 
+            // If no other operation is in progress, the stream is idle until
+            // data is received. Its buffers may be returned to the pool while
+            // it waits for the transport to become readable.
+            if (!waited_ && core_.operations_ == 1)
+            {
+              waited_ = true;
+
+              ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__, Operation::tracking_name()));
+
+              if (async_wait_readable(next_layer_, core_, *this))
+                return;
+            }
+            waited_ = false;
+
             ASIO_HANDLER_LOCATION((
                   __FILE__, __LINE__, Operation::tracking_name()));
 
@@ -181,6 +233,8 @@ public:
           }
           else
           {
+            waited_ = false;
+
             ASIO_HANDLER_LOCATION((
                   __FILE__, __LINE__, Operation::tracking_name()));
 
@@ -209,7 +263,7 @@ public:
 
             // Start writing all the data to the underlying transport.
             asio::async_write(next_layer_,
-                core_.engine_.get_output(core_.output_buffer_),
+                core_.engine_.get_output(),
                 ASIO_MOVE_CAST(io_op)(*this));
           }
           else
@@ -255,13 +309,34 @@ public:
         default:
         if (bytes_transferred == ~std::size_t(0))
           bytes_transferred = 0; // Timer cancellation, no data transferred.
-        else if (!ec_)
-          ec_ = ec;
+        else
+        {
+          if (!ec_)
+            ec_ = ec;
+
+          // The engine's output has been written to the transport.
+          if (want_ == engine::want_output_and_retry
+              || want_ == engine::want_output)
+            core_.engine_.release_output();
+        }
 
         switch (want_)
         {
         case engine::want_input_and_retry:
 
+          if (waited_)
+          {
+            // The transport is readable, so obtain the buffers and try the
+            // operation again to read the data.
+            core_.acquire_buffers();
+            core_.pending_read_.expires_at(core_.neg_infin());
+            if (!ec_)
+              ec_ = ec;
+            if (ec_)
+              break;
+            continue;
+          }
+
           // Add received data to the engine's input.
           core_.input_ = asio::buffer(
               core_.input_buffer_, bytes_transferred);
@@ -305,6 +380,7 @@ public:
         default:
 
           // Pass the result to the handler.
+          core_.finish_operation();
           op_.call_handler(handler_,
               core_.engine_.map_error_code(ec_),
               ec_ ? 0 : bytes_transferred_);
@@ -315,6 +391,7 @@ public:
       } while (!ec_);
 
       // Operation failed. Pass the result to the handler.
+      core_.finish_operation();
       op_.call_handler(handler_, core_.engine_.map_error_code(ec_), 0);
     }
   }
@@ -327,6 +404,7 @@ public:
   engine::want want_;
   asio::error_code ec_;
   std::size_t bytes_transferred_;
+  bool waited_;
   Handler handler_;
 };
 
@@ -394,6 +472,7 @@ template <typename Stream, typename Operation, typename Handler>
 inline void async_io(Stream& next_layer, stream_core& core,
     const Operation& op, Handler& handler)
 {
+  core.start_operation();
   io_op<Stream, Operation, Handler>(
     next_layer, core, op, handler)(
       asio::error_code(), 0, 1);
@@ -0,0 +1,418 @@
+//
+// ssl/detail/kernel_tls_io.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_KERNEL_TLS_IO_HPP
+#define ASIO_SSL_DETAIL_KERNEL_TLS_IO_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#include "asio/detail/base_from_cancellation_state.hpp"
+#include "asio/detail/buffer_sequence_adapter.hpp"
+#include "asio/detail/handler_alloc_helpers.hpp"
+#include "asio/detail/handler_cont_helpers.hpp"
+#include "asio/detail/handler_invoke_helpers.hpp"
+#include "asio/detail/handler_tracking.hpp"
+#include "asio/ssl/detail/io.hpp"
+
+#if defined(ASIO_HAS_SSL_KERNEL_TLS)
+# include "asio/basic_stream_socket.hpp"
+# include "asio/socket_base.hpp"
+# include "asio/ssl/error.hpp"
+#endif // defined(ASIO_HAS_SSL_KERNEL_TLS)
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace ssl {
+namespace detail {
+
+// Operations used once the SSL implementation reads from and writes to the
+// socket directly. Kernel TLS is never used for a transport that is not a
+// basic_stream_socket, and so these overloads simply use the engine.
+
+template <typename Stream>
+inline void start_kernel_tls(Stream&, stream_core& core)
+{
+  core.kernel_tls_requested_ = false;
+}
+
+template <typename Stream, typename Operation>
+inline std::size_t kernel_tls_io(Stream& next_layer, stream_core& core,
+    const Operation& op, asio::error_code& ec)
+{
+  return io(next_layer, core, op, ec);
+}
+
+template <typename Stream, typename Operation, typename Handler>
+inline void async_kernel_tls_io(Stream& next_layer, stream_core& core,
+    const Operation& op, Handler& handler)
+{
+  async_io(next_layer, core, op, handler);
+}
+
+// Writes the first of the buffers in a single call to the engine. Unlike
+// write_op, the records are written to the socket by the SSL implementation.
+template <typename ConstBufferSequence>
+class kernel_tls_write_op
+{
+public:
+  static ASIO_CONSTEXPR const char* tracking_name()
+  {
+    return "ssl::stream<>::async_write_some";
+  }
+
+  kernel_tls_write_op(const ConstBufferSequence& buffers)
+    : buffers_(buffers)
+  {
+  }
+
+  engine::want operator()(engine& eng,
+      asio::error_code& ec,
+      std::size_t& bytes_transferred) const
+  {
+    asio::const_buffer buffer =
+      asio::detail::buffer_sequence_adapter<asio::const_buffer,
+        ConstBufferSequence>::first(buffers_);
+
+    return eng.write(buffer, ec, bytes_transferred);
+  }
+
+  template <typename Handler>
+  void call_handler(Handler& handler,
+      const asio::error_code& ec,
+      const std::size_t& bytes_transferred) const
+  {
+    ASIO_MOVE_OR_LVALUE(Handler)(handler)(ec, bytes_transferred);
+  }
+
+private:
+  ConstBufferSequence buffers_;
+};
+
+#if defined(ASIO_HAS_SSL_KERNEL_TLS)
+
+template <typename Protocol, typename Executor>
+inline void start_kernel_tls(
+    basic_stream_socket<Protocol, Executor>& socket, stream_core& core)
+{
+  core.kernel_tls_requested_ = false;
+
+  // The SSL implementation must not block, so that operations can wait for
+  // the socket to become ready instead. The socket is left in non-blocking
+  // mode for as long as the stream uses it.
+  asio::error_code ec;
+  socket.native_non_blocking(true, ec);
+  if (!ec)
+    core.kernel_tls_ = core.engine_.use_kernel_tls(socket.native_handle());
+}
+
+// Performs an engine operation without blocking. Fails with would_block, and
+// sets the wait type, if the socket must become ready before the operation
+// can continue.
+template <typename Operation>
+class kernel_tls_op
+{
+public:
+  static ASIO_CONSTEXPR const char* tracking_name()
+  {
+    return Operation::tracking_name();
+  }
+
+  explicit kernel_tls_op(const Operation& op)
+    : op_(op)
+  {
+  }
+
+  std::size_t operator()(stream_core& core,
+      socket_base::wait_type& wait, asio::error_code& ec) const
+  {
+    std::size_t bytes_transferred = 0;
+    switch (op_(core.engine_, ec, bytes_transferred))
+    {
+    case engine::want_input_and_retry:
+      wait = socket_base::wait_read;
+      ec = asio::error::would_block;
+      return 0;
+    case engine::want_output_and_retry:
+      wait = socket_base::wait_write;
+      ec = asio::error::would_block;
+      return 0;
+    default:
+      break;
+    }
+
+#if defined(SSL_R_UNEXPECTED_EOF_WHILE_READING)
+    // The SSL implementation reports a transport that was closed without a
+    // close_notify alert as an error of its own.
+    if (ec.category() == asio::error::get_ssl_category()
+        && ERR_GET_REASON(ec.value()) == SSL_R_UNEXPECTED_EOF_WHILE_READING)
+      ec = asio::ssl::error::stream_truncated;
+#endif // defined(SSL_R_UNEXPECTED_EOF_WHILE_READING)
+
+    return ec ? 0 : bytes_transferred;
+  }
+
+  template <typename Handler>
+  void call_handler(Handler& handler,
+      const asio::error_code& ec,
+      const std::size_t& bytes_transferred) const
+  {
+    op_.call_handler(handler, ec, bytes_transferred);
+  }
+
+private:
+  Operation op_;
+};
+
+template <typename Protocol, typename Executor, typename Operation>
+std::size_t kernel_tls_io(basic_stream_socket<Protocol, Executor>& socket,
+    stream_core& core, const Operation& op, asio::error_code& ec)
+{
+  kernel_tls_op<Operation> tls_op(op);
+  for (;;)
+  {
+    socket_base::wait_type wait = socket_base::wait_read;
+    std::size_t bytes_transferred = tls_op(core, wait, ec);
+
+    // Wait for the socket to become ready, unless the user has put it into
+    // non-blocking mode.
+    if (ec != asio::error::would_block || socket.non_blocking())
+      return bytes_transferred;
+
+    socket.wait(wait, ec);
+    if (ec)
+      return 0;
+  }
+}
+
+template <typename Socket, typename Operation, typename Handler>
+class kernel_tls_io_op
+  : public asio::detail::base_from_cancellation_state<Handler>
+{
+public:
+  kernel_tls_io_op(Socket& socket, stream_core& core,
+      const Operation& op, Handler& handler)
+    : asio::detail::base_from_cancellation_state<Handler>(handler),
+      socket_(socket),
+      core_(core),
+      op_(op),
+      start_(0),
+      complete_(false),
+      wait_(socket_base::wait_read),
+      bytes_transferred_(0),
+      handler_(ASIO_MOVE_CAST(Handler)(handler))
+  {
+  }
+
+#if defined(ASIO_HAS_MOVE)
+  kernel_tls_io_op(const kernel_tls_io_op& other)
+    : asio::detail::base_from_cancellation_state<Handler>(other),
+      socket_(other.socket_),
+      core_(other.core_),
+      op_(other.op_),
+      start_(other.start_),
+      complete_(other.complete_),
+      wait_(other.wait_),
+      ec_(other.ec_),
+      bytes_transferred_(other.bytes_transferred_),
+      handler_(other.handler_)
+  {
+  }
+
+  kernel_tls_io_op(kernel_tls_io_op&& other)
+    : asio::detail::base_from_cancellation_state<Handler>(
+        ASIO_MOVE_CAST(
+          asio::detail::base_from_cancellation_state<Handler>)(
+            other)),
+      socket_(other.socket_),
+      core_(other.core_),
+      op_(ASIO_MOVE_CAST(Operation)(other.op_)),
+      start_(other.start_),
+      complete_(other.complete_),
+      wait_(other.wait_),
+      ec_(other.ec_),
+      bytes_transferred_(other.bytes_transferred_),
+      handler_(ASIO_MOVE_CAST(Handler)(other.handler_))
+  {
+  }
+#endif // defined(ASIO_HAS_MOVE)
+
+  void operator()(asio::error_code ec,
+      std::size_t = 0, int start = 0)
+  {
+    switch (start_ = start)
+    {
+    case 1: // Called from the initiating function.
+      for (;;)
+      {
+        bytes_transferred_ = op_(core_, wait_, ec_);
+        if (ec_ != asio::error::would_block)
+        {
+          // The operation is done and we can invoke the handler, but not
+          // from within the initiating function. Instead, issue a zero-sized
+          // read so the handler runs "as-if" posted using post().
+          if (start)
+          {
+            complete_ = true;
+
+            ASIO_HANDLER_LOCATION((
+                  __FILE__, __LINE__, Operation::tracking_name()));
+
+            socket_.async_read_some(asio::mutable_buffer(),
+                ASIO_MOVE_CAST(kernel_tls_io_op)(*this));
+            return;
+          }
+          break;
+        }
+
+        {
+          ASIO_HANDLER_LOCATION((
+                __FILE__, __LINE__, Operation::tracking_name()));
+
+          // Wait until the socket is ready and then retry the operation.
+          socket_.async_wait(wait_, ASIO_MOVE_CAST(kernel_tls_io_op)(*this));
+          return;
+        }
+
+      default:
+        if (complete_)
+          break;
+
+        if (ec)
+        {
+          // The wait failed or was cancelled.
+          ec_ = ec;
+          bytes_transferred_ = 0;
+          break;
+        }
+      }
+
+      op_.call_handler(handler_, ec_, bytes_transferred_);
+    }
+  }
+
+//private:
+  Socket& socket_;
+  stream_core& core_;
+  Operation op_;
+  int start_;
+  bool complete_;
+  socket_base::wait_type wait_;
+  asio::error_code ec_;
+  std::size_t bytes_transferred_;
+  Handler handler_;
+};
+
+template <typename Socket, typename Operation, typename Handler>
+inline asio_handler_allocate_is_deprecated
+asio_handler_allocate(std::size_t size,
+    kernel_tls_io_op<Socket, Operation, Handler>* this_handler)
+{
+#if defined(ASIO_NO_DEPRECATED)
+  asio_handler_alloc_helpers::allocate(size, this_handler->handler_);
+  return asio_handler_allocate_is_no_longer_used();
+#else // defined(ASIO_NO_DEPRECATED)
+  return asio_handler_alloc_helpers::allocate(
+      size, this_handler->handler_);
+#endif // defined(ASIO_NO_DEPRECATED)
+}
+
+template <typename Socket, typename Operation, typename Handler>
+inline asio_handler_deallocate_is_deprecated
+asio_handler_deallocate(void* pointer, std::size_t size,
+    kernel_tls_io_op<Socket, Operation, Handler>* this_handler)
+{
+  asio_handler_alloc_helpers::deallocate(
+      pointer, size, this_handler->handler_);
+#if defined(ASIO_NO_DEPRECATED)
+  return asio_handler_deallocate_is_no_longer_used();
+#endif // defined(ASIO_NO_DEPRECATED)
+}
+
+template <typename Socket, typename Operation, typename Handler>
+inline bool asio_handler_is_continuation(
+    kernel_tls_io_op<Socket, Operation, Handler>* this_handler)
+{
+  return this_handler->start_ == 0 ? true
+    : asio_handler_cont_helpers::is_continuation(this_handler->handler_);
+}
+
+template <typename Function, typename Socket,
+    typename Operation, typename Handler>
+inline asio_handler_invoke_is_deprecated
+asio_handler_invoke(Function& function,
+    kernel_tls_io_op<Socket, Operation, Handler>* this_handler)
+{
+  asio_handler_invoke_helpers::invoke(
+      function, this_handler->handler_);
+#if defined(ASIO_NO_DEPRECATED)
+  return asio_handler_invoke_is_no_longer_used();
+#endif // defined(ASIO_NO_DEPRECATED)
+}
+
+template <typename Function, typename Socket,
+    typename Operation, typename Handler>
+inline asio_handler_invoke_is_deprecated
+asio_handler_invoke(const Function& function,
+    kernel_tls_io_op<Socket, Operation, Handler>* this_handler)
+{
+  asio_handler_invoke_helpers::invoke(
+      function, this_handler->handler_);
+#if defined(ASIO_NO_DEPRECATED)
+  return asio_handler_invoke_is_no_longer_used();
+#endif // defined(ASIO_NO_DEPRECATED)
+}
+
+template <typename Protocol, typename Executor,
+    typename Operation, typename Handler>
+inline void async_kernel_tls_io(
+    basic_stream_socket<Protocol, Executor>& socket, stream_core& core,
+    const Operation& op, Handler& handler)
+{
+  kernel_tls_io_op<basic_stream_socket<Protocol, Executor>,
+    kernel_tls_op<Operation>, Handler>(socket, core,
+      kernel_tls_op<Operation>(op), handler)(
+        asio::error_code(), 0, 1);
+}
+
+#endif // defined(ASIO_HAS_SSL_KERNEL_TLS)
+
+} // namespace detail
+} // namespace ssl
+
+#if defined(ASIO_HAS_SSL_KERNEL_TLS)
+
+template <template <typename, typename> class Associator,
+    typename Socket, typename Operation,
+    typename Handler, typename DefaultCandidate>
+struct associator<Associator,
+    ssl::detail::kernel_tls_io_op<Socket, Operation, Handler>,
+    DefaultCandidate>
+  : Associator<Handler, DefaultCandidate>
+{
+  static typename Associator<Handler, DefaultCandidate>::type get(
+      const ssl::detail::kernel_tls_io_op<Socket, Operation, Handler>& h,
+      const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
+  {
+    return Associator<Handler, DefaultCandidate>::get(h.handler_, c);
+  }
+};
+
+#endif // defined(ASIO_HAS_SSL_KERNEL_TLS)
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_SSL_DETAIL_KERNEL_TLS_IO_HPP
@@ -31,4 +31,11 @@
 #include <openssl/x509.h>
 #include <openssl/x509v3.h>
 
+// Kernel TLS is used only where OpenSSL can enable it itself.
+#if defined(ASIO_HAS_KERNEL_TLS) && !defined(ASIO_USE_WOLFSSL)
+# if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+#  define ASIO_HAS_SSL_KERNEL_TLS 1
+# endif // defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+#endif // defined(ASIO_HAS_KERNEL_TLS) && !defined(ASIO_USE_WOLFSSL)
+
 #endif // ASIO_SSL_DETAIL_OPENSSL_TYPES_HPP
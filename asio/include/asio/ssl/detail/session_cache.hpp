@@ -0,0 +1,169 @@
+//
+// ssl/detail/session_cache.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_SESSION_CACHE_HPP
+#define ASIO_SSL_DETAIL_SESSION_CACHE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/ssl/detail/openssl_types.hpp"
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+# include <cstddef>
+# include <list>
+# include <map>
+# include <string>
+# include "asio/detail/mutex.hpp"
+# include "asio/detail/noncopyable.hpp"
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace ssl {
+namespace detail {
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+
+// The session resumption state shared by the connections of an SSL context.
+// Clients store the sessions they receive under a key that identifies the
+// peer, and servers protect session tickets using keys that may be rotated.
+// The cache is attached to the SSL_CTX, and is destroyed along with it. The
+// cache installs the context's new session callback, and passes each session
+// on to any callback that was installed before it.
+class session_cache
+  : private asio::detail::noncopyable
+{
+public:
+  // The size of the key material used to protect session tickets. This
+  // comprises a 16 byte key name, a 32 byte HMAC key and a 32 byte AES key.
+  enum { ticket_key_size = 80 };
+
+  // The number of ticket keys that are kept, including the current key.
+  // Tickets protected by an older key are not accepted.
+  enum { max_ticket_keys = 2 };
+
+  // Destructor.
+  ASIO_DECL ~session_cache();
+
+  // Get the cache attached to an SSL context. If there is none and create is
+  // true, a new cache is attached. Returns 0 on failure.
+  ASIO_DECL static session_cache* get(SSL_CTX* ctx, bool create);
+
+  // Set the maximum number of sessions that are stored. A maximum of zero
+  // disables the storage of sessions.
+  ASIO_DECL void set_max_sessions(SSL_CTX* ctx, std::size_t max_sessions);
+
+  // Make the specified key material the current ticket key. The previous key
+  // continues to be accepted for tickets it has already protected.
+  ASIO_DECL bool rotate_ticket_key(SSL_CTX* ctx, const unsigned char* key);
+
+  // Identify the peer of a client connection. A session stored for the peer
+  // is resumed by the handshake, and new sessions are stored for the peer.
+  // Returns the connection's cache, or 0 on failure.
+  ASIO_DECL static session_cache* set_peer(SSL* ssl, const std::string& peer);
+
+  // Record the completion of a handshake.
+  ASIO_DECL void handshake_complete(SSL* ssl);
+
+  // Get the number of handshakes that resumed a session.
+  ASIO_DECL std::size_t hits() const;
+
+  // Get the number of handshakes that did not resume a session.
+  ASIO_DECL std::size_t misses() const;
+
+private:
+  // Constructor.
+  ASIO_DECL explicit session_cache(std::size_t max_sessions);
+
+  // Get the index used to attach caches to SSL contexts.
+  ASIO_DECL static int context_index();
+
+  // Get the index used to attach peer names to connections.
+  ASIO_DECL static int connection_index();
+
+  // Callback used to destroy a cache when its SSL context is freed.
+  ASIO_DECL static void free_cache(void* parent, void* ptr,
+      CRYPTO_EX_DATA* data, int index, long argl, void* argp);
+
+  // Callback used to destroy a peer name when its connection is freed.
+  ASIO_DECL static void free_peer(void* parent, void* ptr,
+      CRYPTO_EX_DATA* data, int index, long argl, void* argp);
+
+  // Callback used when a new session is established.
+  ASIO_DECL static int new_session(SSL* ssl, SSL_SESSION* session);
+
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  // Callback used to protect and unprotect session tickets.
+  ASIO_DECL static int ticket_key_callback(SSL* ssl, unsigned char* name,
+      unsigned char* iv, EVP_CIPHER_CTX* cipher, EVP_MAC_CTX* mac, int enc);
+#else // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  // Callback used to protect and unprotect session tickets.
+  ASIO_DECL static int ticket_key_callback(SSL* ssl, unsigned char* name,
+      unsigned char* iv, EVP_CIPHER_CTX* cipher, HMAC_CTX* mac, int enc);
+#endif // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+
+  // Store a session for a peer, evicting the least recently stored session
+  // if the cache is full. Takes ownership of the session's reference.
+  void store(const std::string& peer, SSL_SESSION* session);
+
+  // Remove the least recently stored sessions until the cache holds no more
+  // than the maximum number of sessions.
+  void evict();
+
+  // Mutex to protect access to the cache.
+  mutable asio::detail::mutex mutex_;
+
+  // The maximum number of sessions that are stored.
+  std::size_t max_sessions_;
+
+  // A session stored for a peer.
+  struct entry
+  {
+    std::string peer;
+    SSL_SESSION* session;
+  };
+
+  // The stored sessions, most recently stored first.
+  std::list<entry> sessions_;
+
+  // Index of the stored sessions by peer.
+  std::map<std::string, std::list<entry>::iterator> peers_;
+
+  // The key material used to protect session tickets, current key first.
+  unsigned char ticket_keys_[max_ticket_keys][ticket_key_size];
+  std::size_t ticket_key_count_;
+
+  // The numbers of handshakes that did and did not resume a session.
+  std::size_t hits_;
+  std::size_t misses_;
+
+  // The new session callback that was installed before the cache, if any.
+  int (*next_new_session_)(SSL*, SSL_SESSION*);
+};
+
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+
+} // namespace detail
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/ssl/detail/impl/session_cache.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // ASIO_SSL_DETAIL_SESSION_CACHE_HPP
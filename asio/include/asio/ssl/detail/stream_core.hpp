@@ -22,8 +22,11 @@
 #else // defined(ASIO_HAS_BOOST_DATE_TIME)
 # include "asio/steady_timer.hpp"
 #endif // defined(ASIO_HAS_BOOST_DATE_TIME)
+#include "asio/ssl/detail/buffer_pool.hpp"
 #include "asio/ssl/detail/engine.hpp"
 #include "asio/buffer.hpp"
+#include "asio/execution/context.hpp"
+#include "asio/query.hpp"
 
 #include "asio/detail/push_options.hpp"
 
@@ -38,14 +41,24 @@ struct stream_core
   enum { max_tls_record_size = 17 * 1024 };
 
   template <typename Executor>
-  stream_core(SSL_CTX* context, const Executor& ex)
+  stream_core(SSL_CTX* context, const Executor& ex,
+      std::size_t input_buffer_size = max_tls_record_size,
+      std::size_t output_buffer_size = max_tls_record_size,
+      bool release_idle_buffers = false)
     : engine_(context),
       pending_read_(ex),
       pending_write_(ex),
-      output_buffer_space_(max_tls_record_size),
-      output_buffer_(asio::buffer(output_buffer_space_)),
-      input_buffer_space_(max_tls_record_size),
-      input_buffer_(asio::buffer(input_buffer_space_))
+      buffer_pool_(&asio::use_service<buffer_pool>(
+            asio::query(pending_read_.get_executor(),
+              asio::execution::context))),
+      buffer_space_(0),
+      buffer_space_size_(0),
+      input_buffer_size_(input_buffer_size),
+      output_buffer_size_(output_buffer_size),
+      release_idle_buffers_(release_idle_buffers),
+      operations_(0),
+      kernel_tls_requested_(false),
+      kernel_tls_(false)
   {
     pending_read_.expires_at(neg_infin());
     pending_write_.expires_at(neg_infin());
@@ -69,24 +82,31 @@ struct stream_core
          ASIO_MOVE_CAST(asio::steady_timer)(
            other.pending_write_)),
 #endif // defined(ASIO_HAS_BOOST_DATE_TIME)
-      output_buffer_space_(
-          ASIO_MOVE_CAST(std::vector<unsigned char>)(
-            other.output_buffer_space_)),
+      buffer_pool_(other.buffer_pool_),
+      buffer_space_(other.buffer_space_),
+      buffer_space_size_(other.buffer_space_size_),
+      input_buffer_size_(other.input_buffer_size_),
+      output_buffer_size_(other.output_buffer_size_),
+      release_idle_buffers_(other.release_idle_buffers_),
       output_buffer_(other.output_buffer_),
-      input_buffer_space_(
-          ASIO_MOVE_CAST(std::vector<unsigned char>)(
-            other.input_buffer_space_)),
       input_buffer_(other.input_buffer_),
-      input_(other.input_)
+      input_(other.input_),
+      operations_(other.operations_),
+      kernel_tls_requested_(other.kernel_tls_requested_),
+      kernel_tls_(other.kernel_tls_)
   {
+    other.buffer_space_ = 0;
+    other.buffer_space_size_ = 0;
     other.output_buffer_ = asio::mutable_buffer(0, 0);
     other.input_buffer_ = asio::mutable_buffer(0, 0);
     other.input_ = asio::const_buffer(0, 0);
+    other.operations_ = 0;
   }
 #endif // defined(ASIO_HAS_MOVE)
 
   ~stream_core()
   {
+    buffer_pool_->deallocate(buffer_space_, buffer_space_size_);
   }
 
 #if defined(ASIO_HAS_MOVE)
@@ -110,22 +130,88 @@ struct stream_core
         ASIO_MOVE_CAST(asio::steady_timer)(
           other.pending_write_);
 #endif // defined(ASIO_HAS_BOOST_DATE_TIME)
-      output_buffer_space_ =
-        ASIO_MOVE_CAST(std::vector<unsigned char>)(
-          other.output_buffer_space_);
+      buffer_pool_->deallocate(buffer_space_, buffer_space_size_);
+      buffer_pool_ = other.buffer_pool_;
+      buffer_space_ = other.buffer_space_;
+      buffer_space_size_ = other.buffer_space_size_;
+      input_buffer_size_ = other.input_buffer_size_;
+      output_buffer_size_ = other.output_buffer_size_;
+      release_idle_buffers_ = other.release_idle_buffers_;
       output_buffer_ = other.output_buffer_;
-      input_buffer_space_ =
-        ASIO_MOVE_CAST(std::vector<unsigned char>)(
-          other.input_buffer_space_);
+      input_buffer_ = other.input_buffer_;
       input_ = other.input_;
+      operations_ = other.operations_;
+      kernel_tls_requested_ = other.kernel_tls_requested_;
+      kernel_tls_ = other.kernel_tls_;
+      other.buffer_space_ = 0;
+      other.buffer_space_size_ = 0;
       other.output_buffer_ = asio::mutable_buffer(0, 0);
       other.input_buffer_ = asio::mutable_buffer(0, 0);
       other.input_ = asio::const_buffer(0, 0);
+      other.operations_ = 0;
     }
     return *this;
   }
 #endif // defined(ASIO_HAS_MOVE)
 
+  // Set the sizes of the buffers to be used when they are next allocated.
+  void set_buffer_sizes(std::size_t input_size, std::size_t output_size)
+  {
+    input_buffer_size_ = input_size;
+    output_buffer_size_ = output_size;
+  }
+
+  // Obtain the input and output buffers from the pool, if they are not
+  // already held.
+  void acquire_buffers()
+  {
+    if (buffer_space_ == 0)
+    {
+      std::size_t size = input_buffer_size_ + output_buffer_size_;
+      buffer_space_ = buffer_pool_->allocate(size);
+      buffer_space_size_ = size;
+
+      unsigned char* p = static_cast<unsigned char*>(buffer_space_);
+      input_buffer_ = asio::mutable_buffer(p, input_buffer_size_);
+      output_buffer_ = asio::mutable_buffer(
+          p + input_buffer_size_, output_buffer_size_);
+      engine_.set_output_buffer(output_buffer_);
+    }
+  }
+
+  // Return the input and output buffers to the pool. The buffers are kept if
+  // they contain data that has not yet been consumed. Returns true if the
+  // buffers are no longer held.
+  bool release_buffers()
+  {
+    if (buffer_space_ != 0)
+    {
+      if (input_.size() != 0 || engine_.has_buffered_data())
+        return false;
+
+      engine_.set_output_buffer(asio::mutable_buffer(0, 0));
+      output_buffer_ = asio::mutable_buffer(0, 0);
+      input_buffer_ = asio::mutable_buffer(0, 0);
+      buffer_pool_->deallocate(buffer_space_, buffer_space_size_);
+      buffer_space_ = 0;
+      buffer_space_size_ = 0;
+    }
+    return true;
+  }
+
+  // Called when an operation starts, to ensure that the buffers are held.
+  void start_operation()
+  {
+    ++operations_;
+    acquire_buffers();
+  }
+
+  // Called when an operation completes.
+  void finish_operation()
+  {
+    --operations_;
+  }
+
   // The SSL engine.
   engine engine_;
 
@@ -181,20 +267,39 @@ struct stream_core
   }
 #endif // defined(ASIO_HAS_BOOST_DATE_TIME)
 
-  // Buffer space used to prepare output intended for the transport.
-  std::vector<unsigned char> output_buffer_space_;
+  // The pool from which the input and output buffers are obtained.
+  buffer_pool* buffer_pool_;
 
-  // A buffer that may be used to prepare output intended for the transport.
-  asio::mutable_buffer output_buffer_;
+  // The space holding the input and output buffers, if they are held.
+  void* buffer_space_;
+  std::size_t buffer_space_size_;
+
+  // The sizes of the input and output buffers when they are next allocated.
+  std::size_t input_buffer_size_;
+  std::size_t output_buffer_size_;
 
-  // Buffer space used to read input intended for the engine.
-  std::vector<unsigned char> input_buffer_space_;
+  // Whether the buffers are returned to the pool while waiting for data.
+  bool release_idle_buffers_;
+
+  // The buffer into which the engine writes output intended for the
+  // transport.
+  asio::mutable_buffer output_buffer_;
 
   // A buffer that may be used to read input intended for the engine.
   asio::mutable_buffer input_buffer_;
 
   // The buffer pointing to the engine's unconsumed input.
   asio::const_buffer input_;
+
+  // The number of operations that are in progress on the stream.
+  std::size_t operations_;
+
+  // Whether the handshake should allow records to be processed by the kernel.
+  bool kernel_tls_requested_;
+
+  // Whether the SSL implementation reads from and writes to the socket
+  // directly, so that the kernel may process records.
+  bool kernel_tls_;
 };
 
 } // namespace detail
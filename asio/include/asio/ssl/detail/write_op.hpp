@@ -44,15 +44,42 @@ public:
       asio::error_code& ec,
       std::size_t& bytes_transferred) const
   {
+    // Storage used to coalesce smaller buffers into a single record.
     unsigned char storage[
       asio::detail::buffer_sequence_adapter<asio::const_buffer,
-        ConstBufferSequence>::linearisation_storage_size];
-
-    asio::const_buffer buffer =
-      asio::detail::buffer_sequence_adapter<asio::const_buffer,
-        ConstBufferSequence>::linearise(buffers_, asio::buffer(storage));
-
-    return eng.write(buffer, ec, bytes_transferred);
+        ConstBufferSequence>::is_single_buffer ? 1 : engine::max_record_data];
+
+    // Records are added to the engine's output until the buffers are
+    // exhausted, or until the output buffer cannot hold another record, so
+    // that the records are written to the transport together. The bytes
+    // transferred are the progress made by earlier calls that were
+    // interrupted to write output or to read input.
+    std::size_t total_size = asio::buffer_size(buffers_);
+    std::size_t start = bytes_transferred;
+    for (;;)
+    {
+      asio::const_buffer buffer = prepare(
+          asio::buffer_sequence_begin(buffers_),
+          asio::buffer_sequence_end(buffers_),
+          bytes_transferred, asio::buffer(storage));
+
+      std::size_t length = 0;
+      engine::want want = eng.write(buffer, ec, length);
+      if (want != engine::want_output || ec)
+      {
+        // Write the records that have already been added to the output.
+        if (bytes_transferred != start && !ec)
+          return engine::want_output;
+        return want;
+      }
+
+      bytes_transferred += length;
+      const std::size_t max_data = engine::max_record_data;
+      std::size_t remaining = total_size - bytes_transferred;
+      if (remaining == 0 || eng.max_write_size()
+            < (remaining < max_data ? remaining : max_data))
+        return want;
+    }
   }
 
   template <typename Handler>
@@ -64,6 +91,42 @@ public:
   }
 
 private:
+  // Get the data for the next record, starting at the specified offset into
+  // the buffers. Smaller buffers are copied into the storage so that the
+  // record is as large as possible.
+  template <typename Iterator>
+  static asio::const_buffer prepare(Iterator begin, Iterator end,
+      std::size_t offset, const asio::mutable_buffer& storage)
+  {
+    asio::mutable_buffer unused_storage = storage;
+    for (Iterator iter = begin; iter != end; ++iter)
+    {
+      asio::const_buffer buffer(*iter);
+      if (offset >= buffer.size())
+      {
+        offset -= buffer.size();
+        continue;
+      }
+      buffer += offset;
+      offset = 0;
+
+      // A buffer that fills the storage, or that is the last in the
+      // sequence, may be used without copying.
+      if (unused_storage.size() == storage.size())
+      {
+        Iterator next = iter;
+        if (buffer.size() >= storage.size() || ++next == end)
+          return asio::buffer(buffer, engine::max_record_data);
+      }
+
+      unused_storage += asio::buffer_copy(unused_storage, buffer);
+      if (unused_storage.size() == 0)
+        break;
+    }
+    return asio::const_buffer(storage.data(),
+        storage.size() - unused_storage.size());
+  }
+
   ConstBufferSequence buffers_;
 };
 
@@ -22,8 +22,14 @@
 #include "asio/detail/throw_error.hpp"
 #include "asio/error.hpp"
 #include "asio/ssl/context.hpp"
+#include "asio/ssl/detail/session_cache.hpp"
 #include "asio/ssl/error.hpp"
 
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+# include <openssl/rand.h>
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+
 #include "asio/detail/push_options.hpp"
 
 namespace asio {
@@ -60,7 +66,10 @@ struct context::dh_cleanup
 };
 
 context::context(context::method m)
-  : handle_(0)
+  : handle_(0),
+    input_buffer_size_(default_buffer_size),
+    output_buffer_size_(default_buffer_size),
+    release_idle_buffers_(false)
 {
   ::ERR_clear_error();
 
@@ -367,7 +376,10 @@ context::context(context::method m)
 }
 
 context::context(context::native_handle_type native_handle)
-  : handle_(native_handle)
+  : handle_(native_handle),
+    input_buffer_size_(default_buffer_size),
+    output_buffer_size_(default_buffer_size),
+    release_idle_buffers_(false)
 {
   if (!handle_)
   {
@@ -380,6 +392,9 @@ context::context(context::native_handle_type native_handle)
 context::context(context&& other)
 {
   handle_ = other.handle_;
+  input_buffer_size_ = other.input_buffer_size_;
+  output_buffer_size_ = other.output_buffer_size_;
+  release_idle_buffers_ = other.release_idle_buffers_;
   other.handle_ = 0;
 }
 
@@ -387,6 +402,9 @@ context& context::operator=(context&& other)
 {
   context tmp(ASIO_MOVE_CAST(context)(*this));
   handle_ = other.handle_;
+  input_buffer_size_ = other.input_buffer_size_;
+  output_buffer_size_ = other.output_buffer_size_;
+  release_idle_buffers_ = other.release_idle_buffers_;
   other.handle_ = 0;
   return *this;
 }
@@ -531,6 +549,164 @@ ASIO_SYNC_OP_VOID context::set_verify_depth(
   ASIO_SYNC_OP_VOID_RETURN(ec);
 }
 
+void context::set_buffer_sizes(
+    std::size_t input_size, std::size_t output_size)
+{
+  asio::error_code ec;
+  set_buffer_sizes(input_size, output_size, ec);
+  asio::detail::throw_error(ec, "set_buffer_sizes");
+}
+
+ASIO_SYNC_OP_VOID context::set_buffer_sizes(std::size_t input_size,
+    std::size_t output_size, asio::error_code& ec)
+{
+  if (input_size == 0 || output_size == 0)
+  {
+    ec = asio::error::invalid_argument;
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  input_buffer_size_ = input_size;
+  output_buffer_size_ = output_size;
+
+  ec = asio::error_code();
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+}
+
+void context::set_session_cache_size(std::size_t max_sessions)
+{
+  asio::error_code ec;
+  set_session_cache_size(max_sessions, ec);
+  asio::detail::throw_error(ec, "set_session_cache_size");
+}
+
+ASIO_SYNC_OP_VOID context::set_session_cache_size(
+    std::size_t max_sessions, asio::error_code& ec)
+{
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+  detail::session_cache* cache = detail::session_cache::get(handle_, true);
+  if (!cache)
+  {
+    ec = asio::error::no_memory;
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  cache->set_max_sessions(handle_, max_sessions);
+
+  ec = asio::error_code();
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+#else // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+      //   && !defined(ASIO_USE_WOLFSSL)
+  (void)max_sessions;
+  ec = asio::error::operation_not_supported;
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+}
+
+void context::rotate_session_ticket_key()
+{
+  asio::error_code ec;
+  rotate_session_ticket_key(ec);
+  asio::detail::throw_error(ec, "rotate_session_ticket_key");
+}
+
+ASIO_SYNC_OP_VOID context::rotate_session_ticket_key(
+    asio::error_code& ec)
+{
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+  ::ERR_clear_error();
+
+  unsigned char key[detail::session_cache::ticket_key_size];
+  if (::RAND_bytes(key, sizeof(key)) != 1)
+  {
+    ec = asio::error_code(
+        static_cast<int>(::ERR_get_error()),
+        asio::error::get_ssl_category());
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  rotate_session_ticket_key(asio::buffer(key), ec);
+  ::OPENSSL_cleanse(key, sizeof(key));
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+#else // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+      //   && !defined(ASIO_USE_WOLFSSL)
+  ec = asio::error::operation_not_supported;
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+}
+
+void context::rotate_session_ticket_key(const const_buffer& key)
+{
+  asio::error_code ec;
+  rotate_session_ticket_key(key, ec);
+  asio::detail::throw_error(ec, "rotate_session_ticket_key");
+}
+
+ASIO_SYNC_OP_VOID context::rotate_session_ticket_key(
+    const const_buffer& key, asio::error_code& ec)
+{
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+  if (key.size() != detail::session_cache::ticket_key_size)
+  {
+    ec = asio::error::invalid_argument;
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  detail::session_cache* cache = detail::session_cache::get(handle_, true);
+  if (!cache)
+  {
+    ec = asio::error::no_memory;
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  ::ERR_clear_error();
+
+  if (!cache->rotate_ticket_key(handle_,
+        static_cast<const unsigned char*>(key.data())))
+  {
+    ec = asio::error_code(
+        static_cast<int>(::ERR_get_error()),
+        asio::error::get_ssl_category());
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  ec = asio::error_code();
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+#else // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+      //   && !defined(ASIO_USE_WOLFSSL)
+  (void)key;
+  ec = asio::error::operation_not_supported;
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+}
+
+std::size_t context::session_cache_hits() const
+{
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+  detail::session_cache* cache = detail::session_cache::get(handle_, false);
+  return cache ? cache->hits() : 0;
+#else // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+      //   && !defined(ASIO_USE_WOLFSSL)
+  return 0;
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+}
+
+std::size_t context::session_cache_misses() const
+{
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+  detail::session_cache* cache = detail::session_cache::get(handle_, false);
+  return cache ? cache->misses() : 0;
+#else // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+      //   && !defined(ASIO_USE_WOLFSSL)
+  return 0;
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+}
+
 void context::load_verify_file(const std::string& filename)
 {
   asio::error_code ec;
@@ -0,0 +1,157 @@
+//
+// ssl/session.hpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_SESSION_HPP
+#define ASIO_SSL_SESSION_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#include "asio/ssl/detail/openssl_types.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+namespace ssl {
+
+/// A reference to an SSL session, which may be used to resume the session on
+/// another connection.
+/**
+ * Copies of a session object refer to the same underlying SSL_SESSION, which
+ * is freed when the last reference is destroyed.
+ */
+class session
+{
+public:
+  /// The native handle type of the session.
+  typedef SSL_SESSION* native_handle_type;
+
+  /// Construct an empty session.
+  session() ASIO_NOEXCEPT
+    : handle_(0)
+  {
+  }
+
+  /// Construct a session from a native handle.
+  /**
+   * @param handle The native session handle. Ownership of one reference to
+   * the session is transferred to the session object.
+   */
+  explicit session(native_handle_type handle) ASIO_NOEXCEPT
+    : handle_(handle)
+  {
+  }
+
+  /// Copy constructor.
+  session(const session& other) ASIO_NOEXCEPT
+    : handle_(other.handle_)
+  {
+    if (handle_)
+      add_reference(handle_);
+  }
+
+#if defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Move constructor.
+  session(session&& other) ASIO_NOEXCEPT
+    : handle_(other.handle_)
+  {
+    other.handle_ = 0;
+  }
+#endif // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Destructor.
+  ~session()
+  {
+    if (handle_)
+      ::SSL_SESSION_free(handle_);
+  }
+
+  /// Copy assignment.
+  session& operator=(const session& other) ASIO_NOEXCEPT
+  {
+    if (other.handle_)
+      add_reference(other.handle_);
+    if (handle_)
+      ::SSL_SESSION_free(handle_);
+    handle_ = other.handle_;
+    return *this;
+  }
+
+#if defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Move assignment.
+  session& operator=(session&& other) ASIO_NOEXCEPT
+  {
+    if (this != &other)
+    {
+      if (handle_)
+        ::SSL_SESSION_free(handle_);
+      handle_ = other.handle_;
+      other.handle_ = 0;
+    }
+    return *this;
+  }
+#endif // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Get the underlying implementation in the native type.
+  /**
+   * This function may be used to obtain the underlying implementation of the
+   * session. This is intended to allow access to session functionality that
+   * is not otherwise provided.
+   */
+  native_handle_type native_handle() const ASIO_NOEXCEPT
+  {
+    return handle_;
+  }
+
+  /// Determine whether the object refers to a session.
+  bool empty() const ASIO_NOEXCEPT
+  {
+    return handle_ == 0;
+  }
+
+  /// Determine whether the session may be used to resume a connection.
+  bool is_resumable() const ASIO_NOEXCEPT
+  {
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L) && !defined(ASIO_USE_WOLFSSL)
+    return handle_ != 0 && ::SSL_SESSION_is_resumable(handle_) != 0;
+#else // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+      //   && !defined(ASIO_USE_WOLFSSL)
+    return handle_ != 0;
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+       //   && !defined(ASIO_USE_WOLFSSL)
+  }
+
+private:
+  // Add a reference to a native session.
+  static void add_reference(native_handle_type handle) ASIO_NOEXCEPT
+  {
+#if ((OPENSSL_VERSION_NUMBER >= 0x10100000L) \
+      && (!defined(LIBRESSL_VERSION_NUMBER) \
+        || LIBRESSL_VERSION_NUMBER >= 0x2070000fL)) \
+    || defined(ASIO_USE_WOLFSSL)
+    ::SSL_SESSION_up_ref(handle);
+#else // (OPENSSL_VERSION_NUMBER >= 0x10100000L)
+    ::CRYPTO_add(&handle->references, 1, CRYPTO_LOCK_SSL_SESSION);
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10100000L)
+  }
+
+  // The underlying native implementation.
+  native_handle_type handle_;
+};
+
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_SSL_SESSION_HPP
@@ -27,10 +27,12 @@
 #include "asio/ssl/detail/buffered_handshake_op.hpp"
 #include "asio/ssl/detail/handshake_op.hpp"
 #include "asio/ssl/detail/io.hpp"
+#include "asio/ssl/detail/kernel_tls_io.hpp"
 #include "asio/ssl/detail/read_op.hpp"
 #include "asio/ssl/detail/shutdown_op.hpp"
 #include "asio/ssl/detail/stream_core.hpp"
 #include "asio/ssl/detail/write_op.hpp"
+#include "asio/ssl/session.hpp"
 #include "asio/ssl/stream_base.hpp"
 
 #include "asio/detail/push_options.hpp"
@@ -97,14 +99,18 @@ public:
   template <typename Arg>
   stream(Arg&& arg, context& ctx)
     : next_layer_(ASIO_MOVE_CAST(Arg)(arg)),
-      core_(ctx.native_handle(), next_layer_.lowest_layer().get_executor())
+      core_(ctx.native_handle(), next_layer_.lowest_layer().get_executor(),
+          ctx.input_buffer_size(), ctx.output_buffer_size(),
+          ctx.release_idle_buffers())
   {
   }
 #else // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
   template <typename Arg>
   stream(Arg& arg, context& ctx)
     : next_layer_(arg),
-      core_(ctx.native_handle(), next_layer_.lowest_layer().get_executor())
+      core_(ctx.native_handle(), next_layer_.lowest_layer().get_executor(),
+          ctx.input_buffer_size(), ctx.output_buffer_size(),
+          ctx.release_idle_buffers())
   {
   }
 #endif // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
@@ -319,6 +325,178 @@ public:
     ASIO_SYNC_OP_VOID_RETURN(ec);
   }
 
+  /// Set the sizes of the buffers used by the stream.
+  /**
+   * This function may be used to override the buffer sizes obtained from the
+   * context. The new sizes are used when the stream next allocates its
+   * buffers.
+   *
+   * @param input_size The size of the buffer used to hold data received from
+   * the next layer.
+   *
+   * @param output_size The size of the buffer used to hold data to be sent to
+   * the next layer.
+   *
+   * @throws asio::system_error Thrown on failure.
+   */
+  void set_buffer_sizes(std::size_t input_size, std::size_t output_size)
+  {
+    asio::error_code ec;
+    set_buffer_sizes(input_size, output_size, ec);
+    asio::detail::throw_error(ec, "set_buffer_sizes");
+  }
+
+  /// Set the sizes of the buffers used by the stream.
+  /**
+   * This function may be used to override the buffer sizes obtained from the
+   * context. The new sizes are used when the stream next allocates its
+   * buffers.
+   *
+   * @param input_size The size of the buffer used to hold data received from
+   * the next layer.
+   *
+   * @param output_size The size of the buffer used to hold data to be sent to
+   * the next layer.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  ASIO_SYNC_OP_VOID set_buffer_sizes(std::size_t input_size,
+      std::size_t output_size, asio::error_code& ec)
+  {
+    if (input_size == 0 || output_size == 0)
+    {
+      ec = asio::error::invalid_argument;
+      ASIO_SYNC_OP_VOID_RETURN(ec);
+    }
+
+    core_.set_buffer_sizes(input_size, output_size);
+    ec = asio::error_code();
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  /// Set whether the stream releases its buffers while waiting for data.
+  /**
+   * This function may be used to override the setting obtained from the
+   * context. When enabled, a stream over a basic_stream_socket returns its
+   * buffers to a pool, shared with other streams using the same execution
+   * context, while it waits for data to be received and no other operation is
+   * in progress.
+   *
+   * @param enable Whether idle buffers are released.
+   */
+  void set_release_idle_buffers(bool enable)
+  {
+    core_.release_idle_buffers_ = enable;
+  }
+
+  /// Set the session to be resumed by the handshake.
+  /**
+   * This function may be used by a client to resume a session obtained from
+   * an earlier connection to the same server. It must be called before the
+   * handshake is performed. If the server does not accept the session, the
+   * handshake establishes a new one.
+   *
+   * @param s The session to be resumed.
+   *
+   * @throws asio::system_error Thrown on failure.
+   *
+   * @note Calls @c SSL_set_session.
+   */
+  void set_session(const session& s)
+  {
+    asio::error_code ec;
+    set_session(s, ec);
+    asio::detail::throw_error(ec, "set_session");
+  }
+
+  /// Set the session to be resumed by the handshake.
+  /**
+   * This function may be used by a client to resume a session obtained from
+   * an earlier connection to the same server. It must be called before the
+   * handshake is performed. If the server does not accept the session, the
+   * handshake establishes a new one.
+   *
+   * @param s The session to be resumed.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @note Calls @c SSL_set_session.
+   */
+  ASIO_SYNC_OP_VOID set_session(const session& s, asio::error_code& ec)
+  {
+    core_.engine_.set_session(s.native_handle(), ec);
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  /// Get the session used by the stream.
+  /**
+   * This function may be used to obtain the session established or resumed
+   * by the handshake, so that it may be resumed by a later connection. With
+   * TLS 1.3, the server sends the client its session after the handshake,
+   * and it is available only once the client has read some data.
+   *
+   * @returns The session, which is empty if there is none.
+   *
+   * @note Calls @c SSL_get1_session.
+   */
+  session get_session() const
+  {
+    return session(core_.engine_.get_session());
+  }
+
+  /// Determine whether the handshake resumed a session.
+  /**
+   * @note Calls @c SSL_session_reused.
+   */
+  bool session_reused() const
+  {
+    return core_.engine_.session_reused();
+  }
+
+  /// Identify the peer for which the context caches sessions.
+  /**
+   * This function may be used by a client to resume sessions automatically.
+   * If the context holds a session for the peer, the handshake resumes it.
+   * Sessions that the server sends on this connection are stored in the
+   * context for the peer, replacing any earlier session. The function must be
+   * called before the handshake is performed, and enables the context's
+   * session cache if necessary. See ssl::context::set_session_cache_size()
+   * for the cache's use of the new session callback.
+   *
+   * @param peer A name that identifies the server, such as its host name and
+   * port.
+   *
+   * @throws asio::system_error Thrown on failure.
+   */
+  void set_session_cache_peer(const std::string& peer)
+  {
+    asio::error_code ec;
+    set_session_cache_peer(peer, ec);
+    asio::detail::throw_error(ec, "set_session_cache_peer");
+  }
+
+  /// Identify the peer for which the context caches sessions.
+  /**
+   * This function may be used by a client to resume sessions automatically.
+   * If the context holds a session for the peer, the handshake resumes it.
+   * Sessions that the server sends on this connection are stored in the
+   * context for the peer, replacing any earlier session. The function must be
+   * called before the handshake is performed, and enables the context's
+   * session cache if necessary. See ssl::context::set_session_cache_size()
+   * for the cache's use of the new session callback.
+   *
+   * @param peer A name that identifies the server, such as its host name and
+   * port.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  ASIO_SYNC_OP_VOID set_session_cache_peer(
+      const std::string& peer, asio::error_code& ec)
+  {
+    core_.engine_.set_session_cache_peer(peer, ec);
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
   /// Set the callback used to verify peer certificates.
   /**
    * This function is used to specify a callback function that will be called
@@ -372,6 +550,60 @@ public:
     ASIO_SYNC_OP_VOID_RETURN(ec);
   }
 
+  /// Request that records be processed by the kernel after the handshake.
+  /**
+   * This function may be used to request that the protection of TLS records
+   * is transferred to the kernel. The handshake and all subsequent operations
+   * on the stream are then performed by OpenSSL directly on the underlying
+   * socket, and OpenSSL enables kernel TLS for each direction that the kernel
+   * supports. Once records sent are protected by the kernel, data may be sent
+   * by passing the socket's native handle to functions such as @c sendfile.
+   *
+   * The request has effect only if the next layer is a basic_stream_socket,
+   * the handshake is performed without buffered data, and OpenSSL was built
+   * with kernel TLS support. Otherwise, the SSL engine continues to process
+   * records. After the handshake, kernel_tls_send_active() and
+   * kernel_tls_receive_active() indicate which directions were transferred.
+   *
+   * When the request has effect, every operation bypasses the SSL engine's
+   * buffering, even if the kernel does not take over either direction. The
+   * stream's buffers are not used, so set_buffer_sizes() and
+   * set_release_idle_buffers() have no effect, and each write_some() or
+   * async_write_some() operation writes only the first buffer of the sequence
+   * rather than gathering the buffers into a single record.
+   *
+   * The handshake puts the socket into non-blocking mode, as OpenSSL reads
+   * and writes the socket directly, and the socket is left in that mode. Code
+   * that passes the native handle to functions such as @c sendfile must
+   * either handle @c EAGAIN or restore blocking mode first, by calling the
+   * socket's @c native_non_blocking(false). If it does so, it must set
+   * non-blocking mode again before performing further operations on the
+   * stream.
+   *
+   * @param enable Whether kernel TLS is requested. Must be set before the
+   * handshake is performed.
+   *
+   * @note Kernel TLS is supported on Linux only, and requires OpenSSL 3.0 or
+   * later.
+   */
+  void set_kernel_tls(bool enable)
+  {
+    core_.kernel_tls_requested_ = enable;
+  }
+
+  /// Determine whether records sent on the stream are protected by the kernel.
+  bool kernel_tls_send_active() const
+  {
+    return core_.kernel_tls_ && core_.engine_.kernel_tls_send_active();
+  }
+
+  /// Determine whether records received on the stream are processed by the
+  /// kernel.
+  bool kernel_tls_receive_active() const
+  {
+    return core_.kernel_tls_ && core_.engine_.kernel_tls_receive_active();
+  }
+
   /// Perform SSL handshaking.
   /**
    * This function is used to perform SSL handshaking on the stream. The
@@ -402,7 +634,12 @@ public:
   ASIO_SYNC_OP_VOID handshake(handshake_type type,
       asio::error_code& ec)
   {
-    detail::io(next_layer_, core_, detail::handshake_op(type), ec);
+    if (core_.kernel_tls_requested_)
+      detail::start_kernel_tls(next_layer_, core_);
+    if (core_.kernel_tls_)
+      detail::kernel_tls_io(next_layer_, core_, detail::handshake_op(type), ec);
+    else
+      detail::io(next_layer_, core_, detail::handshake_op(type), ec);
     ASIO_SYNC_OP_VOID_RETURN(ec);
   }
 
@@ -558,7 +795,10 @@ public:
    */
   ASIO_SYNC_OP_VOID shutdown(asio::error_code& ec)
   {
-    detail::io(next_layer_, core_, detail::shutdown_op(), ec);
+    if (core_.kernel_tls_)
+      detail::kernel_tls_io(next_layer_, core_, detail::shutdown_op(), ec);
+    else
+      detail::io(next_layer_, core_, detail::shutdown_op(), ec);
     ASIO_SYNC_OP_VOID_RETURN(ec);
   }
 
@@ -645,6 +885,11 @@ public:
   std::size_t write_some(const ConstBufferSequence& buffers,
       asio::error_code& ec)
   {
+    if (core_.kernel_tls_)
+    {
+      return detail::kernel_tls_io(next_layer_, core_,
+          detail::kernel_tls_write_op<ConstBufferSequence>(buffers), ec);
+    }
     return detail::io(next_layer_, core_,
         detail::write_op<ConstBufferSequence>(buffers), ec);
   }
@@ -743,6 +988,11 @@ public:
   std::size_t read_some(const MutableBufferSequence& buffers,
       asio::error_code& ec)
   {
+    if (core_.kernel_tls_)
+    {
+      return detail::kernel_tls_io(next_layer_, core_,
+          detail::read_op<MutableBufferSequence>(buffers), ec);
+    }
     return detail::io(next_layer_, core_,
         detail::read_op<MutableBufferSequence>(buffers), ec);
   }
@@ -821,8 +1071,18 @@ private:
       ASIO_HANDSHAKE_HANDLER_CHECK(HandshakeHandler, handler) type_check;
 
       asio::detail::non_const_lvalue<HandshakeHandler> handler2(handler);
-      detail::async_io(self_->next_layer_, self_->core_,
-          detail::handshake_op(type), handler2.value);
+      if (self_->core_.kernel_tls_requested_)
+        detail::start_kernel_tls(self_->next_layer_, self_->core_);
+      if (self_->core_.kernel_tls_)
+      {
+        detail::async_kernel_tls_io(self_->next_layer_, self_->core_,
+            detail::handshake_op(type), handler2.value);
+      }
+      else
+      {
+        detail::async_io(self_->next_layer_, self_->core_,
+            detail::handshake_op(type), handler2.value);
+      }
     }
 
   private:
@@ -888,8 +1148,16 @@ private:
       ASIO_HANDSHAKE_HANDLER_CHECK(ShutdownHandler, handler) type_check;
 
       asio::detail::non_const_lvalue<ShutdownHandler> handler2(handler);
-      detail::async_io(self_->next_layer_, self_->core_,
-          detail::shutdown_op(), handler2.value);
+      if (self_->core_.kernel_tls_)
+      {
+        detail::async_kernel_tls_io(self_->next_layer_, self_->core_,
+            detail::shutdown_op(), handler2.value);
+      }
+      else
+      {
+        detail::async_io(self_->next_layer_, self_->core_,
+            detail::shutdown_op(), handler2.value);
+      }
     }
 
   private:
@@ -920,8 +1188,17 @@ private:
       ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
 
       asio::detail::non_const_lvalue<WriteHandler> handler2(handler);
-      detail::async_io(self_->next_layer_, self_->core_,
-          detail::write_op<ConstBufferSequence>(buffers), handler2.value);
+      if (self_->core_.kernel_tls_)
+      {
+        detail::async_kernel_tls_io(self_->next_layer_, self_->core_,
+            detail::kernel_tls_write_op<ConstBufferSequence>(buffers),
+            handler2.value);
+      }
+      else
+      {
+        detail::async_io(self_->next_layer_, self_->core_,
+            detail::write_op<ConstBufferSequence>(buffers), handler2.value);
+      }
     }
 
   private:
@@ -952,8 +1229,16 @@ private:
       ASIO_READ_HANDLER_CHECK(ReadHandler, handler) type_check;
 
       asio::detail::non_const_lvalue<ReadHandler> handler2(handler);
-      detail::async_io(self_->next_layer_, self_->core_,
-          detail::read_op<MutableBufferSequence>(buffers), handler2.value);
+      if (self_->core_.kernel_tls_)
+      {
+        detail::async_kernel_tls_io(self_->next_layer_, self_->core_,
+            detail::read_op<MutableBufferSequence>(buffers), handler2.value);
+      }
+      else
+      {
+        detail::async_io(self_->next_layer_, self_->core_,
+            detail::read_op<MutableBufferSequence>(buffers), handler2.value);
+      }
     }
 
   private:
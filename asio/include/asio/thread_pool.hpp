@@ -17,6 +17,7 @@
 
 #include "asio/detail/config.hpp"
 #include "asio/detail/atomic_count.hpp"
+#include "asio/detail/concurrency_hint.hpp"
 #include "asio/detail/scheduler.hpp"
 #include "asio/detail/thread_group.hpp"
 #include "asio/execution.hpp"
@@ -95,6 +96,17 @@ public:
   /// Constructs a pool with a specified number of threads.
   ASIO_DECL thread_pool(std::size_t num_threads);
 
+  /// Constructs a pool with a specified number of threads and a concurrency
+  /// hint.
+  /**
+   * @param num_threads The number of threads in the pool.
+   *
+   * @param concurrency_hint A hint to the implementation. For example, passing
+   * @c ASIO_CONCURRENCY_HINT_WORK_STEALING gives each thread its own queue of
+   * handlers, from which idle threads steal.
+   */
+  ASIO_DECL thread_pool(std::size_t num_threads, int concurrency_hint);
+
   /// Destructor.
   /**
    * Automatically stops and joins the pool, if not explicitly done beforehand.
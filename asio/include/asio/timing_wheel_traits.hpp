@@ -0,0 +1,76 @@
+//
+// timing_wheel_traits.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_TIMING_WHEEL_TRAITS_HPP
+#define ASIO_TIMING_WHEEL_TRAITS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/wait_traits.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace asio {
+
+/// Traits type used to select a timing wheel to hold a timer type's timers.
+/**
+ * By default, pending timers are held in a binary heap, where scheduling and
+ * cancelling a timer takes logarithmic time. This template may be specialised
+ * for a timer's wait traits type (or, for basic_deadline_timer, its time traits
+ * type) to hold those timers in a hashed hierarchical timing wheel instead. The
+ * timing wheel schedules and cancels timers in constant time, but rounds each
+ * expiry time up to the next tick of the wheel.
+ */
+template <typename Traits>
+struct timing_wheel_resolution
+{
+#if defined(GENERATING_DOCUMENTATION)
+  /// The tick resolution of the timing wheel, in microseconds. A value of zero
+  /// selects the binary heap.
+  static const long value;
+#else
+  ASIO_STATIC_CONSTANT(long, value = 0);
+#endif
+};
+
+/// Wait traits that select a timing wheel with the given tick resolution.
+/**
+ * For example, the following timer type uses a timing wheel with a resolution
+ * of 1 millisecond:
+ *
+ * @code typedef asio::basic_waitable_timer<
+ *     std::chrono::steady_clock,
+ *     asio::timing_wheel_wait_traits<std::chrono::steady_clock> >
+ *   wheel_timer; @endcode
+ */
+template <typename Clock, long TickUsec = 1000>
+struct timing_wheel_wait_traits
+  : wait_traits<Clock>
+{
+};
+
+#if !defined(GENERATING_DOCUMENTATION)
+
+template <typename Clock, long TickUsec>
+struct timing_wheel_resolution<timing_wheel_wait_traits<Clock, TickUsec> >
+{
+  ASIO_STATIC_CONSTANT(long, value = TickUsec);
+};
+
+#endif // !defined(GENERATING_DOCUMENTATION)
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_TIMING_WHEEL_TRAITS_HPP
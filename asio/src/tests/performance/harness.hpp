@@ -0,0 +1,128 @@
+//
+// harness.hpp
+// ~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef HARNESS_HPP
+#define HARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// A harness for benchmarks that run in a single process. A benchmark is an
+// object with a member function run(n) that performs n operations and returns
+// once they have completed. The harness times batches of operations, and
+// reports the throughput over all batches and percentiles of the time per
+// operation within a batch.
+
+struct benchmark_result
+{
+  std::string name;
+  long operations;
+  double operations_per_second;
+  double bytes_per_second;
+  double latency_p50;
+  double latency_p90;
+  double latency_p99;
+  double latency_max;
+};
+
+class benchmark_harness
+{
+public:
+  benchmark_harness(long batches, long batch_size)
+    : batches_(batches),
+      batch_size_(batch_size)
+  {
+  }
+
+  // Run a benchmark. If each operation transfers a fixed number of bytes, the
+  // throughput is also reported in bytes per second.
+  template <typename Benchmark>
+  void run(const char* name, Benchmark& benchmark,
+      std::size_t bytes_per_operation = 0)
+  {
+    // The first batch is a warm-up and is not measured.
+    benchmark.run(batch_size_);
+
+    std::vector<double> latencies;
+    latencies.reserve(batches_);
+    double total = 0;
+    for (long i = 0; i < batches_; ++i)
+    {
+      std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+      benchmark.run(batch_size_);
+      std::chrono::steady_clock::time_point stop =
+        std::chrono::steady_clock::now();
+
+      double ns =
+        std::chrono::duration<double, std::nano>(stop - start).count();
+      latencies.push_back(ns / batch_size_);
+      total += ns;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    benchmark_result result;
+    result.name = name;
+    result.operations = batches_ * batch_size_;
+    result.operations_per_second =
+      total > 0 ? result.operations / total * 1e9 : 0;
+    result.bytes_per_second =
+      result.operations_per_second * bytes_per_operation;
+    result.latency_p50 = percentile(latencies, 50);
+    result.latency_p90 = percentile(latencies, 90);
+    result.latency_p99 = percentile(latencies, 99);
+    result.latency_max = latencies.empty() ? 0 : latencies.back();
+    results_.push_back(result);
+  }
+
+  // Write the results as a JSON document.
+  void print_json(std::FILE* out) const
+  {
+    std::fprintf(out, "{\n  \"batches\": %ld,\n  \"batch_size\": %ld,\n",
+        batches_, batch_size_);
+    std::fprintf(out, "  \"benchmarks\": [");
+    for (std::size_t i = 0; i < results_.size(); ++i)
+    {
+      const benchmark_result& r = results_[i];
+      std::fprintf(out, "%s\n    {\n", i == 0 ? "" : ",");
+      std::fprintf(out, "      \"name\": \"%s\",\n", r.name.c_str());
+      std::fprintf(out, "      \"operations\": %ld,\n", r.operations);
+      std::fprintf(out, "      \"operations_per_second\": %.0f,\n",
+          r.operations_per_second);
+      if (r.bytes_per_second > 0)
+        std::fprintf(out, "      \"bytes_per_second\": %.0f,\n",
+            r.bytes_per_second);
+      std::fprintf(out, "      \"latency_ns\": { \"p50\": %.1f, \"p90\": %.1f,"
+          " \"p99\": %.1f, \"max\": %.1f }\n", r.latency_p50, r.latency_p90,
+          r.latency_p99, r.latency_max);
+      std::fprintf(out, "    }");
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+  }
+
+private:
+  static double percentile(const std::vector<double>& sorted, int p)
+  {
+    if (sorted.empty())
+      return 0;
+    std::size_t index = (sorted.size() - 1) * p / 100;
+    return sorted[index];
+  }
+
+  long batches_;
+  long batch_size_;
+  std::vector<benchmark_result> results_;
+};
+
+#endif // HARNESS_HPP
@@ -0,0 +1,97 @@
+//
+// post.cpp
+// ~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "asio.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Measures the rate at which handlers posted from a number of producer
+// threads can be executed by a single thread running an io_context.
+
+class counter
+{
+public:
+  explicit counter(std::atomic<long>& count)
+    : count_(count)
+  {
+  }
+
+  void operator()()
+  {
+    count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<long>& count_;
+};
+
+double run_test(int num_producers, long posts_per_producer)
+{
+  asio::io_context io_context;
+  auto work = asio::make_work_guard(io_context);
+  std::atomic<long> count(0);
+  const long total = num_producers * posts_per_producer;
+
+  std::thread consumer([&]{ io_context.run(); });
+
+  std::atomic<bool> go(false);
+  std::vector<std::thread> producers;
+  for (int i = 0; i < num_producers; ++i)
+  {
+    producers.emplace_back([&]
+        {
+          while (!go.load(std::memory_order_acquire))
+            std::this_thread::yield();
+          for (long j = 0; j < posts_per_producer; ++j)
+            asio::post(io_context, counter(count));
+        });
+  }
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+
+  for (std::size_t i = 0; i < producers.size(); ++i)
+    producers[i].join();
+  while (count.load(std::memory_order_relaxed) < total)
+    std::this_thread::yield();
+
+  std::chrono::steady_clock::time_point stop =
+    std::chrono::steady_clock::now();
+
+  work.reset();
+  consumer.join();
+
+  double secs = std::chrono::duration<double>(stop - start).count();
+  return total / secs;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc > 3)
+  {
+    std::fprintf(stderr,
+        "Usage: post [<max_producers> [<posts_per_producer>]]\n");
+    return 1;
+  }
+
+  int max_producers = (argc > 1) ? std::atoi(argv[1]) : 16;
+  long posts_per_producer = (argc > 2) ? std::atol(argv[2]) : 1000000;
+
+  std::printf("%10s %16s\n", "producers", "posts/sec");
+  for (int n = 1; n <= max_producers; n *= 2)
+    std::printf("%10d %16.0f\n", n, run_test(n, posts_per_producer));
+
+  return 0;
+}
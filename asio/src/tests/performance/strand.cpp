@@ -0,0 +1,111 @@
+//
+// strand.cpp
+// ~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "asio.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Measures the rate at which handlers can be executed through a large number
+// of strands by a number of threads running an io_context. Each handler posts
+// its successor to the next strand, so most posts are made to a strand that
+// is locked by, or about to be scheduled on, another thread.
+//
+// Build with ASIO_ENABLE_LOCK_FREE_STRANDS defined to measure the lock-free
+// strand implementation instead of the pool of mutexes.
+
+typedef asio::strand<asio::io_context::executor_type> strand_type;
+
+class token
+{
+public:
+  token(std::vector<strand_type>& strands, std::size_t index,
+      std::atomic<long>& count, long total)
+    : strands_(strands),
+      index_(index),
+      count_(count),
+      total_(total)
+  {
+  }
+
+  void operator()()
+  {
+    if (count_.fetch_add(1, std::memory_order_relaxed) < total_)
+    {
+      index_ = (index_ + 1) % strands_.size();
+      asio::post(strands_[index_], *this);
+    }
+  }
+
+private:
+  std::vector<strand_type>& strands_;
+  std::size_t index_;
+  std::atomic<long>& count_;
+  long total_;
+};
+
+double run_test(int num_threads, std::size_t num_strands,
+    int tokens_per_strand, long total)
+{
+  asio::io_context io_context(num_threads);
+
+  std::vector<strand_type> strands;
+  for (std::size_t i = 0; i < num_strands; ++i)
+    strands.push_back(asio::make_strand(io_context));
+
+  std::atomic<long> count(0);
+  for (int t = 0; t < tokens_per_strand; ++t)
+    for (std::size_t i = 0; i < num_strands; ++i)
+      asio::post(strands[i], token(strands, i, count, total));
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+    threads.emplace_back([&]{ io_context.run(); });
+  for (std::size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+
+  std::chrono::steady_clock::time_point stop =
+    std::chrono::steady_clock::now();
+
+  double secs = std::chrono::duration<double>(stop - start).count();
+  return count.load() / secs;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc > 4)
+  {
+    std::fprintf(stderr,
+        "Usage: strand [<max_threads> [<strands> [<handlers>]]]\n");
+    return 1;
+  }
+
+  int max_threads = (argc > 1) ? std::atoi(argv[1]) : 16;
+  std::size_t num_strands = (argc > 2) ? std::atoi(argv[2]) : 1000;
+  long total = (argc > 3) ? std::atol(argv[3]) : 2000000;
+
+#if defined(ASIO_HAS_LOCK_FREE_STRANDS)
+  std::printf("lock-free strands\n");
+#else // defined(ASIO_HAS_LOCK_FREE_STRANDS)
+  std::printf("mutex pool strands\n");
+#endif // defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
+  std::printf("%10s %16s\n", "threads", "handlers/sec");
+  for (int n = 1; n <= max_threads; n *= 2)
+    std::printf("%10d %16.0f\n", n, run_test(n, num_strands, 4, total));
+
+  return 0;
+}
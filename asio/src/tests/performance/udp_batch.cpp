@@ -0,0 +1,192 @@
+//
+// udp_batch.cpp
+// ~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "asio.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Measures the rate at which datagrams can be sent and received over the
+// loopback interface, using one datagram per operation and then using batched
+// operations of increasing size. The sender and receiver share a thread, so
+// datagrams that the receiver cannot keep up with are dropped by the kernel
+// and are not counted.
+
+class sender
+{
+public:
+  sender(asio::io_context& io_context, const asio::ip::udp::endpoint& target,
+      std::size_t datagram_size, std::size_t batch_size)
+    : socket_(io_context, asio::ip::udp::endpoint(target.protocol(), 0)),
+      data_(datagram_size, 'x'),
+      buffers_(batch_size, asio::buffer(data_)),
+      destinations_(batch_size, target),
+      stopped_(false)
+  {
+  }
+
+  void start()
+  {
+    if (stopped_)
+      return;
+
+    if (buffers_.size() == 1)
+    {
+      socket_.async_send_to(buffers_[0], destinations_[0],
+          [this](asio::error_code ec, std::size_t)
+          {
+            if (!ec)
+              start();
+          });
+    }
+    else
+    {
+      socket_.async_send_batch(&buffers_[0], &destinations_[0],
+          buffers_.size(), [this](asio::error_code ec, std::size_t)
+          {
+            if (!ec)
+              start();
+          });
+    }
+  }
+
+  void stop()
+  {
+    stopped_ = true;
+  }
+
+private:
+  asio::ip::udp::socket socket_;
+  std::vector<char> data_;
+  std::vector<asio::const_buffer> buffers_;
+  std::vector<asio::ip::udp::endpoint> destinations_;
+  bool stopped_;
+};
+
+class receiver
+{
+public:
+  receiver(asio::io_context& io_context,
+      std::size_t datagram_size, std::size_t batch_size)
+    : socket_(io_context, asio::ip::udp::endpoint(
+          asio::ip::address_v4::loopback(), 0)),
+      data_(datagram_size * batch_size),
+      buffers_(batch_size),
+      senders_(batch_size),
+      sizes_(batch_size),
+      count_(0)
+  {
+    for (std::size_t i = 0; i < batch_size; ++i)
+      buffers_[i] = asio::buffer(&data_[i * datagram_size], datagram_size);
+  }
+
+  asio::ip::udp::endpoint local_endpoint() const
+  {
+    return socket_.local_endpoint();
+  }
+
+  void start()
+  {
+    if (buffers_.size() == 1)
+    {
+      socket_.async_receive_from(buffers_[0], senders_[0],
+          [this](asio::error_code ec, std::size_t)
+          {
+            if (!ec)
+            {
+              ++count_;
+              start();
+            }
+          });
+    }
+    else
+    {
+      socket_.async_receive_batch(&buffers_[0], &senders_[0], &sizes_[0],
+          buffers_.size(), [this](asio::error_code ec, std::size_t n)
+          {
+            if (!ec)
+            {
+              count_ += n;
+              start();
+            }
+          });
+    }
+  }
+
+  void stop()
+  {
+    socket_.close();
+  }
+
+  long count() const
+  {
+    return count_;
+  }
+
+private:
+  asio::ip::udp::socket socket_;
+  std::vector<char> data_;
+  std::vector<asio::mutable_buffer> buffers_;
+  std::vector<asio::ip::udp::endpoint> senders_;
+  std::vector<std::size_t> sizes_;
+  long count_;
+};
+
+double run_test(std::size_t datagram_size,
+    std::size_t batch_size, double seconds)
+{
+  asio::io_context io_context;
+
+  receiver r(io_context, datagram_size, batch_size);
+  sender s(io_context, r.local_endpoint(), datagram_size, batch_size);
+
+  asio::steady_timer timer(io_context,
+      std::chrono::duration_cast<asio::steady_timer::duration>(
+        std::chrono::duration<double>(seconds)));
+  timer.async_wait([&](asio::error_code)
+      {
+        s.stop();
+        r.stop();
+      });
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+  r.start();
+  s.start();
+  io_context.run();
+
+  std::chrono::steady_clock::time_point stop =
+    std::chrono::steady_clock::now();
+
+  double secs = std::chrono::duration<double>(stop - start).count();
+  return r.count() / secs;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc > 3)
+  {
+    std::fprintf(stderr,
+        "Usage: udp_batch [<datagram_size> [<seconds>]]\n");
+    return 1;
+  }
+
+  std::size_t datagram_size = (argc > 1) ? std::atoi(argv[1]) : 64;
+  double seconds = (argc > 2) ? std::atof(argv[2]) : 2.0;
+
+  std::printf("%10s %16s\n", "batch", "datagrams/sec");
+  for (std::size_t n = 1; n <= 64; n *= 4)
+    std::printf("%10d %16.0f\n", static_cast<int>(n),
+        run_test(datagram_size, n, seconds));
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+//
+// counting_handler.hpp
+// ~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ARCHETYPES_COUNTING_HANDLER_HPP
+#define ARCHETYPES_COUNTING_HANDLER_HPP
+
+#include <cstddef>
+#include <new>
+#include "asio/error_code.hpp"
+
+namespace archetypes {
+
+struct allocation_counts
+{
+  std::size_t allocations;
+  std::size_t deallocations;
+};
+
+// An allocator that counts the calls made through it.
+template <typename T>
+class counting_allocator
+{
+public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind
+  {
+    typedef counting_allocator<U> other;
+  };
+
+  explicit counting_allocator(allocation_counts* counts)
+    : counts_(counts)
+  {
+  }
+
+  template <typename U>
+  counting_allocator(const counting_allocator<U>& other)
+    : counts_(other.counts_)
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    ++counts_->allocations;
+    return static_cast<T*>(::operator new(sizeof(T) * n));
+  }
+
+  void deallocate(T* p, std::size_t)
+  {
+    ++counts_->deallocations;
+    ::operator delete(p);
+  }
+
+  bool operator==(const counting_allocator& other) const
+  {
+    return counts_ == other.counts_;
+  }
+
+  bool operator!=(const counting_allocator& other) const
+  {
+    return counts_ != other.counts_;
+  }
+
+//private:
+  allocation_counts* counts_;
+};
+
+// A completion handler that counts its invocations, and whose associated
+// allocator counts the memory allocated on its behalf.
+class counting_handler
+{
+public:
+  typedef counting_allocator<void> allocator_type;
+
+  counting_handler(int* calls, allocation_counts* counts)
+    : calls_(calls),
+      counts_(counts)
+  {
+  }
+
+  allocator_type get_allocator() const
+  {
+    return allocator_type(counts_);
+  }
+
+  void operator()(const asio::error_code&, std::size_t)
+  {
+    ++(*calls_);
+  }
+
+private:
+  int* calls_;
+  allocation_counts* counts_;
+};
+
+} // namespace archetypes
+
+#endif // ARCHETYPES_COUNTING_HANDLER_HPP
@@ -0,0 +1,156 @@
+//
+// handler_memory.cpp
+// ~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include "asio/handler_memory.hpp"
+
+#include <vector>
+#include "asio/detail/thread_info_base.hpp"
+#include "asio/io_context.hpp"
+#include "asio/post.hpp"
+#include "unit_test.hpp"
+
+using asio::detail::thread_info_base;
+
+class increment_handler
+{
+public:
+  explicit increment_handler(int* count)
+    : count_(count)
+  {
+  }
+
+  void operator()()
+  {
+    ++(*count_);
+  }
+
+private:
+  int* count_;
+  char padding_[64];
+};
+
+void handler_memory_thread_cache_test()
+{
+  thread_info_base this_thread;
+
+  // Each size, up to the largest size class, is reused from the thread's cache.
+  for (std::size_t size = 1; size < thread_info_base::max_block_size;
+      size = size * 3 / 2 + 1)
+  {
+    void* p = thread_info_base::allocate(&this_thread, size);
+    thread_info_base::deallocate(&this_thread, p, size);
+    void* q = thread_info_base::allocate(&this_thread, size);
+    ASIO_CHECK(p == q);
+    thread_info_base::deallocate(&this_thread, q, size);
+  }
+
+  // Blocks of similar size share a size class.
+  void* p = thread_info_base::allocate(&this_thread, 200);
+  thread_info_base::deallocate(&this_thread, p, 200);
+  void* q = thread_info_base::allocate(&this_thread, 250);
+  ASIO_CHECK(p == q);
+  thread_info_base::deallocate(&this_thread, q, 250);
+
+  // Blocks larger than the largest size class are not cached.
+  thread_info_base::memory_statistics before
+    = thread_info_base::get_statistics(&this_thread);
+  std::size_t size = thread_info_base::max_block_size * 2;
+  p = thread_info_base::allocate(&this_thread, size);
+  thread_info_base::deallocate(&this_thread, p, size);
+  thread_info_base::memory_statistics after
+    = thread_info_base::get_statistics(&this_thread);
+  ASIO_CHECK(after.oversized_allocations == before.oversized_allocations + 1);
+  ASIO_CHECK(after.heap_deallocations == before.heap_deallocations + 1);
+
+  // Blocks that overflow the thread's cache are moved to the shared cache.
+  std::vector<void*> blocks;
+  for (int i = 0; i < thread_info_base::cache_size * 2 + 1; ++i)
+    blocks.push_back(thread_info_base::allocate(&this_thread, 100));
+  for (std::size_t i = 0; i < blocks.size(); ++i)
+    thread_info_base::deallocate(&this_thread, blocks[i], 100);
+  for (std::size_t i = 0; i < blocks.size(); ++i)
+    blocks[i] = thread_info_base::allocate(&this_thread, 100);
+  for (std::size_t i = 0; i < blocks.size(); ++i)
+    thread_info_base::deallocate(&this_thread, blocks[i], 100);
+  after = thread_info_base::get_statistics(&this_thread);
+  ASIO_CHECK(after.shared_cache_hits > before.shared_cache_hits);
+}
+
+void handler_memory_shared_cache_test()
+{
+  thread_info_base thread1;
+  thread_info_base thread2;
+
+  // Blocks freed by one thread overflow to the shared cache, from which they
+  // may be reused by another.
+  thread_info_base::memory_statistics before
+    = thread_info_base::get_statistics(&thread1);
+  std::vector<void*> blocks;
+  for (int i = 0; i < thread_info_base::cache_size * 2 + 1; ++i)
+    blocks.push_back(thread_info_base::allocate(&thread1, 300));
+  for (std::size_t i = 0; i < blocks.size(); ++i)
+    thread_info_base::deallocate(&thread2, blocks[i], 300);
+  for (std::size_t i = 0; i < blocks.size(); ++i)
+    blocks[i] = thread_info_base::allocate(&thread1, 300);
+  for (std::size_t i = 0; i < blocks.size(); ++i)
+    thread_info_base::deallocate(&thread1, blocks[i], 300);
+  thread_info_base::memory_statistics after
+    = thread_info_base::get_statistics(&thread1);
+  ASIO_CHECK(after.shared_cache_hits > before.shared_cache_hits);
+
+  // A thread without a cache uses the heap, and leaves the shared cache alone.
+  before = thread_info_base::get_statistics(0);
+  void* p = thread_info_base::allocate(0, 300);
+  thread_info_base::deallocate(0, p, 300);
+  after = thread_info_base::get_statistics(0);
+  ASIO_CHECK(after.allocations == before.allocations + 1);
+  ASIO_CHECK(after.heap_allocations == before.heap_allocations + 1);
+  ASIO_CHECK(after.shared_cache_hits == before.shared_cache_hits);
+  ASIO_CHECK(after.deallocations == before.deallocations + 1);
+  ASIO_CHECK(after.heap_deallocations == before.heap_deallocations + 1);
+}
+
+void handler_memory_cross_thread_test()
+{
+  asio::io_context ioc;
+  int count = 0;
+
+  // Handlers posted from outside the io_context are allocated from the heap,
+  // and freed by the thread running it.
+  asio::handler_memory_statistics before
+    = asio::get_handler_memory_statistics();
+
+  for (int i = 0; i < 100; ++i)
+    asio::post(ioc, increment_handler(&count));
+  ioc.run();
+  ASIO_CHECK(count == 100);
+
+  asio::handler_memory_statistics after
+    = asio::get_handler_memory_statistics();
+  ASIO_CHECK(after.allocations - before.allocations >= 100);
+  ASIO_CHECK(after.heap_allocations - before.heap_allocations >= 100);
+  ASIO_CHECK(after.deallocations - before.deallocations >= 100);
+  ASIO_CHECK(after.allocations == after.thread_cache_hits
+      + after.shared_cache_hits + after.heap_allocations);
+}
+
+ASIO_TEST_SUITE
+(
+  "handler_memory",
+  ASIO_TEST_CASE(handler_memory_thread_cache_test)
+  ASIO_TEST_CASE(handler_memory_shared_cache_test)
+  ASIO_TEST_CASE(handler_memory_cross_thread_test)
+)
@@ -0,0 +1,178 @@
+//
+// handler_tracking.cpp
+// ~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include "asio/handler_tracking.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "asio/error.hpp"
+#include "asio/io_context.hpp"
+#include "asio/post.hpp"
+#include "unit_test.hpp"
+
+#if defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+
+using asio::detail::binary_handler_tracking;
+
+class increment_handler
+{
+public:
+  explicit increment_handler(int* count)
+    : count_(count)
+  {
+  }
+
+  void operator()()
+  {
+    ++(*count_);
+  }
+
+private:
+  int* count_;
+};
+
+// Reads the events from a dump file, or returns false if it is malformed.
+bool read_dump(const char* filename,
+    std::vector<binary_handler_tracking::event>& events)
+{
+  std::FILE* file = std::fopen(filename, "rb");
+  if (!file)
+    return false;
+
+  char magic[8];
+  asio::uint32_t header[6];
+  bool ok = std::fread(magic, sizeof(magic), 1, file) == 1
+    && std::memcmp(magic, "ASIOHTRK", sizeof(magic)) == 0
+    && std::fread(header, sizeof(header), 1, file) == 1
+    && header[0] == 1 && header[1] == 0x01020304
+    && header[2] == sizeof(binary_handler_tracking::event);
+
+  for (asio::uint32_t i = 0; ok && i < header[3]; ++i)
+  {
+    asio::uint64_t address;
+    asio::uint32_t length[2];
+    ok = std::fread(&address, sizeof(address), 1, file) == 1
+      && std::fread(length, sizeof(length), 1, file) == 1
+      && std::fseek(file, length[0], SEEK_CUR) == 0;
+  }
+
+  for (asio::uint32_t i = 0; ok && i < header[4]; ++i)
+  {
+    asio::uint64_t thread[3];
+    ok = std::fread(thread, sizeof(thread), 1, file) == 1;
+    for (asio::uint64_t j = 0; ok && j < thread[2]; ++j)
+    {
+      binary_handler_tracking::event e;
+      ok = std::fread(&e, sizeof(e), 1, file) == 1;
+      events.push_back(e);
+    }
+  }
+
+  std::fclose(file);
+  return ok;
+}
+
+std::size_t count_events(
+    const std::vector<binary_handler_tracking::event>& events,
+    binary_handler_tracking::event_kind kind)
+{
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < events.size(); ++i)
+    if (events[i].kind == kind)
+      ++n;
+  return n;
+}
+
+void handler_tracking_dump_test()
+{
+  const char* filename = "handler_tracking_dump.bin";
+
+  asio::io_context ioc;
+  int count = 0;
+
+  ASIO_CHECK(asio::handler_tracking_started());
+
+  asio::error_code ec;
+  asio::dump_handler_tracking(filename, ec);
+  ASIO_CHECK(!ec);
+  std::vector<binary_handler_tracking::event> before;
+  ASIO_CHECK(read_dump(filename, before));
+
+  for (int i = 0; i < 10; ++i)
+    asio::post(ioc, increment_handler(&count));
+  ioc.run();
+  ASIO_CHECK(count == 10);
+
+  asio::dump_handler_tracking(filename, ec);
+  ASIO_CHECK(!ec);
+  std::vector<binary_handler_tracking::event> after;
+  ASIO_CHECK(read_dump(filename, after));
+
+  ASIO_CHECK(count_events(after, binary_handler_tracking::creation_event)
+      == count_events(before, binary_handler_tracking::creation_event) + 10);
+  ASIO_CHECK(
+      count_events(after, binary_handler_tracking::invocation_begin_event)
+      == count_events(before,
+        binary_handler_tracking::invocation_begin_event) + 10);
+  ASIO_CHECK(count_events(after, binary_handler_tracking::invocation_end_event)
+      == count_events(before,
+        binary_handler_tracking::invocation_end_event) + 10);
+
+  // No events are recorded while tracking is stopped.
+  asio::stop_handler_tracking();
+  ASIO_CHECK(!asio::handler_tracking_started());
+
+  ioc.restart();
+  for (int i = 0; i < 10; ++i)
+    asio::post(ioc, increment_handler(&count));
+  ioc.run();
+  ASIO_CHECK(count == 20);
+
+  asio::dump_handler_tracking(filename, ec);
+  ASIO_CHECK(!ec);
+  std::vector<binary_handler_tracking::event> stopped;
+  ASIO_CHECK(read_dump(filename, stopped));
+  ASIO_CHECK(stopped.size() == after.size());
+
+  asio::start_handler_tracking();
+  ASIO_CHECK(asio::handler_tracking_started());
+
+  std::remove(filename);
+
+  asio::dump_handler_tracking("/nonexistent/handler_tracking_dump.bin", ec);
+  ASIO_CHECK(!!ec);
+}
+
+#else // defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+
+void handler_tracking_dump_test()
+{
+  asio::start_handler_tracking();
+  ASIO_CHECK(!asio::handler_tracking_started());
+
+  asio::error_code ec;
+  asio::dump_handler_tracking("handler_tracking_dump.bin", ec);
+  ASIO_CHECK(ec == asio::error::operation_not_supported);
+}
+
+#endif // defined(ASIO_ENABLE_BINARY_HANDLER_TRACKING)
+
+ASIO_TEST_SUITE
+(
+  "handler_tracking",
+  ASIO_TEST_CASE(handler_tracking_dump_test)
+)
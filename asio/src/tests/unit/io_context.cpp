@@ -17,9 +17,17 @@
 #include "asio/io_context.hpp"
 
 #include <sstream>
+#include <string>
+#include <vector>
 #include "asio/bind_executor.hpp"
+#include "asio/detail/event.hpp"
+#include "asio/detail/mutex.hpp"
 #include "asio/dispatch.hpp"
+#include "asio/io_context_strand.hpp"
+#include "asio/local/connect_pair.hpp"
+#include "asio/local/stream_protocol.hpp"
 #include "asio/post.hpp"
+#include "asio/strand.hpp"
 #include "asio/thread.hpp"
 #include "unit_test.hpp"
 
@@ -284,6 +292,429 @@ void io_context_test()
   ASIO_CHECK(exception_count == 2);
 }
 
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+// Make several sockets readable together, and wait for all of them.
+io_context::metrics wait_for_ready_sockets(io_context& ioc)
+{
+  typedef asio::local::stream_protocol::socket socket_type;
+  socket_type a1(ioc), b1(ioc), a2(ioc), b2(ioc), a3(ioc), b3(ioc);
+  asio::local::connect_pair(a1, b1);
+  asio::local::connect_pair(a2, b2);
+  asio::local::connect_pair(a3, b3);
+
+  char data = 0;
+  b1.send(asio::buffer(&data, 1));
+  b2.send(asio::buffer(&data, 1));
+  b3.send(asio::buffer(&data, 1));
+
+  int count = 0;
+  a1.async_wait(socket_type::wait_read, bindns::bind(increment, &count));
+  a2.async_wait(socket_type::wait_read, bindns::bind(increment, &count));
+  a3.async_wait(socket_type::wait_read, bindns::bind(increment, &count));
+  ioc.run();
+  ASIO_CHECK(count == 3);
+
+  return ioc.get_metrics();
+}
+#endif // defined(ASIO_HAS_LOCAL_SOCKETS)
+
+void io_context_options_test()
+{
+  io_context::options opts;
+  opts.event_batch_size = 1;
+  opts.busy_poll_usec = 1000;
+  opts.enable_metrics = true;
+
+  io_context ioc(opts);
+  int count = 0;
+
+  // Handlers for timers and posted operations are all run while only one
+  // event is dequeued per wait. The timers share a single timer descriptor.
+  timer t1(ioc, chronons::milliseconds(10));
+  t1.async_wait(bindns::bind(increment, &count));
+  timer t2(ioc, chronons::milliseconds(10));
+  t2.async_wait(bindns::bind(increment, &count));
+  timer t3(ioc, chronons::milliseconds(20));
+  t3.async_wait(bindns::bind(increment, &count));
+
+  for (int i = 0; i < 10; ++i)
+    asio::post(ioc, bindns::bind(increment, &count));
+
+  ioc.run();
+
+  ASIO_CHECK(ioc.stopped());
+  ASIO_CHECK(count == 13);
+
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+  // Descriptors that are ready together are dequeued one per wait, while by
+  // default a single wait dequeues all of them.
+  ioc.restart();
+  io_context::metrics m = wait_for_ready_sockets(ioc);
+  io_context::options default_opts;
+  default_opts.enable_metrics = true;
+  io_context ioc3(default_opts);
+  io_context::metrics m3 = wait_for_ready_sockets(ioc3);
+# if defined(ASIO_HAS_IO_CONTEXT_METRICS) \
+  && defined(ASIO_HAS_EPOLL) && !defined(ASIO_HAS_IO_URING)
+  ASIO_CHECK(m.reactor_events > 0);
+  ASIO_CHECK(m.reactor_events <= m.reactor_waits);
+  ASIO_CHECK(m3.reactor_events > m3.reactor_waits);
+# else // defined(ASIO_HAS_IO_CONTEXT_METRICS)
+     //   && defined(ASIO_HAS_EPOLL) && !defined(ASIO_HAS_IO_URING)
+  (void)m;
+  (void)m3;
+# endif // defined(ASIO_HAS_IO_CONTEXT_METRICS)
+       //   && defined(ASIO_HAS_EPOLL) && !defined(ASIO_HAS_IO_URING)
+#endif // defined(ASIO_HAS_LOCAL_SOCKETS)
+
+  opts.concurrency_hint = 1;
+  opts.event_batch_size = 0;
+  io_context ioc2(opts);
+  count = 0;
+
+  timer t4(ioc2, chronons::milliseconds(10));
+  t4.async_wait(bindns::bind(increment, &count));
+
+  ioc2.run();
+
+  ASIO_CHECK(ioc2.stopped());
+  ASIO_CHECK(count == 1);
+}
+
+void io_context_strand_pool_test()
+{
+  io_context::options opts;
+  opts.strand_pool_size = 7;
+
+  io_context ioc(opts);
+  int count = 0;
+
+  io_context::strand_statistics stats = ioc.get_strand_statistics();
+  ASIO_CHECK(stats.strands == 0);
+  ASIO_CHECK(stats.collisions == 0);
+
+#if !defined(ASIO_HAS_LOCK_FREE_STRANDS)
+  {
+    // More live strands than pool entries must collide.
+    std::vector<strand<io_context::executor_type> > strands;
+    for (int i = 0; i < 20; ++i)
+    {
+      strands.push_back(make_strand(ioc));
+      asio::post(strands.back(), bindns::bind(increment, &count));
+    }
+
+    stats = ioc.get_strand_statistics();
+    ASIO_CHECK(stats.pool_size == 7);
+    ASIO_CHECK(stats.strands == 20);
+    ASIO_CHECK(stats.collisions >= 13);
+    ASIO_CHECK(stats.collisions < 20);
+
+    ioc.run();
+    ASIO_CHECK(count == 20);
+  }
+
+  // Entries released by destroyed strands may be reused without a collision.
+  std::size_t collisions = stats.collisions;
+  strand<io_context::executor_type> s = make_strand(ioc);
+  stats = ioc.get_strand_statistics();
+  ASIO_CHECK(stats.strands == 21);
+  ASIO_CHECK(stats.collisions == collisions);
+#endif // !defined(ASIO_HAS_LOCK_FREE_STRANDS)
+
+#if !defined(ASIO_NO_EXTENSIONS) \
+  && !defined(ASIO_NO_TS_EXECUTORS)
+  io_context ioc2(opts);
+  count = 0;
+
+  std::vector<io_context::strand*> strands2;
+  for (int i = 0; i < 10; ++i)
+  {
+    strands2.push_back(new io_context::strand(ioc2));
+    asio::post(*strands2.back(), bindns::bind(increment, &count));
+  }
+
+  stats = ioc2.get_strand_statistics();
+  ASIO_CHECK(stats.pool_size == 7);
+  ASIO_CHECK(stats.strands == 10);
+  ASIO_CHECK(stats.collisions >= 3);
+
+  ioc2.run();
+  ASIO_CHECK(count == 10);
+
+  for (std::size_t i = 0; i < strands2.size(); ++i)
+    delete strands2[i];
+
+  // With a single entry, a strand collides only while another one is alive.
+  opts.strand_pool_size = 1;
+  io_context ioc3(opts);
+
+  io_context::strand* s1 = new io_context::strand(ioc3);
+  io_context::strand* s2 = new io_context::strand(*s1);
+  delete s1;
+
+  stats = ioc3.get_strand_statistics();
+  ASIO_CHECK(stats.strands == 1);
+  ASIO_CHECK(stats.collisions == 0);
+
+  io_context::strand* s3 = new io_context::strand(ioc3);
+  stats = ioc3.get_strand_statistics();
+  ASIO_CHECK(stats.strands == 2);
+  ASIO_CHECK(stats.collisions == 1);
+
+  delete s2;
+  delete s3;
+
+  io_context::strand* s4 = new io_context::strand(ioc3);
+  stats = ioc3.get_strand_statistics();
+  ASIO_CHECK(stats.strands == 3);
+  ASIO_CHECK(stats.collisions == 1);
+  delete s4;
+#endif // !defined(ASIO_NO_EXTENSIONS)
+       //   && !defined(ASIO_NO_TS_EXECUTORS)
+}
+
+void io_context_metrics_test()
+{
+  io_context::options opts;
+  opts.enable_metrics = true;
+
+  io_context ioc(opts);
+  int count = 0;
+
+  io_context::metrics m = ioc.get_metrics();
+  ASIO_CHECK(m.operations_queued == 0);
+  ASIO_CHECK(m.operations_executed == 0);
+  ASIO_CHECK(m.queue_delay.total_count() == 0);
+  ASIO_CHECK(m.queue_delay.value_at_percentile(50) == 0);
+
+  for (int i = 0; i < 10; ++i)
+    asio::post(ioc, bindns::bind(increment, &count));
+
+  timer t1(ioc, chronons::milliseconds(10));
+  t1.async_wait(bindns::bind(increment, &count));
+  timer t2(ioc, chronons::seconds(10));
+  t2.async_wait(bindns::bind(increment, &count));
+
+  m = ioc.get_metrics();
+#if defined(ASIO_HAS_IO_CONTEXT_METRICS)
+  ASIO_CHECK(m.operations_queued == 10);
+  ASIO_CHECK(m.outstanding_work == 12);
+# if defined(ASIO_HAS_EPOLL) && !defined(ASIO_HAS_IO_URING)
+  ASIO_CHECK(m.pending_timers == 2);
+# endif // defined(ASIO_HAS_EPOLL) && !defined(ASIO_HAS_IO_URING)
+#endif // defined(ASIO_HAS_IO_CONTEXT_METRICS)
+
+  ioc.run_for(chronons::milliseconds(100));
+  ASIO_CHECK(count == 11);
+
+  m = ioc.get_metrics();
+#if defined(ASIO_HAS_IO_CONTEXT_METRICS)
+  ASIO_CHECK(m.operations_queued == 11);
+  ASIO_CHECK(m.operations_executed == 11);
+  ASIO_CHECK(m.outstanding_work == 1);
+  ASIO_CHECK(m.task_runs > 0);
+  ASIO_CHECK(m.handler_time > 0);
+  ASIO_CHECK(m.queue_delay.total_count() == 11);
+  ASIO_CHECK(m.run_time.total_count() == 11);
+  ASIO_CHECK(m.run_time.value_at_percentile(0)
+      <= m.run_time.value_at_percentile(100));
+# if defined(ASIO_HAS_EPOLL) && !defined(ASIO_HAS_IO_URING)
+  ASIO_CHECK(m.reactor_waits > 0);
+  ASIO_CHECK(m.pending_timers == 1);
+# endif // defined(ASIO_HAS_EPOLL) && !defined(ASIO_HAS_IO_URING)
+#else // defined(ASIO_HAS_IO_CONTEXT_METRICS)
+  ASIO_CHECK(m.operations_executed == 0);
+#endif // defined(ASIO_HAS_IO_CONTEXT_METRICS)
+
+  t2.cancel();
+  ioc.restart();
+  ioc.run();
+  ASIO_CHECK(count == 12);
+
+  m = ioc.get_metrics();
+  ASIO_CHECK(m.outstanding_work == 0);
+  ASIO_CHECK(m.pending_timers == 0);
+
+  // Bucket boundaries increase, and each value falls in its own bucket.
+  io_context::duration_histogram h;
+  ASIO_CHECK(h.bucket_count() > 0);
+  for (std::size_t i = 1; i < h.bucket_count(); ++i)
+    ASIO_CHECK(h.bucket_lower_bound(i - 1) < h.bucket_lower_bound(i));
+  for (std::size_t i = 0; i < h.bucket_count(); ++i)
+    ASIO_CHECK(h.bucket_samples(i) == 0);
+
+  // Metrics are not collected unless requested.
+  io_context ioc2;
+  asio::post(ioc2, bindns::bind(increment, &count));
+  ioc2.run();
+  m = ioc2.get_metrics();
+  ASIO_CHECK(m.operations_executed == 0);
+  ASIO_CHECK(m.queue_delay.total_count() == 0);
+}
+
+#if defined(ASIO_HAS_STALL_DETECTION)
+
+struct stall_reports
+{
+  asio::detail::mutex mutex;
+  std::vector<io_context::stall_report> reports;
+};
+
+void record_stall(const io_context::stall_report& report, void* context)
+{
+  stall_reports* r = static_cast<stall_reports*>(context);
+  asio::detail::mutex::scoped_lock lock(r->mutex);
+  r->reports.push_back(report);
+}
+
+void stall(int msec)
+{
+  ASIO_HANDLER_LOCATION((__FILE__, __LINE__, "stall"));
+  asio::chrono::steady_clock::time_point end =
+    asio::chrono::steady_clock::now() + asio::chrono::milliseconds(msec);
+  while (asio::chrono::steady_clock::now() < end)
+    ;
+}
+
+#endif // defined(ASIO_HAS_STALL_DETECTION)
+
+void io_context_stall_detection_test()
+{
+#if defined(ASIO_HAS_STALL_DETECTION)
+  stall_reports r;
+
+  io_context::options opts;
+  opts.stall_threshold_usec = 20000;
+  opts.stall_handler = &record_stall;
+  opts.stall_handler_context = &r;
+
+  io_context ioc(opts);
+  int count = 0;
+
+  // Handlers shorter than the threshold are not reported.
+  for (int i = 0; i < 10; ++i)
+    asio::post(ioc, bindns::bind(increment, &count));
+  ioc.run();
+  ASIO_CHECK(count == 10);
+
+  {
+    asio::detail::mutex::scoped_lock lock(r.mutex);
+    ASIO_CHECK(r.reports.empty());
+  }
+
+  // A stalled handler is reported once, with its location.
+  asio::post(ioc, bindns::bind(stall, 200));
+  ioc.restart();
+  ioc.run();
+
+  {
+    asio::detail::mutex::scoped_lock lock(r.mutex);
+    ASIO_CHECK(r.reports.size() == 1);
+    if (!r.reports.empty())
+    {
+      ASIO_CHECK(r.reports[0].duration >= 20000000);
+      ASIO_CHECK(r.reports[0].completion_function != 0);
+      ASIO_CHECK(r.reports[0].file != 0);
+      ASIO_CHECK(r.reports[0].line != 0);
+      ASIO_CHECK(r.reports[0].function != 0
+          && std::string(r.reports[0].function) == "stall");
+    }
+  }
+#endif // defined(ASIO_HAS_STALL_DETECTION)
+}
+
+void fan_out(io_context* ioc, asio::detail::atomic_count* count, int depth)
+{
+  ++(*count);
+  if (depth > 0)
+    for (int i = 0; i < 4; ++i)
+      asio::post(*ioc, bindns::bind(fan_out, ioc, count, depth - 1));
+}
+
+void io_context_work_stealing_test()
+{
+  io_context ioc(ASIO_CONCURRENCY_HINT_WORK_STEALING);
+  asio::detail::atomic_count count(0);
+  int count2 = 0;
+
+  asio::post(ioc, bindns::bind(fan_out, &ioc, &count, 5));
+  timer t(ioc, chronons::milliseconds(10));
+  t.async_wait(bindns::bind(increment, &count2));
+
+  asio::thread th1(bindns::bind(io_context_run, &ioc));
+  asio::thread th2(bindns::bind(io_context_run, &ioc));
+  asio::thread th3(bindns::bind(io_context_run, &ioc));
+  ioc.run();
+  th1.join();
+  th2.join();
+  th3.join();
+
+  // 1 + 4 + 16 + 64 + 256 + 1024 handlers.
+  ASIO_CHECK(ioc.stopped());
+  ASIO_CHECK(count == 1365);
+  ASIO_CHECK(count2 == 1);
+}
+
+struct steal_state
+{
+  asio::detail::mutex mutex;
+  asio::detail::event event;
+  bool stolen;
+};
+
+void mark_stolen(steal_state* state)
+{
+  asio::detail::mutex::scoped_lock lock(state->mutex);
+  state->stolen = true;
+  state->event.signal(lock);
+}
+
+void block_until_stolen(io_context* ioc, steal_state* state)
+{
+  // The handler goes on this thread's own queue, so it can only run while this
+  // thread is blocked if another thread steals it.
+  asio::post(*ioc, bindns::bind(mark_stolen, state));
+
+  asio::detail::mutex::scoped_lock lock(state->mutex);
+  for (int i = 0; i < 100 && !state->stolen; ++i)
+    state->event.wait_for_usec(lock, 100000);
+}
+
+void io_context_work_stealing_steal_test()
+{
+  io_context ioc(ASIO_CONCURRENCY_HINT_WORK_STEALING);
+  steal_state state;
+  state.stolen = false;
+
+  asio::post(ioc, bindns::bind(block_until_stolen, &ioc, &state));
+
+  asio::thread th(bindns::bind(io_context_run, &ioc));
+  ioc.run();
+  th.join();
+
+  ASIO_CHECK(state.stolen);
+}
+
+void repost_until_stopped(io_context* ioc, int* count)
+{
+  if (++(*count) == 5)
+    ioc->stop();
+  asio::post(*ioc, bindns::bind(repost_until_stopped, ioc, count));
+}
+
+void io_context_work_stealing_stop_test()
+{
+  io_context ioc(ASIO_CONCURRENCY_HINT_WORK_STEALING);
+  int count = 0;
+
+  // After the first, each handler is queued on the running thread's own queue.
+  asio::post(ioc, bindns::bind(repost_until_stopped, &ioc, &count));
+  ioc.run();
+
+  ASIO_CHECK(ioc.stopped());
+  ASIO_CHECK(count == 5);
+}
+
 class test_service : public asio::io_context::service
 {
 public:
@@ -579,6 +1010,13 @@ ASIO_TEST_SUITE
 (
   "io_context",
   ASIO_TEST_CASE(io_context_test)
+  ASIO_TEST_CASE(io_context_options_test)
+  ASIO_TEST_CASE(io_context_strand_pool_test)
+  ASIO_TEST_CASE(io_context_metrics_test)
+  ASIO_TEST_CASE(io_context_stall_detection_test)
+  ASIO_TEST_CASE(io_context_work_stealing_test)
+  ASIO_TEST_CASE(io_context_work_stealing_steal_test)
+  ASIO_TEST_CASE(io_context_work_stealing_stop_test)
   ASIO_TEST_CASE(io_context_service_test)
   ASIO_TEST_CASE(io_context_executor_query_test)
   ASIO_TEST_CASE(io_context_executor_execute_test)
@@ -0,0 +1,165 @@
+//
+// io_context_pool.cpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include "asio/io_context_pool.hpp"
+
+#include <stdexcept>
+#include <vector>
+#include "asio/executor_work_guard.hpp"
+#include "asio/ip/tcp.hpp"
+#include "unit_test.hpp"
+
+#if defined(ASIO_HAS_BOOST_BIND)
+# include <boost/bind/bind.hpp>
+#else // defined(ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
+using namespace asio;
+
+#if defined(ASIO_HAS_BOOST_BIND)
+namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+namespace bindns = std;
+#endif
+
+void record_shard(io_context_pool* pool, std::size_t* shard)
+{
+  *shard = pool->current_shard();
+}
+
+typedef executor_work_guard<io_context_pool::executor_type> work_type;
+
+void record_shard_and_finish(io_context_pool* pool,
+    std::size_t* shard, work_type* work)
+{
+  *shard = pool->current_shard();
+  work->reset();
+}
+
+void forward_to_shard(io_context_pool* pool, std::size_t target,
+    std::size_t* from, std::size_t* to, work_type* work)
+{
+  *from = pool->current_shard();
+  pool->post(target,
+      bindns::bind(record_shard_and_finish, pool, to, work));
+}
+
+void io_context_pool_test()
+{
+  io_context_pool pool(static_cast<std::size_t>(3));
+
+  ASIO_CHECK(pool.size() == 3);
+  ASIO_CHECK(pool.current_shard() == 3);
+
+  std::vector<std::size_t> shards(3, 99);
+  for (std::size_t i = 0; i < pool.size(); ++i)
+  {
+    ASIO_CHECK(pool.cpu(i) == -1);
+    ASIO_CHECK(pool.get_executor(i) == pool.get_io_context(i).get_executor());
+    pool.post(i, bindns::bind(record_shard, &pool, &shards[i]));
+  }
+
+  // Keep the target shard running until the message has arrived.
+  work_type work(pool.get_executor(2));
+  std::size_t from = 99, to = 99;
+  asio::post(pool.get_executor(0),
+      bindns::bind(forward_to_shard, &pool, 2, &from, &to, &work));
+
+  pool.join();
+
+  ASIO_CHECK(shards[0] == 0);
+  ASIO_CHECK(shards[1] == 1);
+  ASIO_CHECK(shards[2] == 2);
+  ASIO_CHECK(from == 0);
+  ASIO_CHECK(to == 2);
+
+#if !defined(ASIO_NO_EXCEPTIONS)
+  bool caught = false;
+  try
+  {
+    pool.get_io_context(3);
+  }
+  catch (std::out_of_range&)
+  {
+    caught = true;
+  }
+  ASIO_CHECK(caught);
+#endif // !defined(ASIO_NO_EXCEPTIONS)
+}
+
+void io_context_pool_affinity_test()
+{
+  std::vector<int> cpus = io_context_pool::available_cpus();
+  ASIO_CHECK(!cpus.empty());
+
+  io_context_pool pool(cpus);
+  ASIO_CHECK(pool.size() == cpus.size());
+
+  for (std::size_t i = 0; i < pool.size(); ++i)
+  {
+#if defined(__linux__)
+    ASIO_CHECK(pool.cpu(i) == cpus[i]);
+#else // defined(__linux__)
+    ASIO_CHECK(pool.cpu(i) == cpus[i] || pool.cpu(i) == -1);
+#endif // defined(__linux__)
+  }
+
+  // A CPU that cannot exist leaves the thread unpinned.
+  io_context_pool unpinned(std::vector<int>(1, 1 << 30));
+  ASIO_CHECK(unpinned.cpu(0) == -1);
+
+  asio::error_code ec;
+  std::vector<int> node_cpus = io_context_pool::numa_node_cpus(0, ec);
+  ASIO_CHECK(!!ec || !node_cpus.empty());
+}
+
+void io_context_pool_acceptor_test()
+{
+#if defined(ASIO_HAS_MOVE)
+  typedef basic_socket_acceptor<ip::tcp,
+    io_context_pool::executor_type> acceptor_type;
+
+  io_context_pool pool(static_cast<std::size_t>(2));
+
+  ip::tcp::endpoint endpoint(ip::address_v4::loopback(), 0);
+  acceptor_type acceptor0(pool.make_acceptor(0, endpoint));
+  ASIO_CHECK(acceptor0.is_open());
+  ASIO_CHECK(acceptor0.get_executor() == pool.get_executor(0));
+
+  endpoint = acceptor0.local_endpoint();
+
+  asio::error_code ec;
+  acceptor_type acceptor1(pool.make_acceptor(1, endpoint, ec));
+#if defined(SO_REUSEPORT)
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(acceptor1.is_open());
+  ASIO_CHECK(acceptor1.local_endpoint() == endpoint);
+
+  socket_base::reuse_port option;
+  acceptor1.get_option(option);
+  ASIO_CHECK(option.value());
+#endif // defined(SO_REUSEPORT)
+#endif // defined(ASIO_HAS_MOVE)
+}
+
+ASIO_TEST_SUITE
+(
+  "io_context_pool",
+  ASIO_TEST_CASE(io_context_pool_test)
+  ASIO_TEST_CASE(io_context_pool_affinity_test)
+  ASIO_TEST_CASE(io_context_pool_acceptor_test)
+)
@@ -317,9 +317,34 @@ void strand_wrap_test()
 #endif // !defined(ASIO_NO_DEPRECATED)
 }
 
+void strand_lifetime_test()
+{
+  int count = 0;
+
+  io_context* ioc = new io_context;
+  io_context::strand* s1 = new io_context::strand(*ioc);
+  io_context::strand* s2 = new io_context::strand(*s1);
+  post(*s1, bindns::bind(increment, &count));
+
+  io_context::strand s3(*s2);
+#if defined(ASIO_HAS_MOVE)
+  io_context::strand s4(ASIO_MOVE_CAST(io_context::strand)(s3));
+#endif // defined(ASIO_HAS_MOVE)
+
+  // Strands may be destroyed after their io_context, and pending handlers are
+  // destroyed without being called.
+  delete ioc;
+  ASIO_CHECK(*s1 == *s2);
+  delete s1;
+  delete s2;
+
+  ASIO_CHECK(count == 0);
+}
+
 ASIO_TEST_SUITE
 (
   "strand",
   ASIO_TEST_CASE(strand_test)
   ASIO_TEST_CASE(strand_wrap_test)
+  ASIO_TEST_CASE(strand_lifetime_test)
 )
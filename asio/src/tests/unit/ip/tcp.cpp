@@ -20,7 +20,9 @@
 #include "asio/ip/tcp.hpp"
 
 #include <cstring>
+#include <vector>
 #include "asio/io_context.hpp"
+#include "asio/post.hpp"
 #include "asio/read.hpp"
 #include "asio/write.hpp"
 #include "../unit_test.hpp"
@@ -691,6 +693,185 @@ void test()
   ASIO_CHECK(read_eof_completed);
 }
 
+#if !defined(ASIO_HAS_IOCP)
+
+void handle_inline_read(const asio::error_code& err, size_t bytes_transferred,
+    asio::ip::tcp::socket* socket, char* data, int* remaining,
+    int* depth, int* max_depth)
+{
+  ASIO_CHECK(!err);
+  ASIO_CHECK(bytes_transferred == 1);
+
+  ++(*depth);
+  if (*depth > *max_depth)
+    *max_depth = *depth;
+
+  if (--(*remaining) > 0)
+  {
+#if defined(ASIO_HAS_BOOST_BIND)
+    namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+    namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+    using bindns::placeholders::_1;
+    using bindns::placeholders::_2;
+
+    socket->async_read_some(asio::buffer(data, 1),
+        bindns::bind(handle_inline_read, _1, _2,
+          socket, data, remaining, depth, max_depth));
+  }
+
+  --(*depth);
+}
+
+int run_inline_reads(const asio::io_context::options& opts)
+{
+  using namespace asio;
+  namespace ip = asio::ip;
+
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  io_context ioc(opts);
+
+  ip::tcp::acceptor acceptor(ioc, ip::tcp::endpoint(ip::tcp::v4(), 0));
+  ip::tcp::endpoint server_endpoint = acceptor.local_endpoint();
+  server_endpoint.address(ip::address_v4::loopback());
+
+  ip::tcp::socket client_side_socket(ioc);
+  ip::tcp::socket server_side_socket(ioc);
+
+  client_side_socket.connect(server_endpoint);
+  acceptor.accept(server_side_socket);
+
+  // Make all of the data available before the reads start, so that each read
+  // completes on its first attempt.
+  const char write_data[20] = "";
+  asio::write(client_side_socket, asio::buffer(write_data));
+  server_side_socket.wait(socket_base::wait_read);
+  while (server_side_socket.available() < sizeof(write_data))
+    server_side_socket.wait(socket_base::wait_read);
+
+  // The initial posted call consumes one count without reading.
+  char read_data[1];
+  int remaining = sizeof(write_data) + 1;
+  int depth = 0, max_depth = 0;
+  asio::post(ioc,
+      bindns::bind(handle_inline_read, asio::error_code(), 1,
+        &server_side_socket, read_data, &remaining, &depth, &max_depth));
+
+  ioc.run();
+
+  ASIO_CHECK(remaining == 0);
+  ASIO_CHECK(depth == 0);
+  return max_depth;
+}
+
+void test_inline_completion()
+{
+  asio::io_context::options opts;
+
+  // By default each completion is posted, so handlers never nest.
+  ASIO_CHECK(run_inline_reads(opts) == 1);
+
+  // With inline completion, each handler's read completes within it, up to the
+  // nesting limit. The initial posted handler accounts for one extra level.
+  opts.inline_completion_depth = 4;
+  ASIO_CHECK(run_inline_reads(opts) == 5);
+}
+
+#endif // !defined(ASIO_HAS_IOCP)
+
+#if defined(ASIO_HAS_MSG_ZEROCOPY)
+
+void handle_transfer(const asio::error_code& err,
+    size_t bytes_transferred, size_t expected, bool* called)
+{
+  *called = true;
+  ASIO_CHECK(!err);
+  ASIO_CHECK(bytes_transferred == expected);
+}
+
+void test_zero_copy()
+{
+  using namespace std; // For memcmp.
+  using namespace asio;
+  namespace ip = asio::ip;
+
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  io_context ioc;
+
+  ip::tcp::acceptor acceptor(ioc, ip::tcp::endpoint(ip::tcp::v4(), 0));
+  ip::tcp::endpoint server_endpoint = acceptor.local_endpoint();
+  server_endpoint.address(ip::address_v4::loopback());
+
+  ip::tcp::socket client_side_socket(ioc);
+  ip::tcp::socket server_side_socket(ioc);
+
+  client_side_socket.connect(server_endpoint);
+  acceptor.accept(server_side_socket);
+
+  asio::error_code ec;
+  client_side_socket.set_option(socket_base::zero_copy(true), ec);
+  if (ec)
+    return; // Not supported by the running kernel.
+
+  socket_base::zero_copy option;
+  client_side_socket.get_option(option);
+  ASIO_CHECK(option.value());
+
+  // Send a mix of small and large writes so that both copying and zero-copy
+  // sends are made, and check that the data arrives in order.
+
+  std::vector<char> write_buffer(1024 * 1024);
+  for (size_t i = 0; i < write_buffer.size(); ++i)
+    write_buffer[i] = static_cast<char>(i % 251);
+
+  std::vector<char> read_buffer(write_buffer.size() + 100);
+  bool read_completed = false;
+  asio::async_read(server_side_socket,
+      asio::buffer(read_buffer),
+      bindns::bind(handle_transfer,
+        _1, _2, read_buffer.size(), &read_completed));
+
+  bool small_write_completed = false;
+  asio::async_write(client_side_socket,
+      asio::buffer(write_buffer.data(), 100),
+      bindns::bind(handle_transfer,
+        _1, _2, 100, &small_write_completed));
+
+  while (!small_write_completed)
+    ioc.run_one();
+
+  bool write_completed = false;
+  asio::async_write(client_side_socket,
+      asio::buffer(write_buffer),
+      bindns::bind(handle_transfer,
+        _1, _2, write_buffer.size(), &write_completed));
+
+  ioc.run();
+  ASIO_CHECK(read_completed);
+  ASIO_CHECK(small_write_completed);
+  ASIO_CHECK(write_completed);
+  ASIO_CHECK(memcmp(read_buffer.data(), write_buffer.data(), 100) == 0);
+  ASIO_CHECK(memcmp(read_buffer.data() + 100,
+        write_buffer.data(), write_buffer.size()) == 0);
+}
+
+#endif // defined(ASIO_HAS_MSG_ZEROCOPY)
+
 } // namespace ip_tcp_socket_runtime
 
 //------------------------------------------------------------------------------
@@ -1342,6 +1523,12 @@ ASIO_TEST_SUITE
   ASIO_TEST_CASE(ip_tcp_runtime::test)
   ASIO_TEST_CASE(ip_tcp_socket_compile::test)
   ASIO_TEST_CASE(ip_tcp_socket_runtime::test)
+#if !defined(ASIO_HAS_IOCP)
+  ASIO_TEST_CASE(ip_tcp_socket_runtime::test_inline_completion)
+#endif // !defined(ASIO_HAS_IOCP)
+#if defined(ASIO_HAS_MSG_ZEROCOPY)
+  ASIO_TEST_CASE(ip_tcp_socket_runtime::test_zero_copy)
+#endif // defined(ASIO_HAS_MSG_ZEROCOPY)
   ASIO_TEST_CASE(ip_tcp_acceptor_compile::test)
   ASIO_TEST_CASE(ip_tcp_acceptor_runtime::test)
   ASIO_TEST_CASE(ip_tcp_resolver_compile::test)
@@ -17,6 +17,7 @@
 #include "asio/ip/udp.hpp"
 
 #include <cstring>
+#include <vector>
 #include "asio/io_context.hpp"
 #include "../unit_test.hpp"
 #include "../archetypes/async_result.hpp"
@@ -440,6 +441,86 @@ void test()
     int i29 = socket1.async_receive_from(null_buffers(),
         endpoint, in_flags, lazy);
     (void)i29;
+
+#if !defined(ASIO_HAS_IOCP)
+    const_buffer const_buffers[1] = { buffer(const_char_buffer) };
+    mutable_buffer mutable_buffers[1] = { buffer(mutable_char_buffer) };
+    ip::udp::endpoint endpoints[1];
+    std::size_t sizes[1];
+
+    socket1.send_batch(const_buffers, endpoints, 1);
+    socket1.send_batch(const_buffers, endpoints, 1, in_flags, ec);
+
+    socket1.async_send_batch(const_buffers, endpoints, 1, send_handler());
+    socket1.async_send_batch(const_buffers, endpoints, 1,
+        in_flags, send_handler());
+    int i30 = socket1.async_send_batch(const_buffers, endpoints, 1, lazy);
+    (void)i30;
+    int i31 = socket1.async_send_batch(const_buffers, endpoints, 1,
+        in_flags, lazy);
+    (void)i31;
+
+    socket1.receive_batch(mutable_buffers, endpoints, sizes, 1);
+    socket1.receive_batch(mutable_buffers, endpoints, sizes, 1, in_flags, ec);
+
+    socket1.async_receive_batch(mutable_buffers, endpoints, sizes, 1,
+        receive_handler());
+    socket1.async_receive_batch(mutable_buffers, endpoints, sizes, 1,
+        in_flags, receive_handler());
+    int i32 = socket1.async_receive_batch(mutable_buffers,
+        endpoints, sizes, 1, lazy);
+    (void)i32;
+    int i33 = socket1.async_receive_batch(mutable_buffers,
+        endpoints, sizes, 1, in_flags, lazy);
+    (void)i33;
+#endif // !defined(ASIO_HAS_IOCP)
+
+#if defined(ASIO_HAS_UDP_GSO)
+    ip::udp::segment_size segment_size1(1200);
+    socket1.set_option(segment_size1);
+    ip::udp::segment_size segment_size2;
+    socket1.get_option(segment_size2);
+    (void)static_cast<int>(segment_size1.value());
+
+    ip::udp::receive_offload receive_offload1(true);
+    socket1.set_option(receive_offload1);
+    ip::udp::receive_offload receive_offload2;
+    socket1.get_option(receive_offload2);
+    (void)static_cast<bool>(receive_offload1.value());
+
+    std::size_t segment_size = 0;
+
+    socket1.send_segments(buffer(const_char_buffer), endpoint, 16);
+    socket1.send_segments(buffer(const_char_buffer), endpoint, 16,
+        in_flags, ec);
+
+    socket1.async_send_segments(buffer(const_char_buffer),
+        endpoint, 16, send_handler());
+    socket1.async_send_segments(buffer(const_char_buffer),
+        endpoint, 16, in_flags, send_handler());
+    int i34 = socket1.async_send_segments(buffer(const_char_buffer),
+        endpoint, 16, lazy);
+    (void)i34;
+    int i35 = socket1.async_send_segments(buffer(const_char_buffer),
+        endpoint, 16, in_flags, lazy);
+    (void)i35;
+
+    socket1.receive_segments(buffer(mutable_char_buffer),
+        endpoint, segment_size);
+    socket1.receive_segments(buffer(mutable_char_buffer),
+        endpoint, segment_size, in_flags, ec);
+
+    socket1.async_receive_segments(buffer(mutable_char_buffer),
+        endpoint, segment_size, receive_handler());
+    socket1.async_receive_segments(buffer(mutable_char_buffer),
+        endpoint, segment_size, in_flags, receive_handler());
+    int i36 = socket1.async_receive_segments(buffer(mutable_char_buffer),
+        endpoint, segment_size, lazy);
+    (void)i36;
+    int i37 = socket1.async_receive_segments(buffer(mutable_char_buffer),
+        endpoint, segment_size, in_flags, lazy);
+    (void)i37;
+#endif // defined(ASIO_HAS_UDP_GSO)
   }
   catch (std::exception&)
   {
@@ -517,6 +598,203 @@ void test()
   ASIO_CHECK(memcmp(send_msg, recv_msg, sizeof(send_msg)) == 0);
 }
 
+#if !defined(ASIO_HAS_IOCP)
+
+void handle_batch(const asio::error_code& err,
+    size_t datagrams, size_t* total)
+{
+  ASIO_CHECK(!err);
+  *total += datagrams;
+}
+
+void test_batch()
+{
+  using namespace std; // For memcmp.
+  using namespace asio;
+  namespace ip = asio::ip;
+
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  io_context ioc;
+
+  ip::udp::socket s1(ioc, ip::udp::endpoint(ip::address_v4::loopback(), 0));
+  ip::udp::socket s2(ioc, ip::udp::endpoint(ip::address_v4::loopback(), 0));
+
+  // Send more datagrams than fit in a single system call, each of a different
+  // length so that the received sizes can be checked.
+  const size_t num_datagrams = 100;
+  char send_data[num_datagrams][num_datagrams];
+  const_buffer send_buffers[num_datagrams];
+  ip::udp::endpoint destinations[num_datagrams];
+  for (size_t i = 0; i < num_datagrams; ++i)
+  {
+    for (size_t j = 0; j < num_datagrams; ++j)
+      send_data[i][j] = static_cast<char>(i + j);
+    send_buffers[i] = buffer(send_data[i], i + 1);
+    destinations[i] = s1.local_endpoint();
+  }
+
+  size_t sent = 0;
+  s2.async_send_batch(send_buffers, destinations, num_datagrams,
+      bindns::bind(handle_batch, _1, _2, &sent));
+
+  ioc.run();
+  ASIO_CHECK(sent == num_datagrams);
+
+  // Receive them in batches until all have arrived.
+  char recv_data[num_datagrams][num_datagrams];
+  mutable_buffer recv_buffers[num_datagrams];
+  ip::udp::endpoint senders[num_datagrams];
+  size_t sizes[num_datagrams] = { 0 };
+  for (size_t i = 0; i < num_datagrams; ++i)
+    recv_buffers[i] = buffer(recv_data[i]);
+
+  size_t received = s1.receive_batch(recv_buffers, senders, sizes, 1);
+  ASIO_CHECK(received == 1);
+
+  while (received < num_datagrams)
+  {
+    size_t n = 0;
+    s1.async_receive_batch(recv_buffers + received, senders + received,
+        sizes + received, num_datagrams - received,
+        bindns::bind(handle_batch, _1, _2, &n));
+
+    ioc.restart();
+    ioc.run();
+    ASIO_CHECK(n > 0);
+    if (n == 0)
+      break;
+    received += n;
+  }
+
+  ASIO_CHECK(received == num_datagrams);
+  for (size_t i = 0; i < received; ++i)
+  {
+    ASIO_CHECK(sizes[i] == i + 1);
+    ASIO_CHECK(senders[i] == s2.local_endpoint());
+    ASIO_CHECK(memcmp(recv_data[i], send_data[i], i + 1) == 0);
+  }
+
+  // Synchronous sends go through the same batching.
+  ASIO_CHECK(s2.send_batch(send_buffers, destinations, 3) == 3);
+  received = 0;
+  while (received < 3)
+    received += s1.receive_batch(recv_buffers + received,
+        senders + received, sizes + received, 3 - received);
+  ASIO_CHECK(sizes[0] == 1 && sizes[1] == 2 && sizes[2] == 3);
+}
+
+#endif // !defined(ASIO_HAS_IOCP)
+
+#if defined(ASIO_HAS_UDP_GSO)
+
+void handle_segments_recv(const asio::error_code& err,
+    size_t bytes_recvd, size_t* total)
+{
+  ASIO_CHECK(!err);
+  *total = bytes_recvd;
+}
+
+void test_segments()
+{
+  using namespace std; // For memcmp.
+  using namespace asio;
+  namespace ip = asio::ip;
+
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  io_context ioc;
+
+  ip::udp::socket s1(ioc, ip::udp::endpoint(ip::address_v4::loopback(), 0));
+  ip::udp::socket s2(ioc, ip::udp::endpoint(ip::address_v4::loopback(), 0));
+
+  // The size of each datagram must fit in 16 bits.
+  asio::error_code ec;
+  char data[1] = { 0 };
+  s2.send_segments(buffer(data), s1.local_endpoint(), 0, 0, ec);
+  ASIO_CHECK(ec == asio::error::invalid_argument);
+  s2.send_segments(buffer(data), s1.local_endpoint(), 65536, 0, ec);
+  ASIO_CHECK(ec == asio::error::invalid_argument);
+
+  s1.set_option(ip::udp::receive_offload(true), ec);
+  if (ec)
+    return; // Not supported by the running kernel.
+
+  // Send ten full segments and a short one. The receiver may get them as
+  // separate datagrams or coalesced, depending on the kernel.
+  const size_t seg = 1000;
+  const size_t total = 10 * seg + 500;
+  std::vector<char> send_data(total);
+  for (size_t i = 0; i < total; ++i)
+    send_data[i] = static_cast<char>(i % 253);
+
+  size_t sent = s2.send_segments(buffer(send_data),
+      s1.local_endpoint(), seg, 0, ec);
+  if (ec)
+    return; // Segmentation offload not supported.
+  ASIO_CHECK(sent == total);
+
+  std::vector<char> recv_data(total);
+  size_t received = 0;
+  while (received < total)
+  {
+    ip::udp::endpoint sender;
+    size_t segment_size = 0;
+    size_t n = 0;
+    s1.async_receive_segments(buffer(&recv_data[received], total - received),
+        sender, segment_size, bindns::bind(handle_segments_recv, _1, _2, &n));
+
+    ioc.restart();
+    ioc.run();
+    ASIO_CHECK(n > 0);
+    if (n == 0)
+      break;
+    ASIO_CHECK(sender == s2.local_endpoint());
+    ASIO_CHECK(segment_size == seg
+        || (segment_size == 500 && n == 500));
+    received += n;
+  }
+
+  ASIO_CHECK(received == total);
+  ASIO_CHECK(memcmp(&recv_data[0], &send_data[0], total) == 0);
+
+  // The socket option applies segmentation to ordinary sends.
+  s2.set_option(ip::udp::segment_size(seg));
+  ip::udp::segment_size option;
+  s2.get_option(option);
+  ASIO_CHECK(option.value() == static_cast<int>(seg));
+
+  sent = s2.send_to(buffer(&send_data[0], 3 * seg), s1.local_endpoint());
+  ASIO_CHECK(sent == 3 * seg);
+
+  received = 0;
+  while (received < 3 * seg)
+  {
+    ip::udp::endpoint sender;
+    size_t segment_size = 0;
+    size_t n = s1.receive_segments(buffer(&recv_data[received],
+          total - received), sender, segment_size);
+    ASIO_CHECK(segment_size == seg);
+    received += n;
+  }
+  ASIO_CHECK(received == 3 * seg);
+  ASIO_CHECK(memcmp(&recv_data[0], &send_data[0], 3 * seg) == 0);
+}
+
+#endif // defined(ASIO_HAS_UDP_GSO)
+
 } // namespace ip_udp_socket_runtime
 
 //------------------------------------------------------------------------------
@@ -669,5 +947,11 @@ ASIO_TEST_SUITE
   "ip/udp",
   ASIO_TEST_CASE(ip_udp_socket_compile::test)
   ASIO_TEST_CASE(ip_udp_socket_runtime::test)
+#if !defined(ASIO_HAS_IOCP)
+  ASIO_TEST_CASE(ip_udp_socket_runtime::test_batch)
+#endif // !defined(ASIO_HAS_IOCP)
+#if defined(ASIO_HAS_UDP_GSO)
+  ASIO_TEST_CASE(ip_udp_socket_runtime::test_segments)
+#endif // defined(ASIO_HAS_UDP_GSO)
   ASIO_TEST_CASE(ip_udp_resolver_compile::test)
 )
@@ -19,6 +19,7 @@
 #include <cstring>
 #include <vector>
 #include "archetypes/async_result.hpp"
+#include "archetypes/counting_handler.hpp"
 #include "asio/io_context.hpp"
 #include "asio/post.hpp"
 #include "asio/streambuf.hpp"
@@ -4961,6 +4962,62 @@ void test_4_arg_streambuf_async_read()
 #endif // !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
 }
 
+void test_async_read_allocations()
+{
+  asio::io_context ioc;
+  test_stream s(ioc);
+  char read_buf[sizeof(read_data)];
+  asio::mutable_buffer buffers
+    = asio::buffer(read_buf, sizeof(read_data));
+
+  // The intermediate operations reuse a single allocation, which is released
+  // before the handler is called.
+  s.reset(read_data, sizeof(read_data));
+  s.next_read_length(1);
+  memset(read_buf, 0, sizeof(read_buf));
+  int calls = 0;
+  archetypes::allocation_counts counts = { 0, 0 };
+  asio::async_read(s, buffers,
+      archetypes::counting_handler(&calls, &counts));
+  ioc.restart();
+  ioc.run();
+  ASIO_CHECK(calls == 1);
+  ASIO_CHECK(s.check_buffers(buffers, sizeof(read_data)));
+  ASIO_CHECK(counts.allocations == 1);
+  ASIO_CHECK(counts.deallocations == 1);
+
+  s.reset(read_data, sizeof(read_data));
+  s.next_read_length(1);
+  std::string data;
+  calls = 0;
+  counts.allocations = counts.deallocations = 0;
+  asio::async_read(s, asio::dynamic_buffer(data, sizeof(read_data)),
+      archetypes::counting_handler(&calls, &counts));
+  ioc.restart();
+  ioc.run();
+  ASIO_CHECK(calls == 1);
+  ASIO_CHECK(s.check_buffers(asio::buffer(data), sizeof(read_data)));
+  ASIO_CHECK(counts.allocations == 1);
+  ASIO_CHECK(counts.deallocations == 1);
+
+  // The allocation is freed if the operation is destroyed before completing.
+  {
+    asio::io_context ioc2;
+    test_stream s2(ioc2);
+    s2.reset(read_data, sizeof(read_data));
+    s2.next_read_length(1);
+    calls = 0;
+    counts.allocations = counts.deallocations = 0;
+    asio::async_read(s2, buffers,
+        archetypes::counting_handler(&calls, &counts));
+    ioc2.run_one();
+    ioc2.run_one();
+  }
+  ASIO_CHECK(calls == 0);
+  ASIO_CHECK(counts.allocations == 1);
+  ASIO_CHECK(counts.deallocations == 1);
+}
+
 ASIO_TEST_SUITE
 (
   "read",
@@ -4994,4 +5051,5 @@ ASIO_TEST_SUITE
   ASIO_TEST_CASE(test_4_arg_std_array_buffers_async_read)
   ASIO_TEST_CASE(test_4_arg_dynamic_string_async_read)
   ASIO_TEST_CASE(test_4_arg_streambuf_async_read)
+  ASIO_TEST_CASE(test_async_read_allocations)
 )
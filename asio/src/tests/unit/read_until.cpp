@@ -18,6 +18,7 @@
 
 #include <cstring>
 #include "archetypes/async_result.hpp"
+#include "archetypes/counting_handler.hpp"
 #include "asio/io_context.hpp"
 #include "asio/post.hpp"
 #include "asio/streambuf.hpp"
@@ -1640,6 +1641,42 @@ void test_streambuf_async_read_until_match_condition()
 #endif // !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
 }
 
+void test_async_read_until_allocations()
+{
+  asio::io_context ioc;
+  test_stream s(ioc);
+  std::string data;
+  int calls = 0;
+  archetypes::allocation_counts counts = { 0, 0 };
+
+  // The intermediate operations reuse a single allocation, which is released
+  // before the handler is called.
+  s.reset(read_data, sizeof(read_data));
+  s.next_read_length(1);
+  asio::async_read_until(s, asio::dynamic_buffer(data), 'Z',
+      archetypes::counting_handler(&calls, &counts));
+  ioc.restart();
+  ioc.run();
+  ASIO_CHECK(calls == 1);
+  ASIO_CHECK(data.size() == 26);
+  ASIO_CHECK(counts.allocations == 1);
+  ASIO_CHECK(counts.deallocations == 1);
+
+  s.reset(read_data, sizeof(read_data));
+  s.next_read_length(1);
+  data.clear();
+  calls = 0;
+  counts.allocations = counts.deallocations = 0;
+  asio::async_read_until(s, asio::dynamic_buffer(data), "XYZ",
+      archetypes::counting_handler(&calls, &counts));
+  ioc.restart();
+  ioc.run();
+  ASIO_CHECK(calls == 1);
+  ASIO_CHECK(data.size() == 26);
+  ASIO_CHECK(counts.allocations == 1);
+  ASIO_CHECK(counts.deallocations == 1);
+}
+
 ASIO_TEST_SUITE
 (
   "read_until",
@@ -1655,4 +1692,5 @@ ASIO_TEST_SUITE
   ASIO_TEST_CASE(test_streambuf_async_read_until_string)
   ASIO_TEST_CASE(test_dynamic_string_async_read_until_match_condition)
   ASIO_TEST_CASE(test_streambuf_async_read_until_match_condition)
+  ASIO_TEST_CASE(test_async_read_until_allocations)
 )
@@ -0,0 +1,61 @@
+//
+// session.cpp
+// ~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include "asio/ssl/session.hpp"
+
+#include "../unit_test.hpp"
+
+//------------------------------------------------------------------------------
+
+// ssl_session_references test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks that copies of a session refer to the same
+// underlying SSL_SESSION.
+
+namespace ssl_session_references {
+
+void test()
+{
+  using namespace asio;
+
+  ssl::session session1;
+  ASIO_CHECK(session1.empty());
+  ASIO_CHECK(!session1.is_resumable());
+  ASIO_CHECK(session1.native_handle() == 0);
+
+  ssl::session session2(::SSL_SESSION_new());
+  ASIO_CHECK(!session2.empty());
+
+  ssl::session session3(session2);
+  ASIO_CHECK(session3.native_handle() == session2.native_handle());
+
+  session1 = session3;
+  ASIO_CHECK(session1.native_handle() == session2.native_handle());
+
+  session3 = ssl::session();
+  ASIO_CHECK(session3.empty());
+  ASIO_CHECK(!session1.empty());
+}
+
+} // namespace ssl_session_references
+
+//------------------------------------------------------------------------------
+
+ASIO_TEST_SUITE
+(
+  "ssl/session",
+  ASIO_TEST_CASE(ssl_session_references::test)
+)
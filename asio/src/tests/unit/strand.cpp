@@ -17,9 +17,12 @@
 #include "asio/strand.hpp"
 
 #include <sstream>
+#include <vector>
+#include "asio/detail/atomic_count.hpp"
 #include "asio/executor.hpp"
 #include "asio/io_context.hpp"
 #include "asio/dispatch.hpp"
+#include "asio/executor_work_guard.hpp"
 #include "asio/post.hpp"
 #include "asio/thread.hpp"
 #include "unit_test.hpp"
@@ -239,6 +242,89 @@ void strand_test()
   ASIO_CHECK(count == 0);
 }
 
+struct ordering_state
+{
+  explicit ordering_state(const strand<io_context::executor_type>& st)
+    : s(st),
+      active(0),
+      count(0),
+      errors(0)
+  {
+    for (int i = 0; i < 4; ++i)
+      last[i] = -1;
+  }
+
+  strand<io_context::executor_type> s;
+  asio::detail::atomic_count active;
+  int last[4];
+  int count;
+  asio::detail::atomic_count errors;
+};
+
+void check_order(ordering_state* state, int producer, int seq)
+{
+  // Handlers on a strand never overlap, and handlers posted by one thread run
+  // in the order in which they were posted. The handler stays active for a
+  // while so that an overlapping handler would be seen.
+  if (++state->active != 1)
+    ++state->errors;
+  for (int i = 0; i < 100; ++i)
+    if (state->active != 1)
+      ++state->errors;
+  if (seq != state->last[producer] + 1)
+    ++state->errors;
+  state->last[producer] = seq;
+  ++state->count;
+  --state->active;
+}
+
+void post_in_order(std::vector<ordering_state*>* states,
+    int producer, int num_handlers)
+{
+  for (int seq = 0; seq < num_handlers; ++seq)
+    for (std::size_t i = 0; i < states->size(); ++i)
+      post((*states)[i]->s, bindns::bind(
+            check_order, (*states)[i], producer, seq));
+}
+
+void strand_ordering_test()
+{
+  io_context ioc;
+  executor_work_guard<io_context::executor_type> work
+    = make_work_guard(ioc);
+
+  const int num_producers = 4;
+  const int num_handlers = 2000;
+  std::vector<ordering_state*> states;
+  for (int i = 0; i < 8; ++i)
+    states.push_back(new ordering_state(make_strand(ioc)));
+
+  thread runner1(bindns::bind(io_context_run, &ioc));
+  thread runner2(bindns::bind(io_context_run, &ioc));
+  thread runner3(bindns::bind(io_context_run, &ioc));
+
+  thread producer0(bindns::bind(post_in_order, &states, 0, num_handlers));
+  thread producer1(bindns::bind(post_in_order, &states, 1, num_handlers));
+  thread producer2(bindns::bind(post_in_order, &states, 2, num_handlers));
+  thread producer3(bindns::bind(post_in_order, &states, 3, num_handlers));
+  producer0.join();
+  producer1.join();
+  producer2.join();
+  producer3.join();
+
+  work.reset();
+  runner1.join();
+  runner2.join();
+  runner3.join();
+
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    ASIO_CHECK(states[i]->count == num_producers * num_handlers);
+    ASIO_CHECK(states[i]->errors == 0);
+    delete states[i];
+  }
+}
+
 void strand_conversion_test()
 {
   io_context ioc;
@@ -470,6 +556,7 @@ ASIO_TEST_SUITE
 (
   "strand",
   ASIO_TEST_CASE(strand_test)
+  ASIO_TEST_CASE(strand_ordering_test)
   ASIO_COMPILE_TEST_CASE(strand_conversion_test)
   ASIO_TEST_CASE(strand_query_test)
   ASIO_TEST_CASE(strand_execute_test)
@@ -27,6 +27,7 @@
 
 #include "asio/bind_cancellation_slot.hpp"
 #include "asio/cancellation_signal.hpp"
+#include "asio/detail/chrono_time_traits.hpp"
 #include "asio/executor_work_guard.hpp"
 #include "asio/io_context.hpp"
 #include "asio/thread.hpp"
@@ -468,6 +469,61 @@ void system_timer_move_test()
 #endif // defined(ASIO_HAS_MOVE)
 }
 
+void record_completion(asio::system_timer* t, int* count, int* early,
+    asio::system_timer::time_point* first_completion)
+{
+  asio::system_timer::time_point completion = now();
+  if ((*count)++ == 0)
+    *first_completion = completion;
+  if (completion < t->expiry())
+    ++(*early);
+}
+
+void system_timer_slack_test()
+{
+  typedef asio::detail::chrono_time_traits<asio::chrono::system_clock,
+      asio::wait_traits<asio::chrono::system_clock> > traits;
+
+  asio::io_context ioc;
+  int count = 0;
+  int early = 0;
+  asio::system_timer::time_point first_completion;
+
+  // Find a time to which the slack allows waits to be delayed, and give each
+  // timer an expiry time within the slack before it.
+  const asio::system_timer::duration slack = asio::chrono::milliseconds(200);
+  asio::system_timer::time_point group = traits::coalesce(
+      now() + asio::chrono::milliseconds(300), slack);
+
+  const int num_timers = 16;
+  asio::system_timer* timers[num_timers];
+  for (int i = 0; i < num_timers; ++i)
+  {
+    timers[i] = new asio::system_timer(ioc);
+    ASIO_CHECK(timers[i]->slack() == asio::system_timer::duration());
+
+    timers[i]->slack(slack);
+    ASIO_CHECK(timers[i]->slack() == slack);
+
+    timers[i]->expires_at(group - asio::chrono::milliseconds(i * 5));
+    timers[i]->async_wait(bindns::bind(record_completion,
+          timers[i], &count, &early, &first_completion));
+  }
+
+  ioc.run();
+
+  // Slack may delay a wait, but must never let it complete early.
+  ASIO_CHECK(count == num_timers);
+  ASIO_CHECK(early == 0);
+  ASIO_CHECK(now() - group < asio::chrono::seconds(10));
+
+  // The waits expire together, so none completes before the latest expiry.
+  ASIO_CHECK(first_completion >= group);
+
+  for (int i = 0; i < num_timers; ++i)
+    delete timers[i];
+}
+
 void system_timer_op_cancel_test()
 {
   asio::cancellation_signal cancel_signal;
@@ -515,6 +571,7 @@ ASIO_TEST_SUITE
   ASIO_TEST_CASE(system_timer_thread_test)
   ASIO_TEST_CASE(system_timer_move_test)
   ASIO_TEST_CASE(system_timer_op_cancel_test)
+  ASIO_TEST_CASE(system_timer_slack_test)
 )
 #else // defined(ASIO_HAS_STD_CHRONO)
 ASIO_TEST_SUITE
@@ -109,6 +109,33 @@ private:
 asio::execution_context::id test_service::id;
 #endif // defined(ASIO_NO_TYPEID)
 
+void fan_out(thread_pool* pool, asio::detail::atomic_count* count, int depth)
+{
+  ++(*count);
+  if (depth > 0)
+    for (int i = 0; i < 4; ++i)
+      asio::post(*pool, bindns::bind(fan_out, pool, count, depth - 1));
+}
+
+void thread_pool_work_stealing_test()
+{
+  thread_pool pool(4, ASIO_CONCURRENCY_HINT_WORK_STEALING);
+
+  // Handlers posted from within handlers are queued on the posting thread,
+  // and must be stolen by the other threads.
+  asio::detail::atomic_count count(0);
+  asio::post(pool, bindns::bind(fan_out, &pool, &count, 6));
+
+  int count2 = 10;
+  asio::post(pool, bindns::bind(decrement_to_zero, &pool, &count2));
+
+  pool.wait();
+
+  // 1 + 4 + 16 + 64 + 256 + 1024 + 4096 handlers.
+  ASIO_CHECK(count == 5461);
+  ASIO_CHECK(count2 == 0);
+}
+
 void thread_pool_service_test()
 {
   asio::thread_pool pool1(1);
@@ -518,6 +545,7 @@ ASIO_TEST_SUITE
 (
   "thread_pool",
   ASIO_TEST_CASE(thread_pool_test)
+  ASIO_TEST_CASE(thread_pool_work_stealing_test)
   ASIO_TEST_CASE(thread_pool_service_test)
   ASIO_TEST_CASE(thread_pool_executor_query_test)
   ASIO_TEST_CASE(thread_pool_executor_execute_test)
@@ -0,0 +1,171 @@
+//
+// timing_wheel_traits.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Prevent link dependency on the Boost.System library.
+#if !defined(BOOST_SYSTEM_NO_DEPRECATED)
+#define BOOST_SYSTEM_NO_DEPRECATED
+#endif // !defined(BOOST_SYSTEM_NO_DEPRECATED)
+
+// Test that header file is self-contained.
+#include "asio/timing_wheel_traits.hpp"
+
+#include "unit_test.hpp"
+
+#if defined(ASIO_HAS_STD_CHRONO)
+
+#include <vector>
+#include "asio/basic_waitable_timer.hpp"
+#include "asio/io_context.hpp"
+#include "asio/steady_timer.hpp"
+
+#if defined(ASIO_HAS_BOOST_BIND)
+# include <boost/bind/bind.hpp>
+#else // defined(ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
+#if defined(ASIO_HAS_BOOST_BIND)
+namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
+typedef asio::chrono::steady_clock clock_type;
+
+typedef asio::basic_waitable_timer<clock_type,
+    asio::timing_wheel_wait_traits<clock_type> > wheel_timer;
+
+typedef asio::basic_waitable_timer<clock_type,
+    asio::timing_wheel_wait_traits<clock_type, 10000> > coarse_wheel_timer;
+
+template <typename Timer>
+void record_expiry(const asio::error_code& ec, Timer* t,
+    int* fired, int* aborted, int* early)
+{
+  if (ec == asio::error::operation_aborted)
+    ++(*aborted);
+  else if (!ec)
+  {
+    ++(*fired);
+    if (clock_type::now() < t->expiry())
+      ++(*early);
+  }
+}
+
+template <typename Timer>
+void cancel_timer(Timer* t)
+{
+  t->cancel();
+}
+
+template <typename Timer>
+void timing_wheel_expiry_test_for()
+{
+  using bindns::placeholders::_1;
+
+  asio::io_context ioc;
+
+  // Spread the expiry times so that timers land at several levels of the
+  // wheel and must be moved down as the wheel turns.
+  const int num_timers = 200;
+  std::vector<Timer*> timers;
+  int fired = 0, aborted = 0, early = 0;
+  for (int i = 0; i < num_timers; ++i)
+  {
+    Timer* t = new Timer(ioc,
+        asio::chrono::microseconds((i * 7919) % 300000));
+    t->async_wait(bindns::bind(&record_expiry<Timer>,
+          _1, t, &fired, &aborted, &early));
+    timers.push_back(t);
+  }
+
+  // Timers that are cancelled must not fire.
+  for (int i = 0; i < num_timers; i += 4)
+    timers[i]->cancel();
+
+  // A timer that never expires must not prevent the others from firing.
+  Timer never(ioc, (clock_type::time_point::max)());
+  never.async_wait(bindns::bind(&record_expiry<Timer>,
+        _1, &never, &fired, &aborted, &early));
+
+  Timer stopper(ioc, asio::chrono::seconds(1));
+  stopper.async_wait(bindns::bind(&cancel_timer<Timer>, &never));
+
+  ioc.run();
+
+  ASIO_CHECK(fired == num_timers - num_timers / 4);
+  ASIO_CHECK(aborted == num_timers / 4 + 1);
+  ASIO_CHECK(early == 0);
+
+  for (std::size_t i = 0; i < timers.size(); ++i)
+    delete timers[i];
+}
+
+void timing_wheel_expiry_test()
+{
+  timing_wheel_expiry_test_for<wheel_timer>();
+  timing_wheel_expiry_test_for<coarse_wheel_timer>();
+}
+
+void increment(int* count)
+{
+  ++(*count);
+}
+
+void timing_wheel_reschedule_test()
+{
+  asio::io_context ioc;
+  int count = 0;
+
+  // Rescheduling a timer moves it to a different slot.
+  wheel_timer t1(ioc, asio::chrono::seconds(60));
+  t1.async_wait(bindns::bind(increment, &count));
+  t1.expires_after(asio::chrono::milliseconds(20));
+  t1.async_wait(bindns::bind(increment, &count));
+
+  clock_type::time_point start = clock_type::now();
+  ioc.run();
+
+  ASIO_CHECK(count == 2);
+  ASIO_CHECK(clock_type::now() - start >= asio::chrono::milliseconds(20));
+  ASIO_CHECK(clock_type::now() - start < asio::chrono::seconds(60));
+
+#if defined(ASIO_HAS_MOVE)
+  // Moving a timer keeps its pending wait in the wheel.
+  ioc.restart();
+  count = 0;
+  wheel_timer t2(ioc, asio::chrono::milliseconds(10));
+  t2.async_wait(bindns::bind(increment, &count));
+  wheel_timer t3(ASIO_MOVE_CAST(wheel_timer)(t2));
+
+  ioc.run();
+
+  ASIO_CHECK(count == 1);
+#endif // defined(ASIO_HAS_MOVE)
+}
+
+ASIO_TEST_SUITE
+(
+  "timing_wheel_traits",
+  ASIO_TEST_CASE(timing_wheel_expiry_test)
+  ASIO_TEST_CASE(timing_wheel_reschedule_test)
+)
+#else // defined(ASIO_HAS_STD_CHRONO)
+ASIO_TEST_SUITE
+(
+  "timing_wheel_traits",
+  ASIO_TEST_CASE(null_test)
+)
+#endif // defined(ASIO_HAS_STD_CHRONO)
@@ -19,6 +19,7 @@
 #include <cstring>
 #include <vector>
 #include "archetypes/async_result.hpp"
+#include "archetypes/counting_handler.hpp"
 #include "asio/io_context.hpp"
 #include "asio/post.hpp"
 #include "asio/streambuf.hpp"
@@ -4866,6 +4867,43 @@ void test_4_arg_streambuf_async_write()
 #endif // !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
 }
 
+void test_async_write_allocations()
+{
+  asio::io_context ioc;
+  test_stream s(ioc);
+  asio::const_buffer buffers
+    = asio::buffer(write_data, sizeof(write_data));
+
+  // The intermediate operations reuse a single allocation, which is released
+  // before the handler is called.
+  s.reset();
+  s.next_write_length(1);
+  int calls = 0;
+  archetypes::allocation_counts counts = { 0, 0 };
+  asio::async_write(s, buffers,
+      archetypes::counting_handler(&calls, &counts));
+  ioc.restart();
+  ioc.run();
+  ASIO_CHECK(calls == 1);
+  ASIO_CHECK(s.check_buffers(buffers, sizeof(write_data)));
+  ASIO_CHECK(counts.allocations == 1);
+  ASIO_CHECK(counts.deallocations == 1);
+
+  s.reset();
+  s.next_write_length(1);
+  std::string data(write_data, sizeof(write_data));
+  calls = 0;
+  counts.allocations = counts.deallocations = 0;
+  asio::async_write(s, asio::dynamic_buffer(data),
+      archetypes::counting_handler(&calls, &counts));
+  ioc.restart();
+  ioc.run();
+  ASIO_CHECK(calls == 1);
+  ASIO_CHECK(s.check_buffers(buffers, sizeof(write_data)));
+  ASIO_CHECK(counts.allocations == 1);
+  ASIO_CHECK(counts.deallocations == 1);
+}
+
 ASIO_TEST_SUITE
 (
   "write",
@@ -4901,4 +4939,5 @@ ASIO_TEST_SUITE
   ASIO_TEST_CASE(test_4_arg_vector_buffers_async_write)
   ASIO_TEST_CASE(test_4_arg_dynamic_string_async_write)
   ASIO_TEST_CASE(test_4_arg_streambuf_async_write)
+  ASIO_TEST_CASE(test_async_write_allocations)
 )
@@ -0,0 +1,336 @@
+#!/usr/bin/perl -w
+#
+# handlerdecode.pl
+# ~~~~~~~~~~~~~~~~
+#
+# A tool for decoding the files written by asio::dump_handler_tracking() in
+# programs compiled with the define `ASIO_ENABLE_BINARY_HANDLER_TRACKING'.
+#
+# By default the tool writes the events in the text format produced by
+# `ASIO_ENABLE_HANDLER_TRACKING', so that the output may be used with the other
+# handler tracking tools. For example:
+#
+#   perl handlerdecode.pl dump.bin | perl handlerviz.pl | dot -Tpng > dump.png
+#
+# With the option `--chrome', the tool instead writes the events in the Chrome
+# trace event format, for use with chrome://tracing or Perfetto:
+#
+#   perl handlerdecode.pl --chrome dump.bin > dump.json
+#
+# Copyright (c) 2003-2021 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+#
+# Distributed under the Boost Software License, Version 1.0. (See accompanying
+# file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#
+
+use strict;
+
+my $creation_event = 1;
+my $location_event = 2;
+my $abandoned_event = 3;
+my $destroyed_event = 4;
+my $invocation_begin_event = 5;
+my $invocation_end_event = 6;
+my $operation_event = 7;
+my $reactor_operation_event = 8;
+
+my $has_error_code = 1;
+my $has_bytes_transferred = 2;
+my $has_signal_number = 4;
+my $innermost_location = 16;
+
+my $event_size = 56;
+
+my %strings = ();
+my @events = ();
+
+#-------------------------------------------------------------------------------
+# Read the dump file into the string table and the list of events.
+
+sub read_bytes($$)
+{
+  my ($file, $length) = @_;
+  my $data = "";
+  my $result = read($file, $data, $length);
+  die "Truncated dump file\n" unless defined($result) && $result == $length;
+  return $data;
+}
+
+sub read_dump($)
+{
+  my $filename = shift;
+
+  open(my $file, "<", $filename) or die "Cannot open $filename: $!\n";
+  binmode($file);
+
+  my ($magic, $version, $byte_order, $size, $string_count, $thread_count)
+    = unpack("a8 L L L L L", read_bytes($file, 32));
+
+  die "$filename is not a handler tracking dump\n" if $magic ne "ASIOHTRK";
+  die "Unsupported dump version $version\n" if $version != 1;
+  die "The dump was written on a machine with a different byte order\n"
+    if $byte_order != 0x01020304;
+  die "Unsupported event size $size\n" if $size != $event_size;
+
+  for (my $i = 0; $i < $string_count; ++$i)
+  {
+    my ($address, $length) = unpack("Q L L", read_bytes($file, 16));
+    $strings{$address} = read_bytes($file, $length);
+  }
+
+  for (my $i = 0; $i < $thread_count; ++$i)
+  {
+    my ($thread, $dropped, $count) = unpack("Q Q Q", read_bytes($file, 24));
+    print STDERR "Thread $thread: $dropped events overwritten\n" if $dropped;
+
+    for (my $j = 0; $j < $count; ++$j)
+    {
+      my ($timestamp, $id, $parent_id, $value, $string1, $string2,
+          $error_value, $kind, $flags)
+        = unpack("Q Q Q Q Q Q l C C", read_bytes($file, $event_size));
+
+      push(@events,
+        {
+          thread => $thread,
+          sequence => $dropped + $j,
+          timestamp => $timestamp,
+          id => $id,
+          parent_id => $parent_id,
+          value => $value,
+          string1 => $string1 ? $strings{$string1} : "",
+          string2 => $string2 ? $strings{$string2} : "",
+          error_value => $error_value,
+          kind => $kind,
+          flags => $flags
+        });
+    }
+  }
+
+  close($file);
+
+  # Merge the events of all threads, keeping each thread's events in order.
+  @events = sort {
+      $a->{timestamp} <=> $b->{timestamp}
+        || $a->{thread} <=> $b->{thread}
+        || $a->{sequence} <=> $b->{sequence}
+    } @events;
+}
+
+#-------------------------------------------------------------------------------
+# Write the events in the handler tracking text format.
+
+sub format_timestamp($)
+{
+  my $timestamp = shift;
+  return sprintf("%d.%06d", int($timestamp / 1000000), $timestamp % 1000000);
+}
+
+sub format_arguments($)
+{
+  my $event = shift;
+  my $text = "";
+  if ($event->{flags} & $has_error_code)
+  {
+    $text .= "ec=" . substr($event->{string1}, 0, 20)
+      . ":" . $event->{error_value};
+  }
+  if ($event->{flags} & $has_bytes_transferred)
+  {
+    $text .= ",bytes_transferred=" . $event->{value};
+  }
+  if ($event->{flags} & $has_signal_number)
+  {
+    $text .= ",signal_number=" . $event->{value};
+  }
+  return $text;
+}
+
+sub write_text()
+{
+  foreach my $event (@events)
+  {
+    my $kind = $event->{kind};
+    my $id = $event->{id};
+    my $line = "\@asio|" . format_timestamp($event->{timestamp}) . "|";
+
+    if ($kind == $creation_event)
+    {
+      $line .= $event->{parent_id} . "*" . $id . "|"
+        . substr($event->{string1}, 0, 20) . "@"
+        . sprintf("0x%x", $event->{value}) . "."
+        . substr($event->{string2}, 0, 50);
+    }
+    elsif ($kind == $location_event)
+    {
+      my $func = substr($event->{string2}, 0, 80);
+      $line .= $event->{parent_id} . "^" . $id . "|"
+        . (($event->{flags} & $innermost_location) ? "in " : "called from ")
+        . (length($func) ? "'$func' " : "")
+        . "(" . substr($event->{string1}, 0, 80) . ":" . $event->{value} . ")";
+    }
+    elsif ($kind == $abandoned_event)
+    {
+      $line .= "~" . $id . "|";
+    }
+    elsif ($kind == $destroyed_event)
+    {
+      $line .= "!" . $id . "|";
+    }
+    elsif ($kind == $invocation_begin_event)
+    {
+      $line .= ">" . $id . "|" . format_arguments($event);
+    }
+    elsif ($kind == $invocation_end_event)
+    {
+      $line .= "<" . $id . "|";
+    }
+    elsif ($kind == $operation_event)
+    {
+      $line .= $event->{parent_id} . "|"
+        . substr($event->{string1}, 0, 20) . "@"
+        . sprintf("0x%x", $event->{value}) . "."
+        . substr($event->{string2}, 0, 50);
+    }
+    elsif ($kind == $reactor_operation_event)
+    {
+      $line .= "." . $id . "|" . $event->{string2} . ","
+        . format_arguments($event);
+    }
+    else
+    {
+      next;
+    }
+
+    print("$line\n");
+  }
+}
+
+#-------------------------------------------------------------------------------
+# Write the events in the Chrome trace event format.
+
+sub json_string($)
+{
+  my $text = shift;
+  $text =~ s/(["\\])/\\$1/g;
+  $text =~ s/([\x00-\x1f])/sprintf("\\u%04x", ord($1))/ge;
+  return "\"$text\"";
+}
+
+sub write_chrome()
+{
+  my %names = ();
+  my %locations = ();
+  my @records = ();
+
+  foreach my $event (@events)
+  {
+    my $kind = $event->{kind};
+    my $id = $event->{id};
+    my $common = "\"pid\":1,\"tid\":" . $event->{thread}
+      . ",\"ts\":" . $event->{timestamp};
+
+    if ($kind == $location_event)
+    {
+      if ($event->{flags} & $innermost_location)
+      {
+        my $func = $event->{string2};
+        $locations{$id} = (length($func) ? "$func " : "")
+          . "(" . $event->{string1} . ":" . $event->{value} . ")";
+      }
+    }
+    elsif ($kind == $creation_event)
+    {
+      my $name = $event->{string1} . "." . $event->{string2};
+      $names{$id} = $name;
+      my $args = "\"id\":$id,\"parent\":" . $event->{parent_id}
+        . ",\"object\":" . json_string(sprintf("0x%x", $event->{value}));
+      $args .= ",\"location\":" . json_string($locations{$id})
+        if defined($locations{$id});
+      delete($locations{$id});
+      push(@records, "{\"name\":" . json_string("create $name")
+        . ",\"cat\":\"handler\",\"ph\":\"i\",\"s\":\"t\",$common"
+        . ",\"args\":{$args}}");
+      push(@records, "{\"name\":\"handler\",\"cat\":\"handler\""
+        . ",\"ph\":\"s\",\"id\":$id,$common}");
+    }
+    elsif ($kind == $invocation_begin_event)
+    {
+      my $name = defined($names{$id}) ? $names{$id} : "handler $id";
+      my $args = "\"id\":$id";
+      if ($event->{flags} & $has_error_code)
+      {
+        $args .= ",\"ec\":" . json_string(
+            $event->{string1} . ":" . $event->{error_value});
+      }
+      if ($event->{flags} & $has_bytes_transferred)
+      {
+        $args .= ",\"bytes_transferred\":" . $event->{value};
+      }
+      if ($event->{flags} & $has_signal_number)
+      {
+        $args .= ",\"signal_number\":" . $event->{value};
+      }
+      push(@records, "{\"name\":\"handler\",\"cat\":\"handler\""
+        . ",\"ph\":\"f\",\"bp\":\"e\",\"id\":$id,$common}")
+        if defined($names{$id});
+      push(@records, "{\"name\":" . json_string($name)
+        . ",\"cat\":\"handler\",\"ph\":\"B\",$common,\"args\":{$args}}");
+    }
+    elsif ($kind == $invocation_end_event)
+    {
+      push(@records, "{\"ph\":\"E\",$common}");
+      delete($names{$id});
+    }
+    elsif ($kind == $abandoned_event)
+    {
+      push(@records, "{\"name\":\"abandon\",\"cat\":\"handler\""
+        . ",\"ph\":\"i\",\"s\":\"t\",$common,\"args\":{\"id\":$id}}");
+      delete($names{$id});
+    }
+    elsif ($kind == $operation_event)
+    {
+      my $name = $event->{string1} . "." . $event->{string2};
+      push(@records, "{\"name\":" . json_string($name)
+        . ",\"cat\":\"operation\",\"ph\":\"i\",\"s\":\"t\",$common"
+        . ",\"args\":{\"parent\":" . $event->{parent_id} . "}}");
+    }
+    elsif ($kind == $reactor_operation_event)
+    {
+      my $args = "\"id\":$id,\"ec\":" . json_string(
+          $event->{string1} . ":" . $event->{error_value});
+      if ($event->{flags} & $has_bytes_transferred)
+      {
+        $args .= ",\"bytes_transferred\":" . $event->{value};
+      }
+      push(@records, "{\"name\":" . json_string($event->{string2})
+        . ",\"cat\":\"reactor\",\"ph\":\"i\",\"s\":\"t\",$common"
+        . ",\"args\":{$args}}");
+    }
+  }
+
+  print("{\"traceEvents\":[\n");
+  print(join(",\n", @records));
+  print("\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+#-------------------------------------------------------------------------------
+
+my $chrome = 0;
+if (@ARGV && $ARGV[0] eq "--chrome")
+{
+  $chrome = 1;
+  shift(@ARGV);
+}
+
+die "Usage: perl handlerdecode.pl [--chrome] <dump file>\n" if @ARGV != 1;
+
+read_dump($ARGV[0]);
+
+if ($chrome)
+{
+  write_chrome();
+}
+else
+{
+  write_text();
+}